@@ -0,0 +1,863 @@
+/**
+ * @file gaming_bench.c
+ * @brief gaming-core 效能量測工具
+ * @version 1.0.0
+ *
+ * 量測 logger、config_parser、socket_helper 等模組的效能
+ * 每個量測結果以一行 JSON 輸出到 stdout,方便在版本之間比較
+ *
+ * 用法: gaming_bench [名稱前綴...]
+ *   例如 gaming_bench socket. logger.console
+ */
+
+#define _GNU_SOURCE
+
+#include "gaming_common.h"
+#include "logger.h"
+#include "config_parser.h"
+#include "socket_helper.h"
+#include "relay.h"
+#include "buffer_pool.h"
+#include "timer_wheel.h"
+#include "gaming_protocol.h"
+#include "metrics.h"
+#include "trace.h"
+#include "gpio.h"
+#include "uci_native.h"
+#include "thread_pool.h"
+#include "ps5_state.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <netinet/tcp.h>
+
+// ========================================
+// 量測配置
+// ========================================
+
+#define BENCH_LOG_LINES          200000
+#define BENCH_SYSLOG_LINES       5000
+#define BENCH_CONFIG_LOOKUPS     200
+#define BENCH_RTT_ROUNDS         20000
+#define BENCH_RTT_MESSAGE_SIZE   64
+#define BENCH_STREAM_BYTES       (256ULL * 1024 * 1024)
+#define BENCH_MICRO_OPS          2000000
+#define BENCH_GPIO_EDGES         20000
+#define BENCH_UCI_SECTIONS       200
+#define BENCH_UCI_PARSES         2000
+#define BENCH_POOL_TASKS         100000
+
+#define BENCH_UNIX_PATH          "/tmp/gaming_bench.sock"
+#define BENCH_TCP_PORT           47810
+#define BENCH_TCP_RELAY_PORT     47811
+#define BENCH_UCI_PATH           "/tmp/gaming_bench.uci"
+
+// ========================================
+// 結果輸出
+// ========================================
+
+typedef struct {
+    const char *name;
+    uint64_t ops;
+    uint64_t bytes;
+    uint64_t errors;
+    double seconds;
+    double p50_us;
+    double p99_us;
+} bench_result_t;
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static void bench_report(const bench_result_t *r) {
+    printf("{\"name\":\"%s\",\"ops\":%llu,\"seconds\":%.6f",
+           r->name, (unsigned long long)r->ops, r->seconds);
+
+    if (r->seconds > 0 && r->ops > 0) {
+        printf(",\"ops_per_sec\":%.1f", (double)r->ops / r->seconds);
+    }
+    if (r->bytes > 0) {
+        printf(",\"bytes\":%llu,\"mb_per_sec\":%.1f", (unsigned long long)r->bytes,
+               r->seconds > 0 ? (double)r->bytes / r->seconds / (1024.0 * 1024.0) : 0.0);
+    }
+    if (r->p50_us > 0) {
+        printf(",\"p50_us\":%.2f,\"p99_us\":%.2f", r->p50_us, r->p99_us);
+    }
+    printf(",\"errors\":%llu}\n", (unsigned long long)r->errors);
+    fflush(stdout);
+}
+
+/**
+ * @brief 暫時將 stderr 導向 /dev/null (logger console 輸出、uci 錯誤訊息)
+ *
+ * @return 原本的 stderr fd,交給 bench_restore_stderr 還原
+ */
+static int bench_silence_stderr(void) {
+    int saved = dup(STDERR_FILENO);
+    int devnull = open("/dev/null", O_WRONLY);
+    if (devnull >= 0) {
+        dup2(devnull, STDERR_FILENO);
+        close(devnull);
+    }
+    return saved;
+}
+
+static void bench_restore_stderr(int saved) {
+    if (saved >= 0) {
+        dup2(saved, STDERR_FILENO);
+        close(saved);
+    }
+}
+
+static int compare_double(const void *a, const void *b) {
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static double percentile(double *sorted, size_t count, double p) {
+    if (count == 0) {
+        return 0.0;
+    }
+    size_t index = (size_t)(p * (double)(count - 1));
+    return sorted[index];
+}
+
+// ========================================
+// Logger
+// ========================================
+
+/**
+ * @brief 量測 logger 輸出速度,console 輸出導向 /dev/null
+ */
+static void bench_logger_target(const char *name, log_target_t target,
+                                log_level_t level, uint64_t lines) {
+    int saved_stderr = bench_silence_stderr();
+
+    logger_init("gaming_bench", LOG_LEVEL_INFO, target);
+
+    bench_result_t r = { .name = name, .ops = lines };
+    double start = now_seconds();
+    for (uint64_t i = 0; i < lines; i++) {
+        logger_log(level, "bench line %llu value=%d", (unsigned long long)i, 42);
+    }
+    logger_flush();
+    r.seconds = now_seconds() - start;
+
+    logger_cleanup();
+
+    bench_restore_stderr(saved_stderr);
+
+    bench_report(&r);
+}
+
+static void bench_logger_filtered(void) {
+    bench_logger_target("logger.filtered", LOG_TARGET_CONSOLE, LOG_LEVEL_DEBUG,
+                        BENCH_MICRO_OPS);
+}
+
+static void bench_logger_module_filtered(void) {
+    logger_init("gaming_bench", LOG_LEVEL_INFO, LOG_TARGET_CONSOLE);
+    logger_set_module_levels("socket=debug");
+
+    bench_result_t r = { .name = "logger.module_filtered", .ops = BENCH_MICRO_OPS };
+    double start = now_seconds();
+    for (uint64_t i = 0; i < BENCH_MICRO_OPS; i++) {
+        LOGM_DEBUG(LOG_MODULE_LED, "bench line %llu value=%d", (unsigned long long)i, 42);
+    }
+    r.seconds = now_seconds() - start;
+
+    logger_cleanup();
+    bench_report(&r);
+}
+
+static void bench_logger_flight(void) {
+    logger_init("gaming_bench", LOG_LEVEL_INFO, LOG_TARGET_CONSOLE);
+    logger_flight_recorder_enable(true);
+
+    bench_result_t r = { .name = "logger.flight_record", .ops = BENCH_LOG_LINES };
+    double start = now_seconds();
+    for (uint64_t i = 0; i < BENCH_LOG_LINES; i++) {
+        LOGM_DEBUG(LOG_MODULE_SOCKET, "bench line %llu value=%d", (unsigned long long)i, 42);
+    }
+    r.seconds = now_seconds() - start;
+
+    logger_flight_recorder_enable(false);
+    logger_cleanup();
+    bench_report(&r);
+}
+
+static void bench_logger_console(void) {
+    bench_logger_target("logger.console", LOG_TARGET_CONSOLE, LOG_LEVEL_INFO,
+                        BENCH_LOG_LINES);
+}
+
+static void bench_logger_syslog(void) {
+    bench_logger_target("logger.syslog", LOG_TARGET_SYSLOG, LOG_LEVEL_INFO,
+                        BENCH_SYSLOG_LINES);
+}
+
+static void bench_logger_both(void) {
+    bench_logger_target("logger.both", LOG_TARGET_BOTH, LOG_LEVEL_INFO,
+                        BENCH_SYSLOG_LINES);
+}
+
+// ========================================
+// Config Parser
+// ========================================
+
+static void bench_config_get(void) {
+    int saved_stderr = bench_silence_stderr();
+    config_parser_init();
+
+    char buffer[128];
+    int ivalue;
+    bool bvalue;
+
+    bench_result_t rs = { .name = "config.get_string", .ops = BENCH_CONFIG_LOOKUPS };
+    double start = now_seconds();
+    for (int i = 0; i < BENCH_CONFIG_LOOKUPS; i++) {
+        if (config_parser_get_string(UCI_CONFIG_GAMING, UCI_SECTION_MAIN, UCI_OPTION_DEVICE_TYPE,
+                                     buffer, sizeof(buffer)) != GAMING_OK) {
+            rs.errors++;
+        }
+    }
+    rs.seconds = now_seconds() - start;
+
+    bench_result_t ri = { .name = "config.get_int", .ops = BENCH_CONFIG_LOOKUPS };
+    start = now_seconds();
+    for (int i = 0; i < BENCH_CONFIG_LOOKUPS; i++) {
+        if (config_parser_get_int(UCI_CONFIG_GAMING, UCI_SECTION_MAIN, UCI_OPTION_LOG_LEVEL,
+                                  &ivalue) != GAMING_OK) {
+            ri.errors++;
+        }
+    }
+    ri.seconds = now_seconds() - start;
+
+    bench_result_t rb = { .name = "config.get_bool", .ops = BENCH_CONFIG_LOOKUPS };
+    start = now_seconds();
+    for (int i = 0; i < BENCH_CONFIG_LOOKUPS; i++) {
+        if (config_parser_get_bool(UCI_CONFIG_GAMING, UCI_SECTION_MAIN, UCI_OPTION_ENABLED,
+                                   &bvalue) != GAMING_OK) {
+            rb.errors++;
+        }
+    }
+    rb.seconds = now_seconds() - start;
+
+    config_parser_cleanup();
+    bench_restore_stderr(saved_stderr);
+
+    bench_report(&rs);
+    bench_report(&ri);
+    bench_report(&rb);
+}
+
+// ========================================
+// Socket Helper
+// ========================================
+
+typedef struct {
+    int listen_fd;
+    bool echo;               // true: 回送, false: 只讀取並計數
+    uint64_t received;
+} bench_server_t;
+
+static void *bench_server_thread(void *arg) {
+    bench_server_t *server = arg;
+    int fd = accept(server->listen_fd, NULL, NULL);
+    if (fd < 0) {
+        return NULL;
+    }
+
+    char *buffer = malloc(SOCKET_DEFAULT_BUFFER_SIZE * 16);
+    ssize_t n;
+    while ((n = socket_helper_recv(fd, buffer, SOCKET_DEFAULT_BUFFER_SIZE * 16)) > 0) {
+        server->received += (uint64_t)n;
+        if (server->echo) {
+            ssize_t off = 0;
+            while (off < n) {
+                ssize_t w = socket_helper_send(fd, buffer + off, (size_t)(n - off));
+                if (w <= 0) {
+                    goto out;
+                }
+                off += w;
+            }
+        }
+    }
+
+out:
+    free(buffer);
+    socket_helper_close(fd);
+    return NULL;
+}
+
+static int bench_listen(bool tcp, int port) {
+    return tcp ? socket_helper_create_tcp_server(port, SOCKET_DEFAULT_BACKLOG)
+               : socket_helper_create_unix(BENCH_UNIX_PATH);
+}
+
+static int bench_connect(bool tcp, int port) {
+    return tcp ? socket_helper_connect_tcp("127.0.0.1", port)
+               : socket_helper_connect_unix(BENCH_UNIX_PATH);
+}
+
+/**
+ * @brief 等待 server 執行緒結束
+ *
+ * 連線失敗時 server 仍阻塞在 accept(), 先 shutdown 監聽 socket 讓 accept()
+ * 回傳錯誤, 否則 pthread_join 會永遠等待
+ */
+static void bench_server_join(pthread_t thread, const bench_server_t *server, bool connected) {
+    if (!connected) {
+        shutdown(server->listen_fd, SHUT_RDWR);
+    }
+    pthread_join(thread, NULL);
+}
+
+static void bench_socket_rtt(const char *name, bool tcp) {
+    bench_server_t server = { .echo = true };
+    server.listen_fd = bench_listen(tcp, BENCH_TCP_PORT);
+    if (server.listen_fd < 0) {
+        bench_result_t r = { .name = name, .errors = 1 };
+        bench_report(&r);
+        return;
+    }
+
+    pthread_t thread;
+    pthread_create(&thread, NULL, bench_server_thread, &server);
+
+    int fd = bench_connect(tcp, BENCH_TCP_PORT);
+    double *samples = calloc(BENCH_RTT_ROUNDS, sizeof(double));
+    bench_result_t r = { .name = name, .ops = BENCH_RTT_ROUNDS };
+
+    if (fd >= 0 && samples != NULL) {
+        if (tcp) {
+            int one = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        }
+
+        char message[BENCH_RTT_MESSAGE_SIZE];
+        memset(message, 'g', sizeof(message));
+
+        // I/O 錯誤時結束整個量測, 只統計已完成的回合
+        size_t rounds = 0;
+        double start = now_seconds();
+        while (rounds < BENCH_RTT_ROUNDS && r.errors == 0) {
+            double t0 = now_seconds();
+            if (socket_helper_send(fd, message, sizeof(message)) != sizeof(message)) {
+                r.errors++;
+                break;
+            }
+            size_t got = 0;
+            while (got < sizeof(message)) {
+                ssize_t n = socket_helper_recv(fd, message + got, sizeof(message) - got);
+                if (n <= 0) {
+                    r.errors++;
+                    break;
+                }
+                got += (size_t)n;
+            }
+            if (got == sizeof(message)) {
+                samples[rounds++] = (now_seconds() - t0) * 1e6;
+            }
+        }
+        r.seconds = now_seconds() - start;
+        r.ops = rounds;
+
+        qsort(samples, rounds, sizeof(double), compare_double);
+        r.p50_us = percentile(samples, rounds, 0.50);
+        r.p99_us = percentile(samples, rounds, 0.99);
+    } else {
+        r.ops = 0;
+        r.errors++;
+    }
+
+    socket_helper_close(fd);
+    bench_server_join(thread, &server, fd >= 0);
+    socket_helper_close(server.listen_fd);
+    free(samples);
+    if (!tcp) {
+        unlink(BENCH_UNIX_PATH);
+    }
+
+    bench_report(&r);
+}
+
+static void bench_socket_throughput(const char *name, bool tcp) {
+    bench_server_t server = { .echo = false };
+    server.listen_fd = bench_listen(tcp, BENCH_TCP_PORT);
+    if (server.listen_fd < 0) {
+        bench_result_t r = { .name = name, .errors = 1 };
+        bench_report(&r);
+        return;
+    }
+
+    pthread_t thread;
+    pthread_create(&thread, NULL, bench_server_thread, &server);
+
+    int fd = bench_connect(tcp, BENCH_TCP_PORT);
+    bench_result_t r = { .name = name };
+
+    static char chunk[SOCKET_DEFAULT_BUFFER_SIZE];
+    memset(chunk, 'g', sizeof(chunk));
+
+    double start = now_seconds();
+    uint64_t sent = 0;
+    while (fd >= 0 && sent < BENCH_STREAM_BYTES) {
+        ssize_t n = socket_helper_send(fd, chunk, sizeof(chunk));
+        if (n <= 0) {
+            r.errors++;
+            break;
+        }
+        sent += (uint64_t)n;
+        r.ops++;
+    }
+
+    if (fd < 0) {
+        r.errors++;
+    }
+    socket_helper_close(fd);
+    bench_server_join(thread, &server, fd >= 0);
+    r.seconds = now_seconds() - start;
+    r.bytes = server.received;
+
+    socket_helper_close(server.listen_fd);
+    if (!tcp) {
+        unlink(BENCH_UNIX_PATH);
+    }
+
+    bench_report(&r);
+}
+
+static void bench_socket_unix_rtt(void) {
+    bench_socket_rtt("socket.unix.rtt", false);
+}
+
+static void bench_socket_tcp_rtt(void) {
+    bench_socket_rtt("socket.tcp.rtt", true);
+}
+
+static void bench_socket_unix_throughput(void) {
+    bench_socket_throughput("socket.unix.throughput", false);
+}
+
+static void bench_socket_tcp_throughput(void) {
+    bench_socket_throughput("socket.tcp.throughput", true);
+}
+
+// ========================================
+// Relay
+// ========================================
+
+typedef struct {
+    int port;
+    uint64_t bytes;
+} bench_writer_t;
+
+static void *bench_relay_writer(void *arg) {
+    bench_writer_t *writer = arg;
+    int fd = socket_helper_connect_tcp("127.0.0.1", writer->port);
+    if (fd < 0) {
+        return NULL;
+    }
+
+    static char chunk[SOCKET_DEFAULT_BUFFER_SIZE * 16];
+    memset(chunk, 'r', sizeof(chunk));
+
+    while (writer->bytes < BENCH_STREAM_BYTES) {
+        ssize_t n = socket_helper_send(fd, chunk, sizeof(chunk));
+        if (n <= 0) {
+            break;
+        }
+        writer->bytes += (uint64_t)n;
+    }
+
+    socket_helper_close(fd);
+    return NULL;
+}
+
+/**
+ * @brief TCP loopback: writer → relay → reader
+ */
+static void bench_relay_tcp(void) {
+    bench_result_t r = { .name = "relay.tcp.throughput" };
+
+    int front = socket_helper_create_tcp_server(BENCH_TCP_RELAY_PORT, SOCKET_DEFAULT_BACKLOG);
+    bench_server_t reader = { .echo = false };
+    reader.listen_fd = socket_helper_create_tcp_server(BENCH_TCP_PORT, SOCKET_DEFAULT_BACKLOG);
+    if (front < 0 || reader.listen_fd < 0) {
+        r.errors++;
+        socket_helper_close(front);
+        socket_helper_close(reader.listen_fd);
+        bench_report(&r);
+        return;
+    }
+
+    pthread_t reader_thread;
+    pthread_t writer_thread;
+    bench_writer_t writer = { .port = BENCH_TCP_RELAY_PORT };
+    pthread_create(&reader_thread, NULL, bench_server_thread, &reader);
+    pthread_create(&writer_thread, NULL, bench_relay_writer, &writer);
+
+    double start = now_seconds();
+
+    int upstream = accept(front, NULL, NULL);
+    int downstream = socket_helper_connect_tcp("127.0.0.1", BENCH_TCP_PORT);
+    relay_t *relay = relay_create(upstream, downstream);
+    if (relay == NULL) {
+        r.errors++;
+        socket_helper_close(upstream);
+        socket_helper_close(downstream);
+    } else if (relay_run(relay, 5000) != GAMING_OK) {
+        r.errors++;
+    }
+
+    pthread_join(writer_thread, NULL);
+    relay_destroy(relay);
+    bench_server_join(reader_thread, &reader, downstream >= 0);
+    r.seconds = now_seconds() - start;
+    r.bytes = reader.received;
+
+    socket_helper_close(front);
+    socket_helper_close(reader.listen_fd);
+    bench_report(&r);
+}
+
+// ========================================
+// 微量測
+// ========================================
+
+static void bench_buffer_pool(void) {
+    buffer_pool_t *pool = buffer_pool_create(0, 64);
+    bench_result_t r = { .name = "buffer_pool.alloc_free", .ops = BENCH_MICRO_OPS };
+
+    double start = now_seconds();
+    for (int i = 0; i < BENCH_MICRO_OPS; i++) {
+        void *buffer = buffer_pool_alloc(pool);
+        if (buffer_pool_free(pool, buffer) != GAMING_OK) {
+            r.errors++;
+        }
+    }
+    r.seconds = now_seconds() - start;
+
+    buffer_pool_destroy(pool);
+    bench_report(&r);
+}
+
+static void bench_timer_wheel(void) {
+    enum { TIMERS = 4096 };
+    timer_wheel_t *wheel = timer_wheel_create(TIMER_WHEEL_DEFAULT_TICK_MS);
+    timer_wheel_timer_t *timers = calloc(TIMERS, sizeof(*timers));
+    bench_result_t r = { .name = "timer_wheel.add_cancel", .ops = BENCH_MICRO_OPS };
+
+    for (int i = 0; i < TIMERS; i++) {
+        timer_wheel_timer_init(&timers[i], NULL, NULL);
+    }
+
+    double start = now_seconds();
+    for (int i = 0; i < BENCH_MICRO_OPS; i++) {
+        timer_wheel_timer_t *timer = &timers[i % TIMERS];
+        if (timer->active) {
+            timer_wheel_cancel(wheel, timer);
+        } else if (timer_wheel_add(wheel, timer, 1000 + (i % 60000)) != GAMING_OK) {
+            r.errors++;
+        }
+    }
+    r.seconds = now_seconds() - start;
+
+    timer_wheel_destroy(wheel);
+    free(timers);
+    bench_report(&r);
+}
+
+static void bench_protocol(void) {
+    uint8_t frame[GAMING_PROTOCOL_MAX_FRAME_SIZE];
+    gaming_msg_state_change_t msg = { PS5_STATE_OFF, PS5_STATE_ON, DEVICE_TYPE_SERVER, 0, 0 };
+    gaming_msg_state_change_t out;
+    gaming_msg_view_t view;
+    bench_result_t r = { .name = "protocol.encode_parse_decode", .ops = BENCH_MICRO_OPS };
+
+    double start = now_seconds();
+    for (int i = 0; i < BENCH_MICRO_OPS; i++) {
+        msg.timestamp_ms = (uint32_t)i;
+        int len = gaming_msg_encode_state_change(&msg, (uint16_t)i, frame, sizeof(frame));
+        if (len <= 0 || gaming_msg_parse(frame, (size_t)len, &view) != len ||
+            gaming_msg_decode_state_change(&view, &out) != GAMING_OK ||
+            out.timestamp_ms != (uint32_t)i) {
+            r.errors++;
+        }
+    }
+    r.seconds = now_seconds() - start;
+
+    bench_report(&r);
+}
+
+static void bench_metrics(void) {
+    metrics_counter_t *counter = metrics_counter_register("bench.counter");
+    metrics_histogram_t *histogram = metrics_histogram_register("bench.latency_us");
+    bench_result_t r = { .name = "metrics.counter_histogram", .ops = BENCH_MICRO_OPS };
+
+    double start = now_seconds();
+    for (int i = 0; i < BENCH_MICRO_OPS; i++) {
+        metrics_counter_inc(counter);
+        metrics_histogram_observe(histogram, (uint64_t)i & 0xFFF);
+    }
+    r.seconds = now_seconds() - start;
+
+    if (metrics_counter_read(counter) < BENCH_MICRO_OPS) {
+        r.errors++;
+    }
+    bench_report(&r);
+}
+
+static void bench_gpio(void) {
+    gpio_button_t *button = gpio_button_open_simulated(NULL);
+    double *samples = calloc(BENCH_GPIO_EDGES, sizeof(double));
+    bench_result_t r = { .name = "gpio.sim.edge_latency", .ops = BENCH_GPIO_EDGES };
+
+    if (button != NULL && samples != NULL) {
+        struct pollfd pfd = { .fd = gpio_button_get_fd(button), .events = POLLIN };
+        gpio_button_event_t events[GPIO_MAX_EVENTS];
+
+        double start = now_seconds();
+        for (int i = 0; i < BENCH_GPIO_EDGES; i++) {
+            double t0 = now_seconds();
+            gpio_button_simulate(button, (i & 1) == 0);
+            if (poll(&pfd, 1, 1000) != 1 ||
+                gpio_button_process(button, events, ARRAY_SIZE(events)) != 1) {
+                r.errors++;
+            }
+            samples[i] = (now_seconds() - t0) * 1e6;
+        }
+        r.seconds = now_seconds() - start;
+
+        qsort(samples, BENCH_GPIO_EDGES, sizeof(double), compare_double);
+        r.p50_us = percentile(samples, BENCH_GPIO_EDGES, 0.50);
+        r.p99_us = percentile(samples, BENCH_GPIO_EDGES, 0.99);
+    } else {
+        r.errors++;
+    }
+
+    free(samples);
+    gpio_button_close(button);
+    bench_report(&r);
+}
+
+static void bench_trace(void) {
+    bench_result_t r = { .name = "trace.span", .ops = BENCH_MICRO_OPS };
+
+    trace_set_enabled(true);
+    double start = now_seconds();
+    for (int i = 0; i < BENCH_MICRO_OPS; i++) {
+        trace_begin("bench.span");
+        trace_end("bench.span");
+    }
+    r.seconds = now_seconds() - start;
+    trace_set_enabled(false);
+    trace_clear();
+
+    bench_report(&r);
+}
+
+static bool bench_write_uci(void) {
+    FILE *fp = fopen(BENCH_UCI_PATH, "w");
+    if (fp == NULL) {
+        return false;
+    }
+
+    fprintf(fp, "config main 'main'\n\toption enabled '1'\n\toption log_level '1'\n"
+            "\toption device_type 'client'\n");
+    for (int i = 0; i < BENCH_UCI_SECTIONS; i++) {
+        fprintf(fp, "\n# rule %d\nconfig rule 'rule%d'\n\toption name \"Rule %d\"\n"
+                "\toption port '%d'\n\tlist proto tcp\n\tlist proto udp\n",
+                i, i, i, 10000 + i);
+    }
+    return fclose(fp) == 0;
+}
+
+static void bench_uci_native(void) {
+    bench_result_t rp = { .name = "uci_native.parse", .ops = BENCH_UCI_PARSES };
+    bench_result_t rg = { .name = "uci_native.get", .ops = BENCH_MICRO_OPS };
+
+    if (!bench_write_uci()) {
+        rp.errors++;
+        rg.errors++;
+        bench_report(&rp);
+        bench_report(&rg);
+        return;
+    }
+
+    double start = now_seconds();
+    for (int i = 0; i < BENCH_UCI_PARSES; i++) {
+        uci_native_t *uci = uci_native_open(BENCH_UCI_PATH);
+        if (uci == NULL) {
+            rp.errors++;
+        }
+        uci_native_close(uci);
+    }
+    rp.seconds = now_seconds() - start;
+
+    uci_native_t *uci = uci_native_open(BENCH_UCI_PATH);
+    uci_view_t value;
+    start = now_seconds();
+    for (int i = 0; i < BENCH_MICRO_OPS; i++) {
+        if (uci_native_get(uci, UCI_SECTION_MAIN, UCI_OPTION_DEVICE_TYPE, &value) != GAMING_OK) {
+            rg.errors++;
+        }
+    }
+    rg.seconds = now_seconds() - start;
+    uci_native_close(uci);
+    unlink(BENCH_UCI_PATH);
+
+    bench_report(&rp);
+    bench_report(&rg);
+}
+
+static int bench_pool_task(void *arg) {
+    (void)arg;
+    return 0;
+}
+
+static void bench_pool_done(int result, void *arg) {
+    (void)result;
+    (*(int *)arg)++;
+}
+
+static void bench_thread_pool(void) {
+    thread_pool_t *pool = thread_pool_create(4, 0);
+    double *samples = calloc(BENCH_POOL_TASKS, sizeof(double));
+    bench_result_t r = { .name = "thread_pool.submit_complete", .ops = BENCH_POOL_TASKS };
+
+    if (pool != NULL && samples != NULL) {
+        struct pollfd pfd = { .fd = thread_pool_get_fd(pool), .events = POLLIN };
+        int done = 0;
+
+        double start = now_seconds();
+        for (int i = 0; i < BENCH_POOL_TASKS; i++) {
+            double t0 = now_seconds();
+            int expected = done + 1;
+            if (thread_pool_submit(pool, bench_pool_task, bench_pool_done, &done) != GAMING_OK) {
+                r.errors++;
+                continue;
+            }
+            while (done < expected && poll(&pfd, 1, 1000) == 1) {
+                thread_pool_process(pool);
+            }
+            if (done < expected) {
+                r.errors++;
+            }
+            samples[i] = (now_seconds() - t0) * 1e6;
+        }
+        r.seconds = now_seconds() - start;
+
+        qsort(samples, BENCH_POOL_TASKS, sizeof(double), compare_double);
+        r.p50_us = percentile(samples, BENCH_POOL_TASKS, 0.50);
+        r.p99_us = percentile(samples, BENCH_POOL_TASKS, 0.99);
+    } else {
+        r.errors++;
+    }
+
+    free(samples);
+    thread_pool_destroy(pool);
+    bench_report(&r);
+}
+
+static void bench_ps5_state_changed(ps5_state_t old_state, ps5_state_t new_state,
+                                    void *user_data) {
+    (void)old_state;
+    (void)new_state;
+    (*(int *)user_data)++;
+}
+
+static void bench_ps5_state(void) {
+    ps5_state_engine_t *engine = ps5_state_create(NULL);
+    bench_result_t r = { .name = "ps5_state.report_flap", .ops = BENCH_MICRO_OPS };
+    int transitions = 0;
+
+    if (engine != NULL) {
+        ps5_state_subscribe(engine, bench_ps5_state_changed, &transitions);
+        ps5_state_report(engine, PS5_EVIDENCE_CEC, PS5_STATE_ON);
+
+        // 網路證據來回跳動, 權重不足以推翻 CEC, 不應產生任何切換
+        double start = now_seconds();
+        for (int i = 0; i < BENCH_MICRO_OPS; i++) {
+            ps5_state_report(engine, PS5_EVIDENCE_NETWORK,
+                             (i & 1) ? PS5_STATE_ON : PS5_STATE_OFF);
+        }
+        r.seconds = now_seconds() - start;
+
+        if (transitions != 1 || ps5_state_get(engine) != PS5_STATE_ON) {
+            r.errors++;
+        }
+    } else {
+        r.errors++;
+    }
+
+    ps5_state_destroy(engine);
+    bench_report(&r);
+}
+
+// ========================================
+// 主程式
+// ========================================
+
+typedef struct {
+    const char *name;
+    void (*run)(void);
+} bench_case_t;
+
+static const bench_case_t bench_cases[] = {
+    { "logger.filtered",             bench_logger_filtered },
+    { "logger.module_filtered",      bench_logger_module_filtered },
+    { "logger.flight_record",        bench_logger_flight },
+    { "logger.console",              bench_logger_console },
+    { "logger.syslog",               bench_logger_syslog },
+    { "logger.both",                 bench_logger_both },
+    { "config.get",                  bench_config_get },
+    { "uci_native.parse_get",        bench_uci_native },
+    { "socket.unix.rtt",             bench_socket_unix_rtt },
+    { "socket.tcp.rtt",              bench_socket_tcp_rtt },
+    { "socket.unix.throughput",      bench_socket_unix_throughput },
+    { "socket.tcp.throughput",       bench_socket_tcp_throughput },
+    { "relay.tcp.throughput",        bench_relay_tcp },
+    { "buffer_pool.alloc_free",      bench_buffer_pool },
+    { "timer_wheel.add_cancel",      bench_timer_wheel },
+    { "protocol.encode_parse_decode", bench_protocol },
+    { "metrics.counter_histogram",   bench_metrics },
+    { "trace.span",                  bench_trace },
+    { "gpio.sim.edge_latency",       bench_gpio },
+    { "thread_pool.submit_complete", bench_thread_pool },
+    { "ps5_state.report_flap",       bench_ps5_state },
+};
+
+static bool bench_selected(const char *name, int argc, char **argv) {
+    if (argc <= 1) {
+        return true;
+    }
+
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(name, argv[i], strlen(argv[i])) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int main(int argc, char **argv) {
+    for (size_t i = 0; i < ARRAY_SIZE(bench_cases); i++) {
+        if (bench_selected(bench_cases[i].name, argc, argv)) {
+            bench_cases[i].run();
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,196 @@
+/**
+ * @file test_cache_file.c
+ * @brief cache_file 正確性測試
+ * @version 1.0.0
+ *
+ *   - 寫入與檔案目前內容相同時回傳 0 且不改變檔案 (inode 不變)
+ *   - 其他程式以 temp + rename 取代檔案後,下一次讀取需取得新內容
+ *   - device_detect 啟動時已有快取檔案,需直接採用而不讀 ADC
+ *
+ * 檔案建立在暫存目錄中,結束時刪除
+ *
+ * 用法: test_cache_file
+ */
+
+#define _GNU_SOURCE
+
+#include "gaming_common.h"
+#include "cache_file.h"
+#include "device_detect.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <limits.h>
+#include <sys/stat.h>
+
+static int failures;
+static int checks;
+
+#define CHECK(cond, ...) do {                       \
+    checks++;                                       \
+    if (!(cond)) {                                  \
+        failures++;                                 \
+        fprintf(stderr, "FAIL: " __VA_ARGS__);      \
+        fputc('\n', stderr);                        \
+    }                                               \
+} while (0)
+
+static char test_dir[] = "/tmp/test_cache_file.XXXXXX";
+
+// ========================================
+// 輔助函數
+// ========================================
+
+static void test_path(char *buf, size_t size, const char *name) {
+    snprintf(buf, size, "%s/%s", test_dir, name);
+}
+
+static ino_t file_inode(const char *path) {
+    struct stat st;
+    return (stat(path, &st) == 0) ? st.st_ino : 0;
+}
+
+/**
+ * @brief 模擬其他服務: 寫入暫存檔後 rename 取代
+ */
+static bool replace_file(const char *path, const char *content) {
+    char tmp_path[PATH_MAX + 8];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.ext", path);
+
+    FILE *fp = fopen(tmp_path, "w");
+    if (fp == NULL) {
+        return false;
+    }
+    fputs(content, fp);
+    return fclose(fp) == 0 && rename(tmp_path, path) == 0;
+}
+
+// ========================================
+// 測試
+// ========================================
+
+static void test_skip_identical(void) {
+    char path[PATH_MAX];
+    test_path(path, sizeof(path), "identical");
+
+    cache_file_t *cf = cache_file_open(path);
+    CHECK(cf != NULL, "identical: open failed");
+    if (cf == NULL) {
+        return;
+    }
+
+    CHECK(cache_file_write_line(cf, "client") == 1, "identical: first write");
+    ino_t inode = file_inode(path);
+    CHECK(cache_file_write_line(cf, "client") == 0, "identical: second write not skipped");
+    CHECK(file_inode(path) == inode, "identical: file replaced on skipped write");
+
+    // 另一個 handle (其他服務) 寫入相同內容也需略過
+    cache_file_t *other = cache_file_open(path);
+    CHECK(other != NULL && cache_file_write_line(other, "client") == 0,
+          "identical: write from another handle not skipped");
+    CHECK(file_inode(path) == inode, "identical: file replaced by another handle");
+    cache_file_close(other);
+
+    CHECK(cache_file_write_line(cf, "server") == 1, "identical: changed content not written");
+    CHECK(file_inode(path) != inode, "identical: changed content not renamed into place");
+
+    cache_file_close(cf);
+}
+
+static void test_external_replace(void) {
+    char path[PATH_MAX];
+    char line[64];
+    test_path(path, sizeof(path), "external");
+
+    cache_file_t *cf = cache_file_open(path);
+    CHECK(cf != NULL, "external: open failed");
+    if (cf == NULL) {
+        return;
+    }
+
+    CHECK(cache_file_refresh(cf) == GAMING_ERROR_NOT_FOUND && cache_file_data(cf, NULL) == NULL,
+          "external: missing file");
+    CHECK(cache_file_write_line(cf, "192.168.1.10") == 1, "external: write");
+    CHECK(cache_file_refresh(cf) == 0, "external: unchanged file reported as changed");
+
+    CHECK(replace_file(path, "192.168.1.20\n"), "external: replace failed");
+    CHECK(cache_file_refresh(cf) == 1, "external: rename-over not detected");
+    CHECK(cache_file_read_line(cf, line, sizeof(line)) == GAMING_OK &&
+          strcmp(line, "192.168.1.20") == 0, "external: read '%s'", line);
+    CHECK(cache_file_refresh(cf) == 0, "external: second refresh reported a change");
+
+    // 其他服務以相同內容改寫: 重新讀取但內容未變
+    CHECK(replace_file(path, "192.168.1.20\n"), "external: replace failed");
+    CHECK(cache_file_refresh(cf) == 0, "external: identical rewrite reported as changed");
+
+    // 被刪除後讀取失敗, 記憶體中的內容也失效
+    unlink(path);
+    CHECK(cache_file_read_line(cf, line, sizeof(line)) == GAMING_ERROR_NOT_FOUND &&
+          cache_file_data(cf, NULL) == NULL, "external: removed file still readable");
+
+    cache_file_close(cf);
+}
+
+static int adc_reads;
+
+static int adc_read_client(void *ctx, int *value) {
+    (void)ctx;
+    adc_reads++;
+    *value = 100;
+    return GAMING_OK;
+}
+
+static void test_device_detect_cache(void) {
+    char path[PATH_MAX];
+    test_path(path, sizeof(path), "device_type");
+
+    CHECK(replace_file(path, "server\n"), "device_detect: write cache failed");
+
+    device_detect_adc_t adc = { .read = adc_read_client, .ctx = NULL };
+    device_detect_config_t config = { .adc = &adc, .cache_path = path };
+    adc_reads = 0;
+    CHECK(device_detect_init(&config) == GAMING_OK, "device_detect: init failed");
+    CHECK(device_detect_get() == DEVICE_TYPE_SERVER, "device_detect: cache not used (got %d)",
+          device_detect_get());
+    CHECK(adc_reads == 0, "device_detect: ADC read %d times with a valid cache", adc_reads);
+    device_detect_cleanup();
+
+    // 快取內容無效時讀 ADC 並改寫快取
+    CHECK(replace_file(path, "garbage\n"), "device_detect: write cache failed");
+    CHECK(device_detect_init(&config) == GAMING_OK, "device_detect: init failed");
+    CHECK(adc_reads > 0 && device_detect_get() == DEVICE_TYPE_CLIENT,
+          "device_detect: invalid cache not replaced by ADC result");
+    device_detect_cleanup();
+
+    cache_file_t *cf = cache_file_open(path);
+    char line[32];
+    CHECK(cf != NULL && cache_file_read_line(cf, line, sizeof(line)) == GAMING_OK &&
+          strcmp(line, "client") == 0, "device_detect: cache file not rewritten");
+    cache_file_close(cf);
+}
+
+int main(void) {
+    if (mkdtemp(test_dir) == NULL) {
+        perror("mkdtemp");
+        return 1;
+    }
+
+    test_skip_identical();
+    test_external_replace();
+    test_device_detect_cache();
+
+    static const char *const files[] = { "identical", "external", "device_type" };
+    for (size_t i = 0; i < sizeof(files) / sizeof(files[0]); i++) {
+        char path[PATH_MAX];
+        test_path(path, sizeof(path), files[i]);
+        unlink(path);
+    }
+    if (rmdir(test_dir) < 0) {
+        perror(test_dir);
+    }
+
+    printf("test_cache_file: %d checks, %d failures\n", checks, failures);
+    return (failures == 0) ? 0 : 1;
+}
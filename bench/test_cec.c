@@ -0,0 +1,197 @@
+/**
+ * @file test_cec.c
+ * @brief cec_monitor 正確性測試 (重播檔案)
+ * @version 1.0.0
+ *
+ *   - cec_monitor_decode 對 REPORT_POWER_STATUS / ACTIVE_SOURCE / STANDBY 的判斷,
+ *     以及其他裝置的 frame 需被忽略
+ *   - 以 cec_monitor_open_replay 重播 frame,回呼收到的狀態變化需依序為
+ *     ON / STANDBY / OFF,詢問電源狀態被 NACK 時轉為 OFF
+ *
+ * 用法: test_cec [重播檔案]   (預設 corpus/cec/ps5_power.replay)
+ */
+
+#define _GNU_SOURCE
+
+#include "gaming_common.h"
+#include "cec_monitor.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <poll.h>
+
+#define TEST_DEFAULT_REPLAY  "corpus/cec/ps5_power.replay"
+#define TEST_MAX_CHANGES     32
+
+static int failures;
+static int checks;
+
+#define CHECK(cond, ...) do {                       \
+    checks++;                                       \
+    if (!(cond)) {                                  \
+        failures++;                                 \
+        fprintf(stderr, "FAIL: " __VA_ARGS__);      \
+        fputc('\n', stderr);                        \
+    }                                               \
+} while (0)
+
+// ========================================
+// 輔助函數
+// ========================================
+
+typedef struct {
+    ps5_state_t old_state;
+    ps5_state_t new_state;
+} state_change_t;
+
+typedef struct {
+    state_change_t changes[TEST_MAX_CHANGES];
+    int count;
+} change_log_t;
+
+static void record_change(ps5_state_t old_state, ps5_state_t new_state, void *user_data) {
+    change_log_t *log = user_data;
+    if (log->count < TEST_MAX_CHANGES) {
+        log->changes[log->count].old_state = old_state;
+        log->changes[log->count].new_state = new_state;
+    }
+    log->count++;
+}
+
+static bool fd_readable(int fd) {
+    struct pollfd pfd = { .fd = fd, .events = POLLIN };
+    return poll(&pfd, 1, 0) == 1;
+}
+
+// ========================================
+// 測試
+// ========================================
+
+static void check_decode(const uint8_t *frame, size_t len, bool expect_match,
+                         ps5_state_t expect_state, const char *what) {
+    ps5_state_t state = PS5_STATE_UNKNOWN;
+    bool match = cec_monitor_decode(frame, len, CEC_PS5_DEFAULT_ADDR, &state);
+    CHECK(match == expect_match, "decode %s: match %d, expected %d", what, match, expect_match);
+    if (match && expect_match) {
+        CHECK(state == expect_state, "decode %s: state %d, expected %d", what, state, expect_state);
+    }
+}
+
+static void test_decode(void) {
+    static const uint8_t power_on[] = { 0x40, 0x90, 0x00 };
+    static const uint8_t power_standby[] = { 0x40, 0x90, 0x01 };
+    static const uint8_t power_to_on[] = { 0x40, 0x90, 0x02 };
+    static const uint8_t power_to_standby[] = { 0x40, 0x90, 0x03 };
+    static const uint8_t power_unknown[] = { 0x40, 0x90, 0x07 };
+    static const uint8_t power_short[] = { 0x40, 0x90 };
+    static const uint8_t power_other[] = { 0x50, 0x90, 0x00 };
+    static const uint8_t active_source[] = { 0x4f, 0x82, 0x10, 0x00 };
+    static const uint8_t active_other[] = { 0x5f, 0x82, 0x20, 0x00 };
+    static const uint8_t standby_from_ps5[] = { 0x4f, 0x36 };
+    static const uint8_t standby_broadcast[] = { 0x0f, 0x36 };
+    static const uint8_t standby_to_ps5[] = { 0x04, 0x36 };
+    static const uint8_t standby_other[] = { 0x05, 0x36 };
+    static const uint8_t give_power[] = { 0x04, 0x8f };
+
+    check_decode(power_on, sizeof(power_on), true, PS5_STATE_ON, "power on");
+    check_decode(power_standby, sizeof(power_standby), true, PS5_STATE_STANDBY, "power standby");
+    check_decode(power_to_on, sizeof(power_to_on), true, PS5_STATE_ON, "power to-on");
+    check_decode(power_to_standby, sizeof(power_to_standby), true, PS5_STATE_STANDBY,
+                 "power to-standby");
+    check_decode(power_unknown, sizeof(power_unknown), false, PS5_STATE_UNKNOWN, "power unknown");
+    check_decode(power_short, sizeof(power_short), false, PS5_STATE_UNKNOWN, "power short");
+    check_decode(power_other, sizeof(power_other), false, PS5_STATE_UNKNOWN, "power other");
+    check_decode(active_source, sizeof(active_source), true, PS5_STATE_ON, "active source");
+    check_decode(active_other, sizeof(active_other), false, PS5_STATE_UNKNOWN, "active other");
+    check_decode(standby_from_ps5, sizeof(standby_from_ps5), true, PS5_STATE_STANDBY,
+                 "standby from ps5");
+    check_decode(standby_broadcast, sizeof(standby_broadcast), true, PS5_STATE_STANDBY,
+                 "standby broadcast");
+    check_decode(standby_to_ps5, sizeof(standby_to_ps5), true, PS5_STATE_STANDBY, "standby to ps5");
+    check_decode(standby_other, sizeof(standby_other), false, PS5_STATE_UNKNOWN, "standby other");
+    check_decode(give_power, sizeof(give_power), false, PS5_STATE_UNKNOWN, "give power status");
+    check_decode(give_power, 1, false, PS5_STATE_UNKNOWN, "header only");
+}
+
+static void test_replay(const char *path) {
+    static const state_change_t expected[] = {
+        { PS5_STATE_UNKNOWN, PS5_STATE_ON },
+        { PS5_STATE_ON, PS5_STATE_STANDBY },
+        { PS5_STATE_STANDBY, PS5_STATE_ON },
+        { PS5_STATE_ON, PS5_STATE_STANDBY },
+        { PS5_STATE_STANDBY, PS5_STATE_OFF },      // NACK
+        { PS5_STATE_OFF, PS5_STATE_ON },
+        { PS5_STATE_ON, PS5_STATE_OFF },           // NACK
+    };
+    const int expected_count = (int)(sizeof(expected) / sizeof(expected[0]));
+
+    cec_monitor_t *monitor = cec_monitor_open_replay(path);
+    CHECK(monitor != NULL, "%s: open_replay failed", path);
+    if (monitor == NULL) {
+        return;
+    }
+
+    change_log_t log = { .count = 0 };
+    cec_monitor_set_callback(monitor, record_change, &log);
+    CHECK(cec_monitor_get_state(monitor) == PS5_STATE_UNKNOWN, "replay: initial state");
+
+    int fd = cec_monitor_get_fd(monitor);
+    CHECK(fd >= 0 && fd_readable(fd), "replay: event fd not readable before process");
+    CHECK(cec_monitor_process(monitor) == GAMING_OK, "replay: process failed");
+    CHECK(!fd_readable(fd), "replay: event fd still readable after process");
+
+    CHECK(log.count == expected_count, "replay: %d state changes, expected %d",
+          log.count, expected_count);
+    for (int i = 0; i < expected_count && i < log.count && i < TEST_MAX_CHANGES; i++) {
+        CHECK(log.changes[i].old_state == expected[i].old_state &&
+              log.changes[i].new_state == expected[i].new_state,
+              "replay: change %d is %d -> %d, expected %d -> %d", i,
+              log.changes[i].old_state, log.changes[i].new_state,
+              expected[i].old_state, expected[i].new_state);
+    }
+    CHECK(cec_monitor_get_state(monitor) == PS5_STATE_OFF, "replay: final state %d",
+          cec_monitor_get_state(monitor));
+
+    // 重播結束後再處理不會有新的變化; 傳送指令在重播模式一律成功
+    CHECK(cec_monitor_process(monitor) == GAMING_OK && log.count == expected_count,
+          "replay: process after end");
+    CHECK(cec_monitor_request_power_status(monitor) == GAMING_OK &&
+          cec_monitor_wake(monitor) == GAMING_OK &&
+          cec_monitor_standby(monitor) == GAMING_OK, "replay: transmit failed");
+
+    cec_monitor_close(monitor);
+}
+
+static void test_replay_other_addr(const char *path) {
+    // PS5 位址改為 5 時, 只有位址 5 的 frame 與 NACK 會影響狀態
+    cec_monitor_t *monitor = cec_monitor_open_replay(path);
+    CHECK(monitor != NULL, "%s: open_replay failed", path);
+    if (monitor == NULL) {
+        return;
+    }
+
+    change_log_t log = { .count = 0 };
+    cec_monitor_set_callback(monitor, record_change, &log);
+    cec_monitor_set_ps5_addr(monitor, 5);
+    CHECK(cec_monitor_process(monitor) == GAMING_OK, "other addr: process failed");
+
+    // 廣播 standby -> STANDBY, "50:90:01" (不變), "05:36" (不變), "!05:8f" -> OFF
+    CHECK(log.count == 2 && log.changes[0].new_state == PS5_STATE_STANDBY &&
+          log.changes[1].new_state == PS5_STATE_OFF,
+          "other addr: %d state changes", log.count);
+
+    cec_monitor_close(monitor);
+}
+
+int main(int argc, char *argv[]) {
+    const char *path = (argc > 1) ? argv[1] : TEST_DEFAULT_REPLAY;
+
+    test_decode();
+    test_replay(path);
+    test_replay_other_addr(path);
+    CHECK(cec_monitor_open_replay("/nonexistent/replay") == NULL, "missing replay file accepted");
+
+    printf("test_cec: %d checks, %d failures\n", checks, failures);
+    return (failures == 0) ? 0 : 1;
+}
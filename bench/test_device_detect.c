@@ -0,0 +1,247 @@
+/**
+ * @file test_device_detect.c
+ * @brief device_detect 正確性測試 (模擬 ADC)
+ * @version 1.0.0
+ *
+ *   - 取 N 個樣本的中位數,離群值不影響結果;樣本數上限為 DEVICE_DETECT_MAX_SAMPLES
+ *   - device_detect_refresh 的讀值落在遲滯區間內時維持目前結果
+ *   - 快取檔案有效時 device_detect_init 不讀 ADC
+ *   - ADC 讀取失敗與尚未初始化的錯誤碼
+ *
+ * 快取檔案建立在暫存目錄中,結束時刪除
+ *
+ * 用法: test_device_detect
+ */
+
+#define _GNU_SOURCE
+
+#include "gaming_common.h"
+#include "cache_file.h"
+#include "device_detect.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <limits.h>
+
+#define TEST_MAX_READS  32
+
+static int failures;
+static int checks;
+
+#define CHECK(cond, ...) do {                       \
+    checks++;                                       \
+    if (!(cond)) {                                  \
+        failures++;                                 \
+        fprintf(stderr, "FAIL: " __VA_ARGS__);      \
+        fputc('\n', stderr);                        \
+    }                                               \
+} while (0)
+
+static char test_dir[] = "/tmp/test_device_detect.XXXXXX";
+static char cache_path[PATH_MAX];
+
+// ========================================
+// 模擬 ADC
+// ========================================
+
+/**
+ * @brief 依序回傳 values, 用完後重複最後一個值
+ */
+typedef struct {
+    int values[TEST_MAX_READS];
+    int count;
+    int reads;
+    bool fail;
+} fake_adc_t;
+
+static int fake_adc_read(void *ctx, int *value) {
+    fake_adc_t *adc = ctx;
+    if (adc->fail) {
+        return GAMING_ERROR_HAL_FAILED;
+    }
+
+    int index = (adc->reads < adc->count) ? adc->reads : adc->count - 1;
+    adc->reads++;
+    *value = adc->values[index];
+    return GAMING_OK;
+}
+
+static void fake_adc_set(fake_adc_t *adc, const int *values, int count) {
+    memcpy(adc->values, values, sizeof(int) * (size_t)count);
+    adc->count = count;
+    adc->reads = 0;
+    adc->fail = false;
+}
+
+static void fake_adc_constant(fake_adc_t *adc, int value) {
+    fake_adc_set(adc, &value, 1);
+}
+
+static int init_with(fake_adc_t *fake, int samples) {
+    device_detect_adc_t adc = { .read = fake_adc_read, .ctx = fake };
+    device_detect_config_t config = { .adc = &adc, .cache_path = cache_path, .samples = samples };
+    return device_detect_init(&config);
+}
+
+static device_type_t cached_type(void) {
+    char line[32] = "";
+    cache_file_t *cf = cache_file_open(cache_path);
+    int ret = (cf != NULL) ? cache_file_read_line(cf, line, sizeof(line)) : GAMING_ERROR;
+    cache_file_close(cf);
+    if (ret != GAMING_OK) {
+        return DEVICE_TYPE_UNKNOWN;
+    }
+    return (strcmp(line, "server") == 0) ? DEVICE_TYPE_SERVER
+         : (strcmp(line, "client") == 0) ? DEVICE_TYPE_CLIENT : DEVICE_TYPE_UNKNOWN;
+}
+
+// ========================================
+// 測試
+// ========================================
+
+static void test_median(void) {
+    fake_adc_t fake;
+
+    // 三個低的離群值, 中位數 900 -> server
+    static const int spikes_low[] = { 900, 100, 950, 20, 980, 930, 10 };
+    fake_adc_set(&fake, spikes_low, 7);
+    unlink(cache_path);
+    CHECK(init_with(&fake, 7) == GAMING_OK, "median: init failed");
+    CHECK(fake.reads == 7, "median: %d reads, expected 7", fake.reads);
+    CHECK(device_detect_get() == DEVICE_TYPE_SERVER, "median: low spikes changed the result");
+    CHECK(cached_type() == DEVICE_TYPE_SERVER, "median: cache not written");
+    device_detect_cleanup();
+
+    // 三個滿刻度的離群值, 中位數 105 -> client
+    static const int spikes_high[] = { 100, 1023, 1023, 1023, 110, 90, 105 };
+    fake_adc_set(&fake, spikes_high, 7);
+    unlink(cache_path);
+    CHECK(init_with(&fake, 7) == GAMING_OK, "median: init failed");
+    CHECK(device_detect_get() == DEVICE_TYPE_CLIENT, "median: high spikes changed the result");
+    device_detect_cleanup();
+
+    // 樣本數設定與上限
+    fake_adc_constant(&fake, 100);
+    unlink(cache_path);
+    init_with(&fake, 3);
+    CHECK(fake.reads == 3, "median: %d reads with samples = 3", fake.reads);
+    device_detect_cleanup();
+
+    fake_adc_constant(&fake, 100);
+    unlink(cache_path);
+    init_with(&fake, 100);
+    CHECK(fake.reads == DEVICE_DETECT_MAX_SAMPLES, "median: %d reads with samples = 100",
+          fake.reads);
+    device_detect_cleanup();
+}
+
+static void test_classify(void) {
+    const int h = DEVICE_DETECT_DEFAULT_HYSTERESIS;
+    const int t = ADC_THRESHOLD_CLIENT_SERVER;
+
+    CHECK(device_detect_classify(t + h, DEVICE_TYPE_CLIENT, h) == DEVICE_TYPE_SERVER,
+          "classify: upper edge");
+    CHECK(device_detect_classify(t + h - 1, DEVICE_TYPE_CLIENT, h) == DEVICE_TYPE_CLIENT,
+          "classify: inside band keeps client");
+    CHECK(device_detect_classify(t - h, DEVICE_TYPE_SERVER, h) == DEVICE_TYPE_SERVER,
+          "classify: inside band keeps server");
+    CHECK(device_detect_classify(t - h - 1, DEVICE_TYPE_SERVER, h) == DEVICE_TYPE_CLIENT,
+          "classify: lower edge");
+    CHECK(device_detect_classify(t, DEVICE_TYPE_UNKNOWN, h) == DEVICE_TYPE_SERVER &&
+          device_detect_classify(t - 1, DEVICE_TYPE_UNKNOWN, h) == DEVICE_TYPE_CLIENT,
+          "classify: unknown previous uses the threshold");
+}
+
+static void test_refresh_hysteresis(void) {
+    const int t = ADC_THRESHOLD_CLIENT_SERVER;
+    fake_adc_t fake;
+    device_type_t type;
+
+    CHECK(device_detect_refresh(&type) == GAMING_ERROR_NOT_INITIALIZED,
+          "refresh: accepted before init");
+
+    fake_adc_constant(&fake, t + 100);
+    unlink(cache_path);
+    CHECK(init_with(&fake, 3) == GAMING_OK && device_detect_get() == DEVICE_TYPE_SERVER,
+          "refresh: initial detection");
+
+    static const struct {
+        int value;
+        device_type_t expected;
+    } steps[] = {
+        { ADC_THRESHOLD_CLIENT_SERVER - 10, DEVICE_TYPE_SERVER },   // 區間內, 維持
+        { ADC_THRESHOLD_CLIENT_SERVER - DEVICE_DETECT_DEFAULT_HYSTERESIS, DEVICE_TYPE_SERVER },
+        { ADC_THRESHOLD_CLIENT_SERVER - DEVICE_DETECT_DEFAULT_HYSTERESIS - 1, DEVICE_TYPE_CLIENT },
+        { ADC_THRESHOLD_CLIENT_SERVER + 10, DEVICE_TYPE_CLIENT },   // 區間內, 維持
+        { ADC_THRESHOLD_CLIENT_SERVER + DEVICE_DETECT_DEFAULT_HYSTERESIS - 1, DEVICE_TYPE_CLIENT },
+        { ADC_THRESHOLD_CLIENT_SERVER + DEVICE_DETECT_DEFAULT_HYSTERESIS, DEVICE_TYPE_SERVER },
+    };
+
+    for (size_t i = 0; i < sizeof(steps) / sizeof(steps[0]); i++) {
+        fake_adc_constant(&fake, steps[i].value);
+        type = DEVICE_TYPE_UNKNOWN;
+        CHECK(device_detect_refresh(&type) == GAMING_OK, "refresh %zu: failed", i);
+        CHECK(type == steps[i].expected && device_detect_get() == steps[i].expected,
+              "refresh %zu: value %d gave %d, expected %d", i, steps[i].value, type,
+              steps[i].expected);
+        CHECK(cached_type() == steps[i].expected, "refresh %zu: cache holds %d", i, cached_type());
+    }
+
+    // ADC 失敗時維持目前結果
+    fake.fail = true;
+    CHECK(device_detect_refresh(&type) == GAMING_ERROR_HAL_FAILED, "refresh: ADC failure");
+    CHECK(device_detect_get() == DEVICE_TYPE_SERVER, "refresh: result lost on ADC failure");
+    device_detect_cleanup();
+}
+
+static void test_cache_fast_path(void) {
+    fake_adc_t fake;
+
+    // 第一個服務讀 ADC 並寫入快取
+    fake_adc_constant(&fake, 100);
+    unlink(cache_path);
+    CHECK(init_with(&fake, 5) == GAMING_OK && fake.reads == 5, "cache: first init");
+    device_detect_cleanup();
+
+    // 之後的服務直接採用快取, ADC 讀值不同也不影響
+    fake_adc_constant(&fake, 1000);
+    CHECK(init_with(&fake, 5) == GAMING_OK, "cache: second init failed");
+    CHECK(fake.reads == 0, "cache: ADC read %d times with a valid cache", fake.reads);
+    CHECK(device_detect_get() == DEVICE_TYPE_CLIENT, "cache: cached type not used");
+
+    // refresh 一定會讀 ADC
+    device_type_t type;
+    CHECK(device_detect_refresh(&type) == GAMING_OK && fake.reads == 5 &&
+          type == DEVICE_TYPE_SERVER, "cache: refresh did not sample the ADC");
+    device_detect_cleanup();
+
+    // 沒有快取且 ADC 失敗
+    fake.fail = true;
+    unlink(cache_path);
+    CHECK(init_with(&fake, 5) == GAMING_ERROR_HAL_FAILED, "cache: ADC failure not reported");
+    CHECK(device_detect_get() == DEVICE_TYPE_UNKNOWN, "cache: type set after ADC failure");
+    device_detect_cleanup();
+}
+
+int main(void) {
+    if (mkdtemp(test_dir) == NULL) {
+        perror("mkdtemp");
+        return 1;
+    }
+    snprintf(cache_path, sizeof(cache_path), "%s/device_type", test_dir);
+
+    test_median();
+    test_classify();
+    test_refresh_hysteresis();
+    test_cache_fast_path();
+
+    unlink(cache_path);
+    if (rmdir(test_dir) < 0) {
+        perror(test_dir);
+    }
+
+    printf("test_device_detect: %d checks, %d failures\n", checks, failures);
+    return (failures == 0) ? 0 : 1;
+}
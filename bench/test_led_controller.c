@@ -0,0 +1,264 @@
+/**
+ * @file test_led_controller.c
+ * @brief led_controller 正確性測試 (fake_sysfs)
+ * @version 1.0.0
+ *
+ *   - 寫入 duty_cycle 的值為 gamma 查表結果,period / enable 正確設定
+ *   - 重複設定相同的 solid 顏色不寫入 sysfs (led.writes.skipped 增加)
+ *   - blink 只在亮暗切換時重新設定計時器,不以動畫更新間隔醒來
+ *   - fade 結束後停在目標顏色並停止計時器
+ *
+ * sysfs 以暫存目錄模擬,結束時刪除
+ *
+ * 用法: test_led_controller
+ */
+
+#define _GNU_SOURCE
+
+#include "gaming_common.h"
+#include "led_controller.h"
+#include "metrics.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <limits.h>
+#include <poll.h>
+#include <time.h>
+#include <sys/timerfd.h>
+
+#define TEST_PERIOD_NS   1000000
+#define TEST_FRAME_MS    10
+#define TEST_BLINK_MS    200
+#define TEST_FADE_MS     100
+
+static int failures;
+static int checks;
+
+#define CHECK(cond, ...) do {                       \
+    checks++;                                       \
+    if (!(cond)) {                                  \
+        failures++;                                 \
+        fprintf(stderr, "FAIL: " __VA_ARGS__);      \
+        fputc('\n', stderr);                        \
+    }                                               \
+} while (0)
+
+static char test_dir[] = "/tmp/test_led_controller.XXXXXX";
+static const char *const attrs[] = { "duty_cycle", "period", "enable" };
+
+// ========================================
+// 輔助函數
+// ========================================
+
+static long read_attr(int channel, const char *name) {
+    char path[PATH_MAX];
+    snprintf(path, sizeof(path), "%s/pwm%d/%s", test_dir, channel, name);
+
+    FILE *fp = fopen(path, "r");
+    if (fp == NULL) {
+        return -1;
+    }
+    long value = -1;
+    if (fscanf(fp, "%ld", &value) != 1) {
+        value = -1;
+    }
+    fclose(fp);
+    return value;
+}
+
+static uint64_t now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000ULL + (uint64_t)ts.tv_nsec / 1000000ULL;
+}
+
+/**
+ * @brief 計時器剩餘時間 (ms), 0 表示未啟動
+ */
+static long timer_remaining_ms(const led_controller_t *led) {
+    struct itimerspec its;
+    if (timerfd_gettime(led_controller_get_fd(led), &its) < 0) {
+        return -1;
+    }
+    CHECK(its.it_interval.tv_sec == 0 && its.it_interval.tv_nsec == 0, "timer is periodic");
+    return its.it_value.tv_sec * 1000L + (its.it_value.tv_nsec + 999999L) / 1000000L;
+}
+
+/**
+ * @brief 等待計時器到期並處理一次
+ *
+ * @return true 有到期, false 逾時
+ */
+static bool wait_and_process(led_controller_t *led, int timeout_ms) {
+    struct pollfd pfd = { .fd = led_controller_get_fd(led), .events = POLLIN };
+    if (poll(&pfd, 1, timeout_ms) != 1) {
+        return false;
+    }
+    CHECK(led_controller_process(led) == GAMING_OK, "process failed");
+    return true;
+}
+
+static bool same_color(led_color_t a, led_color_t b) {
+    return a.r == b.r && a.g == b.g && a.b == b.b;
+}
+
+static led_controller_t *create_led(void) {
+    led_controller_config_t config;
+    led_controller_default_config(&config);
+    config.sysfs_root = test_dir;
+    config.period_ns = TEST_PERIOD_NS;
+    config.frame_ms = TEST_FRAME_MS;
+    config.fake_sysfs = true;
+    return led_controller_create(&config);
+}
+
+// ========================================
+// 測試
+// ========================================
+
+static void test_gamma_duty(led_controller_t *led) {
+    CHECK(led_controller_duty(0, TEST_PERIOD_NS) == 0 &&
+          led_controller_duty(255, TEST_PERIOD_NS) == TEST_PERIOD_NS, "duty: end points");
+    uint32_t previous = 0;
+    bool monotonic = true;
+    for (int level = 1; level < 256; level++) {
+        uint32_t duty = led_controller_duty((uint8_t)level, TEST_PERIOD_NS);
+        monotonic = monotonic && duty >= previous;
+        previous = duty;
+    }
+    CHECK(monotonic, "duty: table not monotonic");
+    // gamma 2.2: 一半亮度約為 21.8% duty
+    uint32_t half = led_controller_duty(128, TEST_PERIOD_NS);
+    CHECK(half > TEST_PERIOD_NS / 5 && half < TEST_PERIOD_NS / 4, "duty: 128 -> %u", half);
+
+    for (int i = 0; i < LED_CHANNEL_COUNT; i++) {
+        CHECK(read_attr(i, "period") == TEST_PERIOD_NS && read_attr(i, "enable") == 1 &&
+              read_attr(i, "duty_cycle") == 0, "create: pwm%d attributes", i);
+    }
+
+    led_color_t color = { 255, 128, 0 };
+    CHECK(led_controller_set(led, color, LED_EFFECT_SOLID, 0) == GAMING_OK, "solid: set failed");
+    CHECK(read_attr(0, "duty_cycle") == (long)led_controller_duty(255, TEST_PERIOD_NS) &&
+          read_attr(1, "duty_cycle") == (long)led_controller_duty(128, TEST_PERIOD_NS) &&
+          read_attr(2, "duty_cycle") == 0,
+          "solid: duty %ld / %ld / %ld", read_attr(0, "duty_cycle"),
+          read_attr(1, "duty_cycle"), read_attr(2, "duty_cycle"));
+    CHECK(timer_remaining_ms(led) == 0, "solid: timer armed");
+}
+
+static void test_solid_skip(led_controller_t *led) {
+    metrics_counter_t *writes = metrics_counter_register("led.writes");
+    metrics_counter_t *skipped = metrics_counter_register("led.writes.skipped");
+
+    led_color_t color = { 10, 20, 30 };
+    CHECK(led_controller_set(led, color, LED_EFFECT_SOLID, 0) == GAMING_OK, "skip: set failed");
+    uint64_t writes_before = metrics_counter_read(writes);
+    uint64_t skipped_before = metrics_counter_read(skipped);
+
+    CHECK(led_controller_set(led, color, LED_EFFECT_SOLID, 0) == GAMING_OK, "skip: set failed");
+    CHECK(metrics_counter_read(writes) == writes_before, "skip: repeated color written");
+    CHECK(metrics_counter_read(skipped) == skipped_before + LED_CHANNEL_COUNT,
+          "skip: skipped %llu, expected %d",
+          (unsigned long long)(metrics_counter_read(skipped) - skipped_before), LED_CHANNEL_COUNT);
+
+    // 只改一個通道時只寫一次
+    color.b = 40;
+    CHECK(led_controller_set(led, color, LED_EFFECT_SOLID, 0) == GAMING_OK, "skip: set failed");
+    CHECK(metrics_counter_read(writes) == writes_before + 1, "skip: unchanged channels written");
+}
+
+static void test_blink(led_controller_t *led) {
+    const uint32_t half = TEST_BLINK_MS / 2;
+
+    CHECK(led_controller_set(led, LED_COLOR_GREEN, LED_EFFECT_BLINK, TEST_BLINK_MS) == GAMING_OK,
+          "blink: set failed");
+    long remaining = timer_remaining_ms(led);
+    CHECK(remaining > TEST_FRAME_MS && remaining <= (long)half,
+          "blink: timer armed for %ld ms, expected ~%u", remaining, half);
+
+    led_color_t color;
+    led_controller_get_color(led, &color);
+    CHECK(same_color(color, LED_COLOR_GREEN), "blink: not on at start");
+
+    // 2.5 個週期: 醒來次數應為切換次數 (5), 而非 frame 數 (50)
+    int wakeups = 0;
+    bool alternates = true;
+    uint64_t deadline = now_ms() + TEST_BLINK_MS * 5 / 2;
+    for (uint64_t now = now_ms(); now < deadline; now = now_ms()) {
+        if (!wait_and_process(led, (int)(deadline - now))) {
+            break;
+        }
+        wakeups++;
+        led_color_t next;
+        led_controller_get_color(led, &next);
+        alternates = alternates && !same_color(next, color);
+        color = next;
+    }
+    CHECK(wakeups >= 4 && wakeups <= 6, "blink: %d wakeups in 2.5 periods", wakeups);
+    CHECK(alternates, "blink: woke up without an on/off transition");
+}
+
+static void test_fade(led_controller_t *led) {
+    CHECK(led_controller_set(led, LED_COLOR_BLACK, LED_EFFECT_SOLID, 0) == GAMING_OK,
+          "fade: reset failed");
+    CHECK(led_controller_set(led, LED_COLOR_WHITE, LED_EFFECT_FADE, TEST_FADE_MS) == GAMING_OK,
+          "fade: set failed");
+    CHECK(timer_remaining_ms(led) > 0, "fade: timer not armed");
+
+    int wakeups = 0;
+    while (timer_remaining_ms(led) > 0 && wakeups < 100 && wait_and_process(led, 1000)) {
+        wakeups++;
+    }
+    CHECK(wakeups >= TEST_FADE_MS / TEST_FRAME_MS / 2 && wakeups <= TEST_FADE_MS / TEST_FRAME_MS + 2,
+          "fade: %d frames for %d ms at %d ms/frame", wakeups, TEST_FADE_MS, TEST_FRAME_MS);
+
+    led_color_t color;
+    led_controller_get_color(led, &color);
+    CHECK(same_color(color, LED_COLOR_WHITE), "fade: ended at %u/%u/%u", color.r, color.g, color.b);
+    for (int i = 0; i < LED_CHANNEL_COUNT; i++) {
+        CHECK(read_attr(i, "duty_cycle") == TEST_PERIOD_NS, "fade: pwm%d duty %ld", i,
+              read_attr(i, "duty_cycle"));
+    }
+
+    // 停在 solid: 計時器不再啟動
+    CHECK(led_controller_process(led) == GAMING_OK && timer_remaining_ms(led) == 0,
+          "fade: timer re-armed after the fade ended");
+}
+
+int main(void) {
+    if (mkdtemp(test_dir) == NULL) {
+        perror("mkdtemp");
+        return 1;
+    }
+
+    led_controller_t *led = create_led();
+    CHECK(led != NULL, "create failed");
+    if (led != NULL) {
+        test_gamma_duty(led);
+        test_solid_skip(led);
+        test_blink(led);
+        test_fade(led);
+
+        led_controller_destroy(led);
+        CHECK(read_attr(0, "duty_cycle") == 0 && read_attr(1, "duty_cycle") == 0 &&
+              read_attr(2, "duty_cycle") == 0, "destroy: LED not turned off");
+    }
+
+    for (int i = 0; i < LED_CHANNEL_COUNT; i++) {
+        char path[PATH_MAX];
+        for (size_t j = 0; j < sizeof(attrs) / sizeof(attrs[0]); j++) {
+            snprintf(path, sizeof(path), "%s/pwm%d/%s", test_dir, i, attrs[j]);
+            unlink(path);
+        }
+        snprintf(path, sizeof(path), "%s/pwm%d", test_dir, i);
+        rmdir(path);
+    }
+    if (rmdir(test_dir) < 0) {
+        perror(test_dir);
+    }
+
+    printf("test_led_controller: %d checks, %d failures\n", checks, failures);
+    return (failures == 0) ? 0 : 1;
+}
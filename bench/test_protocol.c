@@ -0,0 +1,232 @@
+/**
+ * @file test_protocol.c
+ * @brief gaming_protocol 正確性測試
+ * @version 1.0.0
+ *
+ *   - 每個訊息 (由 GAMING_PROTOCOL_MESSAGES 表展開) 以亂數欄位 encode 後 parse / decode,
+ *     結果需與原值相同;所有截斷長度需回傳 0 (資料不足)
+ *   - 多個訊息串接後逐位元組餵入,需依序取回全部訊息
+ *   - 亂數與變異過的輸入不可讓 parse 讀出緩衝區範圍或回傳不合理的長度
+ *
+ * 可搭配 CFLAGS="-O1 -g -fsanitize=address,undefined" 建置以檢查越界讀取
+ *
+ * 用法: test_protocol [亂數種子]
+ */
+
+#define _GNU_SOURCE
+
+#include "gaming_common.h"
+#include "gaming_protocol.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TEST_ROUNDTRIP_ROUNDS  1000
+#define TEST_STREAM_MESSAGES   64
+#define TEST_RANDOM_INPUTS     200000
+
+static int failures;
+static int checks;
+
+#define CHECK(cond, ...) do {                       \
+    checks++;                                       \
+    if (!(cond)) {                                  \
+        failures++;                                 \
+        fprintf(stderr, "FAIL: " __VA_ARGS__);      \
+        fputc('\n', stderr);                        \
+    }                                               \
+} while (0)
+
+// ========================================
+// 亂數 (xorshift64, 結果可由種子重現)
+// ========================================
+
+static uint64_t rng_state;
+
+static uint64_t rng_next(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+// ========================================
+// Round-trip (每個訊息類型各展開一份)
+// ========================================
+
+#define TEST_FIELD_FILL(msg_name, type, name) \
+    in.name = (gaming_wire_##type##_t)rng_next();
+
+#define TEST_FIELD_COMPARE(msg_name, type, name) \
+    CHECK(out.name == in.name, #msg_name "." #name ": expected %u, got %u", \
+          (unsigned)in.name, (unsigned)out.name);
+
+#define TEST_MSG_ROUNDTRIP(name, id, FIELDS) \
+    static void test_roundtrip_##name(void) { \
+        size_t total = GAMING_PROTOCOL_HEADER_SIZE + GAMING_MSG_PAYLOAD_SIZE(name); \
+        CHECK(total <= GAMING_PROTOCOL_MAX_FRAME_SIZE, #name ": frame too large"); \
+        \
+        for (int round = 0; round < TEST_ROUNDTRIP_ROUNDS; round++) { \
+            gaming_msg_##name##_t in; \
+            gaming_msg_##name##_t out; \
+            memset(&in, 0, sizeof(in)); \
+            FIELDS(TEST_FIELD_FILL, name) \
+            uint16_t seq = (uint16_t)rng_next(); \
+            \
+            uint8_t buffer[GAMING_PROTOCOL_MAX_FRAME_SIZE]; \
+            CHECK(gaming_msg_encode_##name(&in, seq, buffer, total - 1) == GAMING_ERROR_NO_MEMORY, \
+                  #name ": short buffer accepted"); \
+            int n = gaming_msg_encode_##name(&in, seq, buffer, sizeof(buffer)); \
+            CHECK(n == (int)total, #name ": encode returned %d, expected %zu", n, total); \
+            if (n != (int)total) { \
+                return; \
+            } \
+            \
+            gaming_msg_view_t view; \
+            for (size_t len = 0; len < total; len++) { \
+                int r = gaming_msg_parse(buffer, len, &view); \
+                CHECK(r == 0, #name ": truncated to %zu returned %d", len, r); \
+            } \
+            \
+            int r = gaming_msg_parse(buffer, total, &view); \
+            CHECK(r == (int)total, #name ": parse returned %d", r); \
+            CHECK(view.type == id && view.seq == seq && \
+                  view.version == GAMING_PROTOCOL_VERSION && \
+                  view.payload_len == GAMING_MSG_PAYLOAD_SIZE(name), \
+                  #name ": header mismatch"); \
+            CHECK(gaming_msg_decode_##name(&view, &out) == GAMING_OK, #name ": decode failed"); \
+            FIELDS(TEST_FIELD_COMPARE, name) \
+            \
+            view.type = (uint8_t)(id + 100); \
+            CHECK(gaming_msg_decode_##name(&view, &out) == GAMING_ERROR_INVALID_PARAM, \
+                  #name ": decode accepted wrong type"); \
+        } \
+        CHECK(strcmp(gaming_msg_type_string(id), #name) == 0, #name ": type string"); \
+    }
+
+GAMING_PROTOCOL_MESSAGES(TEST_MSG_ROUNDTRIP)
+#undef TEST_MSG_ROUNDTRIP
+
+static void test_roundtrip(void) {
+#define TEST_MSG_CALL(name, id, FIELDS) test_roundtrip_##name();
+    GAMING_PROTOCOL_MESSAGES(TEST_MSG_CALL)
+#undef TEST_MSG_CALL
+}
+
+// ========================================
+// 串流: 多個訊息串接, 逐位元組到達
+// ========================================
+
+static void test_stream(void) {
+    uint8_t stream[TEST_STREAM_MESSAGES * GAMING_PROTOCOL_MAX_FRAME_SIZE];
+    size_t stream_len = 0;
+
+    for (uint16_t seq = 0; seq < TEST_STREAM_MESSAGES; seq++) {
+        gaming_msg_button_event_t button = { .pin = (uint8_t)seq, .event = 1,
+                                             .duration_ms = seq, .timestamp_ms = seq };
+        gaming_msg_vpn_status_t vpn = { .state = 2, .latency_ms = seq, .timestamp_ms = seq };
+        int n = (seq % 2 == 0)
+            ? gaming_msg_encode_button_event(&button, seq, stream + stream_len,
+                                             sizeof(stream) - stream_len)
+            : gaming_msg_encode_vpn_status(&vpn, seq, stream + stream_len,
+                                           sizeof(stream) - stream_len);
+        CHECK(n > 0, "stream: encode %u failed", seq);
+        if (n <= 0) {
+            return;
+        }
+        stream_len += (size_t)n;
+    }
+
+    // 模擬接收緩衝區: 每次多收一個位元組就嘗試解析
+    uint16_t next_seq = 0;
+    size_t consumed = 0;
+    for (size_t received = 1; received <= stream_len; received++) {
+        gaming_msg_view_t view;
+        int r = gaming_msg_parse(stream + consumed, received - consumed, &view);
+        CHECK(r >= 0, "stream: parse error %d at %zu", r, received);
+        if (r <= 0) {
+            continue;
+        }
+
+        CHECK(view.seq == next_seq, "stream: expected seq %u, got %u", next_seq, view.seq);
+        CHECK(view.type == ((next_seq % 2 == 0) ? GAMING_MSG_BUTTON_EVENT : GAMING_MSG_VPN_STATUS),
+              "stream: seq %u has type %u", next_seq, view.type);
+        next_seq++;
+        consumed += (size_t)r;
+    }
+    CHECK(next_seq == TEST_STREAM_MESSAGES && consumed == stream_len,
+          "stream: got %u of %d messages", next_seq, TEST_STREAM_MESSAGES);
+}
+
+// ========================================
+// 亂數與變異輸入
+// ========================================
+
+static void check_parse_bounds(const uint8_t *buffer, size_t len) {
+    gaming_msg_view_t view;
+    int r = gaming_msg_parse(buffer, len, &view);
+    CHECK(r == 0 || r == GAMING_ERROR_INVALID_PARAM ||
+          (r >= GAMING_PROTOCOL_HEADER_SIZE && (size_t)r <= len), "random: parse returned %d for %zu bytes", r, len);
+    if (r <= 0) {
+        return;
+    }
+
+    CHECK(view.payload == buffer + GAMING_PROTOCOL_HEADER_SIZE &&
+          GAMING_PROTOCOL_HEADER_SIZE + view.payload_len == (size_t)r,
+          "random: view outside frame");
+
+    // 對任何類型呼叫所有 decode: 類型或長度不符時需拒絕, 相符時不可越界
+#define TEST_MSG_DECODE_ANY(name, id, FIELDS) \
+    { \
+        gaming_msg_##name##_t msg; \
+        int d = gaming_msg_decode_##name(&view, &msg); \
+        CHECK((d == GAMING_OK) == (view.type == id), #name ": decode of type %u returned %d", \
+              view.type, d); \
+    }
+    GAMING_PROTOCOL_MESSAGES(TEST_MSG_DECODE_ANY)
+#undef TEST_MSG_DECODE_ANY
+}
+
+static void test_random_input(void) {
+    for (int i = 0; i < TEST_RANDOM_INPUTS; i++) {
+        size_t len = rng_next() % (2 * GAMING_PROTOCOL_MAX_FRAME_SIZE + 1);
+
+        // 以 heap 配置剛好的大小, 搭配 ASan 可偵測越界讀取
+        uint8_t *buffer = malloc(len > 0 ? len : 1);
+        if (buffer == NULL) {
+            failures++;
+            return;
+        }
+        for (size_t j = 0; j < len; j++) {
+            buffer[j] = (uint8_t)rng_next();
+        }
+
+        // 大部分輸入帶正確的 magic / 版本, 才能走到長度與類型檢查
+        if (len >= GAMING_PROTOCOL_HEADER_SIZE && (i % 8) != 0) {
+            gaming_wire_put_u16(buffer, GAMING_PROTOCOL_MAGIC);
+            buffer[2] = GAMING_PROTOCOL_VERSION;
+            buffer[3] = (uint8_t)(rng_next() % (GAMING_MSG_VPN_STATUS + 2));
+            gaming_wire_put_u16(buffer + 4, (uint16_t)(rng_next() % (GAMING_PROTOCOL_MAX_FRAME_SIZE + 8)));
+        }
+
+        check_parse_bounds(buffer, len);
+        free(buffer);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    rng_state = (argc > 1) ? strtoull(argv[1], NULL, 0) : 0x9E3779B97F4A7C15ULL;
+    if (rng_state == 0) {
+        rng_state = 1;
+    }
+    uint64_t seed = rng_state;
+
+    test_roundtrip();
+    test_stream();
+    test_random_input();
+
+    printf("test_protocol: seed 0x%llx, %d checks, %d failures\n",
+           (unsigned long long)seed, checks, failures);
+    return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,211 @@
+/**
+ * @file test_uci_native.c
+ * @brief uci_native 正確性測試 (語料庫比對)
+ * @version 1.0.0
+ *
+ * 對語料庫目錄中的每個 <name>.uci:
+ *   - <name>.export 存在時, uci_native_export(..., "<name>", ...) 的輸出需與其完全相同
+ *     (內容即 "uci export <name>" 的輸出)
+ *   - <name>.get 存在時, 每行 "<section>.<option>=<值>" 以 uci_native_get_string 查詢
+ *     需得到相同的值 ("uci get" 的輸出);"!<section>.<option>" 表示需不存在
+ *   - 檔名以 bad_ 開頭的檔案需解析失敗
+ *
+ * 用法: test_uci_native [語料庫目錄]   (預設 corpus/uci)
+ */
+
+#define _GNU_SOURCE
+
+#include "gaming_common.h"
+#include "uci_native.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <limits.h>
+
+#define TEST_DEFAULT_CORPUS  "corpus/uci"
+#define TEST_EXPORT_MAX      65536
+
+static int failures;
+static int checks;
+
+#define CHECK(cond, ...) do {                       \
+    checks++;                                       \
+    if (!(cond)) {                                  \
+        failures++;                                 \
+        fprintf(stderr, "FAIL: " __VA_ARGS__);      \
+        fputc('\n', stderr);                        \
+    }                                               \
+} while (0)
+
+// ========================================
+// 輔助函數
+// ========================================
+
+static bool has_suffix(const char *name, const char *suffix) {
+    size_t len = strlen(name);
+    size_t suffix_len = strlen(suffix);
+    return len > suffix_len && strcmp(name + len - suffix_len, suffix) == 0;
+}
+
+/**
+ * @brief 讀取整個檔案
+ *
+ * @return 讀取的長度, -1 檔案不存在
+ */
+static long read_file(const char *path, char *buf, size_t size) {
+    FILE *fp = fopen(path, "r");
+    if (fp == NULL) {
+        return -1;
+    }
+    size_t len = fread(buf, 1, size - 1, fp);
+    buf[len] = '\0';
+    fclose(fp);
+    return (long)len;
+}
+
+/**
+ * @brief 印出第一個不同的行, 方便看出差異
+ */
+static void report_diff(const char *expected, const char *actual) {
+    int line = 1;
+    while (*expected != '\0' && *expected == *actual) {
+        if (*expected == '\n') {
+            line++;
+        }
+        expected++;
+        actual++;
+    }
+    fprintf(stderr, "  line %d:\n  expected: %.*s\n  actual:   %.*s\n", line,
+            (int)strcspn(expected, "\n"), expected, (int)strcspn(actual, "\n"), actual);
+}
+
+// ========================================
+// 測試
+// ========================================
+
+static void check_export(const uci_native_t *uci, const char *package, const char *expected_path) {
+    static char expected[TEST_EXPORT_MAX];
+    if (read_file(expected_path, expected, sizeof(expected)) < 0) {
+        return;
+    }
+
+    char *actual = NULL;
+    size_t actual_len = 0;
+    FILE *fp = open_memstream(&actual, &actual_len);
+    if (fp == NULL) {
+        perror("open_memstream");
+        failures++;
+        return;
+    }
+    int ret = uci_native_export(uci, package, fp);
+    fclose(fp);
+
+    CHECK(ret == GAMING_OK, "%s: export returned %d", expected_path, ret);
+    bool same = (strcmp(expected, actual) == 0);
+    CHECK(same, "%s: export output differs", expected_path);
+    if (!same) {
+        report_diff(expected, actual);
+    }
+    free(actual);
+}
+
+static void check_get(const uci_native_t *uci, const char *get_path) {
+    FILE *fp = fopen(get_path, "r");
+    if (fp == NULL) {
+        return;
+    }
+
+    char line[512];
+    int line_no = 0;
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        line_no++;
+        line[strcspn(line, "\n")] = '\0';
+        if (line[0] == '\0' || line[0] == '#') {
+            continue;
+        }
+
+        bool expect_missing = (line[0] == '!');
+        char *query = line + (expect_missing ? 1 : 0);
+        char *expected = NULL;
+        if (!expect_missing) {
+            expected = strchr(query, '=');
+            if (expected == NULL) {
+                fprintf(stderr, "%s:%d: malformed line\n", get_path, line_no);
+                failures++;
+                continue;
+            }
+            *expected++ = '\0';
+        }
+
+        // option 名稱不含 '.', section 可能是 "@type[index]"
+        char *dot = strrchr(query, '.');
+        if (dot == NULL) {
+            fprintf(stderr, "%s:%d: malformed query\n", get_path, line_no);
+            failures++;
+            continue;
+        }
+        *dot = '\0';
+
+        char value[1024];
+        int ret = uci_native_get_string(uci, query, dot + 1, value, sizeof(value));
+        if (expect_missing) {
+            CHECK(ret == GAMING_ERROR_NOT_FOUND, "%s:%d: %s.%s should not exist (ret %d, value '%s')",
+                  get_path, line_no, query, dot + 1, ret, (ret == GAMING_OK) ? value : "");
+        } else {
+            CHECK(ret == GAMING_OK && strcmp(value, expected) == 0,
+                  "%s:%d: %s.%s: expected '%s', got '%s' (ret %d)",
+                  get_path, line_no, query, dot + 1, expected, (ret == GAMING_OK) ? value : "", ret);
+        }
+    }
+    fclose(fp);
+}
+
+static void run_case(const char *dir, const char *file) {
+    char path[PATH_MAX];
+    char package[NAME_MAX + 1];
+    snprintf(path, sizeof(path), "%s/%s", dir, file);
+    snprintf(package, sizeof(package), "%.*s", (int)(strlen(file) - strlen(".uci")), file);
+
+    uci_native_t *uci = uci_native_open(path);
+    if (strncmp(file, "bad_", 4) == 0) {
+        CHECK(uci == NULL, "%s: expected parse error", path);
+        uci_native_close(uci);
+        return;
+    }
+    CHECK(uci != NULL, "%s: parse failed", path);
+    if (uci == NULL) {
+        return;
+    }
+
+    snprintf(path, sizeof(path), "%s/%s.export", dir, package);
+    check_export(uci, package, path);
+    snprintf(path, sizeof(path), "%s/%s.get", dir, package);
+    check_get(uci, path);
+
+    uci_native_close(uci);
+}
+
+int main(int argc, char *argv[]) {
+    const char *dir = (argc > 1) ? argv[1] : TEST_DEFAULT_CORPUS;
+
+    DIR *d = opendir(dir);
+    if (d == NULL) {
+        perror(dir);
+        return 1;
+    }
+
+    int cases = 0;
+    struct dirent *entry;
+    while ((entry = readdir(d)) != NULL) {
+        if (has_suffix(entry->d_name, ".uci")) {
+            run_case(dir, entry->d_name);
+            cases++;
+        }
+    }
+    closedir(d);
+
+    printf("test_uci_native: %d cases, %d checks, %d failures\n", cases, checks, failures);
+    return (failures == 0 && cases > 0) ? 0 : 1;
+}
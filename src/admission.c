@@ -0,0 +1,283 @@
+/**
+ * @file admission.c
+ * @brief TCP 伺服器連線准入控制實作
+ * @version 1.0.0
+ */
+
+#define _GNU_SOURCE
+
+#include "admission.h"
+#include "metrics.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <pthread.h>
+#include <netinet/in.h>
+
+// ========================================
+// 內部結構
+// ========================================
+
+typedef struct {
+    uint32_t ip;                 // network byte order, 0 表示空位
+    admission_peer_t peer;
+} admission_entry_t;
+
+struct admission {
+    admission_config_t config;
+    admission_entry_t *table;
+    admission_stats_t stats;
+};
+
+// ========================================
+// 統計
+// ========================================
+
+static pthread_once_t admission_metrics_once = PTHREAD_ONCE_INIT;
+static metrics_counter_t *metric_accepted;
+static metrics_counter_t *metric_rejected_rate;
+static metrics_counter_t *metric_rejected_cap;
+static metrics_gauge_t *metric_active;
+
+static void admission_metrics_register(void) {
+    metric_accepted = metrics_counter_register("admission.accepted");
+    metric_rejected_rate = metrics_counter_register("admission.rejected.rate");
+    metric_rejected_cap = metrics_counter_register("admission.rejected.cap");
+    metric_active = metrics_gauge_register("admission.active");
+}
+
+static inline void admission_metrics_init(void) {
+    pthread_once(&admission_metrics_once, admission_metrics_register);
+}
+
+// ========================================
+// 來源表
+// ========================================
+
+static inline size_t hash_ip(uint32_t ip, size_t mask) {
+    return (size_t)((ip * 2654435761U) >> 8) & mask;
+}
+
+static bool addr_to_ip(const struct sockaddr *addr, uint32_t *ip) {
+    if (addr == NULL || addr->sa_family != AF_INET) {
+        return false;
+    }
+
+    const struct sockaddr_in *sin = (const struct sockaddr_in *)addr;
+    *ip = sin->sin_addr.s_addr;
+    return *ip != 0;
+}
+
+static admission_entry_t *lookup(const admission_t *admission, uint32_t ip) {
+    size_t mask = admission->config.table_size - 1;
+    size_t slot = hash_ip(ip, mask);
+
+    for (size_t i = 0; i < ADMISSION_PROBE_LIMIT; i++) {
+        admission_entry_t *entry = &admission->table[(slot + i) & mask];
+        if (entry->ip == ip) {
+            return entry;
+        }
+        if (entry->ip == 0) {
+            return NULL;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief 取得或建立來源項目
+ *
+ * 探測範圍內都被佔用時覆寫最久沒出現的來源 (新來源從滿 token 開始,
+ * 被擠掉的來源只是失去計數,不會因此被拒絕)
+ */
+static admission_entry_t *lookup_or_insert(admission_t *admission, uint32_t ip, uint64_t now_ms) {
+    size_t mask = admission->config.table_size - 1;
+    size_t slot = hash_ip(ip, mask);
+    admission_entry_t *victim = NULL;
+
+    for (size_t i = 0; i < ADMISSION_PROBE_LIMIT; i++) {
+        admission_entry_t *entry = &admission->table[(slot + i) & mask];
+        if (entry->ip == ip) {
+            return entry;
+        }
+        if (entry->ip == 0) {
+            victim = entry;
+            break;
+        }
+        if (victim == NULL || entry->peer.last_seen_ms < victim->peer.last_seen_ms) {
+            victim = entry;
+        }
+    }
+
+    victim->ip = ip;
+    memset(&victim->peer, 0, sizeof(victim->peer));
+    victim->peer.tokens_milli = admission->config.burst * 1000;
+    victim->peer.last_seen_ms = now_ms;
+    return victim;
+}
+
+/**
+ * @brief 補充 token 並嘗試扣除一個
+ */
+static bool take_token(const admission_t *admission, admission_peer_t *peer, uint64_t now_ms) {
+    uint64_t elapsed = now_ms - peer->last_seen_ms;
+    uint64_t tokens = peer->tokens_milli + elapsed * admission->config.rate;
+    uint64_t limit = (uint64_t)admission->config.burst * 1000;
+
+    peer->tokens_milli = (uint32_t)MIN(tokens, limit);
+    peer->last_seen_ms = now_ms;
+
+    if (peer->tokens_milli < 1000) {
+        return false;
+    }
+    peer->tokens_milli -= 1000;
+    return true;
+}
+
+// ========================================
+// 公開函數實作
+// ========================================
+
+admission_t *admission_create(const admission_config_t *config) {
+    admission_metrics_init();
+
+    admission_t *admission = calloc(1, sizeof(*admission));
+    if (admission == NULL) {
+        return NULL;
+    }
+
+    if (config != NULL) {
+        admission->config = *config;
+    }
+    if (admission->config.rate == 0) {
+        admission->config.rate = ADMISSION_DEFAULT_RATE;
+    }
+    if (admission->config.burst == 0) {
+        admission->config.burst = ADMISSION_DEFAULT_BURST;
+    }
+    if (admission->config.max_conns == 0) {
+        admission->config.max_conns = ADMISSION_DEFAULT_MAX_CONNS;
+    }
+    if (admission->config.table_size == 0) {
+        admission->config.table_size = ADMISSION_DEFAULT_TABLE_SIZE;
+    }
+
+    size_t size = admission->config.table_size;
+    if ((size & (size - 1)) != 0 || size < ADMISSION_PROBE_LIMIT) {
+        free(admission);
+        return NULL;
+    }
+
+    admission->table = calloc(size, sizeof(admission_entry_t));
+    if (admission->table == NULL) {
+        free(admission);
+        return NULL;
+    }
+
+    return admission;
+}
+
+void admission_destroy(admission_t *admission) {
+    if (admission == NULL) {
+        return;
+    }
+
+    free(admission->table);
+    free(admission);
+}
+
+int admission_check(admission_t *admission, const struct sockaddr *addr) {
+    if (admission == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    // 先檢查總量: 不碰來源表
+    if (admission->stats.active >= admission->config.max_conns) {
+        admission->stats.rejected_cap++;
+        metrics_counter_inc(metric_rejected_cap);
+        return GAMING_ERROR;
+    }
+
+    uint32_t ip;
+    if (addr_to_ip(addr, &ip)) {
+        uint64_t now_ms = metrics_now_us() / 1000;
+        admission_entry_t *entry = lookup_or_insert(admission, ip, now_ms);
+
+        if (!take_token(admission, &entry->peer, now_ms)) {
+            entry->peer.rejected++;
+            admission->stats.rejected_rate++;
+            metrics_counter_inc(metric_rejected_rate);
+            return GAMING_ERROR;
+        }
+        entry->peer.accepted++;
+    }
+
+    admission->stats.active++;
+    admission->stats.accepted++;
+    metrics_counter_inc(metric_accepted);
+    metrics_gauge_set(metric_active, admission->stats.active);
+    return GAMING_OK;
+}
+
+int admission_accept(admission_t *admission, int listen_fd) {
+    if (admission == NULL || listen_fd < 0) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    struct sockaddr_storage addr;
+    socklen_t addr_len = sizeof(addr);
+
+    int fd = accept4(listen_fd, (struct sockaddr *)&addr, &addr_len,
+                     SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (fd < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR ||
+            errno == ECONNABORTED) {
+            return GAMING_ERROR_NOT_FOUND;
+        }
+        perror("accept4");
+        return GAMING_ERROR_IO;
+    }
+
+    if (admission_check(admission, (struct sockaddr *)&addr) != GAMING_OK) {
+        // RST 關閉, 不留 TIME_WAIT
+        struct linger lg = { .l_onoff = 1, .l_linger = 0 };
+        setsockopt(fd, SOL_SOCKET, SO_LINGER, &lg, sizeof(lg));
+        close(fd);
+        return GAMING_ERROR;
+    }
+
+    return fd;
+}
+
+void admission_release(admission_t *admission) {
+    if (admission == NULL || admission->stats.active == 0) {
+        return;
+    }
+
+    admission->stats.active--;
+    metrics_gauge_set(metric_active, admission->stats.active);
+}
+
+int admission_get_peer(const admission_t *admission, const struct sockaddr *addr,
+                       admission_peer_t *peer) {
+    uint32_t ip;
+    if (admission == NULL || peer == NULL || !addr_to_ip(addr, &ip)) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    const admission_entry_t *entry = lookup(admission, ip);
+    if (entry == NULL) {
+        return GAMING_ERROR_NOT_FOUND;
+    }
+
+    *peer = entry->peer;
+    return GAMING_OK;
+}
+
+void admission_get_stats(const admission_t *admission, admission_stats_t *stats) {
+    if (admission != NULL && stats != NULL) {
+        *stats = admission->stats;
+    }
+}
@@ -0,0 +1,144 @@
+/**
+ * @file admission.h
+ * @brief TCP 伺服器連線准入控制
+ * @version 1.0.0
+ *
+ * 在 accept 端限制每個來源 IP 的連線速率 (token bucket) 與同時連線總數,
+ * 避免單一異常用戶端的重連風暴拖垮伺服器
+ *
+ * 來源表為預先配置的固定大小 open addressing 雜湊表,拒絕路徑不配置任何記憶體;
+ * 被拒絕的連線以 RST 立即關閉 (SO_LINGER 0),不留下 TIME_WAIT
+ *
+ * 建議以 ADMISSION_DEFAULT_BACKLOG 呼叫 socket_helper_create_tcp_server():
+ * 較大的 backlog 搭配 SYN cookies,風暴期間排隊的連線由本層快速篩掉
+ *
+ * 所有函數須在同一個執行緒 (accept 所在的事件迴圈) 呼叫
+ */
+
+#ifndef ADMISSION_H
+#define ADMISSION_H
+
+#include "gaming_common.h"
+#include <stddef.h>
+#include <sys/socket.h>
+
+// ========================================
+// Admission 配置
+// ========================================
+
+#define ADMISSION_DEFAULT_BACKLOG     1024
+#define ADMISSION_DEFAULT_RATE        5       // 每秒補充的 token
+#define ADMISSION_DEFAULT_BURST       10
+#define ADMISSION_DEFAULT_MAX_CONNS   64
+#define ADMISSION_DEFAULT_TABLE_SIZE  256     // 必須是 2 的次方
+#define ADMISSION_PROBE_LIMIT         8
+
+// ========================================
+// Admission 型別定義
+// ========================================
+
+typedef struct admission admission_t;
+
+/**
+ * @brief 准入設定 (0 使用預設值)
+ */
+typedef struct {
+    uint32_t rate;               ///< 每個來源每秒允許的新連線數
+    uint32_t burst;              ///< 每個來源的突發上限
+    uint32_t max_conns;          ///< 同時連線上限
+    size_t table_size;           ///< 來源表大小 (2 的次方)
+} admission_config_t;
+
+/**
+ * @brief 單一來源的狀態
+ */
+typedef struct {
+    uint32_t tokens_milli;       ///< 剩餘 token (千分之一)
+    uint64_t accepted;           ///< 累計接受
+    uint64_t rejected;           ///< 累計拒絕
+    uint64_t last_seen_ms;       ///< 最後一次連線時間 (CLOCK_MONOTONIC)
+} admission_peer_t;
+
+/**
+ * @brief 全域統計
+ */
+typedef struct {
+    uint32_t active;             ///< 目前的連線數
+    uint64_t accepted;
+    uint64_t rejected_rate;      ///< 超過來源速率被拒絕
+    uint64_t rejected_cap;       ///< 超過同時連線上限被拒絕
+} admission_stats_t;
+
+// ========================================
+// Admission 公開函數
+// ========================================
+
+/**
+ * @brief 建立准入控制
+ *
+ * @param config 設定, NULL 使用預設值
+ * @return 指標, NULL 失敗
+ */
+admission_t *admission_create(const admission_config_t *config);
+
+/**
+ * @brief 銷毀准入控制
+ *
+ * @param admission 指標
+ */
+void admission_destroy(admission_t *admission);
+
+/**
+ * @brief 判斷來源是否可以建立新連線
+ *
+ * 通過時會佔用一個連線名額,連線結束時必須呼叫 admission_release()
+ *
+ * @param admission 指標
+ * @param addr 來源位址 (非 IPv4 只受連線上限限制)
+ * @return GAMING_OK 允許
+ * @return GAMING_ERROR 拒絕
+ */
+int admission_check(admission_t *admission, const struct sockaddr *addr);
+
+/**
+ * @brief 接受一個連線並做准入判斷
+ *
+ * 被拒絕的連線會以 RST 關閉;通常在 listener 可讀時迴圈呼叫直到 GAMING_ERROR_NOT_FOUND
+ *
+ * @param admission 指標
+ * @param listen_fd listener (建議為非阻塞)
+ * @return >= 0 允許的連線 fd (非阻塞, CLOEXEC)
+ * @return GAMING_ERROR 連線被拒絕 (已關閉, 可繼續 accept)
+ * @return GAMING_ERROR_NOT_FOUND 沒有等待中的連線
+ * @return GAMING_ERROR_IO accept 失敗
+ */
+int admission_accept(admission_t *admission, int listen_fd);
+
+/**
+ * @brief 釋放一個連線名額
+ *
+ * @param admission 指標
+ */
+void admission_release(admission_t *admission);
+
+/**
+ * @brief 查詢來源狀態
+ *
+ * @param admission 指標
+ * @param addr 來源位址 (IPv4)
+ * @param peer 輸出狀態
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR_NOT_FOUND 不在來源表中
+ */
+int admission_get_peer(const admission_t *admission, const struct sockaddr *addr,
+                       admission_peer_t *peer);
+
+/**
+ * @brief 取得全域統計
+ *
+ * @param admission 指標
+ * @param stats 輸出統計
+ */
+void admission_get_stats(const admission_t *admission, admission_stats_t *stats);
+
+#endif // ADMISSION_H
@@ -0,0 +1,191 @@
+/**
+ * @file buffer_pool.c
+ * @brief 固定大小 I/O 緩衝區池實作
+ * @version 1.0.0
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "buffer_pool.h"
+#include "socket_helper.h"
+#include <stdlib.h>
+#include <pthread.h>
+
+// ========================================
+// 內部結構
+// ========================================
+
+struct buffer_pool {
+    uint8_t *memory;         // 預先配置的整塊記憶體
+    size_t buffer_size;      // 使用者要求的大小
+    size_t stride;           // 對齊後每個緩衝區實際佔用的大小
+    size_t capacity;
+
+    uint32_t *free_stack;    // 空閒緩衝區索引堆疊
+    size_t free_top;
+    uint8_t *in_use_flags;   // 用於偵測重複歸還
+
+    size_t high_water;
+    uint64_t alloc_count;
+    uint64_t alloc_failures;
+
+    pthread_mutex_t lock;
+};
+
+// ========================================
+// 公開函數實作
+// ========================================
+
+buffer_pool_t *buffer_pool_create(size_t buffer_size, size_t count) {
+    if (count == 0 || count > UINT32_MAX) {
+        return NULL;
+    }
+
+    if (buffer_size == 0) {
+        buffer_size = SOCKET_DEFAULT_BUFFER_SIZE;
+    }
+
+    size_t stride = (buffer_size + BUFFER_POOL_ALIGNMENT - 1) &
+                    ~((size_t)BUFFER_POOL_ALIGNMENT - 1);
+    if (stride < buffer_size || count > SIZE_MAX / stride) {
+        return NULL;
+    }
+
+    buffer_pool_t *pool = calloc(1, sizeof(*pool));
+    if (pool == NULL) {
+        return NULL;
+    }
+
+    void *memory = NULL;
+    if (posix_memalign(&memory, BUFFER_POOL_ALIGNMENT, stride * count) != 0) {
+        free(pool);
+        return NULL;
+    }
+
+    pool->memory = memory;
+    pool->buffer_size = buffer_size;
+    pool->stride = stride;
+    pool->capacity = count;
+    pthread_mutex_init(&pool->lock, NULL);
+    pool->free_stack = malloc(count * sizeof(uint32_t));
+    pool->in_use_flags = calloc(count, sizeof(uint8_t));
+
+    if (pool->free_stack == NULL || pool->in_use_flags == NULL) {
+        buffer_pool_destroy(pool);
+        return NULL;
+    }
+
+    // 由高到低推入,讓第一次取得的是最低位址的緩衝區
+    for (size_t i = 0; i < count; i++) {
+        pool->free_stack[i] = (uint32_t)(count - 1 - i);
+    }
+    pool->free_top = count;
+
+    return pool;
+}
+
+void buffer_pool_destroy(buffer_pool_t *pool) {
+    if (pool == NULL) {
+        return;
+    }
+
+    pthread_mutex_destroy(&pool->lock);
+    free(pool->memory);
+    free(pool->free_stack);
+    free(pool->in_use_flags);
+    free(pool);
+}
+
+void *buffer_pool_alloc(buffer_pool_t *pool) {
+    if (pool == NULL) {
+        return NULL;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+
+    if (pool->free_top == 0) {
+        pool->alloc_failures++;
+        pthread_mutex_unlock(&pool->lock);
+        return NULL;
+    }
+
+    uint32_t index = pool->free_stack[--pool->free_top];
+    pool->in_use_flags[index] = 1;
+    pool->alloc_count++;
+
+    size_t in_use = pool->capacity - pool->free_top;
+    if (in_use > pool->high_water) {
+        pool->high_water = in_use;
+    }
+
+    pthread_mutex_unlock(&pool->lock);
+
+    return pool->memory + (size_t)index * pool->stride;
+}
+
+int buffer_pool_free(buffer_pool_t *pool, void *buffer) {
+    if (pool == NULL || buffer == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    uint8_t *ptr = buffer;
+    if (ptr < pool->memory || ptr >= pool->memory + pool->stride * pool->capacity) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    size_t offset = (size_t)(ptr - pool->memory);
+    if (offset % pool->stride != 0) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    size_t index = offset / pool->stride;
+
+    pthread_mutex_lock(&pool->lock);
+
+    if (!pool->in_use_flags[index]) {
+        pthread_mutex_unlock(&pool->lock);
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    pool->in_use_flags[index] = 0;
+    pool->free_stack[pool->free_top++] = (uint32_t)index;
+
+    pthread_mutex_unlock(&pool->lock);
+    return GAMING_OK;
+}
+
+size_t buffer_pool_buffer_size(const buffer_pool_t *pool) {
+    if (pool == NULL) {
+        return 0;
+    }
+    return pool->buffer_size;
+}
+
+int buffer_pool_get_stats(buffer_pool_t *pool, buffer_pool_stats_t *stats) {
+    if (pool == NULL || stats == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    stats->buffer_size = pool->buffer_size;
+    stats->capacity = pool->capacity;
+    stats->in_use = pool->capacity - pool->free_top;
+    stats->high_water = pool->high_water;
+    stats->alloc_count = pool->alloc_count;
+    stats->alloc_failures = pool->alloc_failures;
+    pthread_mutex_unlock(&pool->lock);
+
+    return GAMING_OK;
+}
+
+void buffer_pool_reset_stats(buffer_pool_t *pool) {
+    if (pool == NULL) {
+        return;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    pool->high_water = pool->capacity - pool->free_top;
+    pool->alloc_count = 0;
+    pool->alloc_failures = 0;
+    pthread_mutex_unlock(&pool->lock);
+}
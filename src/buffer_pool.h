@@ -0,0 +1,106 @@
+/**
+ * @file buffer_pool.h
+ * @brief 固定大小 I/O 緩衝區池
+ * @version 1.0.0
+ *
+ * 一次預先配置一整塊 cache line 對齊的記憶體,切成固定大小的緩衝區
+ * 取得/歸還時不呼叫 malloc/free,讓連線爆量時的 heap 用量有上限且不產生碎片
+ */
+
+#ifndef BUFFER_POOL_H
+#define BUFFER_POOL_H
+
+#include "gaming_common.h"
+#include <stddef.h>
+
+// ========================================
+// Buffer Pool 配置
+// ========================================
+
+// 緩衝區對齊 (cache line 大小)
+#define BUFFER_POOL_ALIGNMENT 64
+
+// ========================================
+// Buffer Pool 型別定義
+// ========================================
+
+typedef struct buffer_pool buffer_pool_t;
+
+/**
+ * @brief Buffer Pool 統計資訊
+ */
+typedef struct {
+    size_t buffer_size;      ///< 每個緩衝區大小
+    size_t capacity;         ///< 緩衝區總數
+    size_t in_use;           ///< 目前使用中的數量
+    size_t high_water;       ///< 使用中數量的歷史最高值
+    uint64_t alloc_count;    ///< 成功取得次數
+    uint64_t alloc_failures; ///< 池已用盡而失敗的次數
+} buffer_pool_stats_t;
+
+// ========================================
+// Buffer Pool 公開函數
+// ========================================
+
+/**
+ * @brief 建立緩衝區池
+ *
+ * @param buffer_size 每個緩衝區大小 (0 則使用 SOCKET_DEFAULT_BUFFER_SIZE)
+ * @param count 緩衝區數量
+ * @return 緩衝區池指標, NULL 失敗
+ */
+buffer_pool_t *buffer_pool_create(size_t buffer_size, size_t count);
+
+/**
+ * @brief 銷毀緩衝區池
+ *
+ * 所有由此池取得的緩衝區在銷毀後都不可再使用
+ *
+ * @param pool 緩衝區池指標
+ */
+void buffer_pool_destroy(buffer_pool_t *pool);
+
+/**
+ * @brief 取得一個緩衝區 (執行緒安全)
+ *
+ * @param pool 緩衝區池指標
+ * @return 緩衝區指標 (BUFFER_POOL_ALIGNMENT 對齊), NULL 池已用盡
+ */
+void *buffer_pool_alloc(buffer_pool_t *pool);
+
+/**
+ * @brief 歸還緩衝區 (執行緒安全)
+ *
+ * @param pool 緩衝區池指標
+ * @param buffer 由 buffer_pool_alloc 取得的緩衝區
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR_INVALID_PARAM 不屬於此池或重複歸還
+ */
+int buffer_pool_free(buffer_pool_t *pool, void *buffer);
+
+/**
+ * @brief 取得每個緩衝區的大小
+ *
+ * @param pool 緩衝區池指標
+ * @return 緩衝區大小, 0 參數錯誤
+ */
+size_t buffer_pool_buffer_size(const buffer_pool_t *pool);
+
+/**
+ * @brief 取得統計資訊
+ *
+ * @param pool 緩衝區池指標
+ * @param stats 輸出統計
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR_INVALID_PARAM 參數錯誤
+ */
+int buffer_pool_get_stats(buffer_pool_t *pool, buffer_pool_stats_t *stats);
+
+/**
+ * @brief 重設歷史最高值與計數器
+ *
+ * @param pool 緩衝區池指標
+ */
+void buffer_pool_reset_stats(buffer_pool_t *pool);
+
+#endif // BUFFER_POOL_H
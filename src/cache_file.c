@@ -0,0 +1,277 @@
+/**
+ * @file cache_file.c
+ * @brief /var/run 快取檔案的原子寫入與變更偵測實作
+ * @version 1.0.0
+ */
+
+#define _GNU_SOURCE
+
+#include "cache_file.h"
+#include "logger.h"
+#include "metrics.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <limits.h>
+#include <pthread.h>
+#include <sys/stat.h>
+
+// ========================================
+// 內部結構
+// ========================================
+
+struct cache_file {
+    char path[PATH_MAX];
+
+    bool loaded;                 // data 對應 dev/ino/size/mtime 所描述的檔案
+    dev_t dev;
+    ino_t ino;
+    off_t size;
+    struct timespec mtime;
+
+    size_t len;
+    char data[CACHE_FILE_MAX_SIZE + 1];
+};
+
+// ========================================
+// 統計
+// ========================================
+
+static pthread_once_t cache_file_metrics_once = PTHREAD_ONCE_INIT;
+static metrics_counter_t *metric_writes;
+static metrics_counter_t *metric_skipped;
+static metrics_counter_t *metric_reloads;
+
+static void cache_file_metrics_register(void) {
+    metric_writes = metrics_counter_register("cache_file.writes");
+    metric_skipped = metrics_counter_register("cache_file.skipped");
+    metric_reloads = metrics_counter_register("cache_file.reloads");
+}
+
+static inline void cache_file_metrics_init(void) {
+    pthread_once(&cache_file_metrics_once, cache_file_metrics_register);
+}
+
+// ========================================
+// 內部輔助函數
+// ========================================
+
+static bool same_identity(const cache_file_t *cf, const struct stat *st) {
+    return cf->dev == st->st_dev && cf->ino == st->st_ino && cf->size == st->st_size &&
+           cf->mtime.tv_sec == st->st_mtim.tv_sec && cf->mtime.tv_nsec == st->st_mtim.tv_nsec;
+}
+
+static void set_identity(cache_file_t *cf, const struct stat *st) {
+    cf->dev = st->st_dev;
+    cf->ino = st->st_ino;
+    cf->size = st->st_size;
+    cf->mtime = st->st_mtim;
+    cf->loaded = true;
+}
+
+static void forget(cache_file_t *cf) {
+    cf->loaded = false;
+    cf->len = 0;
+    cf->data[0] = '\0';
+}
+
+static bool content_equals(const cache_file_t *cf, const void *data, size_t len) {
+    return cf->loaded && cf->len == len && memcmp(cf->data, data, len) == 0;
+}
+
+/**
+ * @brief 讀取整個檔案 (身分取自同一個 fd, 與內容一致)
+ */
+static int load(cache_file_t *cf) {
+    int fd = open(cf->path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        forget(cf);
+        return (errno == ENOENT) ? GAMING_ERROR_NOT_FOUND : GAMING_ERROR_IO;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) < 0 || st.st_size > CACHE_FILE_MAX_SIZE) {
+        close(fd);
+        forget(cf);
+        return GAMING_ERROR_IO;
+    }
+
+    char buf[CACHE_FILE_MAX_SIZE];
+    size_t len = 0;
+    while (len < sizeof(buf)) {
+        ssize_t n = read(fd, buf + len, sizeof(buf) - len);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            close(fd);
+            forget(cf);
+            return GAMING_ERROR_IO;
+        }
+        if (n == 0) {
+            break;
+        }
+        len += (size_t)n;
+    }
+    close(fd);
+
+    metrics_counter_inc(metric_reloads);
+
+    // 其他服務以相同內容改寫時不算變更
+    bool changed = !content_equals(cf, buf, len);
+    memcpy(cf->data, buf, len);
+    cf->data[len] = '\0';
+    cf->len = len;
+    set_identity(cf, &st);
+    return changed ? 1 : 0;
+}
+
+static int write_all(int fd, const void *data, size_t len) {
+    const char *p = data;
+    while (len > 0) {
+        ssize_t n = write(fd, p, len);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return GAMING_ERROR_IO;
+        }
+        p += n;
+        len -= (size_t)n;
+    }
+    return GAMING_OK;
+}
+
+// ========================================
+// 公開函數實作
+// ========================================
+
+cache_file_t *cache_file_open(const char *path) {
+    if (path == NULL || strlen(path) >= PATH_MAX) {
+        return NULL;
+    }
+
+    cache_file_metrics_init();
+
+    cache_file_t *cf = calloc(1, sizeof(*cf));
+    if (cf == NULL) {
+        return NULL;
+    }
+
+    snprintf(cf->path, sizeof(cf->path), "%s", path);
+    return cf;
+}
+
+void cache_file_close(cache_file_t *cf) {
+    free(cf);
+}
+
+const char *cache_file_path(const cache_file_t *cf) {
+    return cf != NULL ? cf->path : NULL;
+}
+
+int cache_file_refresh(cache_file_t *cf) {
+    if (cf == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    struct stat st;
+    if (stat(cf->path, &st) < 0) {
+        forget(cf);
+        return (errno == ENOENT) ? GAMING_ERROR_NOT_FOUND : GAMING_ERROR_IO;
+    }
+
+    if (cf->loaded && same_identity(cf, &st)) {
+        return 0;
+    }
+    return load(cf);
+}
+
+const char *cache_file_data(const cache_file_t *cf, size_t *len) {
+    if (cf == NULL || !cf->loaded) {
+        return NULL;
+    }
+    if (len != NULL) {
+        *len = cf->len;
+    }
+    return cf->data;
+}
+
+int cache_file_read_line(cache_file_t *cf, char *buf, size_t size) {
+    if (cf == NULL || buf == NULL || size == 0) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    int ret = cache_file_refresh(cf);
+    if (ret < 0) {
+        return ret;
+    }
+
+    size_t n = strcspn(cf->data, "\r\n");
+    n = MIN(n, size - 1);
+    memcpy(buf, cf->data, n);
+    buf[n] = '\0';
+    return GAMING_OK;
+}
+
+int cache_file_write(cache_file_t *cf, const void *data, size_t len) {
+    if (cf == NULL || (data == NULL && len > 0) || len > CACHE_FILE_MAX_SIZE) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    // 以檔案目前的內容比較, 其他服務改寫過也能正確判斷
+    cache_file_refresh(cf);
+    if (content_equals(cf, data, len)) {
+        metrics_counter_inc(metric_skipped);
+        return 0;
+    }
+
+    char tmp_path[PATH_MAX + 16];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.%d.tmp", cf->path, (int)getpid());
+
+    int fd = open(tmp_path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        LOGM_ERRNO(LOG_MODULE_CONFIG, "open cache tmp");
+        return GAMING_ERROR_IO;
+    }
+
+    struct stat st;
+    if (write_all(fd, data, len) != GAMING_OK || fstat(fd, &st) < 0) {
+        LOGM_ERRNO(LOG_MODULE_CONFIG, "write cache");
+        close(fd);
+        unlink(tmp_path);
+        return GAMING_ERROR_IO;
+    }
+
+    if (close(fd) < 0 || rename(tmp_path, cf->path) < 0) {
+        LOGM_ERRNO(LOG_MODULE_CONFIG, "rename cache");
+        unlink(tmp_path);
+        forget(cf);
+        return GAMING_ERROR_IO;
+    }
+
+    // rename 不改變 inode 與 mtime, 以寫入時的身分記住內容
+    memcpy(cf->data, data, len);
+    cf->data[len] = '\0';
+    cf->len = len;
+    set_identity(cf, &st);
+
+    metrics_counter_inc(metric_writes);
+    return 1;
+}
+
+int cache_file_write_line(cache_file_t *cf, const char *str) {
+    if (str == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    char buf[CACHE_FILE_MAX_SIZE];
+    int n = snprintf(buf, sizeof(buf), "%s\n", str);
+    if (n < 0 || (size_t)n >= sizeof(buf)) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+    return cache_file_write(cf, buf, (size_t)n);
+}
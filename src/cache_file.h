@@ -0,0 +1,117 @@
+/**
+ * @file cache_file.h
+ * @brief /var/run 快取檔案的原子寫入與變更偵測
+ * @version 1.0.0
+ *
+ * PATH_DEVICE_TYPE_CACHE、PATH_PS5_IP_CACHE、PATH_PS5_MAC_CACHE 等小型快取檔
+ * 由不同的服務寫入、由更多的服務讀取:
+ *   - 寫入: 內容與檔案目前的內容相同時略過;否則以 temp + rename 原子取代,
+ *     讀取端不會看到不完整的內容
+ *   - 讀取: 以 stat 比對 inode / 大小 / mtime,檔案沒變時直接回傳
+ *     記憶體中的內容,只有變更後才重新讀取
+ *
+ * 記憶體中的內容以最後一次看到的檔案身分 (inode 等) 為準,其他服務改寫後
+ * 下一次讀寫會自動重新載入。同一個 handle 不可跨執行緒同時使用
+ *
+ * 匯出 metrics: cache_file.writes / cache_file.skipped / cache_file.reloads (counter)
+ */
+
+#ifndef CACHE_FILE_H
+#define CACHE_FILE_H
+
+#include "gaming_common.h"
+#include <stddef.h>
+
+// ========================================
+// 快取檔案配置
+// ========================================
+
+#define CACHE_FILE_MAX_SIZE  4096
+
+// ========================================
+// 快取檔案型別定義
+// ========================================
+
+typedef struct cache_file cache_file_t;
+
+// ========================================
+// 快取檔案公開函數
+// ========================================
+
+/**
+ * @brief 建立快取檔案 handle (不存取檔案)
+ *
+ * @param path 檔案路徑
+ * @return handle, NULL 失敗
+ */
+cache_file_t *cache_file_open(const char *path);
+
+/**
+ * @brief 釋放 handle (不刪除檔案)
+ *
+ * @param cf handle
+ */
+void cache_file_close(cache_file_t *cf);
+
+/**
+ * @brief 取得檔案路徑
+ */
+const char *cache_file_path(const cache_file_t *cf);
+
+/**
+ * @brief 重新驗證並在檔案改變時重新載入
+ *
+ * @param cf handle
+ * @return 1 內容已重新載入 (呼叫端需重新解析)
+ * @return 0 內容未改變
+ * @return GAMING_ERROR_NOT_FOUND 檔案不存在
+ * @return GAMING_ERROR_IO 讀取失敗或超過 CACHE_FILE_MAX_SIZE
+ */
+int cache_file_refresh(cache_file_t *cf);
+
+/**
+ * @brief 取得記憶體中的內容 (以 NUL 結尾)
+ *
+ * 不會存取檔案;需要最新內容時先呼叫 cache_file_refresh()
+ *
+ * @param cf handle
+ * @param len 輸出長度 (可為 NULL)
+ * @return 內容, NULL 表示尚未載入或檔案不存在
+ */
+const char *cache_file_data(const cache_file_t *cf, size_t *len);
+
+/**
+ * @brief 重新驗證後複製第一行 (去除換行)
+ *
+ * @param cf handle
+ * @param buf 輸出緩衝區
+ * @param size 緩衝區大小
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR_NOT_FOUND 檔案不存在
+ * @return GAMING_ERROR_IO 讀取失敗
+ */
+int cache_file_read_line(cache_file_t *cf, char *buf, size_t size);
+
+/**
+ * @brief 原子寫入內容,與檔案目前內容相同時略過
+ *
+ * @param cf handle
+ * @param data 內容
+ * @param len 長度 (不可超過 CACHE_FILE_MAX_SIZE)
+ * @return 1 已寫入
+ * @return 0 內容未改變, 略過
+ * @return GAMING_ERROR_INVALID_PARAM 參數錯誤
+ * @return GAMING_ERROR_IO 寫入失敗
+ */
+int cache_file_write(cache_file_t *cf, const void *data, size_t len);
+
+/**
+ * @brief 寫入單行字串 (自動加上換行)
+ *
+ * @param cf handle
+ * @param str 字串
+ * @return 同 cache_file_write()
+ */
+int cache_file_write_line(cache_file_t *cf, const char *str);
+
+#endif // CACHE_FILE_H
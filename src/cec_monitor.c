@@ -0,0 +1,574 @@
+/**
+ * @file cec_monitor.c
+ * @brief HDMI-CEC 監看實作
+ * @version 1.0.0
+ */
+
+#define _GNU_SOURCE
+
+#include "cec_monitor.h"
+#include "logger.h"
+#include "metrics.h"
+#include "trace.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <pthread.h>
+#include <sys/ioctl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <linux/cec.h>
+
+// ========================================
+// 內部結構
+// ========================================
+
+typedef struct {
+    uint8_t data[CEC_MAX_FRAME_SIZE];
+    uint8_t len;
+    bool nack;                   // 模擬傳送結果 NACK
+} cec_replay_frame_t;
+
+struct cec_monitor {
+    int cec_fd;                  // CEC 裝置, 重播模式為 -1
+    int event_fd;                // 重播模式的通知 eventfd, 否則為 -1
+    int epfd;
+
+    uint8_t own_addr;            // 本機邏輯位址 (尚未取得為 CEC_LOG_ADDR_UNREGISTERED)
+    uint8_t ps5_addr;
+    uint16_t ps5_phys_addr;
+    bool ps5_phys_known;
+    ps5_state_t state;
+
+    cec_monitor_callback_t callback;
+    void *user_data;
+
+    cec_replay_frame_t *frames;
+    size_t frame_count;
+    size_t frame_next;
+};
+
+// ========================================
+// 統計
+// ========================================
+
+static pthread_once_t cec_metrics_once = PTHREAD_ONCE_INIT;
+static metrics_counter_t *metric_frames;
+static metrics_counter_t *metric_state_changes;
+static metrics_counter_t *metric_transmit_errors;
+
+static void cec_metrics_register(void) {
+    metric_frames = metrics_counter_register("cec.frames.received");
+    metric_state_changes = metrics_counter_register("cec.state.changes");
+    metric_transmit_errors = metrics_counter_register("cec.transmit.errors");
+}
+
+static inline void cec_metrics_init(void) {
+    pthread_once(&cec_metrics_once, cec_metrics_register);
+}
+
+// ========================================
+// 內部函數
+// ========================================
+
+static cec_monitor_t *cec_monitor_alloc(void) {
+    cec_metrics_init();
+
+    cec_monitor_t *monitor = calloc(1, sizeof(*monitor));
+    if (monitor == NULL) {
+        return NULL;
+    }
+
+    monitor->cec_fd = -1;
+    monitor->event_fd = -1;
+    monitor->epfd = -1;
+    monitor->own_addr = CEC_LOG_ADDR_UNREGISTERED;
+    monitor->ps5_addr = CEC_PS5_DEFAULT_ADDR;
+    monitor->state = PS5_STATE_UNKNOWN;
+    return monitor;
+}
+
+static int cec_monitor_watch(cec_monitor_t *monitor, int fd, uint32_t events) {
+    if (monitor->epfd < 0) {
+        monitor->epfd = epoll_create1(EPOLL_CLOEXEC);
+        if (monitor->epfd < 0) {
+            LOGM_ERRNO(LOG_MODULE_CEC, "epoll_create1");
+            return GAMING_ERROR;
+        }
+    }
+
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = events;
+    ev.data.fd = fd;
+    if (epoll_ctl(monitor->epfd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+        LOGM_ERRNO(LOG_MODULE_CEC, "epoll_ctl");
+        return GAMING_ERROR;
+    }
+    return GAMING_OK;
+}
+
+static void cec_set_state(cec_monitor_t *monitor, ps5_state_t state) {
+    if (state == monitor->state) {
+        return;
+    }
+
+    ps5_state_t old_state = monitor->state;
+    monitor->state = state;
+
+    trace_instant("cec.state_change");
+    metrics_counter_inc(metric_state_changes);
+
+    if (monitor->callback != NULL) {
+        monitor->callback(old_state, state, monitor->user_data);
+    }
+}
+
+/**
+ * @brief 取得本機邏輯位址 (adapter 設定完成後才有)
+ */
+static void cec_refresh_own_addr(cec_monitor_t *monitor) {
+    struct cec_log_addrs laddrs;
+    memset(&laddrs, 0, sizeof(laddrs));
+
+    if (ioctl(monitor->cec_fd, CEC_ADAP_G_LOG_ADDRS, &laddrs) == 0 &&
+        laddrs.num_log_addrs > 0 && laddrs.log_addr[0] != CEC_LOG_ADDR_INVALID) {
+        monitor->own_addr = laddrs.log_addr[0];
+    } else {
+        monitor->own_addr = CEC_LOG_ADDR_UNREGISTERED;
+    }
+}
+
+/**
+ * @brief 傳送一個 frame (非阻塞,結果經 CEC_RECEIVE 回報)
+ */
+static int cec_transmit(cec_monitor_t *monitor, uint8_t dest, const uint8_t *payload,
+                        size_t len) {
+    if (len + 1 > CEC_MAX_FRAME_SIZE) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    // 重播模式沒有實際的匯流排
+    if (monitor->cec_fd < 0) {
+        return GAMING_OK;
+    }
+
+    if (monitor->own_addr == CEC_LOG_ADDR_UNREGISTERED) {
+        cec_refresh_own_addr(monitor);
+    }
+
+    struct cec_msg msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg[0] = (uint8_t)((monitor->own_addr << 4) | (dest & 0x0f));
+    memcpy(&msg.msg[1], payload, len);
+    msg.len = (uint32_t)(len + 1);
+
+    if (ioctl(monitor->cec_fd, CEC_TRANSMIT, &msg) < 0) {
+        LOGM_ERRNO(LOG_MODULE_CEC, "ioctl(CEC_TRANSMIT)");
+        metrics_counter_inc(metric_transmit_errors);
+        return GAMING_ERROR_IO;
+    }
+    return GAMING_OK;
+}
+
+/**
+ * @brief 處理一個收到的 frame 或傳送結果
+ *
+ * @param tx_status 0 為收到的 frame, 否則為本機傳送的結果 (CEC_TX_STATUS_*)
+ */
+static void cec_handle_frame(cec_monitor_t *monitor, const uint8_t *data, size_t len,
+                             uint8_t tx_status) {
+    metrics_counter_inc(metric_frames);
+
+    if (len < 2) {
+        return;
+    }
+
+    uint8_t initiator = data[0] >> 4;
+    uint8_t dest = data[0] & 0x0f;
+    uint8_t opcode = data[1];
+
+    // 詢問電源狀態沒有被應答: PS5 不在匯流排上 (完全關機或拔除)
+    if (tx_status != 0) {
+        if ((tx_status & CEC_TX_STATUS_NACK) && dest == monitor->ps5_addr &&
+            opcode == CEC_MSG_GIVE_DEVICE_POWER_STATUS) {
+            cec_set_state(monitor, PS5_STATE_OFF);
+        }
+        return;
+    }
+
+    if (initiator == monitor->ps5_addr && opcode == CEC_MSG_REPORT_PHYSICAL_ADDR &&
+        len >= 4) {
+        monitor->ps5_phys_addr = (uint16_t)((data[2] << 8) | data[3]);
+        monitor->ps5_phys_known = true;
+    }
+
+    ps5_state_t state;
+    if (cec_monitor_decode(data, len, monitor->ps5_addr, &state)) {
+        cec_set_state(monitor, state);
+    }
+}
+
+static int cec_process_device(cec_monitor_t *monitor) {
+    struct cec_event event;
+    for (;;) {
+        memset(&event, 0, sizeof(event));
+        if (ioctl(monitor->cec_fd, CEC_DQEVENT, &event) < 0) {
+            if (errno == EAGAIN || errno == EINTR) {
+                break;
+            }
+            LOGM_ERRNO(LOG_MODULE_CEC, "ioctl(CEC_DQEVENT)");
+            return GAMING_ERROR_IO;
+        }
+
+        // adapter 重新設定或遺失訊息後重新同步狀態
+        if (event.event == CEC_EVENT_STATE_CHANGE) {
+            cec_refresh_own_addr(monitor);
+            if (event.state_change.phys_addr != CEC_PHYS_ADDR_INVALID) {
+                cec_monitor_request_power_status(monitor);
+            }
+        } else if (event.event == CEC_EVENT_LOST_MSGS) {
+            cec_monitor_request_power_status(monitor);
+        }
+    }
+
+    struct cec_msg msg;
+    for (;;) {
+        memset(&msg, 0, sizeof(msg));
+        if (ioctl(monitor->cec_fd, CEC_RECEIVE, &msg) < 0) {
+            if (errno == EAGAIN || errno == EINTR) {
+                break;
+            }
+            LOGM_ERRNO(LOG_MODULE_CEC, "ioctl(CEC_RECEIVE)");
+            return GAMING_ERROR_IO;
+        }
+
+        cec_handle_frame(monitor, msg.msg, MIN(msg.len, CEC_MAX_FRAME_SIZE), msg.tx_status);
+    }
+
+    return GAMING_OK;
+}
+
+static int cec_process_replay(cec_monitor_t *monitor) {
+    uint64_t pending;
+    if (read(monitor->event_fd, &pending, sizeof(pending)) != sizeof(pending)) {
+        return (errno == EAGAIN) ? GAMING_OK : GAMING_ERROR_IO;
+    }
+
+    while (pending-- > 0 && monitor->frame_next < monitor->frame_count) {
+        const cec_replay_frame_t *frame = &monitor->frames[monitor->frame_next++];
+        cec_handle_frame(monitor, frame->data, frame->len,
+                         frame->nack ? CEC_TX_STATUS_NACK : 0);
+    }
+    return GAMING_OK;
+}
+
+/**
+ * @brief 解析重播檔案的一行
+ *
+ * @return true 得到一個 frame
+ */
+static bool cec_replay_parse_line(char *line, cec_replay_frame_t *frame) {
+    char *p = line;
+    while (*p == ' ' || *p == '\t') {
+        p++;
+    }
+    if (*p == '#' || *p == '\n' || *p == '\0') {
+        return false;
+    }
+
+    memset(frame, 0, sizeof(*frame));
+    if (*p == '!') {
+        frame->nack = true;
+        p++;
+    }
+
+    char *save = NULL;
+    for (char *tok = strtok_r(p, ": \t\r\n", &save); tok != NULL;
+         tok = strtok_r(NULL, ": \t\r\n", &save)) {
+        if (frame->len >= CEC_MAX_FRAME_SIZE) {
+            break;
+        }
+        frame->data[frame->len++] = (uint8_t)strtoul(tok, NULL, 16);
+    }
+
+    return frame->len > 0;
+}
+
+// ========================================
+// 公開函數
+// ========================================
+
+cec_monitor_t *cec_monitor_open(const char *path) {
+    if (path == NULL) {
+        path = DEVICE_CEC;
+    }
+
+    cec_monitor_t *monitor = cec_monitor_alloc();
+    if (monitor == NULL) {
+        return NULL;
+    }
+
+    monitor->cec_fd = open(path, O_RDWR | O_NONBLOCK | O_CLOEXEC);
+    if (monitor->cec_fd < 0) {
+        LOGM_ERRNO(LOG_MODULE_CEC, "open(cec)");
+        free(monitor);
+        return NULL;
+    }
+
+    uint32_t mode = CEC_MODE_INITIATOR | CEC_MODE_MONITOR;
+    if (ioctl(monitor->cec_fd, CEC_S_MODE, &mode) < 0) {
+        // monitor 模式需要 CAP_NET_ADMIN
+        mode = CEC_MODE_INITIATOR | CEC_MODE_FOLLOWER;
+        if (ioctl(monitor->cec_fd, CEC_S_MODE, &mode) < 0) {
+            LOGM_ERRNO(LOG_MODULE_CEC, "ioctl(CEC_S_MODE)");
+            cec_monitor_close(monitor);
+            return NULL;
+        }
+    }
+
+    // adapter 尚未被其他程式設定時,以 unregistered 身分取得可傳送的位址
+    struct cec_log_addrs laddrs;
+    memset(&laddrs, 0, sizeof(laddrs));
+    if (ioctl(monitor->cec_fd, CEC_ADAP_G_LOG_ADDRS, &laddrs) == 0 &&
+        laddrs.num_log_addrs == 0) {
+        memset(&laddrs, 0, sizeof(laddrs));
+        laddrs.cec_version = CEC_OP_CEC_VERSION_1_4;
+        laddrs.vendor_id = CEC_VENDOR_ID_NONE;
+        laddrs.num_log_addrs = 1;
+        laddrs.log_addr_type[0] = CEC_LOG_ADDR_TYPE_UNREGISTERED;
+        laddrs.primary_device_type[0] = CEC_OP_PRIM_DEVTYPE_SWITCH;
+        laddrs.all_device_types[0] = CEC_OP_ALL_DEVTYPE_SWITCH;
+        strncpy(laddrs.osd_name, CEC_OSD_NAME, sizeof(laddrs.osd_name) - 1);
+
+        // 非阻塞: 設定完成後以 CEC_EVENT_STATE_CHANGE 通知
+        if (ioctl(monitor->cec_fd, CEC_ADAP_S_LOG_ADDRS, &laddrs) < 0 && errno != EBUSY) {
+            LOGM_ERRNO(LOG_MODULE_CEC, "ioctl(CEC_ADAP_S_LOG_ADDRS)");
+        }
+    }
+    cec_refresh_own_addr(monitor);
+
+    // 核心事件為 EPOLLPRI, 收到的訊息為 EPOLLIN
+    if (cec_monitor_watch(monitor, monitor->cec_fd, EPOLLIN | EPOLLPRI) != GAMING_OK) {
+        cec_monitor_close(monitor);
+        return NULL;
+    }
+
+    return monitor;
+}
+
+cec_monitor_t *cec_monitor_open_replay(const char *replay_path) {
+    if (replay_path == NULL) {
+        return NULL;
+    }
+
+    FILE *fp = fopen(replay_path, "r");
+    if (fp == NULL) {
+        LOGM_ERRNO(LOG_MODULE_CEC, "fopen");
+        return NULL;
+    }
+
+    cec_monitor_t *monitor = cec_monitor_alloc();
+    if (monitor == NULL) {
+        fclose(fp);
+        return NULL;
+    }
+
+    size_t capacity = 0;
+    char line[256];
+    cec_replay_frame_t frame;
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        if (!cec_replay_parse_line(line, &frame)) {
+            continue;
+        }
+
+        if (monitor->frame_count == capacity) {
+            size_t new_capacity = (capacity == 0) ? 32 : capacity * 2;
+            cec_replay_frame_t *frames = realloc(monitor->frames,
+                                                 new_capacity * sizeof(*frames));
+            if (frames == NULL) {
+                fclose(fp);
+                cec_monitor_close(monitor);
+                return NULL;
+            }
+            monitor->frames = frames;
+            capacity = new_capacity;
+        }
+        monitor->frames[monitor->frame_count++] = frame;
+    }
+    fclose(fp);
+
+    monitor->event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (monitor->event_fd < 0) {
+        LOGM_ERRNO(LOG_MODULE_CEC, "eventfd");
+        cec_monitor_close(monitor);
+        return NULL;
+    }
+
+    if (cec_monitor_watch(monitor, monitor->event_fd, EPOLLIN) != GAMING_OK) {
+        cec_monitor_close(monitor);
+        return NULL;
+    }
+
+    if (monitor->frame_count > 0) {
+        uint64_t count = monitor->frame_count;
+        if (write(monitor->event_fd, &count, sizeof(count)) != sizeof(count)) {
+            LOGM_ERRNO(LOG_MODULE_CEC, "write(eventfd)");
+        }
+    }
+
+    return monitor;
+}
+
+void cec_monitor_close(cec_monitor_t *monitor) {
+    if (monitor == NULL) {
+        return;
+    }
+
+    if (monitor->epfd >= 0) {
+        close(monitor->epfd);
+    }
+    if (monitor->cec_fd >= 0) {
+        close(monitor->cec_fd);
+    }
+    if (monitor->event_fd >= 0) {
+        close(monitor->event_fd);
+    }
+    free(monitor->frames);
+    free(monitor);
+}
+
+int cec_monitor_get_fd(const cec_monitor_t *monitor) {
+    if (monitor == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+    return monitor->epfd;
+}
+
+int cec_monitor_process(cec_monitor_t *monitor) {
+    if (monitor == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    TRACE_SCOPE("cec.process");
+
+    if (monitor->cec_fd >= 0) {
+        return cec_process_device(monitor);
+    }
+    return cec_process_replay(monitor);
+}
+
+void cec_monitor_set_callback(cec_monitor_t *monitor, cec_monitor_callback_t callback,
+                              void *user_data) {
+    if (monitor == NULL) {
+        return;
+    }
+
+    monitor->callback = callback;
+    monitor->user_data = user_data;
+}
+
+void cec_monitor_set_ps5_addr(cec_monitor_t *monitor, uint8_t addr) {
+    if (monitor == NULL || addr >= CEC_LOG_ADDR_BROADCAST) {
+        return;
+    }
+
+    monitor->ps5_addr = addr;
+    monitor->ps5_phys_known = false;
+}
+
+ps5_state_t cec_monitor_get_state(const cec_monitor_t *monitor) {
+    return (monitor != NULL) ? monitor->state : PS5_STATE_UNKNOWN;
+}
+
+int cec_monitor_request_power_status(cec_monitor_t *monitor) {
+    if (monitor == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    uint8_t payload[] = { CEC_MSG_GIVE_DEVICE_POWER_STATUS };
+    return cec_transmit(monitor, monitor->ps5_addr, payload, sizeof(payload));
+}
+
+int cec_monitor_wake(cec_monitor_t *monitor) {
+    if (monitor == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    if (monitor->ps5_phys_known) {
+        uint8_t stream_path[] = {
+            CEC_MSG_SET_STREAM_PATH,
+            (uint8_t)(monitor->ps5_phys_addr >> 8),
+            (uint8_t)monitor->ps5_phys_addr,
+        };
+        cec_transmit(monitor, CEC_LOG_ADDR_BROADCAST, stream_path, sizeof(stream_path));
+    }
+
+    uint8_t pressed[] = { CEC_MSG_USER_CONTROL_PRESSED, CEC_OP_UI_CMD_POWER_ON_FUNCTION };
+    uint8_t released[] = { CEC_MSG_USER_CONTROL_RELEASED };
+
+    int ret = cec_transmit(monitor, monitor->ps5_addr, pressed, sizeof(pressed));
+    if (ret != GAMING_OK) {
+        return ret;
+    }
+    return cec_transmit(monitor, monitor->ps5_addr, released, sizeof(released));
+}
+
+int cec_monitor_standby(cec_monitor_t *monitor) {
+    if (monitor == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    uint8_t payload[] = { CEC_MSG_STANDBY };
+    return cec_transmit(monitor, monitor->ps5_addr, payload, sizeof(payload));
+}
+
+bool cec_monitor_decode(const uint8_t *frame, size_t len, uint8_t ps5_addr,
+                        ps5_state_t *state) {
+    if (frame == NULL || state == NULL || len < 2) {
+        return false;
+    }
+
+    uint8_t initiator = frame[0] >> 4;
+    uint8_t dest = frame[0] & 0x0f;
+
+    switch (frame[1]) {
+        case CEC_MSG_REPORT_POWER_STATUS:
+            if (initiator != ps5_addr || len < 3) {
+                return false;
+            }
+            switch (frame[2]) {
+                case CEC_OP_POWER_STATUS_ON:
+                case CEC_OP_POWER_STATUS_TO_ON:
+                    *state = PS5_STATE_ON;
+                    return true;
+                case CEC_OP_POWER_STATUS_STANDBY:
+                case CEC_OP_POWER_STATUS_TO_STANDBY:
+                    *state = PS5_STATE_STANDBY;
+                    return true;
+                default:
+                    return false;
+            }
+
+        case CEC_MSG_ACTIVE_SOURCE:
+            if (initiator != ps5_addr) {
+                return false;
+            }
+            *state = PS5_STATE_ON;
+            return true;
+
+        case CEC_MSG_STANDBY:
+            // PS5 進入休眠時送出 (one-touch standby), 或電視要求所有裝置待機
+            if (initiator != ps5_addr && dest != ps5_addr && dest != CEC_LOG_ADDR_BROADCAST) {
+                return false;
+            }
+            *state = PS5_STATE_STANDBY;
+            return true;
+
+        default:
+            return false;
+    }
+}
@@ -0,0 +1,170 @@
+/**
+ * @file cec_monitor.h
+ * @brief HDMI-CEC 監看 (PS5 電源狀態)
+ * @version 1.0.0
+ *
+ * 以 monitor 模式開啟 DEVICE_CEC,由核心事件 (CEC_DQEVENT / CEC_RECEIVE)
+ * 驅動,不需要定期探測 PS5:
+ * - REPORT_POWER_STATUS / ACTIVE_SOURCE / STANDBY 轉為 ps5_state_t 變化
+ * - 詢問電源狀態未被應答 (NACK) 視為 PS5 已關機
+ * - 可送出喚醒 (Power On Function) 與待機指令
+ *
+ * 測試時可改用重播檔案作為來源 (每行一個 CEC frame,十六進位)
+ */
+
+#ifndef CEC_MONITOR_H
+#define CEC_MONITOR_H
+
+#include "gaming_common.h"
+#include <stddef.h>
+
+// ========================================
+// CEC 配置
+// ========================================
+
+// PS5 預設邏輯位址 (Playback Device 1)
+#define CEC_PS5_DEFAULT_ADDR     4
+#define CEC_OSD_NAME             "Gaming"
+#define CEC_MAX_FRAME_SIZE       16
+
+// ========================================
+// CEC 型別定義
+// ========================================
+
+typedef struct cec_monitor cec_monitor_t;
+
+/**
+ * @brief PS5 狀態變化回呼
+ *
+ * @param old_state 舊狀態
+ * @param new_state 新狀態
+ * @param user_data 使用者資料
+ */
+typedef void (*cec_monitor_callback_t)(ps5_state_t old_state, ps5_state_t new_state,
+                                       void *user_data);
+
+// ========================================
+// CEC 公開函數
+// ========================================
+
+/**
+ * @brief 開啟 CEC 裝置
+ *
+ * 優先使用 monitor 模式 (可看到 PS5 與電視之間的所有訊息,需要 CAP_NET_ADMIN),
+ * 失敗時退回 follower 模式;adapter 尚未設定邏輯位址時以 unregistered 身分設定
+ *
+ * @param path 裝置路徑, NULL 使用 DEVICE_CEC
+ * @return 監看器指標, NULL 失敗
+ */
+cec_monitor_t *cec_monitor_open(const char *path);
+
+/**
+ * @brief 開啟重播來源 (測試用)
+ *
+ * 檔案每行一個 frame,位元組以 ':' 或空白分隔 (例如 "40:90:01"),'#' 開頭為註解
+ * 以 '!' 開頭的行表示一次被 NACK 的傳送結果 (例如 "!04:8f")
+ * 所有 frame 在第一次 cec_monitor_process() 時依序送出;傳送指令一律成功
+ *
+ * @param replay_path 重播檔案
+ * @return 監看器指標, NULL 失敗
+ */
+cec_monitor_t *cec_monitor_open_replay(const char *replay_path);
+
+/**
+ * @brief 關閉監看器
+ *
+ * @param monitor 監看器指標
+ */
+void cec_monitor_close(cec_monitor_t *monitor);
+
+/**
+ * @brief 取得事件 fd
+ *
+ * 回傳 epoll fd,加入呼叫端的事件迴圈 (EPOLLIN),可讀時呼叫 cec_monitor_process()
+ *
+ * @param monitor 監看器指標
+ * @return >= 0 事件 fd
+ * @return < 0 參數錯誤
+ */
+int cec_monitor_get_fd(const cec_monitor_t *monitor);
+
+/**
+ * @brief 處理所有待處理的 CEC 事件與訊息 (不阻塞)
+ *
+ * @param monitor 監看器指標
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR_IO 讀取失敗
+ */
+int cec_monitor_process(cec_monitor_t *monitor);
+
+/**
+ * @brief 設定狀態變化回呼
+ *
+ * @param monitor 監看器指標
+ * @param callback 回呼函數 (NULL 取消)
+ * @param user_data 使用者資料
+ */
+void cec_monitor_set_callback(cec_monitor_t *monitor, cec_monitor_callback_t callback,
+                              void *user_data);
+
+/**
+ * @brief 設定 PS5 的邏輯位址
+ *
+ * @param monitor 監看器指標
+ * @param addr 邏輯位址 (0 - 14)
+ */
+void cec_monitor_set_ps5_addr(cec_monitor_t *monitor, uint8_t addr);
+
+/**
+ * @brief 取得目前 PS5 狀態
+ *
+ * @param monitor 監看器指標
+ * @return PS5 狀態
+ */
+ps5_state_t cec_monitor_get_state(const cec_monitor_t *monitor);
+
+/**
+ * @brief 詢問 PS5 電源狀態 (GIVE_DEVICE_POWER_STATUS)
+ *
+ * 結果經由 cec_monitor_process() 非同步回報
+ *
+ * @param monitor 監看器指標
+ * @return GAMING_OK 已送出
+ * @return GAMING_ERROR_IO 傳送失敗
+ */
+int cec_monitor_request_power_status(cec_monitor_t *monitor);
+
+/**
+ * @brief 喚醒 PS5
+ *
+ * 送出 USER_CONTROL_PRESSED (Power On Function) / RELEASED;
+ * 已知 PS5 實體位址時另外廣播 SET_STREAM_PATH
+ *
+ * @param monitor 監看器指標
+ * @return GAMING_OK 已送出
+ * @return GAMING_ERROR_IO 傳送失敗
+ */
+int cec_monitor_wake(cec_monitor_t *monitor);
+
+/**
+ * @brief 讓 PS5 進入待機
+ *
+ * @param monitor 監看器指標
+ * @return GAMING_OK 已送出
+ * @return GAMING_ERROR_IO 傳送失敗
+ */
+int cec_monitor_standby(cec_monitor_t *monitor);
+
+/**
+ * @brief 解析一個 CEC frame 中的 PS5 狀態資訊
+ *
+ * @param frame frame 內容 (header + opcode + operands)
+ * @param len frame 長度
+ * @param ps5_addr PS5 邏輯位址
+ * @param state 輸出狀態
+ * @return true frame 帶有 PS5 狀態資訊
+ */
+bool cec_monitor_decode(const uint8_t *frame, size_t len, uint8_t ps5_addr,
+                        ps5_state_t *state);
+
+#endif // CEC_MONITOR_H
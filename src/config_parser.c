@@ -7,10 +7,17 @@
 #define _POSIX_C_SOURCE 200809L
 
 #include "config_parser.h"
+#include "logger.h"
+#include "metrics.h"
+#include "trace.h"
+#include "uci_native.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <strings.h>
+#include <pthread.h>
+#include <limits.h>
+#include <unistd.h>
 
 // ========================================
 // 內部狀態
@@ -18,6 +25,31 @@
 
 static bool config_parser_initialized = false;
 
+// ========================================
+// 統計
+// ========================================
+
+static pthread_once_t config_metrics_once = PTHREAD_ONCE_INIT;
+static metrics_histogram_t *metric_get_latency;
+static metrics_counter_t *metric_get_not_found;
+static metrics_counter_t *metric_get_errors;
+static metrics_counter_t *metric_get_native;
+static metrics_counter_t *metric_set_errors;
+static metrics_histogram_t *metric_commit_latency;
+
+static void config_metrics_register(void) {
+    metric_get_latency = metrics_histogram_register("config.get.latency_us");
+    metric_get_not_found = metrics_counter_register("config.get.not_found");
+    metric_get_errors = metrics_counter_register("config.get.errors");
+    metric_get_native = metrics_counter_register("config.get.native");
+    metric_set_errors = metrics_counter_register("config.set.errors");
+    metric_commit_latency = metrics_histogram_register("config.commit.latency_us");
+}
+
+static inline void config_metrics_init(void) {
+    pthread_once(&config_metrics_once, config_metrics_register);
+}
+
 // ========================================
 // 內部輔助函數
 // ========================================
@@ -46,6 +78,30 @@ static int execute_uci_command(const char *command, char *output, size_t output_
     return GAMING_OK;
 }
 
+/**
+ * @brief 直接解析 /etc/config 檔案讀取 option
+ *
+ * 有尚未 commit 的變更 (/tmp/.uci/<config>) 時檔案內容不是最新值,
+ * 回傳 GAMING_ERROR 讓呼叫端改用 uci 命令
+ */
+static int native_get_string(const char *config_name, const char *section, const char *option,
+                             char *buffer, size_t buffer_size) {
+    char delta_path[PATH_MAX];
+    snprintf(delta_path, sizeof(delta_path), UCI_NATIVE_DELTA_DIR "/%s", config_name);
+    if (access(delta_path, F_OK) == 0) {
+        return GAMING_ERROR;
+    }
+
+    uci_native_t *uci = uci_native_open_config(config_name);
+    if (uci == NULL) {
+        return GAMING_ERROR;
+    }
+
+    int ret = uci_native_get_string(uci, section, option, buffer, buffer_size);
+    uci_native_close(uci);
+    return ret;
+}
+
 // ========================================
 // 公開函數實作
 // ========================================
@@ -76,11 +132,29 @@ int config_parser_get_string(const char *config_name,
         return GAMING_ERROR_INVALID_PARAM;
     }
 
-    char command[256];
-    snprintf(command, sizeof(command), "uci get %s.%s.%s", 
-             config_name, section, option);
+    TRACE_SCOPE("config.get");
+    config_metrics_init();
+    uint64_t start = metrics_now_us();
+
+    int ret = native_get_string(config_name, section, option, buffer, buffer_size);
+    if (ret != GAMING_ERROR) {
+        metrics_counter_inc(metric_get_native);
+    } else {
+        char command[256];
+        snprintf(command, sizeof(command), "uci get %s.%s.%s", 
+                 config_name, section, option);
 
-    return execute_uci_command(command, buffer, buffer_size);
+        ret = execute_uci_command(command, buffer, buffer_size);
+    }
+
+    metrics_histogram_observe(metric_get_latency, metrics_now_us() - start);
+    if (ret == GAMING_ERROR_NOT_FOUND) {
+        metrics_counter_inc(metric_get_not_found);
+    } else if (ret != GAMING_OK) {
+        metrics_counter_inc(metric_get_errors);
+    }
+
+    return ret;
 }
 
 int config_parser_get_int(const char *config_name,
@@ -136,11 +210,17 @@ int config_parser_set_string(const char *config_name,
         return GAMING_ERROR_INVALID_PARAM;
     }
 
+    TRACE_SCOPE("config.set");
+
     char command[512];
     snprintf(command, sizeof(command), "uci set %s.%s.%s='%s'", 
              config_name, section, option, value);
 
     int ret = system(command);
+    if (ret != 0) {
+        config_metrics_init();
+        metrics_counter_inc(metric_set_errors);
+    }
     return (ret == 0) ? GAMING_OK : GAMING_ERROR;
 }
 
@@ -171,9 +251,37 @@ int config_parser_commit(const char *config_name) {
         return GAMING_ERROR_INVALID_PARAM;
     }
 
+    TRACE_SCOPE("config.commit");
+    config_metrics_init();
+    uint64_t start = metrics_now_us();
+
     char command[256];
     snprintf(command, sizeof(command), "uci commit %s", config_name);
 
     int ret = system(command);
+    metrics_histogram_observe(metric_commit_latency, metrics_now_us() - start);
     return (ret == 0) ? GAMING_OK : GAMING_ERROR;
 }
+
+int config_parser_load_log_levels(const char *config_name, const char *section) {
+    if (config_name == NULL || section == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    char level[32];
+    char modules[192];
+    bool has_level = (config_parser_get_string(config_name, section, UCI_OPTION_LOG_LEVEL,
+                                               level, sizeof(level)) == GAMING_OK);
+    bool has_modules = (config_parser_get_string(config_name, section, UCI_OPTION_LOG_MODULES,
+                                                 modules, sizeof(modules)) == GAMING_OK);
+    if (!has_level && !has_modules) {
+        return GAMING_ERROR_NOT_FOUND;
+    }
+
+    // 合成單一設定字串, 任一部分錯誤時整體不套用
+    char spec[256];
+    snprintf(spec, sizeof(spec), "%s%s%s%s",
+             has_level ? "*=" : "", has_level ? level : "",
+             (has_level && has_modules) ? "," : "", has_modules ? modules : "");
+    return logger_set_module_levels(spec);
+}
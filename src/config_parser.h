@@ -26,13 +26,17 @@
 // Gaming Server 配置
 #define UCI_CONFIG_GAMING_SERVER "gaming-server"
 
+// 主區段 (通用選項, 例如 log_level / log_modules)
+#define UCI_SECTION_MAIN "main"
+
 // ========================================
 // 配置選項定義
 // ========================================
 
 // 通用選項
 #define UCI_OPTION_ENABLED      "enabled"
-#define UCI_OPTION_LOG_LEVEL    "log_level"
+#define UCI_OPTION_LOG_LEVEL    "log_level"     // 名稱 (info) 或數值 0-3
+#define UCI_OPTION_LOG_MODULES  "log_modules"   // logger_set_module_levels() 格式
 #define UCI_OPTION_DEVICE_TYPE  "device_type"
 
 // Client 選項
@@ -174,4 +178,19 @@ int config_parser_set_bool(const char *config_name,
  */
 int config_parser_commit(const char *config_name);
 
+/**
+ * @brief 由 UCI 套用日誌等級
+ *
+ * 讀取 UCI_OPTION_LOG_LEVEL (全部模組) 與 UCI_OPTION_LOG_MODULES
+ * (logger_set_module_levels() 格式, 覆寫個別模組),一次套用;
+ * 於啟動及設定重新載入時呼叫
+ *
+ * @param config_name 配置文件名稱
+ * @param section 配置區段 (例如 UCI_SECTION_MAIN)
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR_NOT_FOUND 兩個選項都不存在 (等級不變)
+ * @return GAMING_ERROR_INVALID_PARAM 選項格式錯誤 (等級不變)
+ */
+int config_parser_load_log_levels(const char *config_name, const char *section);
+
 #endif // CONFIG_PARSER_H
@@ -0,0 +1,278 @@
+/**
+ * @file device_detect.c
+ * @brief 裝置類型偵測實作
+ * @version 1.0.0
+ */
+
+#define _GNU_SOURCE
+
+#include "device_detect.h"
+#include "cache_file.h"
+#include "logger.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <limits.h>
+#include <pthread.h>
+
+// ========================================
+// 私有變數
+// ========================================
+
+static pthread_mutex_t device_detect_mutex = PTHREAD_MUTEX_INITIALIZER;
+static bool device_detect_initialized = false;
+static device_type_t device_detect_cached = DEVICE_TYPE_UNKNOWN;
+
+static device_detect_adc_t device_detect_adc;
+static cache_file_t *device_detect_cache;
+static int device_detect_samples = DEVICE_DETECT_DEFAULT_SAMPLES;
+static int device_detect_hysteresis = DEVICE_DETECT_DEFAULT_HYSTERESIS;
+
+// 預設 ADC 來源的裝置 fd
+static int device_detect_adc_fd = -1;
+
+// ========================================
+// 私有函數
+// ========================================
+
+/**
+ * @brief 預設 ADC 來源: 從 DEVICE_ADC 讀取十進位數值
+ */
+static int adc_device_read(void *ctx, int *value) {
+    (void)ctx;
+
+    if (device_detect_adc_fd < 0) {
+        device_detect_adc_fd = open(DEVICE_ADC, O_RDONLY | O_CLOEXEC);
+        if (device_detect_adc_fd < 0) {
+            LOGM_ERRNO(LOG_MODULE_DEFAULT, "open(" DEVICE_ADC ")");
+            return GAMING_ERROR_HAL_FAILED;
+        }
+    }
+
+    char buf[32];
+    ssize_t n = pread(device_detect_adc_fd, buf, sizeof(buf) - 1, 0);
+    if (n <= 0) {
+        LOGM_ERRNO(LOG_MODULE_DEFAULT, "pread(" DEVICE_ADC ")");
+        return GAMING_ERROR_HAL_FAILED;
+    }
+    buf[n] = '\0';
+
+    char *end;
+    long v = strtol(buf, &end, 10);
+    if (end == buf || v < 0 || v > INT_MAX) {
+        return GAMING_ERROR_HAL_FAILED;
+    }
+
+    *value = (int)v;
+    return GAMING_OK;
+}
+
+/**
+ * @brief 讀取 N 個樣本並回傳中位數
+ */
+static int adc_sample_median(int *median) {
+    int samples[DEVICE_DETECT_MAX_SAMPLES];
+    int count = device_detect_samples;
+
+    for (int i = 0; i < count; i++) {
+        if (i > 0) {
+            usleep(DEVICE_DETECT_SAMPLE_INTERVAL_US);
+        }
+
+        int value;
+        int ret = device_detect_adc.read(device_detect_adc.ctx, &value);
+        if (ret != GAMING_OK) {
+            return ret;
+        }
+
+        // 插入排序 (樣本數很少)
+        int j = i;
+        while (j > 0 && samples[j - 1] > value) {
+            samples[j] = samples[j - 1];
+            j--;
+        }
+        samples[j] = value;
+    }
+
+    *median = samples[count / 2];
+    return GAMING_OK;
+}
+
+static device_type_t device_type_parse(const char *str) {
+    if (strncmp(str, "server", 6) == 0) {
+        return DEVICE_TYPE_SERVER;
+    }
+    if (strncmp(str, "client", 6) == 0) {
+        return DEVICE_TYPE_CLIENT;
+    }
+
+    int value = atoi(str);
+    if (value == DEVICE_TYPE_CLIENT || value == DEVICE_TYPE_SERVER) {
+        return (device_type_t)value;
+    }
+    return DEVICE_TYPE_UNKNOWN;
+}
+
+static device_type_t cache_read(void) {
+    char buf[32];
+    if (cache_file_read_line(device_detect_cache, buf, sizeof(buf)) != GAMING_OK) {
+        return DEVICE_TYPE_UNKNOWN;
+    }
+    return device_type_parse(buf);
+}
+
+/**
+ * @brief 原子寫入快取 (內容未改變時不寫入)
+ */
+static int cache_write(device_type_t type) {
+    int ret = cache_file_write_line(device_detect_cache, device_detect_type_string(type));
+    return (ret < 0) ? ret : GAMING_OK;
+}
+
+/**
+ * @brief 取樣、判定並寫入快取 (需持有 device_detect_mutex)
+ */
+static int detect_locked(device_type_t previous, device_type_t *type) {
+    int median;
+    int ret = adc_sample_median(&median);
+    if (ret != GAMING_OK) {
+        return ret;
+    }
+
+    device_type_t detected = device_detect_classify(median, previous,
+                                                    device_detect_hysteresis);
+    __atomic_store_n(&device_detect_cached, detected, __ATOMIC_RELEASE);
+
+    if (type != NULL) {
+        *type = detected;
+    }
+
+    return cache_write(detected);
+}
+
+// ========================================
+// 公開函數實作
+// ========================================
+
+int device_detect_init(const device_detect_config_t *config) {
+    pthread_mutex_lock(&device_detect_mutex);
+
+    if (device_detect_initialized) {
+        pthread_mutex_unlock(&device_detect_mutex);
+        return GAMING_OK;
+    }
+
+    device_detect_adc.read = adc_device_read;
+    device_detect_adc.ctx = NULL;
+    device_detect_samples = DEVICE_DETECT_DEFAULT_SAMPLES;
+    device_detect_hysteresis = DEVICE_DETECT_DEFAULT_HYSTERESIS;
+
+    if (config != NULL) {
+        if (config->adc != NULL && config->adc->read != NULL) {
+            device_detect_adc = *config->adc;
+        }
+        if (config->samples > 0) {
+            device_detect_samples = MIN(config->samples, DEVICE_DETECT_MAX_SAMPLES);
+        }
+        if (config->hysteresis > 0) {
+            device_detect_hysteresis = config->hysteresis;
+        }
+    }
+
+    const char *cache_path = PATH_DEVICE_TYPE_CACHE;
+    if (config != NULL && config->cache_path != NULL) {
+        cache_path = config->cache_path;
+    }
+    device_detect_cache = cache_file_open(cache_path);
+    if (device_detect_cache == NULL) {
+        pthread_mutex_unlock(&device_detect_mutex);
+        return GAMING_ERROR_NO_MEMORY;
+    }
+
+    device_detect_initialized = true;
+
+    // 快速路徑: 本次開機已有服務偵測過
+    device_type_t cached = cache_read();
+    int ret = GAMING_OK;
+    if (cached != DEVICE_TYPE_UNKNOWN) {
+        __atomic_store_n(&device_detect_cached, cached, __ATOMIC_RELEASE);
+    } else {
+        ret = detect_locked(DEVICE_TYPE_UNKNOWN, NULL);
+    }
+
+    pthread_mutex_unlock(&device_detect_mutex);
+    return ret;
+}
+
+void device_detect_cleanup(void) {
+    pthread_mutex_lock(&device_detect_mutex);
+
+    if (device_detect_adc_fd >= 0) {
+        close(device_detect_adc_fd);
+        device_detect_adc_fd = -1;
+    }
+
+    cache_file_close(device_detect_cache);
+    device_detect_cache = NULL;
+
+    __atomic_store_n(&device_detect_cached, DEVICE_TYPE_UNKNOWN, __ATOMIC_RELEASE);
+    device_detect_initialized = false;
+
+    pthread_mutex_unlock(&device_detect_mutex);
+}
+
+device_type_t device_detect_get(void) {
+    device_type_t type = __atomic_load_n(&device_detect_cached, __ATOMIC_ACQUIRE);
+    if (type != DEVICE_TYPE_UNKNOWN) {
+        return type;
+    }
+
+    if (!__atomic_load_n(&device_detect_initialized, __ATOMIC_ACQUIRE)) {
+        device_detect_init(NULL);
+    }
+    return __atomic_load_n(&device_detect_cached, __ATOMIC_ACQUIRE);
+}
+
+int device_detect_refresh(device_type_t *type) {
+    pthread_mutex_lock(&device_detect_mutex);
+
+    if (!device_detect_initialized) {
+        pthread_mutex_unlock(&device_detect_mutex);
+        return GAMING_ERROR_NOT_INITIALIZED;
+    }
+
+    device_type_t previous = __atomic_load_n(&device_detect_cached, __ATOMIC_ACQUIRE);
+    int ret = detect_locked(previous, type);
+
+    pthread_mutex_unlock(&device_detect_mutex);
+    return ret;
+}
+
+device_type_t device_detect_classify(int value, device_type_t previous, int hysteresis) {
+    if (value >= ADC_THRESHOLD_CLIENT_SERVER + hysteresis) {
+        return DEVICE_TYPE_SERVER;
+    }
+    if (value < ADC_THRESHOLD_CLIENT_SERVER - hysteresis) {
+        return DEVICE_TYPE_CLIENT;
+    }
+
+    // 遲滯區間
+    if (previous != DEVICE_TYPE_UNKNOWN) {
+        return previous;
+    }
+    return (value >= ADC_THRESHOLD_CLIENT_SERVER) ? DEVICE_TYPE_SERVER : DEVICE_TYPE_CLIENT;
+}
+
+const char *device_detect_type_string(device_type_t type) {
+    switch (type) {
+        case DEVICE_TYPE_CLIENT:
+            return "client";
+        case DEVICE_TYPE_SERVER:
+            return "server";
+        default:
+            return "unknown";
+    }
+}
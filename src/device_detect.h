@@ -0,0 +1,121 @@
+/**
+ * @file device_detect.h
+ * @brief 裝置類型偵測 (ADC)
+ * @version 1.0.0
+ *
+ * 開機時由 ADC 取 N 個樣本的中位數,依 ADC_THRESHOLD_CLIENT_SERVER 判定
+ * client / server,閾值附近有遲滯區間,避免讀值在閾值邊緣時結果跳動
+ * 結果以 cache_file 原子寫入 PATH_DEVICE_TYPE_CACHE (內容未改變時不重寫,/var/run 為 tmpfs,
+ * 每次開機只有第一個服務需要讀 ADC),之後的查詢直接回傳記憶體中的值
+ *
+ * ADC 讀取可替換為模擬來源,以便在主機上測試
+ */
+
+#ifndef DEVICE_DETECT_H
+#define DEVICE_DETECT_H
+
+#include "gaming_common.h"
+
+// ========================================
+// 偵測配置
+// ========================================
+
+#define DEVICE_DETECT_DEFAULT_SAMPLES      7
+#define DEVICE_DETECT_MAX_SAMPLES          15
+#define DEVICE_DETECT_DEFAULT_HYSTERESIS   32
+#define DEVICE_DETECT_SAMPLE_INTERVAL_US   1000
+
+// ========================================
+// 偵測型別定義
+// ========================================
+
+/**
+ * @brief ADC 來源
+ */
+typedef struct {
+    /**
+     * @brief 讀取一個 ADC 樣本
+     *
+     * @param ctx 來源私有資料
+     * @param value 輸出讀值
+     * @return GAMING_OK 成功, < 0 錯誤碼
+     */
+    int (*read)(void *ctx, int *value);
+    void *ctx;
+} device_detect_adc_t;
+
+/**
+ * @brief 偵測設定
+ */
+typedef struct {
+    const device_detect_adc_t *adc;  ///< ADC 來源, NULL 使用 DEVICE_ADC
+    const char *cache_path;          ///< 快取檔案, NULL 使用 PATH_DEVICE_TYPE_CACHE
+    int samples;                     ///< 樣本數 (上限 DEVICE_DETECT_MAX_SAMPLES), 0 使用預設值
+    int hysteresis;                  ///< 閾值上下的遲滯範圍, 0 使用預設值
+} device_detect_config_t;
+
+// ========================================
+// 偵測公開函數
+// ========================================
+
+/**
+ * @brief 初始化裝置偵測
+ *
+ * 快取檔案存在且有效時直接採用,否則讀取 ADC 並寫入快取
+ *
+ * @param config 設定, NULL 使用預設值
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR_HAL_FAILED ADC 讀取失敗
+ * @return GAMING_ERROR_IO 快取寫入失敗 (結果仍可由 device_detect_get 取得)
+ */
+int device_detect_init(const device_detect_config_t *config);
+
+/**
+ * @brief 清理裝置偵測
+ */
+void device_detect_cleanup(void);
+
+/**
+ * @brief 取得裝置類型 (O(1))
+ *
+ * 尚未初始化時以預設設定初始化一次
+ *
+ * @return 裝置類型, 偵測失敗為 DEVICE_TYPE_UNKNOWN
+ */
+device_type_t device_detect_get(void);
+
+/**
+ * @brief 重新讀取 ADC 並更新快取
+ *
+ * 讀值落在遲滯區間內時維持目前結果
+ *
+ * @param type 輸出裝置類型 (可為 NULL)
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR_NOT_INITIALIZED 尚未初始化
+ * @return GAMING_ERROR_HAL_FAILED ADC 讀取失敗
+ * @return GAMING_ERROR_IO 快取寫入失敗
+ */
+int device_detect_refresh(device_type_t *type);
+
+/**
+ * @brief 依讀值判定裝置類型
+ *
+ * 高於 threshold + hysteresis 為 server, 低於 threshold - hysteresis 為 client,
+ * 中間區間維持 previous (previous 未知時以 threshold 判定)
+ *
+ * @param value ADC 讀值
+ * @param previous 目前的裝置類型
+ * @param hysteresis 遲滯範圍
+ * @return 裝置類型
+ */
+device_type_t device_detect_classify(int value, device_type_t previous, int hysteresis);
+
+/**
+ * @brief 取得裝置類型名稱
+ *
+ * @param type 裝置類型
+ * @return "client" / "server" / "unknown"
+ */
+const char *device_detect_type_string(device_type_t type);
+
+#endif // DEVICE_DETECT_H
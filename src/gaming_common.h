@@ -25,6 +25,7 @@ typedef enum {
     GAMING_ERROR_ALREADY_EXISTS = -7,
     GAMING_ERROR_NO_MEMORY = -8,
     GAMING_ERROR_IO = -9,
+    GAMING_ERROR_BUSY = -10,
 } gaming_error_t;
 
 // ========================================
@@ -49,6 +50,26 @@ typedef enum {
     PS5_STATE_OFF = 3,
 } ps5_state_t;
 
+// ========================================
+// VPN 狀態定義
+// ========================================
+typedef enum {
+    VPN_STATE_UNKNOWN = 0,
+    VPN_STATE_DISCONNECTED = 1,
+    VPN_STATE_CONNECTING = 2,
+    VPN_STATE_CONNECTED = 3,
+} vpn_state_t;
+
+// ========================================
+// 按鈕事件定義
+// ========================================
+typedef enum {
+    BUTTON_EVENT_NONE = 0,
+    BUTTON_EVENT_PRESS = 1,        // 按下
+    BUTTON_EVENT_RELEASE = 2,      // 放開 (短按)
+    BUTTON_EVENT_LONG_PRESS = 3,   // 長按
+} button_event_t;
+
 // ========================================
 // LED 顏色定義
 // ========================================
@@ -67,6 +88,15 @@ typedef struct {
 #define LED_COLOR_BLUE     ((led_color_t){0, 0, 255})
 #define LED_COLOR_YELLOW   ((led_color_t){255, 255, 0})
 
+// LED 效果
+typedef enum {
+    LED_EFFECT_OFF = 0,
+    LED_EFFECT_SOLID = 1,
+    LED_EFFECT_BLINK = 2,
+    LED_EFFECT_BREATHE = 3,
+    LED_EFFECT_FADE = 4,
+} led_effect_t;
+
 // ========================================
 // GPIO Pin 定義（從 UCI 讀取，這裡是預設值）
 // ========================================
@@ -0,0 +1,147 @@
+/**
+ * @file gaming_protocol.c
+ * @brief 狀態訊息二進位線路協定實作
+ * @version 1.0.0
+ */
+
+#include "gaming_protocol.h"
+#include <string.h>
+
+// ========================================
+// 標頭佈局
+// ========================================
+
+#define HDR_OFF_MAGIC    0
+#define HDR_OFF_VERSION  2
+#define HDR_OFF_TYPE     3
+#define HDR_OFF_LENGTH   4
+#define HDR_OFF_SEQ      6
+
+// ========================================
+// 內部輔助函數
+// ========================================
+
+static void gaming_msg_write_header(uint8_t *buffer, uint8_t type,
+                                    uint16_t payload_len, uint16_t seq) {
+    gaming_wire_put_u16(buffer + HDR_OFF_MAGIC, GAMING_PROTOCOL_MAGIC);
+    gaming_wire_put_u8(buffer + HDR_OFF_VERSION, GAMING_PROTOCOL_VERSION);
+    gaming_wire_put_u8(buffer + HDR_OFF_TYPE, type);
+    gaming_wire_put_u16(buffer + HDR_OFF_LENGTH, payload_len);
+    gaming_wire_put_u16(buffer + HDR_OFF_SEQ, seq);
+}
+
+/**
+ * @brief 取得已知訊息類型的 payload 大小
+ *
+ * @return payload 大小, 0 未知類型
+ */
+static size_t gaming_msg_expected_size(uint8_t type) {
+    switch (type) {
+#define GAMING_MSG_SIZE_CASE(name, id, FIELDS) \
+        case id: \
+            return GAMING_MSG_PAYLOAD_SIZE(name);
+        GAMING_PROTOCOL_MESSAGES(GAMING_MSG_SIZE_CASE)
+#undef GAMING_MSG_SIZE_CASE
+        default:
+            return 0;
+    }
+}
+
+// ========================================
+// 公開函數實作
+// ========================================
+
+int gaming_msg_parse(const uint8_t *buffer, size_t len, gaming_msg_view_t *view) {
+    if (buffer == NULL || view == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    if (len < GAMING_PROTOCOL_HEADER_SIZE) {
+        return 0;
+    }
+
+    if (gaming_wire_get_u16(buffer + HDR_OFF_MAGIC) != GAMING_PROTOCOL_MAGIC ||
+        gaming_wire_get_u8(buffer + HDR_OFF_VERSION) != GAMING_PROTOCOL_VERSION) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    size_t payload_len = gaming_wire_get_u16(buffer + HDR_OFF_LENGTH);
+    if (payload_len > GAMING_PROTOCOL_MAX_FRAME_SIZE - GAMING_PROTOCOL_HEADER_SIZE) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    // 已知類型的 payload 不可短於定義;較長則視為新版尾端欄位,予以保留
+    uint8_t type = gaming_wire_get_u8(buffer + HDR_OFF_TYPE);
+    size_t expected = gaming_msg_expected_size(type);
+    if (expected > 0 && payload_len < expected) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    if (len < GAMING_PROTOCOL_HEADER_SIZE + payload_len) {
+        return 0;
+    }
+
+    view->version = gaming_wire_get_u8(buffer + HDR_OFF_VERSION);
+    view->type = type;
+    view->seq = gaming_wire_get_u16(buffer + HDR_OFF_SEQ);
+    view->payload = buffer + GAMING_PROTOCOL_HEADER_SIZE;
+    view->payload_len = payload_len;
+
+    return (int)(GAMING_PROTOCOL_HEADER_SIZE + payload_len);
+}
+
+const char *gaming_msg_type_string(uint8_t type) {
+    switch (type) {
+#define GAMING_MSG_NAME_CASE(name, id, FIELDS) \
+        case id: \
+            return #name;
+        GAMING_PROTOCOL_MESSAGES(GAMING_MSG_NAME_CASE)
+#undef GAMING_MSG_NAME_CASE
+        default:
+            return "unknown";
+    }
+}
+
+// ========================================
+// 產生的 encode / decode
+// ========================================
+
+#define GAMING_FIELD_ENCODE(msg_name, type, name) \
+    gaming_wire_put_##type(payload + offsetof(gaming_layout_##msg_name##_t, name), \
+                           msg->name);
+
+#define GAMING_FIELD_DECODE(msg_name, type, name) \
+    msg->name = gaming_msg_##msg_name##_##name(view);
+
+#define GAMING_MSG_CODEC(name, id, FIELDS) \
+    int gaming_msg_encode_##name(const gaming_msg_##name##_t *msg, uint16_t seq, \
+                                 uint8_t *buffer, size_t size) { \
+        if (msg == NULL || buffer == NULL) { \
+            return GAMING_ERROR_INVALID_PARAM; \
+        } \
+        size_t total = GAMING_PROTOCOL_HEADER_SIZE + GAMING_MSG_PAYLOAD_SIZE(name); \
+        if (size < total) { \
+            return GAMING_ERROR_NO_MEMORY; \
+        } \
+        gaming_msg_write_header(buffer, id, GAMING_MSG_PAYLOAD_SIZE(name), seq); \
+        uint8_t *payload = buffer + GAMING_PROTOCOL_HEADER_SIZE; \
+        FIELDS(GAMING_FIELD_ENCODE, name) \
+        return (int)total; \
+    } \
+    \
+    int gaming_msg_decode_##name(const gaming_msg_view_t *view, \
+                                 gaming_msg_##name##_t *msg) { \
+        if (view == NULL || msg == NULL || view->type != id || \
+            view->payload_len < GAMING_MSG_PAYLOAD_SIZE(name)) { \
+            return GAMING_ERROR_INVALID_PARAM; \
+        } \
+        memset(msg, 0, sizeof(*msg)); \
+        FIELDS(GAMING_FIELD_DECODE, name) \
+        return GAMING_OK; \
+    }
+
+GAMING_PROTOCOL_MESSAGES(GAMING_MSG_CODEC)
+
+#undef GAMING_MSG_CODEC
+#undef GAMING_FIELD_ENCODE
+#undef GAMING_FIELD_DECODE
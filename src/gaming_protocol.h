@@ -0,0 +1,212 @@
+/**
+ * @file gaming_protocol.h
+ * @brief 狀態訊息二進位線路協定
+ * @version 1.0.0
+ *
+ * 各 daemon 之間 (Unix socket / WebSocket) 共用的固定格式二進位訊息
+ * 所有欄位皆為 big-endian,每個訊息 = 8 位元組標頭 + 固定長度 payload
+ *
+ * 訊息格式由下方 GAMING_PROTOCOL_MESSAGES 表定義,
+ * 結構、線路佈局、encode/decode 與欄位存取函數都由此表以巨集展開產生
+ * 新增訊息或欄位只需修改此表
+ */
+
+#ifndef GAMING_PROTOCOL_H
+#define GAMING_PROTOCOL_H
+
+#include "gaming_common.h"
+#include <stddef.h>
+
+// ========================================
+// 協定常數
+// ========================================
+
+#define GAMING_PROTOCOL_MAGIC          0x474D   // "GM"
+#define GAMING_PROTOCOL_VERSION        1
+#define GAMING_PROTOCOL_HEADER_SIZE    8
+
+// 單一訊息最大長度 (標頭 + payload)
+#define GAMING_PROTOCOL_MAX_FRAME_SIZE 64
+
+// ========================================
+// 訊息類型
+// ========================================
+
+typedef enum {
+    GAMING_MSG_INVALID = 0,
+    GAMING_MSG_STATE_CHANGE = 1,   ///< PS5 狀態變化
+    GAMING_MSG_BUTTON_EVENT = 2,   ///< 按鈕事件
+    GAMING_MSG_LED_COMMAND = 3,    ///< LED 指令
+    GAMING_MSG_VPN_STATUS = 4,     ///< VPN 狀態
+} gaming_msg_type_t;
+
+// ========================================
+// 訊息定義表
+// ========================================
+//
+// FIELD(msg, type, name): type 為 u8 / u16 / u32
+// 欄位順序即線路順序,不可重排;新增欄位只能加在尾端
+
+#define GAMING_MSG_STATE_CHANGE_FIELDS(FIELD, msg) \
+    FIELD(msg, u8,  old_state)      /* ps5_state_t */ \
+    FIELD(msg, u8,  new_state)      /* ps5_state_t */ \
+    FIELD(msg, u8,  device_type)    /* device_type_t (發送端) */ \
+    FIELD(msg, u8,  reserved)       \
+    FIELD(msg, u32, timestamp_ms)
+
+#define GAMING_MSG_BUTTON_EVENT_FIELDS(FIELD, msg) \
+    FIELD(msg, u8,  pin)            \
+    FIELD(msg, u8,  event)          /* button_event_t */ \
+    FIELD(msg, u16, duration_ms)    /* 按住時間 */ \
+    FIELD(msg, u32, timestamp_ms)
+
+#define GAMING_MSG_LED_COMMAND_FIELDS(FIELD, msg) \
+    FIELD(msg, u8,  r)              \
+    FIELD(msg, u8,  g)              \
+    FIELD(msg, u8,  b)              \
+    FIELD(msg, u8,  effect)         /* led_effect_t */ \
+    FIELD(msg, u16, period_ms)      \
+    FIELD(msg, u16, reserved)
+
+#define GAMING_MSG_VPN_STATUS_FIELDS(FIELD, msg) \
+    FIELD(msg, u8,  state)          /* vpn_state_t */ \
+    FIELD(msg, u8,  reserved)       \
+    FIELD(msg, u16, latency_ms)     \
+    FIELD(msg, u32, timestamp_ms)
+
+// MSG(name, type_id, fields)
+#define GAMING_PROTOCOL_MESSAGES(MSG) \
+    MSG(state_change, GAMING_MSG_STATE_CHANGE, GAMING_MSG_STATE_CHANGE_FIELDS) \
+    MSG(button_event, GAMING_MSG_BUTTON_EVENT, GAMING_MSG_BUTTON_EVENT_FIELDS) \
+    MSG(led_command,  GAMING_MSG_LED_COMMAND,  GAMING_MSG_LED_COMMAND_FIELDS)  \
+    MSG(vpn_status,   GAMING_MSG_VPN_STATUS,   GAMING_MSG_VPN_STATUS_FIELDS)
+
+// ========================================
+// 線路型別與 big-endian 存取
+// ========================================
+
+typedef uint8_t  gaming_wire_u8_t;
+typedef uint16_t gaming_wire_u16_t;
+typedef uint32_t gaming_wire_u32_t;
+
+static inline uint8_t gaming_wire_get_u8(const uint8_t *p) {
+    return p[0];
+}
+
+static inline uint16_t gaming_wire_get_u16(const uint8_t *p) {
+    return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+static inline uint32_t gaming_wire_get_u32(const uint8_t *p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) |
+           ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+static inline uint64_t gaming_wire_get_u64(const uint8_t *p) {
+    return ((uint64_t)gaming_wire_get_u32(p) << 32) | gaming_wire_get_u32(p + 4);
+}
+
+static inline void gaming_wire_put_u8(uint8_t *p, uint8_t v) {
+    p[0] = v;
+}
+
+static inline void gaming_wire_put_u16(uint8_t *p, uint16_t v) {
+    p[0] = (uint8_t)(v >> 8);
+    p[1] = (uint8_t)v;
+}
+
+static inline void gaming_wire_put_u32(uint8_t *p, uint32_t v) {
+    p[0] = (uint8_t)(v >> 24);
+    p[1] = (uint8_t)(v >> 16);
+    p[2] = (uint8_t)(v >> 8);
+    p[3] = (uint8_t)v;
+}
+
+static inline void gaming_wire_put_u64(uint8_t *p, uint64_t v) {
+    gaming_wire_put_u32(p, (uint32_t)(v >> 32));
+    gaming_wire_put_u32(p + 4, (uint32_t)v);
+}
+
+// ========================================
+// 產生的訊息結構
+// ========================================
+
+/**
+ * @brief 已解析的訊息 (指向接收緩衝區,不複製)
+ *
+ * 在接收緩衝區被覆寫前有效
+ */
+typedef struct {
+    uint8_t version;
+    uint8_t type;                ///< gaming_msg_type_t
+    uint16_t seq;
+    const uint8_t *payload;      ///< 指向緩衝區中的 payload
+    size_t payload_len;
+} gaming_msg_view_t;
+
+// 主機端結構: gaming_msg_<name>_t
+#define GAMING_FIELD_DECL(msg, type, name) gaming_wire_##type##_t name;
+#define GAMING_MSG_STRUCT(name, id, FIELDS) \
+    typedef struct { FIELDS(GAMING_FIELD_DECL, name) } gaming_msg_##name##_t;
+GAMING_PROTOCOL_MESSAGES(GAMING_MSG_STRUCT)
+#undef GAMING_MSG_STRUCT
+
+// 線路佈局: gaming_layout_<name>_t (僅用於計算欄位 offset 與 payload 大小)
+#define GAMING_FIELD_LAYOUT(msg, type, name) uint8_t name[sizeof(gaming_wire_##type##_t)];
+#define GAMING_MSG_LAYOUT(name, id, FIELDS) \
+    typedef struct { FIELDS(GAMING_FIELD_LAYOUT, name) } gaming_layout_##name##_t;
+GAMING_PROTOCOL_MESSAGES(GAMING_MSG_LAYOUT)
+#undef GAMING_MSG_LAYOUT
+
+#define GAMING_MSG_PAYLOAD_SIZE(name) sizeof(gaming_layout_##name##_t)
+
+// 零拷貝欄位存取: gaming_msg_<name>_<field>(view)
+// 呼叫前需確認 view->type 相符 (gaming_msg_parse 已確保 payload 長度足夠)
+#define GAMING_FIELD_GETTER(msg, type, name) \
+    static inline gaming_wire_##type##_t \
+    gaming_msg_##msg##_##name(const gaming_msg_view_t *view) { \
+        return gaming_wire_get_##type(view->payload + \
+                                      offsetof(gaming_layout_##msg##_t, name)); \
+    }
+#define GAMING_MSG_GETTERS(name, id, FIELDS) FIELDS(GAMING_FIELD_GETTER, name)
+GAMING_PROTOCOL_MESSAGES(GAMING_MSG_GETTERS)
+#undef GAMING_MSG_GETTERS
+
+// ========================================
+// 協定公開函數
+// ========================================
+
+/**
+ * @brief 解析一個訊息框 (不複製資料)
+ *
+ * 可直接用於串流接收緩衝區:資料不足時回傳 0,呼叫端應繼續接收
+ * 未知的訊息類型仍會成功解析,由呼叫端決定是否忽略
+ *
+ * @param buffer 接收緩衝區
+ * @param len 緩衝區中的資料長度
+ * @param view 輸出訊息 (指向 buffer)
+ * @return > 0 此訊息框的總長度 (可從 buffer 中移除)
+ * @return 0 資料不足
+ * @return GAMING_ERROR_INVALID_PARAM 格式錯誤 (magic / 版本 / 長度),應關閉連線
+ */
+int gaming_msg_parse(const uint8_t *buffer, size_t len, gaming_msg_view_t *view);
+
+/**
+ * @brief 取得訊息類型名稱
+ *
+ * @param type 訊息類型
+ * @return 類型名稱字串 ("state_change" 等, 未知則 "unknown")
+ */
+const char *gaming_msg_type_string(uint8_t type);
+
+// encode: 回傳寫入的位元組數, < 0 為錯誤 (緩衝區不足為 GAMING_ERROR_NO_MEMORY)
+// decode: 將 view 中的欄位轉為主機端結構, view 類型或長度不符則回傳 GAMING_ERROR_INVALID_PARAM
+#define GAMING_MSG_PROTOTYPES(name, id, FIELDS) \
+    int gaming_msg_encode_##name(const gaming_msg_##name##_t *msg, uint16_t seq, \
+                                 uint8_t *buffer, size_t size); \
+    int gaming_msg_decode_##name(const gaming_msg_view_t *view, \
+                                 gaming_msg_##name##_t *msg);
+GAMING_PROTOCOL_MESSAGES(GAMING_MSG_PROTOTYPES)
+#undef GAMING_MSG_PROTOTYPES
+
+#endif // GAMING_PROTOCOL_H
@@ -0,0 +1,635 @@
+/**
+ * @file gpio.c
+ * @brief GPIO 按鈕輸入實作
+ * @version 1.0.0
+ */
+
+#define _GNU_SOURCE
+
+#include "gpio.h"
+#include "gaming_protocol.h"
+#include "logger.h"
+#include "metrics.h"
+#include "trace.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/ioctl.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+#include <sys/un.h>
+#include <linux/gpio.h>
+
+// ========================================
+// 內部結構
+// ========================================
+
+#define NS_PER_MS 1000000ULL
+
+struct gpio_button {
+    unsigned int line;
+    uint32_t debounce_ms;
+    uint32_t long_press_ms;
+
+    int line_fd;                 // line request fd (模擬時為 pipe 讀端)
+    int sim_fd;                  // 模擬 pipe 寫端, 實體按鈕為 -1
+    int timer_fd;                // 長按計時器
+    int debounce_fd;             // 軟體去彈跳計時器
+    int epfd;
+
+    bool soft_debounce;          // 核心不支援去彈跳時由軟體處理
+    bool settling;               // 去彈跳視窗進行中
+    bool sim_level;              // 模擬後端目前的電位
+    bool pressed;
+    bool long_press_sent;
+    uint64_t press_ns;
+    uint64_t settle_ns;          // 此次視窗第一個邊緣的時間
+
+    bool publish_enabled;
+    int publish_fd;
+    uint16_t publish_seq;
+    uint32_t publish_backoff_ms;  // 下一次連線失敗後的等待時間
+    uint64_t publish_retry_ns;    // 此時間之前不重新連線
+    char publish_path[sizeof(((struct sockaddr_un *)0)->sun_path)];
+};
+
+// ========================================
+// 統計
+// ========================================
+
+static pthread_once_t gpio_metrics_once = PTHREAD_ONCE_INIT;
+static metrics_counter_t *metric_events;
+static metrics_counter_t *metric_bounces;
+static metrics_counter_t *metric_publish_errors;
+static metrics_histogram_t *metric_latency;
+
+static void gpio_metrics_register(void) {
+    metric_events = metrics_counter_register("gpio.button.events");
+    metric_bounces = metrics_counter_register("gpio.button.bounces");
+    metric_publish_errors = metrics_counter_register("gpio.button.publish.errors");
+    metric_latency = metrics_histogram_register("gpio.button.latency_us");
+}
+
+static inline void gpio_metrics_init(void) {
+    pthread_once(&gpio_metrics_once, gpio_metrics_register);
+}
+
+// ========================================
+// 內部函數
+// ========================================
+
+static uint64_t gpio_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void gpio_apply_config(gpio_button_t *button, const gpio_button_config_t *config) {
+    gpio_button_config_t defaults;
+    if (config == NULL) {
+        gpio_button_default_config(&defaults);
+        config = &defaults;
+    }
+
+    button->line = config->line;
+    button->debounce_ms = config->debounce_ms;
+    button->long_press_ms = config->long_press_ms;
+}
+
+/**
+ * @brief 設定絕對時間的單次計時器 (expires_ns 為 0 時停止)
+ */
+static int gpio_arm_timer(int timer_fd, uint64_t expires_ns) {
+    struct itimerspec its;
+    memset(&its, 0, sizeof(its));
+    its.it_value.tv_sec = (time_t)(expires_ns / 1000000000ULL);
+    its.it_value.tv_nsec = (long)(expires_ns % 1000000000ULL);
+
+    if (timerfd_settime(timer_fd, TFD_TIMER_ABSTIME, &its, NULL) < 0) {
+        LOGM_ERRNO(LOG_MODULE_GPIO, "timerfd_settime");
+        return GAMING_ERROR;
+    }
+    return GAMING_OK;
+}
+
+static int gpio_arm_long_press(gpio_button_t *button, uint64_t press_ns) {
+    uint64_t expires = (press_ns != 0) ? press_ns + (uint64_t)button->long_press_ms * NS_PER_MS : 0;
+    return gpio_arm_timer(button->timer_fd, expires);
+}
+
+/**
+ * @brief 讀取 line 目前的電位 (已套用 active_low)
+ */
+static int gpio_read_level(const gpio_button_t *button, bool *active) {
+    if (button->sim_fd >= 0) {
+        *active = button->sim_level;
+        return GAMING_OK;
+    }
+
+    struct gpio_v2_line_values values = { .bits = 0, .mask = 1 };
+    if (ioctl(button->line_fd, GPIO_V2_LINE_GET_VALUES_IOCTL, &values) < 0) {
+        LOGM_ERRNO(LOG_MODULE_GPIO, "ioctl(GPIO_V2_LINE_GET_VALUES_IOCTL)");
+        return GAMING_ERROR_IO;
+    }
+    *active = (values.bits & 1) != 0;
+    return GAMING_OK;
+}
+
+/**
+ * @brief 建立計時器與 epoll,接管 line_fd
+ */
+static int gpio_button_setup(gpio_button_t *button) {
+    int flags = fcntl(button->line_fd, F_GETFL, 0);
+    if (flags < 0 || fcntl(button->line_fd, F_SETFL, flags | O_NONBLOCK) < 0) {
+        LOGM_ERRNO(LOG_MODULE_GPIO, "fcntl");
+        return GAMING_ERROR;
+    }
+
+    button->timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    button->debounce_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (button->timer_fd < 0 || button->debounce_fd < 0) {
+        LOGM_ERRNO(LOG_MODULE_GPIO, "timerfd_create");
+        return GAMING_ERROR;
+    }
+
+    button->epfd = epoll_create1(EPOLL_CLOEXEC);
+    if (button->epfd < 0) {
+        LOGM_ERRNO(LOG_MODULE_GPIO, "epoll_create1");
+        return GAMING_ERROR;
+    }
+
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.fd = button->line_fd;
+    if (epoll_ctl(button->epfd, EPOLL_CTL_ADD, button->line_fd, &ev) < 0) {
+        LOGM_ERRNO(LOG_MODULE_GPIO, "epoll_ctl");
+        return GAMING_ERROR;
+    }
+
+    ev.data.fd = button->timer_fd;
+    if (epoll_ctl(button->epfd, EPOLL_CTL_ADD, button->timer_fd, &ev) < 0) {
+        LOGM_ERRNO(LOG_MODULE_GPIO, "epoll_ctl");
+        return GAMING_ERROR;
+    }
+
+    ev.data.fd = button->debounce_fd;
+    if (epoll_ctl(button->epfd, EPOLL_CTL_ADD, button->debounce_fd, &ev) < 0) {
+        LOGM_ERRNO(LOG_MODULE_GPIO, "epoll_ctl");
+        return GAMING_ERROR;
+    }
+
+    gpio_metrics_init();
+    return GAMING_OK;
+}
+
+static gpio_button_t *gpio_button_alloc(const gpio_button_config_t *config) {
+    gpio_button_t *button = calloc(1, sizeof(*button));
+    if (button == NULL) {
+        return NULL;
+    }
+
+    gpio_apply_config(button, config);
+    button->line_fd = -1;
+    button->sim_fd = -1;
+    button->timer_fd = -1;
+    button->debounce_fd = -1;
+    button->epfd = -1;
+    button->publish_fd = -1;
+    return button;
+}
+
+/**
+ * @brief 向核心請求 line event
+ *
+ * @return >= 0 line request fd
+ * @return < 0 失敗 (errno 保留)
+ */
+static int gpio_request_line(int chip_fd, const gpio_button_t *button,
+                             const char *consumer, bool active_low, bool debounce) {
+    struct gpio_v2_line_request req;
+    memset(&req, 0, sizeof(req));
+
+    req.offsets[0] = button->line;
+    req.num_lines = 1;
+    strncpy(req.consumer, consumer, sizeof(req.consumer) - 1);
+
+    req.config.flags = GPIO_V2_LINE_FLAG_INPUT |
+                       GPIO_V2_LINE_FLAG_EDGE_RISING |
+                       GPIO_V2_LINE_FLAG_EDGE_FALLING;
+    if (active_low) {
+        req.config.flags |= GPIO_V2_LINE_FLAG_ACTIVE_LOW;
+    }
+
+    if (debounce && button->debounce_ms > 0) {
+        req.config.num_attrs = 1;
+        req.config.attrs[0].mask = 1;
+        req.config.attrs[0].attr.id = GPIO_V2_LINE_ATTR_ID_DEBOUNCE;
+        req.config.attrs[0].attr.debounce_period_us = button->debounce_ms * 1000;
+    }
+
+    if (ioctl(chip_fd, GPIO_V2_GET_LINE_IOCTL, &req) < 0) {
+        return -1;
+    }
+    return req.fd;
+}
+
+static size_t gpio_emit(gpio_button_t *button, button_event_t type, uint64_t timestamp_ns,
+                        uint32_t duration_ms, gpio_button_event_t *events,
+                        size_t max_events, size_t count) {
+    gpio_button_event_t event = {
+        .pin = (uint8_t)button->line,
+        .event = type,
+        .duration_ms = duration_ms,
+        .timestamp_ns = timestamp_ns,
+    };
+
+    metrics_counter_inc(metric_events);
+    uint64_t now = gpio_now_ns();
+    if (now > timestamp_ns) {
+        metrics_histogram_observe(metric_latency, (now - timestamp_ns) / 1000);
+    }
+
+    if (button->publish_enabled) {
+        gpio_button_publish(button, &event);
+    }
+
+    if (events != NULL && count < max_events) {
+        events[count] = event;
+    }
+    return count + 1;
+}
+
+/**
+ * @brief 套用穩定後的電位,回傳更新後的事件數
+ */
+static size_t gpio_apply_level(gpio_button_t *button, bool active, uint64_t timestamp_ns,
+                               gpio_button_event_t *events, size_t max_events,
+                               size_t count) {
+    if (active == button->pressed) {
+        metrics_counter_inc(metric_bounces);
+        return count;
+    }
+
+    button->pressed = active;
+
+    if (active) {
+        button->press_ns = timestamp_ns;
+        button->long_press_sent = false;
+        gpio_arm_long_press(button, timestamp_ns);
+        return gpio_emit(button, BUTTON_EVENT_PRESS, timestamp_ns, 0,
+                         events, max_events, count);
+    }
+
+    gpio_arm_long_press(button, 0);
+
+    // 長按後的放開不再回報為短按
+    if (button->long_press_sent) {
+        return count;
+    }
+
+    uint32_t duration_ms = (uint32_t)((timestamp_ns - button->press_ns) / NS_PER_MS);
+    return gpio_emit(button, BUTTON_EVENT_RELEASE, timestamp_ns, duration_ms,
+                     events, max_events, count);
+}
+
+/**
+ * @brief 處理一個邊緣,回傳更新後的事件數
+ *
+ * 軟體去彈跳時不丟棄邊緣:每個邊緣把視窗延到 debounce_ms 之後,
+ * 視窗結束時讀取實際電位再套用 (短於視窗的按下/放開不會遺失放開)
+ */
+static size_t gpio_handle_edge(gpio_button_t *button, bool active, uint64_t timestamp_ns,
+                               gpio_button_event_t *events, size_t max_events,
+                               size_t count) {
+    trace_instant("gpio.edge");
+
+    if (!button->soft_debounce) {
+        return gpio_apply_level(button, active, timestamp_ns, events, max_events, count);
+    }
+
+    if (button->settling) {
+        metrics_counter_inc(metric_bounces);
+    } else {
+        button->settling = true;
+        button->settle_ns = timestamp_ns;
+    }
+    gpio_arm_timer(button->debounce_fd, timestamp_ns + (uint64_t)button->debounce_ms * NS_PER_MS);
+    return count;
+}
+
+/**
+ * @brief 去彈跳視窗結束,依實際電位產生事件
+ */
+static size_t gpio_settle(gpio_button_t *button, gpio_button_event_t *events,
+                          size_t max_events, size_t count) {
+    button->settling = false;
+
+    bool active;
+    if (gpio_read_level(button, &active) != GAMING_OK) {
+        return count;
+    }
+
+    // 視窗內電位來回變化但最後未改變時視為雜訊,不產生事件
+    if (active == button->pressed) {
+        return count;
+    }
+    return gpio_apply_level(button, active, button->settle_ns, events, max_events, count);
+}
+
+// ========================================
+// 公開函數
+// ========================================
+
+void gpio_button_default_config(gpio_button_config_t *config) {
+    if (config == NULL) {
+        return;
+    }
+
+    config->chip_path = GPIO_DEFAULT_CHIP;
+    config->line = GPIO_PIN_BUTTON;
+    config->active_low = true;
+    config->debounce_ms = GPIO_DEFAULT_DEBOUNCE_MS;
+    config->long_press_ms = GPIO_DEFAULT_LONG_PRESS_MS;
+}
+
+gpio_button_t *gpio_button_open(const gpio_button_config_t *config) {
+    gpio_button_config_t defaults;
+    if (config == NULL) {
+        gpio_button_default_config(&defaults);
+        config = &defaults;
+    }
+
+    const char *chip_path = (config->chip_path != NULL) ? config->chip_path : GPIO_DEFAULT_CHIP;
+
+    gpio_button_t *button = gpio_button_alloc(config);
+    if (button == NULL) {
+        return NULL;
+    }
+
+    int chip_fd = open(chip_path, O_RDONLY | O_CLOEXEC);
+    if (chip_fd < 0) {
+        LOGM_ERRNO(LOG_MODULE_GPIO, "open(gpiochip)");
+        free(button);
+        return NULL;
+    }
+
+    button->line_fd = gpio_request_line(chip_fd, button, GPIO_CONSUMER_NAME,
+                                        config->active_low, true);
+    if (button->line_fd < 0 && (errno == EINVAL || errno == ENOTSUP) &&
+        button->debounce_ms > 0) {
+        // 舊核心沒有 debounce 屬性
+        button->soft_debounce = true;
+        button->line_fd = gpio_request_line(chip_fd, button, GPIO_CONSUMER_NAME,
+                                            config->active_low, false);
+    }
+    if (button->line_fd < 0) {
+        LOGM_ERRNO(LOG_MODULE_GPIO, "ioctl(GPIO_V2_GET_LINE_IOCTL)");
+        close(chip_fd);
+        free(button);
+        return NULL;
+    }
+    close(chip_fd);
+
+    // 讀取初始狀態 (開機時已按住不觸發長按)
+    struct gpio_v2_line_values values = { .bits = 0, .mask = 1 };
+    if (ioctl(button->line_fd, GPIO_V2_LINE_GET_VALUES_IOCTL, &values) == 0) {
+        button->pressed = (values.bits & 1) != 0;
+        button->long_press_sent = button->pressed;
+    }
+
+    if (gpio_button_setup(button) != GAMING_OK) {
+        gpio_button_close(button);
+        return NULL;
+    }
+
+    return button;
+}
+
+gpio_button_t *gpio_button_open_simulated(const gpio_button_config_t *config) {
+    gpio_button_t *button = gpio_button_alloc(config);
+    if (button == NULL) {
+        return NULL;
+    }
+
+    int fds[2];
+    if (pipe2(fds, O_CLOEXEC) < 0) {
+        LOGM_ERRNO(LOG_MODULE_GPIO, "pipe2");
+        free(button);
+        return NULL;
+    }
+
+    button->line_fd = fds[0];
+    button->sim_fd = fds[1];
+
+    if (gpio_button_setup(button) != GAMING_OK) {
+        gpio_button_close(button);
+        return NULL;
+    }
+
+    return button;
+}
+
+void gpio_button_close(gpio_button_t *button) {
+    if (button == NULL) {
+        return;
+    }
+
+    if (button->epfd >= 0) {
+        close(button->epfd);
+    }
+    if (button->timer_fd >= 0) {
+        close(button->timer_fd);
+    }
+    if (button->debounce_fd >= 0) {
+        close(button->debounce_fd);
+    }
+    if (button->line_fd >= 0) {
+        close(button->line_fd);
+    }
+    if (button->sim_fd >= 0) {
+        close(button->sim_fd);
+    }
+    if (button->publish_fd >= 0) {
+        close(button->publish_fd);
+    }
+    free(button);
+}
+
+int gpio_button_get_fd(const gpio_button_t *button) {
+    if (button == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+    return button->epfd;
+}
+
+int gpio_button_process(gpio_button_t *button, gpio_button_event_t *events,
+                        size_t max_events) {
+    if (button == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    TRACE_SCOPE("gpio.process");
+    size_t count = 0;
+
+    // 直接讀取兩個非阻塞 fd,不需再呼叫 epoll_wait
+    struct gpio_v2_line_event edges[GPIO_MAX_EVENTS];
+    ssize_t n = read(button->line_fd, edges, sizeof(edges));
+    if (n < 0 && errno != EAGAIN && errno != EINTR) {
+        LOGM_ERRNO(LOG_MODULE_GPIO, "read(gpio line)");
+        return GAMING_ERROR_IO;
+    }
+
+    for (ssize_t i = 0; i < n / (ssize_t)sizeof(edges[0]); i++) {
+        bool active = (edges[i].id == GPIO_V2_LINE_EVENT_RISING_EDGE);
+        count = gpio_handle_edge(button, active, edges[i].timestamp_ns,
+                                 events, max_events, count);
+    }
+
+    uint64_t expirations;
+    if (read(button->debounce_fd, &expirations, sizeof(expirations)) == sizeof(expirations) &&
+        button->settling) {
+        count = gpio_settle(button, events, max_events, count);
+    }
+
+    if (read(button->timer_fd, &expirations, sizeof(expirations)) == sizeof(expirations) &&
+        button->pressed && !button->long_press_sent) {
+        uint64_t now = gpio_now_ns();
+        button->long_press_sent = true;
+        count = gpio_emit(button, BUTTON_EVENT_LONG_PRESS, now,
+                          (uint32_t)((now - button->press_ns) / NS_PER_MS),
+                          events, max_events, count);
+    }
+
+    return (int)MIN(count, max_events);
+}
+
+int gpio_button_set_publish(gpio_button_t *button, const char *path) {
+    if (button == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    if (path == NULL) {
+        path = PATH_BUTTON_SOCKET;
+    }
+
+    if (button->publish_fd >= 0) {
+        close(button->publish_fd);
+        button->publish_fd = -1;
+    }
+
+    strncpy(button->publish_path, path, sizeof(button->publish_path) - 1);
+    button->publish_path[sizeof(button->publish_path) - 1] = '\0';
+    button->publish_enabled = true;
+    button->publish_backoff_ms = GPIO_PUBLISH_BACKOFF_MIN_MS;
+    button->publish_retry_ns = 0;
+    return GAMING_OK;
+}
+
+/**
+ * @brief 非阻塞連線到發佈 socket
+ *
+ * 接收端尚未啟動是正常情況,失敗時不印出錯誤,改為延後下一次重試
+ */
+static int gpio_publish_connect(gpio_button_t *button) {
+    uint64_t now = gpio_now_ns();
+    if (now < button->publish_retry_ns) {
+        return GAMING_ERROR_IO;
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        LOGM_ERRNO(LOG_MODULE_GPIO, "socket");
+        return GAMING_ERROR_IO;
+    }
+
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    memcpy(addr.sun_path, button->publish_path, sizeof(addr.sun_path));
+
+    // Unix socket 的 connect 不會回傳 EINPROGRESS, 接收端 backlog 滿時為 EAGAIN
+    if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        close(fd);
+        button->publish_retry_ns = now + (uint64_t)button->publish_backoff_ms * NS_PER_MS;
+        button->publish_backoff_ms = MIN(button->publish_backoff_ms * 2,
+                                         GPIO_PUBLISH_BACKOFF_MAX_MS);
+        return GAMING_ERROR_IO;
+    }
+
+    button->publish_fd = fd;
+    button->publish_backoff_ms = GPIO_PUBLISH_BACKOFF_MIN_MS;
+    return GAMING_OK;
+}
+
+int gpio_button_publish(gpio_button_t *button, const gpio_button_event_t *event) {
+    if (button == NULL || event == NULL || !button->publish_enabled) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    gpio_metrics_init();
+
+    if (button->publish_fd < 0 && gpio_publish_connect(button) != GAMING_OK) {
+        metrics_counter_inc(metric_publish_errors);
+        return GAMING_ERROR_IO;
+    }
+
+    gaming_msg_button_event_t msg = {
+        .pin = event->pin,
+        .event = (uint8_t)event->event,
+        .duration_ms = (uint16_t)MIN(event->duration_ms, UINT16_MAX),
+        .timestamp_ms = (uint32_t)(event->timestamp_ns / NS_PER_MS),
+    };
+
+    uint8_t frame[GAMING_PROTOCOL_MAX_FRAME_SIZE];
+    int len = gaming_msg_encode_button_event(&msg, button->publish_seq++, frame, sizeof(frame));
+    if (len < 0) {
+        return len;
+    }
+
+    // 對端關閉時不產生 SIGPIPE,下一個事件會重新連線
+    ssize_t sent = send(button->publish_fd, frame, (size_t)len, MSG_NOSIGNAL);
+    if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+        // 接收端處理不及, 丟棄此事件但保留連線
+        metrics_counter_inc(metric_publish_errors);
+        return GAMING_ERROR_IO;
+    }
+    if (sent != len) {
+        // 連線中斷或只送出部分訊息框 (串流已無法對齊), 重新連線
+        metrics_counter_inc(metric_publish_errors);
+        close(button->publish_fd);
+        button->publish_fd = -1;
+        return GAMING_ERROR_IO;
+    }
+
+    return GAMING_OK;
+}
+
+int gpio_button_simulate(gpio_button_t *button, bool pressed) {
+    if (button == NULL || button->sim_fd < 0) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    struct gpio_v2_line_event edge;
+    memset(&edge, 0, sizeof(edge));
+    edge.timestamp_ns = gpio_now_ns();
+    edge.id = pressed ? GPIO_V2_LINE_EVENT_RISING_EDGE : GPIO_V2_LINE_EVENT_FALLING_EDGE;
+    edge.offset = button->line;
+
+    button->sim_level = pressed;
+    if (write(button->sim_fd, &edge, sizeof(edge)) != (ssize_t)sizeof(edge)) {
+        LOGM_ERRNO(LOG_MODULE_GPIO, "write(gpio sim)");
+        return GAMING_ERROR_IO;
+    }
+    return GAMING_OK;
+}
+
+bool gpio_button_is_pressed(const gpio_button_t *button) {
+    return button != NULL && button->pressed;
+}
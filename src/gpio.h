@@ -0,0 +1,171 @@
+/**
+ * @file gpio.h
+ * @brief GPIO 按鈕輸入 (中斷驅動)
+ * @version 1.0.0
+ *
+ * 透過 /dev/gpiochipN 字元裝置的 line event API (GPIO v2) 接收邊緣中斷,
+ * 去彈跳由核心處理,不需輪詢
+ * 按下、長按、放開事件帶有核心時間戳,經由可加入 epoll 的 fd 傳遞,
+ * 並可以 gaming_protocol 的 button_event 訊息發佈到 PATH_BUTTON_SOCKET
+ *
+ * 另提供模擬後端 (pipe),可在沒有 GPIO 硬體的環境注入按鈕邊緣
+ */
+
+#ifndef GPIO_H
+#define GPIO_H
+
+#include "gaming_common.h"
+#include <stddef.h>
+
+// ========================================
+// GPIO 配置
+// ========================================
+
+#define GPIO_DEFAULT_CHIP           "/dev/gpiochip0"
+#define GPIO_DEFAULT_DEBOUNCE_MS    20
+#define GPIO_DEFAULT_LONG_PRESS_MS  2000
+#define GPIO_CONSUMER_NAME          "gaming-button"
+
+// 每次 gpio_button_process() 最多回傳的事件數
+#define GPIO_MAX_EVENTS             8
+
+// 發佈 socket 連線失敗後的重試間隔 (每次失敗加倍)
+#define GPIO_PUBLISH_BACKOFF_MIN_MS 100
+#define GPIO_PUBLISH_BACKOFF_MAX_MS 5000
+
+// ========================================
+// GPIO 型別定義
+// ========================================
+
+typedef struct gpio_button gpio_button_t;
+
+/**
+ * @brief 按鈕設定
+ */
+typedef struct {
+    const char *chip_path;       ///< GPIO chip 裝置, NULL 使用 GPIO_DEFAULT_CHIP
+    unsigned int line;           ///< chip 上的 line offset (例如 GPIO_PIN_BUTTON)
+    bool active_low;             ///< 按下時為低電位
+    uint32_t debounce_ms;        ///< 去彈跳時間
+    uint32_t long_press_ms;      ///< 長按判定時間
+} gpio_button_config_t;
+
+/**
+ * @brief 按鈕事件
+ */
+typedef struct {
+    uint8_t pin;                 ///< line offset
+    button_event_t event;        ///< PRESS / LONG_PRESS / RELEASE
+    uint32_t duration_ms;        ///< 按住時間 (PRESS 為 0)
+    uint64_t timestamp_ns;       ///< CLOCK_MONOTONIC 時間戳 (邊緣發生的時間)
+} gpio_button_event_t;
+
+// ========================================
+// GPIO 公開函數
+// ========================================
+
+/**
+ * @brief 取得預設按鈕設定 (GPIO_PIN_BUTTON, active low)
+ *
+ * @param config 輸出設定
+ */
+void gpio_button_default_config(gpio_button_config_t *config);
+
+/**
+ * @brief 開啟 GPIO 按鈕
+ *
+ * 請求雙邊緣事件與核心去彈跳;核心不支援去彈跳時改用軟體去彈跳
+ * (邊緣後等待 debounce_ms 無變化,再讀取實際電位決定事件)
+ *
+ * @param config 按鈕設定, NULL 使用預設值
+ * @return 按鈕指標, NULL 失敗
+ */
+gpio_button_t *gpio_button_open(const gpio_button_config_t *config);
+
+/**
+ * @brief 開啟模擬按鈕 (不需要 GPIO 硬體)
+ *
+ * 以 gpio_button_simulate() 注入邊緣,其餘行為與實體按鈕相同
+ *
+ * @param config 按鈕設定, NULL 使用預設值
+ * @return 按鈕指標, NULL 失敗
+ */
+gpio_button_t *gpio_button_open_simulated(const gpio_button_config_t *config);
+
+/**
+ * @brief 關閉按鈕並釋放資源
+ *
+ * @param button 按鈕指標
+ */
+void gpio_button_close(gpio_button_t *button);
+
+/**
+ * @brief 取得按鈕的事件 fd
+ *
+ * 回傳的 fd 為 epoll fd (包含 line event 與長按計時器),
+ * 可加入呼叫端的事件迴圈 (EPOLLIN),可讀時呼叫 gpio_button_process()
+ *
+ * @param button 按鈕指標
+ * @return >= 0 事件 fd
+ * @return < 0 參數錯誤
+ */
+int gpio_button_get_fd(const gpio_button_t *button);
+
+/**
+ * @brief 處理就緒的邊緣與計時器 (不阻塞)
+ *
+ * 若已設定發佈路徑,事件會同時發佈出去
+ *
+ * @param button 按鈕指標
+ * @param events 輸出事件陣列 (可為 NULL,僅發佈)
+ * @param max_events 陣列大小
+ * @return >= 0 寫入 events 的事件數
+ * @return < 0 錯誤碼
+ */
+int gpio_button_process(gpio_button_t *button, gpio_button_event_t *events,
+                        size_t max_events);
+
+/**
+ * @brief 設定事件發佈的 Unix socket
+ *
+ * 每個事件編碼為 GAMING_MSG_BUTTON_EVENT 送出;
+ * 連線於第一次發佈時建立,失敗時於下一個事件重試
+ *
+ * @param button 按鈕指標
+ * @param path Socket 路徑, NULL 使用 PATH_BUTTON_SOCKET
+ * @return GAMING_OK 成功
+ */
+int gpio_button_set_publish(gpio_button_t *button, const char *path);
+
+/**
+ * @brief 發佈一個按鈕事件
+ *
+ * 不會阻塞:接收端不存在時依 GPIO_PUBLISH_BACKOFF_* 延後重新連線,
+ * 期間的事件直接丟棄;接收端緩衝區滿時同樣丟棄該事件
+ *
+ * @param button 按鈕指標
+ * @param event 事件
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR_IO 連線或傳送失敗
+ */
+int gpio_button_publish(gpio_button_t *button, const gpio_button_event_t *event);
+
+/**
+ * @brief 注入模擬邊緣 (僅模擬後端)
+ *
+ * @param button 按鈕指標
+ * @param pressed true 按下, false 放開
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR_INVALID_PARAM 非模擬後端
+ */
+int gpio_button_simulate(gpio_button_t *button, bool pressed);
+
+/**
+ * @brief 取得按鈕目前是否按下
+ *
+ * @param button 按鈕指標
+ * @return true 按下中
+ */
+bool gpio_button_is_pressed(const gpio_button_t *button);
+
+#endif // GPIO_H
@@ -0,0 +1,469 @@
+/**
+ * @file led_controller.c
+ * @brief RGB LED 控制器實作
+ * @version 1.0.0
+ */
+
+#define _GNU_SOURCE
+
+#include "led_controller.h"
+#include "logger.h"
+#include "metrics.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <time.h>
+#include <limits.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <sys/timerfd.h>
+
+// ========================================
+// 預先計算的查表
+// ========================================
+
+// gamma 2.2 校正: round((i / 255)^2.2 * 65535)
+static const uint16_t led_gamma_table[256] = {
+        0,     0,     2,     4,     7,    11,    17,    24,
+       32,    42,    53,    65,    79,    94,   111,   129,
+      148,   169,   192,   216,   242,   270,   299,   330,
+      362,   396,   432,   469,   508,   549,   591,   635,
+      681,   729,   779,   830,   883,   938,   995,  1053,
+     1113,  1175,  1239,  1305,  1373,  1443,  1514,  1587,
+     1663,  1740,  1819,  1900,  1983,  2068,  2155,  2243,
+     2334,  2427,  2521,  2618,  2717,  2817,  2920,  3024,
+     3131,  3240,  3350,  3463,  3578,  3694,  3813,  3934,
+     4057,  4182,  4309,  4438,  4570,  4703,  4838,  4976,
+     5115,  5257,  5401,  5547,  5695,  5845,  5998,  6152,
+     6309,  6468,  6629,  6792,  6957,  7124,  7294,  7466,
+     7640,  7816,  7994,  8175,  8358,  8543,  8730,  8919,
+     9111,  9305,  9501,  9699,  9900, 10102, 10307, 10515,
+    10724, 10936, 11150, 11366, 11585, 11806, 12029, 12254,
+    12482, 12712, 12944, 13179, 13416, 13655, 13896, 14140,
+    14386, 14635, 14885, 15138, 15394, 15652, 15912, 16174,
+    16439, 16706, 16975, 17247, 17521, 17798, 18077, 18358,
+    18642, 18928, 19216, 19507, 19800, 20095, 20393, 20694,
+    20996, 21301, 21609, 21919, 22231, 22546, 22863, 23182,
+    23504, 23829, 24156, 24485, 24817, 25151, 25487, 25826,
+    26168, 26512, 26858, 27207, 27558, 27912, 28268, 28627,
+    28988, 29351, 29717, 30086, 30457, 30830, 31206, 31585,
+    31966, 32349, 32735, 33124, 33514, 33908, 34304, 34702,
+    35103, 35507, 35913, 36321, 36732, 37146, 37562, 37981,
+    38402, 38825, 39252, 39680, 40112, 40546, 40982, 41421,
+    41862, 42306, 42753, 43202, 43654, 44108, 44565, 45025,
+    45487, 45951, 46418, 46888, 47360, 47835, 48313, 48793,
+    49275, 49761, 50249, 50739, 51232, 51728, 52226, 52727,
+    53230, 53736, 54245, 54756, 55270, 55787, 56306, 56828,
+    57352, 57879, 58409, 58941, 59476, 60014, 60554, 61097,
+    61642, 62190, 62741, 63295, 63851, 64410, 64971, 65535,
+};
+
+// 呼吸波形 (一個週期): round((1 - cos(2 * pi * i / 256)) / 2 * 255)
+static const uint8_t led_wave_table[256] = {
+      0,   0,   0,   0,   1,   1,   1,   2,   2,   3,   4,   5,   5,   6,   7,   9,
+     10,  11,  12,  14,  15,  17,  18,  20,  21,  23,  25,  27,  29,  31,  33,  35,
+     37,  40,  42,  44,  47,  49,  52,  54,  57,  59,  62,  65,  67,  70,  73,  76,
+     79,  82,  85,  88,  90,  93,  97, 100, 103, 106, 109, 112, 115, 118, 121, 124,
+    127, 131, 134, 137, 140, 143, 146, 149, 152, 155, 158, 162, 165, 167, 170, 173,
+    176, 179, 182, 185, 188, 190, 193, 196, 198, 201, 203, 206, 208, 211, 213, 215,
+    218, 220, 222, 224, 226, 228, 230, 232, 234, 235, 237, 238, 240, 241, 243, 244,
+    245, 246, 248, 249, 250, 250, 251, 252, 253, 253, 254, 254, 254, 255, 255, 255,
+    255, 255, 255, 255, 254, 254, 254, 253, 253, 252, 251, 250, 250, 249, 248, 246,
+    245, 244, 243, 241, 240, 238, 237, 235, 234, 232, 230, 228, 226, 224, 222, 220,
+    218, 215, 213, 211, 208, 206, 203, 201, 198, 196, 193, 190, 188, 185, 182, 179,
+    176, 173, 170, 167, 165, 162, 158, 155, 152, 149, 146, 143, 140, 137, 134, 131,
+    128, 124, 121, 118, 115, 112, 109, 106, 103, 100,  97,  93,  90,  88,  85,  82,
+     79,  76,  73,  70,  67,  65,  62,  59,  57,  54,  52,  49,  47,  44,  42,  40,
+     37,  35,  33,  31,  29,  27,  25,  23,  21,  20,  18,  17,  15,  14,  12,  11,
+     10,   9,   7,   6,   5,   5,   4,   3,   2,   2,   1,   1,   1,   0,   0,   0,
+};
+
+// ========================================
+// 內部結構
+// ========================================
+
+#define LED_DUTY_UNSET UINT32_MAX
+
+struct led_controller {
+    char channel_dir[LED_CHANNEL_COUNT][PATH_MAX];
+    int duty_fd[LED_CHANNEL_COUNT];
+    uint32_t duty_written[LED_CHANNEL_COUNT];   // 上次寫入的 duty cycle
+    uint32_t period_ns;
+    uint32_t frame_ms;
+    bool fake_sysfs;
+
+    int timer_fd;
+    bool timer_armed;
+
+    led_effect_t effect;
+    led_color_t target;
+    led_color_t from;            // FADE 起始顏色
+    led_color_t current;         // 目前輸出 (gamma 前)
+    uint32_t effect_ms;
+    uint64_t start_ms;
+};
+
+// ========================================
+// 統計
+// ========================================
+
+static pthread_once_t led_metrics_once = PTHREAD_ONCE_INIT;
+static metrics_counter_t *metric_writes;
+static metrics_counter_t *metric_writes_skipped;
+static metrics_counter_t *metric_write_errors;
+
+static void led_metrics_register(void) {
+    metric_writes = metrics_counter_register("led.writes");
+    metric_writes_skipped = metrics_counter_register("led.writes.skipped");
+    metric_write_errors = metrics_counter_register("led.write.errors");
+}
+
+static inline void led_metrics_init(void) {
+    pthread_once(&led_metrics_once, led_metrics_register);
+}
+
+// ========================================
+// sysfs 存取
+// ========================================
+
+static uint64_t led_now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000ULL + (uint64_t)ts.tv_nsec / 1000000ULL;
+}
+
+static int led_write_attr(const char *dir, const char *name, unsigned long value, bool create) {
+    char path[PATH_MAX];
+    snprintf(path, sizeof(path), "%s/%s", dir, name);
+
+    int flags = O_WRONLY | O_CLOEXEC | (create ? (O_CREAT | O_TRUNC) : 0);
+    int fd = open(path, flags, 0644);
+    if (fd < 0) {
+        LOGM_ERRNO(LOG_MODULE_LED, path);
+        return GAMING_ERROR_IO;
+    }
+
+    char buf[24];
+    int len = snprintf(buf, sizeof(buf), "%lu\n", value);
+    ssize_t n = write(fd, buf, (size_t)len);
+    close(fd);
+
+    if (n != len) {
+        LOGM_ERRNO(LOG_MODULE_LED, path);
+        return GAMING_ERROR_IO;
+    }
+    return GAMING_OK;
+}
+
+/**
+ * @brief 匯出並啟用一個 PWM 通道,開啟 duty_cycle 供後續寫入
+ */
+static int led_channel_open(led_controller_t *led, int index, const char *root,
+                            unsigned int channel) {
+    char *dir = led->channel_dir[index];
+    snprintf(dir, PATH_MAX, "%s/pwm%u", root, channel);
+
+    if (led->fake_sysfs) {
+        if (mkdir(dir, 0755) < 0 && errno != EEXIST) {
+            LOGM_ERRNO(LOG_MODULE_LED, dir);
+            return GAMING_ERROR_IO;
+        }
+    } else if (access(dir, F_OK) < 0) {
+        if (led_write_attr(root, "export", channel, false) != GAMING_OK) {
+            return GAMING_ERROR_IO;
+        }
+    }
+
+    // duty 必須 <= period, 因此先歸零再設定週期
+    bool create = led->fake_sysfs;
+    if (led_write_attr(dir, "duty_cycle", 0, create) != GAMING_OK ||
+        led_write_attr(dir, "period", led->period_ns, create) != GAMING_OK ||
+        led_write_attr(dir, "enable", 1, create) != GAMING_OK) {
+        return GAMING_ERROR_IO;
+    }
+
+    char path[PATH_MAX];
+    snprintf(path, sizeof(path), "%s/duty_cycle", dir);
+    led->duty_fd[index] = open(path, O_WRONLY | O_CLOEXEC);
+    if (led->duty_fd[index] < 0) {
+        LOGM_ERRNO(LOG_MODULE_LED, path);
+        return GAMING_ERROR_IO;
+    }
+
+    led->duty_written[index] = 0;
+    return GAMING_OK;
+}
+
+/**
+ * @brief 寫入 duty cycle (與上次相同則略過)
+ */
+static int led_channel_write(led_controller_t *led, int index, uint8_t level) {
+    uint32_t duty = led_controller_duty(level, led->period_ns);
+    if (duty == led->duty_written[index]) {
+        metrics_counter_inc(metric_writes_skipped);
+        return GAMING_OK;
+    }
+
+    char buf[16];
+    int len = snprintf(buf, sizeof(buf), "%u\n", duty);
+    if (pwrite(led->duty_fd[index], buf, (size_t)len, 0) != len) {
+        LOGM_ERRNO(LOG_MODULE_LED, "pwrite(duty_cycle)");
+        metrics_counter_inc(metric_write_errors);
+        led->duty_written[index] = LED_DUTY_UNSET;
+        return GAMING_ERROR_IO;
+    }
+
+    // 一般檔案不會像 sysfs 屬性一樣整個取代內容
+    if (led->fake_sysfs && ftruncate(led->duty_fd[index], len) < 0) {
+        LOGM_ERRNO(LOG_MODULE_LED, "ftruncate");
+    }
+
+    metrics_counter_inc(metric_writes);
+    led->duty_written[index] = duty;
+    return GAMING_OK;
+}
+
+// ========================================
+// 動畫
+// ========================================
+
+static inline uint8_t led_scale(uint8_t value, uint8_t level) {
+    return (uint8_t)(((unsigned int)value * level + 127) / 255);
+}
+
+static inline uint8_t led_lerp(uint8_t from, uint8_t to, unsigned int t) {
+    return (uint8_t)((int)from + (((int)to - (int)from) * (int)t + 127) / 255);
+}
+
+static int led_arm_timer(led_controller_t *led, uint32_t delay_ms) {
+    if (delay_ms == 0 && !led->timer_armed) {
+        return GAMING_OK;
+    }
+
+    struct itimerspec its;
+    memset(&its, 0, sizeof(its));
+    its.it_value.tv_sec = delay_ms / 1000;
+    its.it_value.tv_nsec = (long)(delay_ms % 1000) * 1000000L;
+
+    if (timerfd_settime(led->timer_fd, 0, &its, NULL) < 0) {
+        LOGM_ERRNO(LOG_MODULE_LED, "timerfd_settime");
+        return GAMING_ERROR;
+    }
+
+    led->timer_armed = (delay_ms != 0);
+    return GAMING_OK;
+}
+
+/**
+ * @brief 計算目前畫面並寫入,回傳下一次更新的延遲 (0 表示不需要更新)
+ */
+static uint32_t led_render(led_controller_t *led, uint64_t now_ms, led_color_t *out) {
+    uint64_t elapsed = now_ms - led->start_ms;
+    uint32_t period = led->effect_ms;
+
+    switch (led->effect) {
+        case LED_EFFECT_SOLID:
+            *out = led->target;
+            return 0;
+
+        case LED_EFFECT_BLINK: {
+            uint32_t half = MAX(period / 2, 1);
+            uint64_t phase = elapsed % ((uint64_t)half * 2);
+            *out = (phase < half) ? led->target : LED_COLOR_BLACK;
+            // 只在亮暗切換時醒來
+            return half - (uint32_t)(phase % half);
+        }
+
+        case LED_EFFECT_BREATHE: {
+            unsigned int index = (unsigned int)((elapsed % period) * 256 / period);
+            uint8_t level = led_wave_table[index];
+            out->r = led_scale(led->target.r, level);
+            out->g = led_scale(led->target.g, level);
+            out->b = led_scale(led->target.b, level);
+            return led->frame_ms;
+        }
+
+        case LED_EFFECT_FADE: {
+            if (elapsed >= period) {
+                *out = led->target;
+                led->effect = LED_EFFECT_SOLID;
+                return 0;
+            }
+            unsigned int t = (unsigned int)(elapsed * 255 / period);
+            out->r = led_lerp(led->from.r, led->target.r, t);
+            out->g = led_lerp(led->from.g, led->target.g, t);
+            out->b = led_lerp(led->from.b, led->target.b, t);
+            return led->frame_ms;
+        }
+
+        case LED_EFFECT_OFF:
+        default:
+            *out = LED_COLOR_BLACK;
+            return 0;
+    }
+}
+
+static int led_update(led_controller_t *led) {
+    led_color_t color;
+    uint32_t next_ms = led_render(led, led_now_ms(), &color);
+
+    int ret = GAMING_OK;
+    if (led_channel_write(led, 0, color.r) != GAMING_OK) {
+        ret = GAMING_ERROR_IO;
+    }
+    if (led_channel_write(led, 1, color.g) != GAMING_OK) {
+        ret = GAMING_ERROR_IO;
+    }
+    if (led_channel_write(led, 2, color.b) != GAMING_OK) {
+        ret = GAMING_ERROR_IO;
+    }
+    led->current = color;
+
+    led_arm_timer(led, next_ms);
+    return ret;
+}
+
+// ========================================
+// 公開函數
+// ========================================
+
+uint32_t led_controller_duty(uint8_t level, uint32_t period_ns) {
+    return (uint32_t)(((uint64_t)period_ns * led_gamma_table[level]) / 65535U);
+}
+
+void led_controller_default_config(led_controller_config_t *config) {
+    if (config == NULL) {
+        return;
+    }
+
+    config->sysfs_root = LED_DEFAULT_SYSFS_ROOT;
+    config->channels[0] = 0;
+    config->channels[1] = 1;
+    config->channels[2] = 2;
+    config->period_ns = LED_DEFAULT_PERIOD_NS;
+    config->frame_ms = LED_DEFAULT_FRAME_MS;
+    config->fake_sysfs = false;
+}
+
+led_controller_t *led_controller_create(const led_controller_config_t *config) {
+    led_controller_config_t defaults;
+    if (config == NULL) {
+        led_controller_default_config(&defaults);
+        config = &defaults;
+    }
+
+    if (config->period_ns == 0 || config->frame_ms == 0) {
+        return NULL;
+    }
+
+    led_metrics_init();
+
+    led_controller_t *led = calloc(1, sizeof(*led));
+    if (led == NULL) {
+        return NULL;
+    }
+
+    led->period_ns = config->period_ns;
+    led->frame_ms = config->frame_ms;
+    led->fake_sysfs = config->fake_sysfs;
+    led->effect = LED_EFFECT_OFF;
+    led->timer_fd = -1;
+    for (int i = 0; i < LED_CHANNEL_COUNT; i++) {
+        led->duty_fd[i] = -1;
+    }
+
+    const char *root = (config->sysfs_root != NULL) ? config->sysfs_root : LED_DEFAULT_SYSFS_ROOT;
+    for (int i = 0; i < LED_CHANNEL_COUNT; i++) {
+        if (led_channel_open(led, i, root, config->channels[i]) != GAMING_OK) {
+            goto fail;
+        }
+    }
+
+    led->timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (led->timer_fd < 0) {
+        LOGM_ERRNO(LOG_MODULE_LED, "timerfd_create");
+        goto fail;
+    }
+
+    return led;
+
+fail:
+    led_controller_destroy(led);
+    return NULL;
+}
+
+void led_controller_destroy(led_controller_t *led) {
+    if (led == NULL) {
+        return;
+    }
+
+    for (int i = 0; i < LED_CHANNEL_COUNT; i++) {
+        if (led->duty_fd[i] >= 0) {
+            led_channel_write(led, i, 0);
+            close(led->duty_fd[i]);
+        }
+    }
+
+    if (led->timer_fd >= 0) {
+        close(led->timer_fd);
+    }
+    free(led);
+}
+
+int led_controller_get_fd(const led_controller_t *led) {
+    if (led == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+    return led->timer_fd;
+}
+
+int led_controller_process(led_controller_t *led) {
+    if (led == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    uint64_t expirations;
+    if (read(led->timer_fd, &expirations, sizeof(expirations)) < 0 && errno != EAGAIN) {
+        LOGM_ERRNO(LOG_MODULE_LED, "read(timerfd)");
+        return GAMING_ERROR_IO;
+    }
+
+    led->timer_armed = false;
+    return led_update(led);
+}
+
+int led_controller_set(led_controller_t *led, led_color_t color,
+                       led_effect_t effect, uint32_t period_ms) {
+    if (led == NULL || effect < LED_EFFECT_OFF || effect > LED_EFFECT_FADE) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    led->from = led->current;
+    led->target = color;
+    led->effect = effect;
+    led->effect_ms = (period_ms > 0) ? period_ms : LED_DEFAULT_EFFECT_MS;
+    led->start_ms = led_now_ms();
+
+    return led_update(led);
+}
+
+int led_controller_apply(led_controller_t *led, const gaming_msg_led_command_t *msg) {
+    if (msg == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    led_color_t color = { msg->r, msg->g, msg->b };
+    return led_controller_set(led, color, (led_effect_t)msg->effect, msg->period_ms);
+}
+
+int led_controller_get_color(const led_controller_t *led, led_color_t *color) {
+    if (led == NULL || color == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    *color = led->current;
+    return GAMING_OK;
+}
@@ -0,0 +1,145 @@
+/**
+ * @file led_controller.h
+ * @brief RGB LED 控制器 (PWM)
+ * @version 1.0.0
+ *
+ * 透過 sysfs PWM (/sys/class/pwm/pwmchipN) 設定 R/G/B 三個通道的 duty cycle
+ * 支援 solid / blink / breathe / fade 效果:
+ * - 亮度經由預先計算的 gamma 查表轉為 duty cycle,執行期不做浮點運算
+ * - 所有動畫由單一 timerfd 驅動,靜態顏色時計時器停止,閒置時不耗 CPU
+ * - duty cycle 與上次寫入相同時不會寫入 sysfs
+ *
+ * 測試時可將 sysfs_root 指向暫存目錄並開啟 fake_sysfs,
+ * 控制器會自行建立 pwmN/ 目錄與屬性檔案
+ */
+
+#ifndef LED_CONTROLLER_H
+#define LED_CONTROLLER_H
+
+#include "gaming_common.h"
+#include "gaming_protocol.h"
+
+// ========================================
+// LED 配置
+// ========================================
+
+#define LED_DEFAULT_SYSFS_ROOT   "/sys/class/pwm/pwmchip0"
+#define LED_DEFAULT_PERIOD_NS    1000000     // 1 kHz PWM
+#define LED_DEFAULT_FRAME_MS     20          // 動畫更新間隔 (50 fps)
+#define LED_DEFAULT_EFFECT_MS    2000        // 未指定時的效果週期
+
+#define LED_CHANNEL_COUNT        3
+
+// ========================================
+// LED 型別定義
+// ========================================
+
+typedef struct led_controller led_controller_t;
+
+/**
+ * @brief LED 控制器設定
+ */
+typedef struct {
+    const char *sysfs_root;                  ///< pwmchip 目錄, NULL 使用 LED_DEFAULT_SYSFS_ROOT
+    unsigned int channels[LED_CHANNEL_COUNT]; ///< R/G/B 對應的 PWM 通道
+    uint32_t period_ns;                      ///< PWM 週期
+    uint32_t frame_ms;                       ///< 動畫更新間隔
+    bool fake_sysfs;                         ///< 測試用: 自行建立屬性檔案而非 export
+} led_controller_config_t;
+
+// ========================================
+// LED 公開函數
+// ========================================
+
+/**
+ * @brief 取得預設設定 (通道 0/1/2, 1 kHz)
+ *
+ * @param config 輸出設定
+ */
+void led_controller_default_config(led_controller_config_t *config);
+
+/**
+ * @brief 建立 LED 控制器
+ *
+ * 匯出並啟用三個 PWM 通道,初始為熄滅
+ *
+ * @param config 設定, NULL 使用預設值
+ * @return 控制器指標, NULL 失敗
+ */
+led_controller_t *led_controller_create(const led_controller_config_t *config);
+
+/**
+ * @brief 熄滅 LED 並銷毀控制器
+ *
+ * @param led 控制器指標
+ */
+void led_controller_destroy(led_controller_t *led);
+
+/**
+ * @brief 取得動畫計時器 fd
+ *
+ * 加入呼叫端的事件迴圈 (EPOLLIN),可讀時呼叫 led_controller_process()
+ *
+ * @param led 控制器指標
+ * @return >= 0 timerfd
+ * @return < 0 參數錯誤
+ */
+int led_controller_get_fd(const led_controller_t *led);
+
+/**
+ * @brief 推進動畫並更新輸出 (不阻塞)
+ *
+ * @param led 控制器指標
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR_IO sysfs 寫入失敗
+ */
+int led_controller_process(led_controller_t *led);
+
+/**
+ * @brief 設定顏色與效果
+ *
+ * - SOLID: 立即顯示 color
+ * - BLINK: 每個 period_ms 週期亮暗各一半
+ * - BREATHE: 以 period_ms 為週期漸亮漸暗
+ * - FADE: 在 period_ms 內由目前顏色漸變到 color,之後保持
+ * - OFF: 熄滅
+ *
+ * @param led 控制器指標
+ * @param color 顏色
+ * @param effect 效果
+ * @param period_ms 效果週期, 0 使用 LED_DEFAULT_EFFECT_MS
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR_INVALID_PARAM 參數錯誤
+ * @return GAMING_ERROR_IO sysfs 寫入失敗
+ */
+int led_controller_set(led_controller_t *led, led_color_t color,
+                       led_effect_t effect, uint32_t period_ms);
+
+/**
+ * @brief 套用 GAMING_MSG_LED_COMMAND 訊息
+ *
+ * @param led 控制器指標
+ * @param msg 已解碼的 LED 指令
+ * @return 同 led_controller_set()
+ */
+int led_controller_apply(led_controller_t *led, const gaming_msg_led_command_t *msg);
+
+/**
+ * @brief 取得目前輸出的顏色 (gamma 校正前)
+ *
+ * @param led 控制器指標
+ * @param color 輸出顏色
+ * @return GAMING_OK 成功
+ */
+int led_controller_get_color(const led_controller_t *led, led_color_t *color);
+
+/**
+ * @brief 將 0-255 亮度經 gamma 校正轉為 duty cycle
+ *
+ * @param level 亮度
+ * @param period_ns PWM 週期
+ * @return duty cycle (ns)
+ */
+uint32_t led_controller_duty(uint8_t level, uint32_t period_ns);
+
+#endif // LED_CONTROLLER_H
@@ -7,10 +7,18 @@
 #define _GNU_SOURCE  // 需要這個才能使用 vsyslog
 
 #include "logger.h"
+#include "metrics.h"
+#include "trace.h"
 #include <stdarg.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <strings.h>
 #include <time.h>
+#include <pthread.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <unistd.h>
 
 // ========================================
 // 私有變數
@@ -18,13 +26,231 @@
 
 static bool logger_initialized = false;
 static char logger_ident[64] = "gaming";
-static log_level_t current_log_level = LOG_LEVEL_INFO;
 static log_target_t current_log_target = LOG_TARGET_CONSOLE;
 
+// 各模組等級 (LOG_LEVEL_OFF 表示關閉), 修改時持有 logger_config_lock
+static int module_levels[LOG_MODULE_COUNT] = {
+    [0 ... LOG_MODULE_COUNT - 1] = LOG_LEVEL_INFO,
+};
+static pthread_mutex_t logger_config_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static const char *const module_names[LOG_MODULE_COUNT] = {
+    [LOG_MODULE_DEFAULT] = "default",
+    [LOG_MODULE_SOCKET]  = "socket",
+    [LOG_MODULE_CONFIG]  = "config",
+    [LOG_MODULE_GPIO]    = "gpio",
+    [LOG_MODULE_LED]     = "led",
+    [LOG_MODULE_PS5]     = "ps5",
+    [LOG_MODULE_VPN]     = "vpn",
+    [LOG_MODULE_CEC]     = "cec",
+    [LOG_MODULE_RELAY]   = "relay",
+    [LOG_MODULE_UBUS]    = "ubus",
+};
+
+// 初始化前 WARN / ERROR 輸出到 stderr (見 logger_vlog)
+#define LOGGER_ALL_MODULES ((1U << LOG_MODULE_COUNT) - 1)
+uint32_t logger_enabled_mask[LOG_LEVEL_ERROR + 1] = {
+    [LOG_LEVEL_WARN] = LOGGER_ALL_MODULES,
+    [LOG_LEVEL_ERROR] = LOGGER_ALL_MODULES,
+};
+
+// ========================================
+// Flight Recorder
+// ========================================
+
+typedef struct {
+    uint64_t sequence;           // 寫入完成後為 index + 1, 寫入中為 0
+    uint64_t time_ns;            // CLOCK_REALTIME
+    uint8_t module;
+    uint8_t level;
+    uint16_t len;
+    char text[LOGGER_FLIGHT_LINE_SIZE];
+} flight_entry_t;
+
+static flight_entry_t *flight_ring;
+static uint64_t flight_head;
+static bool flight_enabled = false;
+
+static const int flight_signals[] = { SIGSEGV, SIGBUS, SIGILL, SIGFPE, SIGABRT };
+static struct sigaction flight_old_actions[ARRAY_SIZE(flight_signals)];
+
+// 堆疊溢位造成的 SIGSEGV 無法在原堆疊上執行處理函數
+#define LOGGER_FLIGHT_ALTSTACK_SIZE  65536
+static void *flight_altstack;
+
+// ========================================
+// 統計
+// ========================================
+
+static pthread_once_t logger_metrics_once = PTHREAD_ONCE_INIT;
+static metrics_counter_t *metric_lines_emitted;
+static metrics_counter_t *metric_lines_filtered;
+static metrics_counter_t *metric_write_errors;
+
+static void logger_metrics_register(void) {
+    metric_lines_emitted = metrics_counter_register("logger.lines.emitted");
+    metric_lines_filtered = metrics_counter_register("logger.lines.filtered");
+    metric_write_errors = metrics_counter_register("logger.write.errors");
+}
+
+static inline void logger_metrics_init(void) {
+    pthread_once(&logger_metrics_once, logger_metrics_register);
+}
+
 // ========================================
 // 私有函數
 // ========================================
 
+/**
+ * @brief 檢查是否為可輸出的日誌等級
+ *
+ * 列舉由詳細到嚴重遞增 (DEBUG=0 ... ERROR=3),下限為 DEBUG、上限為 ERROR;
+ * 反過來比較會拒絕所有等級,使 logger_init 永遠失敗
+ */
+static inline bool level_valid(log_level_t level) {
+    return level >= LOG_LEVEL_DEBUG && level <= LOG_LEVEL_ERROR;
+}
+
+/**
+ * @brief 依 module_levels 重建 logger_enabled_mask (未初始化時只開 WARN / ERROR)
+ */
+static void rebuild_enabled_mask(void) {
+    for (int level = LOG_LEVEL_DEBUG; level <= LOG_LEVEL_ERROR; level++) {
+        uint32_t mask = 0;
+        if (__atomic_load_n(&flight_enabled, __ATOMIC_RELAXED)) {
+            // flight recorder 要收集所有等級, 實際輸出由 logger_vlog 判斷
+            mask = LOGGER_ALL_MODULES;
+        } else if (logger_initialized) {
+            for (int module = 0; module < LOG_MODULE_COUNT; module++) {
+                if (level >= module_levels[module]) {
+                    mask |= 1U << module;
+                }
+            }
+        } else if (level >= LOG_LEVEL_WARN) {
+            mask = LOGGER_ALL_MODULES;
+        }
+        __atomic_store_n(&logger_enabled_mask[level], mask, __ATOMIC_RELAXED);
+    }
+}
+
+/**
+ * @brief 解析等級字串 (名稱或數值 0-3, 即 log_level_t)
+ *
+ * @return 等級, -1 無法辨識
+ */
+static int parse_level(const char *str) {
+    // 舊設定以整數存放 UCI log_level
+    if (str[0] >= '0' && str[0] <= '0' + LOG_LEVEL_ERROR && str[1] == '\0') {
+        return str[0] - '0';
+    } else if (strcasecmp(str, "debug") == 0) {
+        return LOG_LEVEL_DEBUG;
+    } else if (strcasecmp(str, "info") == 0) {
+        return LOG_LEVEL_INFO;
+    } else if (strcasecmp(str, "warn") == 0 || strcasecmp(str, "warning") == 0) {
+        return LOG_LEVEL_WARN;
+    } else if (strcasecmp(str, "error") == 0) {
+        return LOG_LEVEL_ERROR;
+    } else if (strcasecmp(str, "off") == 0) {
+        return LOG_LEVEL_OFF;
+    }
+    return -1;
+}
+
+/**
+ * @brief 寫入一行到 flight recorder (不輸出)
+ */
+static void flight_record(log_module_t module, log_level_t level, const char *fmt, va_list args) {
+    uint64_t index = __atomic_fetch_add(&flight_head, 1, __ATOMIC_RELAXED);
+    flight_entry_t *entry = &flight_ring[index & (LOGGER_FLIGHT_ENTRIES - 1)];
+
+    __atomic_store_n(&entry->sequence, 0, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    entry->time_ns = (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+    entry->module = (uint8_t)module;
+    entry->level = (uint8_t)level;
+
+    int len = vsnprintf(entry->text, sizeof(entry->text), fmt, args);
+    entry->len = (uint16_t)((len < 0) ? 0 : MIN((size_t)len, sizeof(entry->text) - 1));
+
+    __atomic_store_n(&entry->sequence, index + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief 附加字串 (async-signal-safe)
+ */
+static size_t flight_append(char *buffer, size_t pos, size_t size, const char *str, size_t len) {
+    if (pos + len > size) {
+        len = size - pos;
+    }
+    memcpy(buffer + pos, str, len);
+    return pos + len;
+}
+
+/**
+ * @brief 附加十進位數字, width 不足補 0 (async-signal-safe)
+ */
+static size_t flight_append_uint(char *buffer, size_t pos, size_t size, uint64_t value,
+                                 int width) {
+    char digits[20];
+    int n = 0;
+    do {
+        digits[n++] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value > 0 && n < (int)sizeof(digits));
+    while (n < width && n < (int)sizeof(digits)) {
+        digits[n++] = '0';
+    }
+
+    while (n > 0 && pos < size) {
+        buffer[pos++] = digits[--n];
+    }
+    return pos;
+}
+
+static void flight_signal_handler(int signo) {
+    logger_flight_recorder_dump(NULL);
+
+    // 交回原本的處理方式後重新觸發
+    for (size_t i = 0; i < ARRAY_SIZE(flight_signals); i++) {
+        if (flight_signals[i] == signo) {
+            sigaction(signo, &flight_old_actions[i], NULL);
+            break;
+        }
+    }
+    raise(signo);
+}
+
+/**
+ * @brief 為呼叫的執行緒設定備用訊號堆疊
+ *
+ * 已有備用堆疊 (例如應用程式自行設定) 時不取代;配置失敗時處理函數
+ * 仍在原堆疊上執行,只是堆疊溢位時無法寫出
+ */
+static void flight_install_altstack(void) {
+    stack_t current;
+    if (sigaltstack(NULL, &current) == 0 && !(current.ss_flags & SS_DISABLE)) {
+        return;
+    }
+
+    flight_altstack = malloc(LOGGER_FLIGHT_ALTSTACK_SIZE);
+    if (flight_altstack == NULL) {
+        return;
+    }
+
+    stack_t ss = {
+        .ss_sp = flight_altstack,
+        .ss_size = LOGGER_FLIGHT_ALTSTACK_SIZE,
+        .ss_flags = 0,
+    };
+    if (sigaltstack(&ss, NULL) < 0) {
+        free(flight_altstack);
+        flight_altstack = NULL;
+    }
+}
+
 /**
  * @brief 將 log_level_t 轉換為 syslog priority
  */
@@ -55,23 +281,85 @@ static void get_timestamp(char *buffer, size_t size) {
 /**
  * @brief 輸出日誌到 console
  */
-static void log_to_console(log_level_t level, const char *fmt, va_list args) {
+static int log_to_console(log_module_t module, log_level_t level, const char *fmt, va_list args) {
     char timestamp[32];
     get_timestamp(timestamp, sizeof(timestamp));
     
     const char *level_str = logger_level_string(level);
+    int ret = (module == LOG_MODULE_DEFAULT)
+        ? fprintf(stderr, "[%s] [%s] ", timestamp, level_str)
+        : fprintf(stderr, "[%s] [%s] [%s] ", timestamp, level_str, module_names[module]);
     
-    fprintf(stderr, "[%s] [%s] ", timestamp, level_str);
-    vfprintf(stderr, fmt, args);
-    fprintf(stderr, "\n");
+    if (ret < 0 ||
+        vfprintf(stderr, fmt, args) < 0 ||
+        fprintf(stderr, "\n") < 0) {
+        return GAMING_ERROR_IO;
+    }
+    return GAMING_OK;
 }
 
 /**
  * @brief 輸出日誌到 syslog
  */
-static void log_to_syslog(log_level_t level, const char *fmt, va_list args) {
+static void log_to_syslog(log_module_t module, log_level_t level, const char *fmt, va_list args) {
     int priority = log_level_to_syslog_priority(level);
-    vsyslog(priority, fmt, args);
+    if (module == LOG_MODULE_DEFAULT) {
+        vsyslog(priority, fmt, args);
+        return;
+    }
+
+    char message[512];
+    vsnprintf(message, sizeof(message), fmt, args);
+    syslog(priority, "[%s] %s", module_names[module], message);
+}
+
+/**
+ * @brief 依目前輸出目標輸出一行日誌
+ */
+static void logger_vlog(log_module_t module, log_level_t level, const char *fmt, va_list args) {
+    logger_metrics_init();
+
+    if (!level_valid(level)) {
+        metrics_counter_inc(metric_lines_filtered);
+        return;
+    }
+
+    if (__atomic_load_n(&flight_enabled, __ATOMIC_RELAXED)) {
+        va_list copy;
+        va_copy(copy, args);
+        flight_record(module, level, fmt, copy);
+        va_end(copy);
+    }
+
+    // 初始化前只輸出 WARN / ERROR 到 stderr, 函式庫的錯誤訊息不會因為
+    // 呼叫端沒有初始化 logger 而消失
+    int threshold = logger_initialized ? module_levels[module] : LOG_LEVEL_WARN;
+    log_target_t target = logger_initialized ? current_log_target : LOG_TARGET_CONSOLE;
+    if ((int)level < threshold) {
+        metrics_counter_inc(metric_lines_filtered);
+        return;
+    }
+
+    TRACE_SCOPE("logger.write");
+    va_list copy;
+
+    // 輸出到 console
+    if (target == LOG_TARGET_CONSOLE || target == LOG_TARGET_BOTH) {
+        va_copy(copy, args);
+        if (log_to_console(module, level, fmt, copy) < 0) {
+            metrics_counter_inc(metric_write_errors);
+        }
+        va_end(copy);
+    }
+
+    // 輸出到 syslog
+    if (target == LOG_TARGET_SYSLOG || target == LOG_TARGET_BOTH) {
+        va_copy(copy, args);
+        log_to_syslog(module, level, fmt, copy);
+        va_end(copy);
+    }
+
+    metrics_counter_inc(metric_lines_emitted);
 }
 
 // ========================================
@@ -80,7 +368,7 @@ static void log_to_syslog(log_level_t level, const char *fmt, va_list args) {
 
 int logger_init(const char *ident, log_level_t level, log_target_t target) {
     // 驗證參數
-    if (level < LOG_LEVEL_ERROR || level > LOG_LEVEL_DEBUG) {
+    if (!level_valid(level)) {
         return GAMING_ERROR_INVALID_PARAM;
     }
     
@@ -97,7 +385,10 @@ int logger_init(const char *ident, log_level_t level, log_target_t target) {
     }
     
     // 設定日誌等級和目標
-    current_log_level = level;
+    pthread_mutex_lock(&logger_config_lock);
+    for (int module = 0; module < LOG_MODULE_COUNT; module++) {
+        module_levels[module] = level;
+    }
     current_log_target = target;
     
     // 如果需要 syslog,開啟它
@@ -106,6 +397,8 @@ int logger_init(const char *ident, log_level_t level, log_target_t target) {
     }
     
     logger_initialized = true;
+    rebuild_enabled_mask();
+    pthread_mutex_unlock(&logger_config_lock);
     
     return GAMING_OK;
 }
@@ -121,20 +414,118 @@ void logger_cleanup(void) {
         closelog();
     }
     
+    pthread_mutex_lock(&logger_config_lock);
     logger_initialized = false;
+    rebuild_enabled_mask();
+    pthread_mutex_unlock(&logger_config_lock);
 }
 
 int logger_set_level(log_level_t level) {
-    if (level < LOG_LEVEL_ERROR || level > LOG_LEVEL_DEBUG) {
+    if (!level_valid(level)) {
         return GAMING_ERROR_INVALID_PARAM;
     }
     
-    current_log_level = level;
+    pthread_mutex_lock(&logger_config_lock);
+    for (int module = 0; module < LOG_MODULE_COUNT; module++) {
+        module_levels[module] = level;
+    }
+    rebuild_enabled_mask();
+    pthread_mutex_unlock(&logger_config_lock);
     return GAMING_OK;
 }
 
 log_level_t logger_get_level(void) {
-    return current_log_level;
+    int level = module_levels[LOG_MODULE_DEFAULT];
+    return (level > LOG_LEVEL_ERROR) ? LOG_LEVEL_ERROR : (log_level_t)level;
+}
+
+int logger_set_module_level(log_module_t module, int level) {
+    if (module < 0 || module >= LOG_MODULE_COUNT ||
+        level < LOG_LEVEL_DEBUG || level > LOG_LEVEL_OFF) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    pthread_mutex_lock(&logger_config_lock);
+    module_levels[module] = level;
+    rebuild_enabled_mask();
+    pthread_mutex_unlock(&logger_config_lock);
+    return GAMING_OK;
+}
+
+int logger_get_module_level(log_module_t module) {
+    if (module < 0 || module >= LOG_MODULE_COUNT) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+    return module_levels[module];
+}
+
+int logger_set_module_levels(const char *spec) {
+    if (spec == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    char buffer[256];
+    if (strlen(spec) >= sizeof(buffer)) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+    strcpy(buffer, spec);
+
+    // 先全部解析, 有錯誤就不套用
+    int levels[LOG_MODULE_COUNT];
+    memcpy(levels, module_levels, sizeof(levels));
+
+    char *saveptr = NULL;
+    for (char *item = strtok_r(buffer, ", \t\n", &saveptr); item != NULL;
+         item = strtok_r(NULL, ", \t\n", &saveptr)) {
+        char *eq = strchr(item, '=');
+        if (eq == NULL) {
+            return GAMING_ERROR_INVALID_PARAM;
+        }
+        *eq = '\0';
+
+        int level = parse_level(eq + 1);
+        if (level < 0) {
+            return GAMING_ERROR_INVALID_PARAM;
+        }
+
+        if (strcmp(item, "*") == 0) {
+            for (int module = 0; module < LOG_MODULE_COUNT; module++) {
+                levels[module] = level;
+            }
+        } else {
+            int module = logger_module_from_name(item);
+            if (module < 0) {
+                return GAMING_ERROR_INVALID_PARAM;
+            }
+            levels[module] = level;
+        }
+    }
+
+    pthread_mutex_lock(&logger_config_lock);
+    memcpy(module_levels, levels, sizeof(levels));
+    rebuild_enabled_mask();
+    pthread_mutex_unlock(&logger_config_lock);
+    return GAMING_OK;
+}
+
+const char *logger_module_name(log_module_t module) {
+    if (module < 0 || module >= LOG_MODULE_COUNT) {
+        return "unknown";
+    }
+    return module_names[module];
+}
+
+int logger_module_from_name(const char *name) {
+    if (name == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    for (int module = 0; module < LOG_MODULE_COUNT; module++) {
+        if (strcmp(module_names[module], name) == 0) {
+            return module;
+        }
+    }
+    return GAMING_ERROR_NOT_FOUND;
 }
 
 int logger_set_target(log_target_t target) {
@@ -164,126 +555,60 @@ log_target_t logger_get_target(void) {
 }
 
 bool logger_should_log(log_level_t level) {
-    if (!logger_initialized) {
+    if (!level_valid(level)) {
         return false;
     }
     
     // 等級數字越大,越詳細
     // ERROR=3, WARN=2, INFO=1, DEBUG=0
     // 如果設定為 INFO,則只輸出 ERROR, WARN, INFO
-    return (level >= current_log_level);
+    return logger_initialized && (int)level >= module_levels[LOG_MODULE_DEFAULT];
 }
 
 void logger_log(log_level_t level, const char *fmt, ...) {
-    if (!logger_initialized || !logger_should_log(level)) {
-        return;
-    }
-    
     va_list args;
-    
-    // 輸出到 console
-    if (current_log_target == LOG_TARGET_CONSOLE || 
-        current_log_target == LOG_TARGET_BOTH) {
-        va_start(args, fmt);
-        log_to_console(level, fmt, args);
-        va_end(args);
-    }
-    
-    // 輸出到 syslog
-    if (current_log_target == LOG_TARGET_SYSLOG || 
-        current_log_target == LOG_TARGET_BOTH) {
-        va_start(args, fmt);
-        log_to_syslog(level, fmt, args);
-        va_end(args);
+    va_start(args, fmt);
+    logger_vlog(LOG_MODULE_DEFAULT, level, fmt, args);
+    va_end(args);
+}
+
+void logger_module_log(log_module_t module, log_level_t level, const char *fmt, ...) {
+    if (module < 0 || module >= LOG_MODULE_COUNT) {
+        module = LOG_MODULE_DEFAULT;
     }
+
+    va_list args;
+    va_start(args, fmt);
+    logger_vlog(module, level, fmt, args);
+    va_end(args);
 }
 
 void logger_error(const char *fmt, ...) {
-    if (!logger_initialized || !logger_should_log(LOG_LEVEL_ERROR)) {
-        return;
-    }
-    
     va_list args;
-    
-    if (current_log_target == LOG_TARGET_CONSOLE || 
-        current_log_target == LOG_TARGET_BOTH) {
-        va_start(args, fmt);
-        log_to_console(LOG_LEVEL_ERROR, fmt, args);
-        va_end(args);
-    }
-    
-    if (current_log_target == LOG_TARGET_SYSLOG || 
-        current_log_target == LOG_TARGET_BOTH) {
-        va_start(args, fmt);
-        log_to_syslog(LOG_LEVEL_ERROR, fmt, args);
-        va_end(args);
-    }
+    va_start(args, fmt);
+    logger_vlog(LOG_MODULE_DEFAULT, LOG_LEVEL_ERROR, fmt, args);
+    va_end(args);
 }
 
 void logger_warning(const char *fmt, ...) {
-    if (!logger_initialized || !logger_should_log(LOG_LEVEL_WARN)) {  // ← 使用 LOG_LEVEL_WARN
-        return;
-    }
-    
     va_list args;
-    
-    if (current_log_target == LOG_TARGET_CONSOLE || 
-        current_log_target == LOG_TARGET_BOTH) {
-        va_start(args, fmt);
-        log_to_console(LOG_LEVEL_WARN, fmt, args);  // ← 使用 LOG_LEVEL_WARN
-        va_end(args);
-    }
-    
-    if (current_log_target == LOG_TARGET_SYSLOG || 
-        current_log_target == LOG_TARGET_BOTH) {
-        va_start(args, fmt);
-        log_to_syslog(LOG_LEVEL_WARN, fmt, args);  // ← 使用 LOG_LEVEL_WARN
-        va_end(args);
-    }
+    va_start(args, fmt);
+    logger_vlog(LOG_MODULE_DEFAULT, LOG_LEVEL_WARN, fmt, args);  // ← 使用 LOG_LEVEL_WARN
+    va_end(args);
 }
 
 void logger_info(const char *fmt, ...) {
-    if (!logger_initialized || !logger_should_log(LOG_LEVEL_INFO)) {
-        return;
-    }
-    
     va_list args;
-    
-    if (current_log_target == LOG_TARGET_CONSOLE || 
-        current_log_target == LOG_TARGET_BOTH) {
-        va_start(args, fmt);
-        log_to_console(LOG_LEVEL_INFO, fmt, args);
-        va_end(args);
-    }
-    
-    if (current_log_target == LOG_TARGET_SYSLOG || 
-        current_log_target == LOG_TARGET_BOTH) {
-        va_start(args, fmt);
-        log_to_syslog(LOG_LEVEL_INFO, fmt, args);
-        va_end(args);
-    }
+    va_start(args, fmt);
+    logger_vlog(LOG_MODULE_DEFAULT, LOG_LEVEL_INFO, fmt, args);
+    va_end(args);
 }
 
 void logger_debug(const char *fmt, ...) {
-    if (!logger_initialized || !logger_should_log(LOG_LEVEL_DEBUG)) {
-        return;
-    }
-    
     va_list args;
-    
-    if (current_log_target == LOG_TARGET_CONSOLE || 
-        current_log_target == LOG_TARGET_BOTH) {
-        va_start(args, fmt);
-        log_to_console(LOG_LEVEL_DEBUG, fmt, args);
-        va_end(args);
-    }
-    
-    if (current_log_target == LOG_TARGET_SYSLOG || 
-        current_log_target == LOG_TARGET_BOTH) {
-        va_start(args, fmt);
-        log_to_syslog(LOG_LEVEL_DEBUG, fmt, args);
-        va_end(args);
-    }
+    va_start(args, fmt);
+    logger_vlog(LOG_MODULE_DEFAULT, LOG_LEVEL_DEBUG, fmt, args);
+    va_end(args);
 }
 
 const char* logger_level_string(log_level_t level) {
@@ -306,4 +631,96 @@ void logger_flush(void) {
     fflush(stderr);
     
     // syslog 不需要手動刷新
+
+    if (__atomic_load_n(&flight_enabled, __ATOMIC_RELAXED)) {
+        logger_flight_recorder_dump(NULL);
+    }
+}
+
+int logger_flight_recorder_enable(bool enable) {
+    pthread_mutex_lock(&logger_config_lock);
+
+    if (enable && flight_ring == NULL) {
+        flight_ring = calloc(LOGGER_FLIGHT_ENTRIES, sizeof(flight_entry_t));
+        if (flight_ring == NULL) {
+            pthread_mutex_unlock(&logger_config_lock);
+            return GAMING_ERROR_NO_MEMORY;
+        }
+
+        flight_install_altstack();
+
+        struct sigaction sa;
+        memset(&sa, 0, sizeof(sa));
+        sa.sa_handler = flight_signal_handler;
+        sa.sa_flags = SA_ONSTACK;
+        sigemptyset(&sa.sa_mask);
+        for (size_t i = 0; i < ARRAY_SIZE(flight_signals); i++) {
+            sigaction(flight_signals[i], &sa, &flight_old_actions[i]);
+        }
+    }
+
+    __atomic_store_n(&flight_enabled, enable, __ATOMIC_RELAXED);
+    rebuild_enabled_mask();
+    pthread_mutex_unlock(&logger_config_lock);
+    return GAMING_OK;
+}
+
+int logger_flight_recorder_dump(const char *path) {
+    if (flight_ring == NULL) {
+        return GAMING_ERROR_NOT_INITIALIZED;
+    }
+
+    int fd = open((path != NULL) ? path : LOGGER_FLIGHT_DUMP_PATH,
+                  O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        return GAMING_ERROR_IO;
+    }
+
+    uint64_t head = __atomic_load_n(&flight_head, __ATOMIC_ACQUIRE);
+    uint64_t first = (head > LOGGER_FLIGHT_ENTRIES) ? head - LOGGER_FLIGHT_ENTRIES : 0;
+    int lines = 0;
+    char line[LOGGER_FLIGHT_LINE_SIZE + 64];
+    flight_entry_t copy;
+
+    for (uint64_t index = first; index < head; index++) {
+        const flight_entry_t *slot = &flight_ring[index & (LOGGER_FLIGHT_ENTRIES - 1)];
+        if (__atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE) != index + 1) {
+            continue;    // 寫入中或已被覆寫
+        }
+
+        // 先複製再確認 sequence 未變, 複製期間被覆寫的項目略過
+        memcpy(&copy, slot, sizeof(copy));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&slot->sequence, __ATOMIC_RELAXED) != index + 1) {
+            continue;
+        }
+        const flight_entry_t *entry = &copy;
+
+        // "[sec.usec] [LEVEL] [module] text\n"
+        const char *level = logger_level_string((log_level_t)entry->level);
+        const char *module = (entry->module < LOG_MODULE_COUNT) ? module_names[entry->module]
+                                                                : "unknown";
+        size_t pos = flight_append(line, 0, sizeof(line), "[", 1);
+        pos = flight_append_uint(line, pos, sizeof(line), entry->time_ns / 1000000000ULL, 1);
+        pos = flight_append(line, pos, sizeof(line), ".", 1);
+        pos = flight_append_uint(line, pos, sizeof(line),
+                                 (entry->time_ns % 1000000000ULL) / 1000, 6);
+        pos = flight_append(line, pos, sizeof(line), "] [", 3);
+        pos = flight_append(line, pos, sizeof(line), level, strlen(level));
+        pos = flight_append(line, pos, sizeof(line), "] [", 3);
+        pos = flight_append(line, pos, sizeof(line), module, strlen(module));
+        pos = flight_append(line, pos, sizeof(line), "] ", 2);
+        pos = flight_append(line, pos, sizeof(line), entry->text,
+                            MIN((size_t)entry->len, sizeof(entry->text) - 1));
+        pos = flight_append(line, pos, sizeof(line), "\n", 1);
+
+        if (write(fd, line, pos) != (ssize_t)pos) {
+            close(fd);
+            return GAMING_ERROR_IO;
+        }
+        lines++;
+    }
+
+    close(fd);
+    return lines;
 }
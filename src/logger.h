@@ -4,14 +4,26 @@
  * @version 1.0.0
  * 
  * 提供統一的日誌系統,支援輸出到 syslog 和 console
+ *
+ * 每個模組 (socket, config, gpio, ...) 有獨立的日誌等級,
+ * LOGM_* 巨集以 inline bitmask 判斷,關閉的模組只花一次讀取與分支,
+ * 連參數都不會求值;原有的 logger_* 函數對應到 LOG_MODULE_DEFAULT
+ * logger_init() 之前 WARN / ERROR 仍會輸出到 stderr,其餘等級不輸出
+ *
+ * Flight recorder 開啟時,所有等級的日誌都會寫入記憶體環形緩衝區 (不輸出),
+ * 在致命訊號、logger_flush() 或 logger_flight_recorder_dump() 時寫到
+ * LOGGER_FLIGHT_DUMP_PATH,平時以 INFO 運作也能在當機後取得 DEBUG 細節
  */
 
 #ifndef LOGGER_H
 #define LOGGER_H
 
 #include "gaming_common.h"
+#include <errno.h>
+#include <string.h>
 #include <syslog.h>
 #include <stdbool.h>
+#include <stdint.h>
 
 // ========================================
 // 日誌目標定義
@@ -23,6 +35,70 @@ typedef enum {
     LOG_TARGET_BOTH = 2,     ///< 同時輸出到 syslog 和 console
 } log_target_t;
 
+// ========================================
+// Flight Recorder 配置
+// ========================================
+
+#define LOGGER_FLIGHT_ENTRIES    1024   // 必須是 2 的次方
+#define LOGGER_FLIGHT_LINE_SIZE  160
+#define LOGGER_FLIGHT_DUMP_PATH  PATH_RUN_DIR "/gaming_flight.log"
+
+// ========================================
+// 日誌模組定義
+// ========================================
+
+typedef enum {
+    LOG_MODULE_DEFAULT = 0,  ///< 未指定模組 (logger_* 函數)
+    LOG_MODULE_SOCKET,
+    LOG_MODULE_CONFIG,
+    LOG_MODULE_GPIO,
+    LOG_MODULE_LED,
+    LOG_MODULE_PS5,
+    LOG_MODULE_VPN,
+    LOG_MODULE_CEC,
+    LOG_MODULE_RELAY,
+    LOG_MODULE_UBUS,
+    LOG_MODULE_COUNT,
+} log_module_t;
+
+// 模組等級設為此值表示完全關閉
+#define LOG_LEVEL_OFF (LOG_LEVEL_ERROR + 1)
+
+/**
+ * @brief 各等級啟用的模組位元遮罩
+ *
+ * logger_enabled_mask[level] 的第 m 個位元代表模組 m 會輸出此等級的日誌
+ * 未初始化時只有 WARN / ERROR 開啟;只能經由 logger_set_*level* 修改
+ */
+extern uint32_t logger_enabled_mask[LOG_LEVEL_ERROR + 1];
+
+/**
+ * @brief 判斷模組是否輸出指定等級 (inline fast path)
+ */
+static inline bool logger_module_enabled(log_module_t module, log_level_t level) {
+    return (__atomic_load_n(&logger_enabled_mask[level], __ATOMIC_RELAXED) >> module) & 1U;
+}
+
+/**
+ * @brief 依模組輸出日誌 (關閉時不會求值參數)
+ */
+#define LOGM(module, level, ...) \
+    do { \
+        if (logger_module_enabled((module), (level))) { \
+            logger_module_log((module), (level), __VA_ARGS__); \
+        } \
+    } while (0)
+
+#define LOGM_ERROR(module, ...) LOGM((module), LOG_LEVEL_ERROR, __VA_ARGS__)
+#define LOGM_WARN(module, ...)  LOGM((module), LOG_LEVEL_WARN, __VA_ARGS__)
+#define LOGM_INFO(module, ...)  LOGM((module), LOG_LEVEL_INFO, __VA_ARGS__)
+#define LOGM_DEBUG(module, ...) LOGM((module), LOG_LEVEL_DEBUG, __VA_ARGS__)
+
+/**
+ * @brief 以 ERROR 等級輸出系統呼叫失敗 (取代 perror, 格式 "<what>: <strerror(errno)>")
+ */
+#define LOGM_ERRNO(module, what) LOGM_ERROR((module), "%s: %s", (what), strerror(errno))
+
 // ========================================
 // 初始化與清理
 // ========================================
@@ -51,6 +127,8 @@ void logger_cleanup(void);
 /**
  * @brief 設定日誌等級
  * 
+ * 套用到所有模組;之後可再以 logger_set_module_level() 個別調整
+ *
  * @param level 新的日誌等級
  * @return GAMING_OK 成功, GAMING_ERROR_INVALID_PARAM 參數錯誤
  */
@@ -59,10 +137,56 @@ int logger_set_level(log_level_t level);
 /**
  * @brief 取得目前日誌等級
  * 
- * @return 目前的日誌等級
+ * @return LOG_MODULE_DEFAULT 的日誌等級
  */
 log_level_t logger_get_level(void);
 
+/**
+ * @brief 設定單一模組的日誌等級
+ *
+ * @param module 模組
+ * @param level 日誌等級 (LOG_LEVEL_OFF 關閉)
+ * @return GAMING_OK 成功, GAMING_ERROR_INVALID_PARAM 參數錯誤
+ */
+int logger_set_module_level(log_module_t module, int level);
+
+/**
+ * @brief 取得單一模組的日誌等級
+ *
+ * @param module 模組
+ * @return 日誌等級 (LOG_LEVEL_OFF 表示關閉), 模組錯誤回傳 GAMING_ERROR_INVALID_PARAM
+ */
+int logger_get_module_level(log_module_t module);
+
+/**
+ * @brief 以字串設定多個模組的等級
+ *
+ * 格式為逗號或空白分隔的 "module=level",例如 "socket=debug,led=off";
+ * 供 UCI 選項 (UCI_OPTION_LOG_MODULES) 或控制 socket 收到的命令使用
+ * 等級可為 debug / info / warn / warning / error / off 或數值 0-3 (log_level_t),
+ * 模組 "*" 代表全部模組;任一項目錯誤時不套用任何變更
+ *
+ * @param spec 設定字串
+ * @return GAMING_OK 成功, GAMING_ERROR_INVALID_PARAM 格式錯誤或模組不存在
+ */
+int logger_set_module_levels(const char *spec);
+
+/**
+ * @brief 取得模組名稱
+ *
+ * @param module 模組
+ * @return 名稱 ("default", "socket", ...), 錯誤回傳 "unknown"
+ */
+const char *logger_module_name(log_module_t module);
+
+/**
+ * @brief 依名稱查詢模組
+ *
+ * @param name 模組名稱
+ * @return >= 0 模組, GAMING_ERROR_NOT_FOUND 不存在
+ */
+int logger_module_from_name(const char *name);
+
 /**
  * @brief 設定日誌輸出目標
  * 
@@ -79,7 +203,7 @@ int logger_set_target(log_target_t target);
 log_target_t logger_get_target(void);
 
 /**
- * @brief 檢查是否應該輸出指定等級的日誌
+ * @brief 檢查是否應該輸出指定等級的日誌 (LOG_MODULE_DEFAULT)
  * 
  * @param level 要檢查的日誌等級
  * @return true 應該輸出, false 不應輸出
@@ -100,6 +224,19 @@ bool logger_should_log(log_level_t level);
 void logger_log(log_level_t level, const char *fmt, ...) 
     __attribute__((format(printf, 2, 3)));
 
+/**
+ * @brief 依模組輸出日誌
+ *
+ * 通常經由 LOGM_* 巨集呼叫,先在呼叫端做等級判斷
+ *
+ * @param module 模組
+ * @param level 日誌等級
+ * @param fmt printf 格式字串
+ * @param ... 可變參數
+ */
+void logger_module_log(log_module_t module, log_level_t level, const char *fmt, ...)
+    __attribute__((format(printf, 3, 4)));
+
 /**
  * @brief 輸出 ERROR 等級日誌
  * 
@@ -151,8 +288,39 @@ const char* logger_level_string(log_level_t level);
 /**
  * @brief 刷新日誌緩衝區
  * 
- * 確保所有日誌都已寫入
+ * 確保所有日誌都已寫入;flight recorder 開啟時一併寫出環形緩衝區
  */
 void logger_flush(void);
 
+// ========================================
+// Flight Recorder
+// ========================================
+
+/**
+ * @brief 開啟或關閉 flight recorder
+ *
+ * 第一次開啟時配置環形緩衝區 (之後不釋放,避免與寫入端競爭),
+ * 並為 SIGSEGV / SIGBUS / SIGILL / SIGFPE / SIGABRT 安裝處理函數:
+ * 寫出緩衝區後交回原本的處理方式
+ * 處理函數以 SA_ONSTACK 安裝,並為呼叫的執行緒設定備用訊號堆疊,
+ * 堆疊溢位時仍能寫出 (其他執行緒需自行以 sigaltstack 設定)
+ *
+ * @param enable true 開啟
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR_NO_MEMORY 配置失敗
+ */
+int logger_flight_recorder_enable(bool enable);
+
+/**
+ * @brief 將環形緩衝區由舊到新寫到檔案
+ *
+ * 只使用 async-signal-safe 的系統呼叫,可在訊號處理函數中呼叫
+ *
+ * @param path 輸出路徑, NULL 使用 LOGGER_FLIGHT_DUMP_PATH
+ * @return >= 0 寫出的行數
+ * @return GAMING_ERROR_NOT_INITIALIZED 從未開啟
+ * @return GAMING_ERROR_IO 寫入失敗
+ */
+int logger_flight_recorder_dump(const char *path);
+
 #endif // LOGGER_H
@@ -0,0 +1,611 @@
+/**
+ * @file metrics.c
+ * @brief 執行期統計實作
+ * @version 1.0.0
+ */
+
+#define _GNU_SOURCE
+
+#include "metrics.h"
+#include "socket_helper.h"
+#include "gaming_protocol.h"
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <unistd.h>
+#include <time.h>
+#include <pthread.h>
+#include <errno.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+
+// ========================================
+// 內部狀態
+// ========================================
+
+// 註冊表為靜態陣列,註冊後不會移除,熱路徑持有的指標永遠有效
+static metrics_counter_t metrics_counters[METRICS_MAX_COUNTERS];
+static metrics_gauge_t metrics_gauges[METRICS_MAX_GAUGES];
+static metrics_histogram_t metrics_histograms[METRICS_MAX_HISTOGRAMS];
+
+static size_t metrics_counter_count = 0;
+static size_t metrics_gauge_count = 0;
+static size_t metrics_histogram_count = 0;
+
+static pthread_mutex_t metrics_lock = PTHREAD_MUTEX_INITIALIZER;
+
+__thread int metrics_thread_shard = -1;
+static unsigned int metrics_next_shard = 0;
+
+// 快照輸出緩衝區大小
+#define METRICS_SNAPSHOT_SIZE (64 * 1024)
+
+// 統計輸出 socket 的同時連線數與等待請求行的時間
+#define METRICS_SERVER_MAX_CLIENTS   8
+#define METRICS_SERVER_REQUEST_MS    100
+
+/**
+ * @brief 統計輸出連線
+ *
+ * 先等待請求行 (逾時視為 text),產生快照後以非阻塞方式送出,送完即關閉
+ */
+typedef struct {
+    int fd;                      // -1 表示空位
+    uint64_t deadline_ms;        // 等待請求行的期限
+    char *snapshot;              // 非 NULL 表示正在送出
+    size_t len;
+    size_t sent;
+} metrics_client_t;
+
+static int metrics_listen_fd = -1;
+static int metrics_epoll_fd = -1;
+static int metrics_timer_fd = -1;
+static char metrics_socket_path[108];
+static metrics_client_t metrics_clients[METRICS_SERVER_MAX_CLIENTS];
+
+// ========================================
+// 內部輔助函數
+// ========================================
+
+static bool metrics_name_valid(const char *name) {
+    return name != NULL && name[0] != '\0' && strlen(name) < METRICS_NAME_SIZE;
+}
+
+/**
+ * @brief 在註冊表中尋找或新增項目 (呼叫端需持有 metrics_lock)
+ *
+ * 各註冊表的元素都以 name 為第一個成員
+ */
+static void *metrics_find_or_add(void *table, size_t entry_size, size_t *count,
+                                 size_t max, const char *name) {
+    uint8_t *base = table;
+    size_t n = __atomic_load_n(count, __ATOMIC_RELAXED);
+
+    for (size_t i = 0; i < n; i++) {
+        char *entry_name = (char *)(base + i * entry_size);
+        if (strcmp(entry_name, name) == 0) {
+            return entry_name;
+        }
+    }
+
+    if (n >= max) {
+        return NULL;
+    }
+
+    char *entry = (char *)(base + n * entry_size);
+    memset(entry, 0, entry_size);
+    strcpy(entry, name);
+
+    // 讀取端以 acquire 讀取數量,確保看到完整初始化的項目
+    __atomic_store_n(count, n + 1, __ATOMIC_RELEASE);
+    return entry;
+}
+
+/**
+ * @brief 輸出 Prometheus 名稱 ("socket.send.bytes" → "gaming_socket_send_bytes")
+ */
+static void metrics_export_name(const char *name, char *out, size_t size) {
+    snprintf(out, size, "gaming_%.*s", METRICS_NAME_SIZE - 1, name);
+    for (char *p = out; *p != '\0'; p++) {
+        if (*p == '.' || *p == '-') {
+            *p = '_';
+        }
+    }
+}
+
+/**
+ * @brief 帶邊界檢查的 snprintf 累加
+ */
+static bool metrics_append(char *buffer, size_t size, size_t *offset, const char *fmt, ...)
+    __attribute__((format(printf, 4, 5)));
+
+static bool metrics_append(char *buffer, size_t size, size_t *offset, const char *fmt, ...) {
+    if (*offset >= size) {
+        return false;
+    }
+
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(buffer + *offset, size - *offset, fmt, args);
+    va_end(args);
+
+    if (n < 0 || (size_t)n >= size - *offset) {
+        return false;
+    }
+
+    *offset += (size_t)n;
+    return true;
+}
+
+// ========================================
+// 註冊
+// ========================================
+
+metrics_counter_t *metrics_counter_register(const char *name) {
+    if (!metrics_name_valid(name)) {
+        return NULL;
+    }
+
+    pthread_mutex_lock(&metrics_lock);
+    metrics_counter_t *counter = metrics_find_or_add(metrics_counters, sizeof(metrics_counter_t),
+                                                     &metrics_counter_count,
+                                                     METRICS_MAX_COUNTERS, name);
+    pthread_mutex_unlock(&metrics_lock);
+    return counter;
+}
+
+metrics_gauge_t *metrics_gauge_register(const char *name) {
+    if (!metrics_name_valid(name)) {
+        return NULL;
+    }
+
+    pthread_mutex_lock(&metrics_lock);
+    metrics_gauge_t *gauge = metrics_find_or_add(metrics_gauges, sizeof(metrics_gauge_t),
+                                                 &metrics_gauge_count,
+                                                 METRICS_MAX_GAUGES, name);
+    pthread_mutex_unlock(&metrics_lock);
+    return gauge;
+}
+
+metrics_histogram_t *metrics_histogram_register(const char *name) {
+    if (!metrics_name_valid(name)) {
+        return NULL;
+    }
+
+    pthread_mutex_lock(&metrics_lock);
+    metrics_histogram_t *histogram = metrics_find_or_add(metrics_histograms,
+                                                         sizeof(metrics_histogram_t),
+                                                         &metrics_histogram_count,
+                                                         METRICS_MAX_HISTOGRAMS, name);
+    pthread_mutex_unlock(&metrics_lock);
+    return histogram;
+}
+
+// ========================================
+// 更新輔助
+// ========================================
+
+unsigned int metrics_assign_shard(void) {
+    unsigned int shard = __atomic_fetch_add(&metrics_next_shard, 1, __ATOMIC_RELAXED) &
+                         (METRICS_SHARDS - 1);
+    metrics_thread_shard = (int)shard;
+    return shard;
+}
+
+uint64_t metrics_now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000ULL + (uint64_t)ts.tv_nsec / 1000ULL;
+}
+
+// ========================================
+// 讀取與輸出
+// ========================================
+
+uint64_t metrics_counter_read(const metrics_counter_t *counter) {
+    if (counter == NULL) {
+        return 0;
+    }
+
+    uint64_t total = 0;
+    for (int i = 0; i < METRICS_SHARDS; i++) {
+        total += __atomic_load_n(&counter->shards[i].value, __ATOMIC_RELAXED);
+    }
+    return total;
+}
+
+int metrics_snapshot_text(char *buffer, size_t size) {
+    if (buffer == NULL || size == 0) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    size_t offset = 0;
+    char name[METRICS_NAME_SIZE + 16];
+    buffer[0] = '\0';
+
+    size_t n = __atomic_load_n(&metrics_counter_count, __ATOMIC_ACQUIRE);
+    for (size_t i = 0; i < n; i++) {
+        metrics_export_name(metrics_counters[i].name, name, sizeof(name));
+        if (!metrics_append(buffer, size, &offset, "# TYPE %s counter\n%s %llu\n", name, name,
+                            (unsigned long long)metrics_counter_read(&metrics_counters[i]))) {
+            return GAMING_ERROR_NO_MEMORY;
+        }
+    }
+
+    n = __atomic_load_n(&metrics_gauge_count, __ATOMIC_ACQUIRE);
+    for (size_t i = 0; i < n; i++) {
+        metrics_export_name(metrics_gauges[i].name, name, sizeof(name));
+        if (!metrics_append(buffer, size, &offset, "# TYPE %s gauge\n%s %lld\n", name, name,
+                            (long long)__atomic_load_n(&metrics_gauges[i].value,
+                                                       __ATOMIC_RELAXED))) {
+            return GAMING_ERROR_NO_MEMORY;
+        }
+    }
+
+    n = __atomic_load_n(&metrics_histogram_count, __ATOMIC_ACQUIRE);
+    for (size_t i = 0; i < n; i++) {
+        const metrics_histogram_t *h = &metrics_histograms[i];
+        metrics_export_name(h->name, name, sizeof(name));
+
+        if (!metrics_append(buffer, size, &offset, "# TYPE %s histogram\n", name)) {
+            return GAMING_ERROR_NO_MEMORY;
+        }
+
+        // Prometheus 的 bucket 為累計值,上界 le 為 2^i - 1
+        uint64_t cumulative = 0;
+        for (int b = 0; b < METRICS_HISTOGRAM_BUCKETS - 1; b++) {
+            cumulative += __atomic_load_n(&h->buckets[b], __ATOMIC_RELAXED);
+            if (!metrics_append(buffer, size, &offset, "%s_bucket{le=\"%llu\"} %llu\n", name,
+                                (unsigned long long)((1ULL << b) - 1),
+                                (unsigned long long)cumulative)) {
+                return GAMING_ERROR_NO_MEMORY;
+            }
+        }
+        cumulative += __atomic_load_n(&h->buckets[METRICS_HISTOGRAM_BUCKETS - 1],
+                                      __ATOMIC_RELAXED);
+
+        if (!metrics_append(buffer, size, &offset,
+                            "%s_bucket{le=\"+Inf\"} %llu\n%s_sum %llu\n%s_count %llu\n",
+                            name, (unsigned long long)cumulative,
+                            name, (unsigned long long)__atomic_load_n(&h->sum, __ATOMIC_RELAXED),
+                            name, (unsigned long long)cumulative)) {
+            return GAMING_ERROR_NO_MEMORY;
+        }
+    }
+
+    return (int)offset;
+}
+
+int metrics_snapshot_binary(uint8_t *buffer, size_t size) {
+    if (buffer == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    size_t counters = __atomic_load_n(&metrics_counter_count, __ATOMIC_ACQUIRE);
+    size_t gauges = __atomic_load_n(&metrics_gauge_count, __ATOMIC_ACQUIRE);
+    size_t histograms = __atomic_load_n(&metrics_histogram_count, __ATOMIC_ACQUIRE);
+
+    if (size < 8) {
+        return GAMING_ERROR_NO_MEMORY;
+    }
+
+    gaming_wire_put_u32(buffer, METRICS_BINARY_MAGIC);
+    gaming_wire_put_u16(buffer + 4, METRICS_BINARY_VERSION);
+    gaming_wire_put_u16(buffer + 6, (uint16_t)(counters + gauges + histograms));
+    size_t offset = 8;
+
+    for (size_t i = 0; i < counters + gauges + histograms; i++) {
+        const char *name;
+        uint8_t type;
+
+        if (i < counters) {
+            name = metrics_counters[i].name;
+            type = METRICS_TYPE_COUNTER;
+        } else if (i < counters + gauges) {
+            name = metrics_gauges[i - counters].name;
+            type = METRICS_TYPE_GAUGE;
+        } else {
+            name = metrics_histograms[i - counters - gauges].name;
+            type = METRICS_TYPE_HISTOGRAM;
+        }
+
+        size_t name_len = strlen(name);
+        size_t body = (type == METRICS_TYPE_HISTOGRAM)
+                          ? 8 + 8 + 1 + 8 * METRICS_HISTOGRAM_BUCKETS
+                          : 8;
+        if (offset + 2 + name_len + body > size) {
+            return GAMING_ERROR_NO_MEMORY;
+        }
+
+        gaming_wire_put_u8(buffer + offset, type);
+        gaming_wire_put_u8(buffer + offset + 1, (uint8_t)name_len);
+        memcpy(buffer + offset + 2, name, name_len);
+        offset += 2 + name_len;
+
+        if (type == METRICS_TYPE_COUNTER) {
+            gaming_wire_put_u64(buffer + offset, metrics_counter_read(&metrics_counters[i]));
+            offset += 8;
+        } else if (type == METRICS_TYPE_GAUGE) {
+            int64_t value = __atomic_load_n(&metrics_gauges[i - counters].value,
+                                            __ATOMIC_RELAXED);
+            gaming_wire_put_u64(buffer + offset, (uint64_t)value);
+            offset += 8;
+        } else {
+            const metrics_histogram_t *h = &metrics_histograms[i - counters - gauges];
+            gaming_wire_put_u64(buffer + offset, __atomic_load_n(&h->count, __ATOMIC_RELAXED));
+            gaming_wire_put_u64(buffer + offset + 8, __atomic_load_n(&h->sum, __ATOMIC_RELAXED));
+            gaming_wire_put_u8(buffer + offset + 16, METRICS_HISTOGRAM_BUCKETS);
+            offset += 17;
+            for (int b = 0; b < METRICS_HISTOGRAM_BUCKETS; b++) {
+                gaming_wire_put_u64(buffer + offset,
+                                    __atomic_load_n(&h->buckets[b], __ATOMIC_RELAXED));
+                offset += 8;
+            }
+        }
+    }
+
+    return (int)offset;
+}
+
+// ========================================
+// 統計輸出 Socket
+// ========================================
+
+static uint64_t metrics_now_ms(void) {
+    return metrics_now_us() / 1000;
+}
+
+static int metrics_epoll_add(int fd, uint32_t events) {
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = events;
+    ev.data.fd = fd;
+    return epoll_ctl(metrics_epoll_fd, EPOLL_CTL_ADD, fd, &ev);
+}
+
+static void metrics_client_close(metrics_client_t *client) {
+    epoll_ctl(metrics_epoll_fd, EPOLL_CTL_DEL, client->fd, NULL);
+    socket_helper_close(client->fd);
+    free(client->snapshot);
+    memset(client, 0, sizeof(*client));
+    client->fd = -1;
+}
+
+/**
+ * @brief 以最早的請求期限設定 timerfd (沒有等待中的連線時停用)
+ */
+static void metrics_arm_timer(void) {
+    uint64_t earliest = 0;
+    for (int i = 0; i < METRICS_SERVER_MAX_CLIENTS; i++) {
+        const metrics_client_t *client = &metrics_clients[i];
+        if (client->fd >= 0 && client->snapshot == NULL &&
+            (earliest == 0 || client->deadline_ms < earliest)) {
+            earliest = client->deadline_ms;
+        }
+    }
+
+    struct itimerspec its;
+    memset(&its, 0, sizeof(its));
+    if (earliest != 0) {
+        its.it_value.tv_sec = (time_t)(earliest / 1000);
+        its.it_value.tv_nsec = (long)(earliest % 1000) * 1000000L;
+    }
+    timerfd_settime(metrics_timer_fd, TFD_TIMER_ABSTIME, &its, NULL);
+}
+
+/**
+ * @brief 送出快照的剩餘部分
+ *
+ * @return true 連線已結束 (送完或錯誤), 已關閉
+ */
+static bool metrics_client_flush(metrics_client_t *client) {
+    while (client->sent < client->len) {
+        ssize_t n = send(client->fd, client->snapshot + client->sent,
+                         client->len - client->sent, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (n > 0) {
+            client->sent += (size_t)n;
+            continue;
+        }
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            struct epoll_event ev;
+            memset(&ev, 0, sizeof(ev));
+            ev.events = EPOLLOUT;
+            ev.data.fd = client->fd;
+            epoll_ctl(metrics_epoll_fd, EPOLL_CTL_MOD, client->fd, &ev);
+            return false;
+        }
+        break;
+    }
+
+    metrics_client_close(client);
+    return true;
+}
+
+/**
+ * @brief 產生快照並開始送出
+ */
+static void metrics_client_respond(metrics_client_t *client, bool binary) {
+    client->snapshot = malloc(METRICS_SNAPSHOT_SIZE);
+    if (client->snapshot == NULL) {
+        metrics_client_close(client);
+        return;
+    }
+
+    int len = binary ? metrics_snapshot_binary((uint8_t *)client->snapshot,
+                                               METRICS_SNAPSHOT_SIZE)
+                     : metrics_snapshot_text(client->snapshot, METRICS_SNAPSHOT_SIZE);
+    if (len <= 0) {
+        metrics_client_close(client);
+        return;
+    }
+
+    client->len = (size_t)len;
+    client->sent = 0;
+    metrics_client_flush(client);
+}
+
+static void metrics_server_accept(void) {
+    for (;;) {
+        int fd = accept4(metrics_listen_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            return;
+        }
+
+        metrics_client_t *client = NULL;
+        for (int i = 0; i < METRICS_SERVER_MAX_CLIENTS; i++) {
+            if (metrics_clients[i].fd < 0) {
+                client = &metrics_clients[i];
+                break;
+            }
+        }
+        if (client == NULL || metrics_epoll_add(fd, EPOLLIN) < 0) {
+            socket_helper_close(fd);
+            continue;
+        }
+
+        client->fd = fd;
+        client->deadline_ms = metrics_now_ms() + METRICS_SERVER_REQUEST_MS;
+    }
+}
+
+static metrics_client_t *metrics_client_find(int fd) {
+    for (int i = 0; i < METRICS_SERVER_MAX_CLIENTS; i++) {
+        if (metrics_clients[i].fd == fd) {
+            return &metrics_clients[i];
+        }
+    }
+    return NULL;
+}
+
+static void metrics_client_readable(metrics_client_t *client) {
+    char request[16];
+    ssize_t n = recv(client->fd, request, sizeof(request) - 1, MSG_DONTWAIT);
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+        return;
+    }
+
+    bool binary = false;
+    if (n > 0) {
+        request[n] = '\0';
+        binary = (strncasecmp(request, "binary", 6) == 0);
+    }
+    metrics_client_respond(client, binary);
+}
+
+int metrics_server_start(const char *path) {
+    if (metrics_epoll_fd >= 0) {
+        return metrics_epoll_fd;
+    }
+
+    if (path == NULL) {
+        path = METRICS_SOCKET_PATH;
+    }
+
+    if (strlen(path) >= sizeof(metrics_socket_path)) {
+        return -1;
+    }
+
+    int fd = socket_helper_create_unix(path);
+    if (fd < 0) {
+        return -1;
+    }
+
+    if (socket_helper_set_nonblocking(fd) != GAMING_OK) {
+        socket_helper_close(fd);
+        unlink(path);
+        return -1;
+    }
+
+    strcpy(metrics_socket_path, path);
+    metrics_listen_fd = fd;
+    for (int i = 0; i < METRICS_SERVER_MAX_CLIENTS; i++) {
+        metrics_clients[i].fd = -1;
+    }
+
+    metrics_epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    metrics_timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (metrics_epoll_fd < 0 || metrics_timer_fd < 0 ||
+        metrics_epoll_add(metrics_listen_fd, EPOLLIN) < 0 ||
+        metrics_epoll_add(metrics_timer_fd, EPOLLIN) < 0) {
+        perror("metrics_server_start");
+        metrics_server_stop();
+        return -1;
+    }
+
+    return metrics_epoll_fd;
+}
+
+int metrics_server_process(void) {
+    if (metrics_epoll_fd < 0) {
+        return GAMING_ERROR_NOT_INITIALIZED;
+    }
+
+    struct epoll_event events[METRICS_SERVER_MAX_CLIENTS + 2];
+    int n = epoll_wait(metrics_epoll_fd, events, (int)ARRAY_SIZE(events), 0);
+
+    for (int i = 0; i < n; i++) {
+        int fd = events[i].data.fd;
+        if (fd == metrics_listen_fd) {
+            metrics_server_accept();
+        } else if (fd == metrics_timer_fd) {
+            uint64_t expirations;
+            if (read(metrics_timer_fd, &expirations, sizeof(expirations)) < 0 &&
+                errno != EAGAIN) {
+                perror("read timerfd");
+            }
+        } else {
+            metrics_client_t *client = metrics_client_find(fd);
+            if (client == NULL) {
+                continue;
+            }
+            if (client->snapshot != NULL) {
+                metrics_client_flush(client);
+            } else {
+                metrics_client_readable(client);
+            }
+        }
+    }
+
+    // 未在期限內送出請求行的連線預設為 text
+    uint64_t now = metrics_now_ms();
+    for (int i = 0; i < METRICS_SERVER_MAX_CLIENTS; i++) {
+        metrics_client_t *client = &metrics_clients[i];
+        if (client->fd >= 0 && client->snapshot == NULL && now >= client->deadline_ms) {
+            metrics_client_respond(client, false);
+        }
+    }
+
+    metrics_arm_timer();
+    return GAMING_OK;
+}
+
+void metrics_server_stop(void) {
+    if (metrics_listen_fd < 0) {
+        return;
+    }
+
+    for (int i = 0; i < METRICS_SERVER_MAX_CLIENTS; i++) {
+        if (metrics_clients[i].fd >= 0) {
+            metrics_client_close(&metrics_clients[i]);
+        }
+    }
+    if (metrics_timer_fd >= 0) {
+        close(metrics_timer_fd);
+        metrics_timer_fd = -1;
+    }
+    if (metrics_epoll_fd >= 0) {
+        close(metrics_epoll_fd);
+        metrics_epoll_fd = -1;
+    }
+
+    socket_helper_close(metrics_listen_fd);
+    unlink(metrics_socket_path);
+    metrics_listen_fd = -1;
+    metrics_socket_path[0] = '\0';
+}
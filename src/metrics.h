@@ -0,0 +1,259 @@
+/**
+ * @file metrics.h
+ * @brief 執行期統計 (counter / gauge / histogram)
+ * @version 1.0.0
+ *
+ * 輕量統計系統:
+ * - counter 依執行緒分片,更新只是一次 relaxed atomic add,不會有 cache line 爭用
+ * - gauge 為單一 atomic 值
+ * - histogram 以 2 的次方分桶 (單位由呼叫端決定,慣例為微秒)
+ *
+ * 統計值只在有人讀取時才彙總,透過 PATH_RUN_DIR 下的 Unix socket
+ * 以文字 (Prometheus 格式) 或二進位格式輸出;沒有讀取者時沒有額外成本
+ */
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include "gaming_common.h"
+#include <stddef.h>
+
+// ========================================
+// Metrics 配置
+// ========================================
+
+#define METRICS_SOCKET_PATH        PATH_RUN_DIR "/gaming_metrics.sock"
+
+#define METRICS_MAX_COUNTERS       64
+#define METRICS_MAX_GAUGES         32
+#define METRICS_MAX_HISTOGRAMS     16
+#define METRICS_NAME_SIZE          48
+
+// counter 分片數 (2 的次方)
+#define METRICS_SHARDS             8
+
+// histogram 桶數: 桶 0 為 0, 桶 i 為 [2^(i-1), 2^i), 最後一桶包含以上所有值
+#define METRICS_HISTOGRAM_BUCKETS  24
+
+// 二進位快照格式
+#define METRICS_BINARY_MAGIC       0x474D4554   // "GMET"
+#define METRICS_BINARY_VERSION     1
+
+// ========================================
+// Metrics 型別定義
+// ========================================
+
+typedef enum {
+    METRICS_TYPE_COUNTER = 1,
+    METRICS_TYPE_GAUGE = 2,
+    METRICS_TYPE_HISTOGRAM = 3,
+} metrics_type_t;
+
+/**
+ * @brief 單一 cache line 的 counter 分片
+ */
+typedef struct {
+    uint64_t value;
+} __attribute__((aligned(64))) metrics_shard_t;
+
+typedef struct {
+    char name[METRICS_NAME_SIZE];
+    metrics_shard_t shards[METRICS_SHARDS];
+} metrics_counter_t;
+
+typedef struct {
+    char name[METRICS_NAME_SIZE];
+    int64_t value;
+} metrics_gauge_t;
+
+typedef struct {
+    char name[METRICS_NAME_SIZE];
+    uint64_t count;
+    uint64_t sum;
+    uint64_t buckets[METRICS_HISTOGRAM_BUCKETS];
+} metrics_histogram_t;
+
+// ========================================
+// 註冊
+// ========================================
+
+/**
+ * @brief 註冊 counter
+ *
+ * 同名重複註冊會回傳同一個 counter,因此多個模組可共用
+ *
+ * @param name 名稱 (建議格式 "module.metric", 例如 "socket.send.bytes")
+ * @return counter 指標, NULL 名稱無效或已達上限
+ */
+metrics_counter_t *metrics_counter_register(const char *name);
+
+/**
+ * @brief 註冊 gauge
+ *
+ * @param name 名稱
+ * @return gauge 指標, NULL 名稱無效或已達上限
+ */
+metrics_gauge_t *metrics_gauge_register(const char *name);
+
+/**
+ * @brief 註冊 histogram
+ *
+ * @param name 名稱 (建議以單位結尾, 例如 "config.get.latency_us")
+ * @return histogram 指標, NULL 名稱無效或已達上限
+ */
+metrics_histogram_t *metrics_histogram_register(const char *name);
+
+// ========================================
+// 更新 (熱路徑)
+// ========================================
+
+// 目前執行緒的 counter 分片 (-1 表示尚未指派)
+extern __thread int metrics_thread_shard;
+
+/**
+ * @brief 為目前執行緒指派 counter 分片 (內部使用)
+ */
+unsigned int metrics_assign_shard(void);
+
+/**
+ * @brief 取得目前執行緒的 counter 分片索引
+ */
+static inline unsigned int metrics_shard_index(void) {
+    int shard = metrics_thread_shard;
+    return (shard >= 0) ? (unsigned int)shard : metrics_assign_shard();
+}
+
+/**
+ * @brief counter 增加 (NULL 安全)
+ */
+static inline void metrics_counter_add(metrics_counter_t *counter, uint64_t value) {
+    if (counter != NULL) {
+        __atomic_fetch_add(&counter->shards[metrics_shard_index()].value, value,
+                           __ATOMIC_RELAXED);
+    }
+}
+
+static inline void metrics_counter_inc(metrics_counter_t *counter) {
+    metrics_counter_add(counter, 1);
+}
+
+/**
+ * @brief 設定 gauge (NULL 安全)
+ */
+static inline void metrics_gauge_set(metrics_gauge_t *gauge, int64_t value) {
+    if (gauge != NULL) {
+        __atomic_store_n(&gauge->value, value, __ATOMIC_RELAXED);
+    }
+}
+
+/**
+ * @brief gauge 增減 (NULL 安全)
+ */
+static inline void metrics_gauge_add(metrics_gauge_t *gauge, int64_t delta) {
+    if (gauge != NULL) {
+        __atomic_fetch_add(&gauge->value, delta, __ATOMIC_RELAXED);
+    }
+}
+
+/**
+ * @brief 計算數值所屬的 histogram 桶
+ */
+static inline unsigned int metrics_histogram_bucket(uint64_t value) {
+    if (value == 0) {
+        return 0;
+    }
+    unsigned int bucket = 64 - (unsigned int)__builtin_clzll(value);
+    return MIN(bucket, METRICS_HISTOGRAM_BUCKETS - 1);
+}
+
+/**
+ * @brief 記錄一個 histogram 樣本 (NULL 安全)
+ */
+static inline void metrics_histogram_observe(metrics_histogram_t *histogram, uint64_t value) {
+    if (histogram != NULL) {
+        __atomic_fetch_add(&histogram->buckets[metrics_histogram_bucket(value)], 1,
+                           __ATOMIC_RELAXED);
+        __atomic_fetch_add(&histogram->sum, value, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&histogram->count, 1, __ATOMIC_RELAXED);
+    }
+}
+
+/**
+ * @brief 取得單調時鐘 (微秒),用於量測延遲
+ */
+uint64_t metrics_now_us(void);
+
+// ========================================
+// 讀取與輸出
+// ========================================
+
+/**
+ * @brief 讀取 counter 目前總和
+ *
+ * @param counter counter 指標
+ * @return 所有分片的總和
+ */
+uint64_t metrics_counter_read(const metrics_counter_t *counter);
+
+/**
+ * @brief 輸出文字快照 (Prometheus exposition 格式)
+ *
+ * 名稱中的 '.' 會轉為 '_',並加上 "gaming_" 前綴
+ *
+ * @param buffer 輸出緩衝區
+ * @param size 緩衝區大小
+ * @return >= 0 寫入長度 (不含 '\0')
+ * @return GAMING_ERROR_NO_MEMORY 緩衝區不足
+ */
+int metrics_snapshot_text(char *buffer, size_t size);
+
+/**
+ * @brief 輸出二進位快照
+ *
+ * 格式 (big-endian):
+ *   u32 magic, u16 version, u16 metric 數量, 之後每個 metric:
+ *   u8 type, u8 name_len, name, 然後
+ *   counter/gauge: u64 值; histogram: u64 count, u64 sum, u8 桶數, 每桶 u64
+ *
+ * @param buffer 輸出緩衝區
+ * @param size 緩衝區大小
+ * @return >= 0 寫入長度
+ * @return GAMING_ERROR_NO_MEMORY 緩衝區不足
+ */
+int metrics_snapshot_binary(uint8_t *buffer, size_t size);
+
+// ========================================
+// 統計輸出 Socket
+// ========================================
+
+/**
+ * @brief 啟動統計輸出 socket
+ *
+ * 回傳的 fd 為內部 epoll fd (包含 listen socket、連線與請求期限計時器),
+ * 加入事件迴圈後可讀時呼叫 metrics_server_process()
+ * 用戶端連線後送出 "text\n" 或 "binary\n" (100 ms 內未送出則預設 text),
+ * 收到快照後連線即關閉
+ *
+ * @param path Socket 路徑, NULL 則使用 METRICS_SOCKET_PATH
+ * @return >= 0 epoll fd
+ * @return < 0 建立失敗
+ */
+int metrics_server_start(const char *path);
+
+/**
+ * @brief 處理統計讀取連線 (不阻塞)
+ *
+ * 接受新連線、讀取請求行並以非阻塞方式送出快照;
+ * 對端提早關閉只會結束該連線
+ *
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR_NOT_INITIALIZED 尚未啟動
+ */
+int metrics_server_process(void);
+
+/**
+ * @brief 停止統計輸出 socket
+ */
+void metrics_server_stop(void);
+
+#endif // METRICS_H
@@ -0,0 +1,461 @@
+/**
+ * @file pcap_capture.c
+ * @brief socket_helper 流量擷取實作
+ * @version 1.0.0
+ */
+
+#include "pcap_capture.h"
+#include "metrics.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+// ========================================
+// 內部結構
+// ========================================
+
+#define PCAP_CAPTURE_RING_MASK   (PCAP_CAPTURE_RING_SIZE - 1)
+#define PCAP_CAPTURE_MAX_CONVS   64
+#define PCAP_CAPTURE_FAKE_PORT   10000
+#define PCAP_CAPTURE_ENDPOINT_FDS 1024           // 快取位址的 fd 範圍 (0 ~ N-1)
+
+_Static_assert((PCAP_CAPTURE_RING_SIZE & PCAP_CAPTURE_RING_MASK) == 0,
+               "PCAP_CAPTURE_RING_SIZE must be a power of two");
+
+// pcapng 常數
+#define PCAPNG_BLOCK_SHB         0x0A0D0D0AU
+#define PCAPNG_BLOCK_IDB         0x00000001U
+#define PCAPNG_BLOCK_EPB         0x00000006U
+#define PCAPNG_BYTE_ORDER_MAGIC  0x1A2B3C4DU
+#define PCAPNG_LINKTYPE_RAW      101
+
+#define PCAP_HEADERS_LEN         40              // IPv4 (20) + TCP (20)
+
+/**
+ * @brief 一筆擷取記錄
+ *
+ * seq 為 2 * pos + 1 表示寫入中, 2 * pos + 2 表示完成 (pos 為累計序號),
+ * 輸出時前後讀到相同且為完成值才使用,避免讀到寫到一半或已被覆蓋的內容
+ */
+typedef struct {
+    uint64_t seq;
+    uint64_t ts_us;              // CLOCK_REALTIME
+    int32_t fd;
+    uint8_t dir;                 // pcap_dir_t
+    uint32_t local_addr;         // network byte order
+    uint32_t peer_addr;
+    uint16_t local_port;
+    uint16_t peer_port;
+    uint32_t orig_len;
+    uint32_t cap_len;
+    uint8_t data[PCAP_CAPTURE_SNAPLEN];
+} pcap_slot_t;
+
+/**
+ * @brief 輸出時的連線狀態 (推算 sequence / ack)
+ */
+typedef struct {
+    int32_t fd;
+    uint32_t local_addr;
+    uint32_t peer_addr;
+    uint16_t local_port;
+    uint16_t peer_port;
+    uint32_t out_seq;
+    uint32_t in_seq;
+} pcap_conv_t;
+
+/**
+ * @brief 依 fd 快取的連線位址 (避免每筆記錄都呼叫 getsockname / getpeername)
+ *
+ * seq 為 seqlock 序號,奇數表示寫入中;valid 為 false 表示需要重新查詢
+ */
+typedef struct {
+    uint32_t seq;
+    bool valid;
+    uint32_t local_addr;
+    uint32_t peer_addr;
+    uint16_t local_port;
+    uint16_t peer_port;
+} pcap_endpoint_t;
+
+bool pcap_capture_enabled_flag = false;
+
+static pcap_slot_t *pcap_ring = NULL;
+static uint64_t pcap_head = 0;           // 累計記錄數
+static uint64_t pcap_base = 0;           // pcap_capture_clear 時的 head
+static pthread_mutex_t pcap_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pcap_endpoint_t pcap_endpoints[PCAP_CAPTURE_ENDPOINT_FDS];
+
+// ========================================
+// 統計
+// ========================================
+
+static pthread_once_t pcap_metrics_once = PTHREAD_ONCE_INIT;
+static metrics_counter_t *metric_records;
+
+static void pcap_metrics_register(void) {
+    metric_records = metrics_counter_register("pcap.records");
+}
+
+static inline void pcap_metrics_init(void) {
+    pthread_once(&pcap_metrics_once, pcap_metrics_register);
+}
+
+// ========================================
+// 內部函數
+// ========================================
+
+static uint64_t pcap_now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (uint64_t)ts.tv_sec * 1000000ULL + (uint64_t)ts.tv_nsec / 1000ULL;
+}
+
+/**
+ * @brief 取得連線兩端位址, 非 IPv4 時使用 127.0.0.1 / 127.0.0.2 與 fd 導出的 port
+ *
+ * @return true 結果可快取 (IPv4 位址完整, 或非 AF_INET socket)
+ */
+static bool resolve_endpoints(int sockfd, pcap_slot_t *slot) {
+    struct sockaddr_in local, peer;
+    socklen_t local_len = sizeof(local);
+    socklen_t peer_len = sizeof(peer);
+
+    int local_ret = getsockname(sockfd, (struct sockaddr *)&local, &local_len);
+    if (local_ret == 0 && local.sin_family == AF_INET &&
+        getpeername(sockfd, (struct sockaddr *)&peer, &peer_len) == 0 &&
+        peer.sin_family == AF_INET) {
+        slot->local_addr = local.sin_addr.s_addr;
+        slot->local_port = local.sin_port;
+        slot->peer_addr = peer.sin_addr.s_addr;
+        slot->peer_port = peer.sin_port;
+        return true;
+    }
+
+    uint16_t port = htons((uint16_t)(PCAP_CAPTURE_FAKE_PORT + (sockfd % 50000)));
+    slot->local_addr = htonl(INADDR_LOOPBACK);
+    slot->peer_addr = htonl(INADDR_LOOPBACK + 1);
+    slot->local_port = port;
+    slot->peer_port = port;
+    // AF_INET 但 getpeername 失敗 (例如尚未連線) 時不快取, 下次再查
+    return local_ret == 0 && local.sin_family != AF_INET;
+}
+
+/**
+ * @brief 由快取取得位址
+ *
+ * @param seq 回傳讀到的 seqlock 序號, 供 endpoint_cache_store 判斷期間是否被清除
+ * @return true 命中
+ */
+static bool endpoint_cache_load(int sockfd, pcap_slot_t *slot, uint32_t *seq) {
+    *seq = 1;
+    if (sockfd < 0 || sockfd >= PCAP_CAPTURE_ENDPOINT_FDS) {
+        return false;
+    }
+
+    pcap_endpoint_t *entry = &pcap_endpoints[sockfd];
+    *seq = __atomic_load_n(&entry->seq, __ATOMIC_ACQUIRE);
+    if (*seq & 1) {
+        return false;
+    }
+
+    bool valid = __atomic_load_n(&entry->valid, __ATOMIC_RELAXED);
+    slot->local_addr = __atomic_load_n(&entry->local_addr, __ATOMIC_RELAXED);
+    slot->peer_addr = __atomic_load_n(&entry->peer_addr, __ATOMIC_RELAXED);
+    slot->local_port = __atomic_load_n(&entry->local_port, __ATOMIC_RELAXED);
+    slot->peer_port = __atomic_load_n(&entry->peer_port, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return valid && __atomic_load_n(&entry->seq, __ATOMIC_RELAXED) == *seq;
+}
+
+/**
+ * @brief 寫入快取
+ *
+ * 只有序號仍為 seq 時才寫入:查詢期間若 fd 被關閉 (pcap_capture_forget)
+ * 或有其他執行緒正在寫入,放棄此次快取
+ */
+static void endpoint_cache_store(int sockfd, uint32_t seq, const pcap_slot_t *slot) {
+    if (seq & 1) {
+        return;
+    }
+
+    pcap_endpoint_t *entry = &pcap_endpoints[sockfd];
+    if (!__atomic_compare_exchange_n(&entry->seq, &seq, seq + 1, false,
+                                     __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        return;
+    }
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    __atomic_store_n(&entry->local_addr, slot->local_addr, __ATOMIC_RELAXED);
+    __atomic_store_n(&entry->peer_addr, slot->peer_addr, __ATOMIC_RELAXED);
+    __atomic_store_n(&entry->local_port, slot->local_port, __ATOMIC_RELAXED);
+    __atomic_store_n(&entry->peer_port, slot->peer_port, __ATOMIC_RELAXED);
+    __atomic_store_n(&entry->valid, true, __ATOMIC_RELAXED);
+
+    __atomic_store_n(&entry->seq, seq + 2, __ATOMIC_RELEASE);
+}
+
+static pcap_conv_t *find_conv(pcap_conv_t *convs, size_t *count, const pcap_slot_t *slot) {
+    for (size_t i = 0; i < *count; i++) {
+        pcap_conv_t *conv = &convs[i];
+        if (conv->fd == slot->fd && conv->local_addr == slot->local_addr &&
+            conv->peer_addr == slot->peer_addr && conv->local_port == slot->local_port &&
+            conv->peer_port == slot->peer_port) {
+            return conv;
+        }
+    }
+
+    // 表滿時覆蓋最後一個 (僅影響 sequence 連續性)
+    size_t index = (*count < PCAP_CAPTURE_MAX_CONVS) ? (*count)++ : PCAP_CAPTURE_MAX_CONVS - 1;
+    pcap_conv_t *conv = &convs[index];
+    conv->fd = slot->fd;
+    conv->local_addr = slot->local_addr;
+    conv->peer_addr = slot->peer_addr;
+    conv->local_port = slot->local_port;
+    conv->peer_port = slot->peer_port;
+    conv->out_seq = 1;
+    conv->in_seq = 1;
+    return conv;
+}
+
+static inline void put_be16(uint8_t *p, uint16_t v) {
+    p[0] = (uint8_t)(v >> 8);
+    p[1] = (uint8_t)v;
+}
+
+static inline void put_be32(uint8_t *p, uint32_t v) {
+    p[0] = (uint8_t)(v >> 24);
+    p[1] = (uint8_t)(v >> 16);
+    p[2] = (uint8_t)(v >> 8);
+    p[3] = (uint8_t)v;
+}
+
+static uint16_t ipv4_checksum(const uint8_t *header) {
+    uint32_t sum = 0;
+    for (int i = 0; i < 20; i += 2) {
+        sum += (uint32_t)(header[i] << 8 | header[i + 1]);
+    }
+    while (sum >> 16) {
+        sum = (sum & 0xFFFF) + (sum >> 16);
+    }
+    return (uint16_t)~sum;
+}
+
+/**
+ * @brief 產生合成的 IPv4 + TCP 標頭 (TCP checksum 留 0)
+ */
+static void build_headers(uint8_t *out, const pcap_slot_t *slot, pcap_conv_t *conv,
+                          uint16_t ip_id) {
+    bool outbound = (slot->dir == PCAP_DIR_OUT);
+    uint32_t src_addr = outbound ? slot->local_addr : slot->peer_addr;
+    uint32_t dst_addr = outbound ? slot->peer_addr : slot->local_addr;
+    uint16_t src_port = outbound ? slot->local_port : slot->peer_port;
+    uint16_t dst_port = outbound ? slot->peer_port : slot->local_port;
+    uint32_t *seq = outbound ? &conv->out_seq : &conv->in_seq;
+    uint32_t ack = outbound ? conv->in_seq : conv->out_seq;
+
+    uint8_t *ip = out;
+    memset(ip, 0, PCAP_HEADERS_LEN);
+    ip[0] = 0x45;
+    put_be16(ip + 2, (uint16_t)MIN(PCAP_HEADERS_LEN + slot->orig_len, 0xFFFFU));
+    put_be16(ip + 4, ip_id);
+    put_be16(ip + 6, 0x4000);            // DF
+    ip[8] = 64;
+    ip[9] = IPPROTO_TCP;
+    memcpy(ip + 12, &src_addr, 4);
+    memcpy(ip + 16, &dst_addr, 4);
+    put_be16(ip + 10, ipv4_checksum(ip));
+
+    uint8_t *tcp = out + 20;
+    memcpy(tcp, &src_port, 2);
+    memcpy(tcp + 2, &dst_port, 2);
+    put_be32(tcp + 4, *seq);
+    put_be32(tcp + 8, ack);
+    tcp[12] = 5 << 4;
+    tcp[13] = 0x18;                      // PSH | ACK
+    put_be16(tcp + 14, 0xFFFF);
+
+    *seq += slot->orig_len;
+}
+
+static void write_u32(FILE *fp, uint32_t v) {
+    fwrite(&v, sizeof(v), 1, fp);
+}
+
+static void write_header_blocks(FILE *fp) {
+    // Section Header Block
+    write_u32(fp, PCAPNG_BLOCK_SHB);
+    write_u32(fp, 28);
+    write_u32(fp, PCAPNG_BYTE_ORDER_MAGIC);
+    uint16_t version[2] = { 1, 0 };
+    fwrite(version, sizeof(version), 1, fp);
+    int64_t section_len = -1;
+    fwrite(&section_len, sizeof(section_len), 1, fp);
+    write_u32(fp, 28);
+
+    // Interface Description Block (時間單位預設為微秒)
+    write_u32(fp, PCAPNG_BLOCK_IDB);
+    write_u32(fp, 20);
+    uint16_t link[2] = { PCAPNG_LINKTYPE_RAW, 0 };
+    fwrite(link, sizeof(link), 1, fp);
+    write_u32(fp, PCAP_HEADERS_LEN + PCAP_CAPTURE_SNAPLEN);
+    write_u32(fp, 20);
+}
+
+static void write_packet_block(FILE *fp, const pcap_slot_t *slot, const uint8_t *headers) {
+    uint32_t cap_len = PCAP_HEADERS_LEN + slot->cap_len;
+    uint32_t padded = (cap_len + 3U) & ~3U;
+    uint32_t block_len = 32 + padded;
+    static const uint8_t padding[4] = { 0 };
+
+    write_u32(fp, PCAPNG_BLOCK_EPB);
+    write_u32(fp, block_len);
+    write_u32(fp, 0);                    // interface id
+    write_u32(fp, (uint32_t)(slot->ts_us >> 32));
+    write_u32(fp, (uint32_t)slot->ts_us);
+    write_u32(fp, cap_len);
+    write_u32(fp, PCAP_HEADERS_LEN + slot->orig_len);
+    fwrite(headers, PCAP_HEADERS_LEN, 1, fp);
+    fwrite(slot->data, slot->cap_len, 1, fp);
+    fwrite(padding, padded - cap_len, 1, fp);
+    write_u32(fp, block_len);
+}
+
+// ========================================
+// 公開函數
+// ========================================
+
+int pcap_capture_set_enabled(bool enabled) {
+    if (enabled && __atomic_load_n(&pcap_ring, __ATOMIC_ACQUIRE) == NULL) {
+        pcap_metrics_init();
+
+        pthread_mutex_lock(&pcap_mutex);
+        if (pcap_ring == NULL) {
+            pcap_slot_t *ring = calloc(PCAP_CAPTURE_RING_SIZE, sizeof(pcap_slot_t));
+            if (ring == NULL) {
+                pthread_mutex_unlock(&pcap_mutex);
+                return GAMING_ERROR_NO_MEMORY;
+            }
+            __atomic_store_n(&pcap_ring, ring, __ATOMIC_RELEASE);
+        }
+        pthread_mutex_unlock(&pcap_mutex);
+    }
+
+    __atomic_store_n(&pcap_capture_enabled_flag, enabled, __ATOMIC_RELAXED);
+    return GAMING_OK;
+}
+
+void pcap_capture_record(int sockfd, pcap_dir_t dir, const void *data, size_t len) {
+    pcap_slot_t *ring = __atomic_load_n(&pcap_ring, __ATOMIC_ACQUIRE);
+    if (ring == NULL || data == NULL || len == 0) {
+        return;
+    }
+
+    uint64_t pos = __atomic_fetch_add(&pcap_head, 1, __ATOMIC_RELAXED);
+    pcap_slot_t *slot = &ring[pos & PCAP_CAPTURE_RING_MASK];
+
+    __atomic_store_n(&slot->seq, 2 * pos + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    slot->ts_us = pcap_now_us();
+    slot->fd = sockfd;
+    slot->dir = (uint8_t)dir;
+    slot->orig_len = (uint32_t)MIN(len, UINT32_MAX);
+    slot->cap_len = (uint32_t)MIN(len, PCAP_CAPTURE_SNAPLEN);
+    memcpy(slot->data, data, slot->cap_len);
+
+    uint32_t cache_seq;
+    if (!endpoint_cache_load(sockfd, slot, &cache_seq) &&
+        resolve_endpoints(sockfd, slot)) {
+        endpoint_cache_store(sockfd, cache_seq, slot);
+    }
+
+    __atomic_store_n(&slot->seq, 2 * pos + 2, __ATOMIC_RELEASE);
+    metrics_counter_inc(metric_records);
+}
+
+int pcap_capture_dump(const char *path) {
+    if (path == NULL) {
+        path = PCAP_CAPTURE_DEFAULT_DUMP_PATH;
+    }
+
+    FILE *fp = fopen(path, "w");
+    if (fp == NULL) {
+        perror("fopen");
+        return GAMING_ERROR_IO;
+    }
+
+    write_header_blocks(fp);
+
+    pcap_slot_t *ring = __atomic_load_n(&pcap_ring, __ATOMIC_ACQUIRE);
+    pcap_slot_t *copy = malloc(sizeof(pcap_slot_t));
+    pcap_conv_t *convs = calloc(PCAP_CAPTURE_MAX_CONVS, sizeof(pcap_conv_t));
+    size_t conv_count = 0;
+    int count = 0;
+
+    if (ring != NULL && copy != NULL && convs != NULL) {
+        uint64_t head = __atomic_load_n(&pcap_head, __ATOMIC_ACQUIRE);
+        uint64_t base = __atomic_load_n(&pcap_base, __ATOMIC_ACQUIRE);
+        uint64_t start = (head > PCAP_CAPTURE_RING_SIZE) ? head - PCAP_CAPTURE_RING_SIZE : 0;
+        start = MAX(start, base);
+
+        for (uint64_t pos = start; pos < head; pos++) {
+            const pcap_slot_t *slot = &ring[pos & PCAP_CAPTURE_RING_MASK];
+
+            uint64_t seq = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+            if (seq != 2 * pos + 2) {
+                continue;
+            }
+            memcpy(copy, slot, sizeof(*copy));
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+            if (__atomic_load_n(&slot->seq, __ATOMIC_RELAXED) != seq) {
+                continue;
+            }
+
+            uint8_t headers[PCAP_HEADERS_LEN];
+            build_headers(headers, copy, find_conv(convs, &conv_count, copy), (uint16_t)pos);
+            write_packet_block(fp, copy, headers);
+            count++;
+        }
+    }
+
+    free(copy);
+    free(convs);
+
+    if (fclose(fp) != 0) {
+        perror("fclose");
+        return GAMING_ERROR_IO;
+    }
+
+    return count;
+}
+
+void pcap_capture_forget(int sockfd) {
+    // 從未開啟過擷取時快取必定是空的
+    if (sockfd < 0 || sockfd >= PCAP_CAPTURE_ENDPOINT_FDS ||
+        __atomic_load_n(&pcap_ring, __ATOMIC_RELAXED) == NULL) {
+        return;
+    }
+
+    // 一律推進序號, 關閉前已開始查詢的寫入者才會放棄寫入舊位址;
+    // 寫入者不會在持有奇數序號時做系統呼叫, 等待時間很短
+    pcap_endpoint_t *entry = &pcap_endpoints[sockfd];
+    uint32_t seq = __atomic_load_n(&entry->seq, __ATOMIC_RELAXED);
+    do {
+        seq &= ~1U;
+    } while (!__atomic_compare_exchange_n(&entry->seq, &seq, seq + 1, true,
+                                          __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    __atomic_store_n(&entry->valid, false, __ATOMIC_RELAXED);
+    __atomic_store_n(&entry->seq, seq + 2, __ATOMIC_RELEASE);
+}
+
+void pcap_capture_clear(void) {
+    __atomic_store_n(&pcap_base, __atomic_load_n(&pcap_head, __ATOMIC_ACQUIRE),
+                     __ATOMIC_RELEASE);
+}
@@ -0,0 +1,111 @@
+/**
+ * @file pcap_capture.h
+ * @brief socket_helper 流量擷取 (pcapng)
+ * @version 1.0.0
+ *
+ * 開啟後 socket_helper_send / recv / send_fds / recv_fds 的資料會複製到
+ * 全域共用的無鎖環狀緩衝區 (每筆最多 PCAP_CAPTURE_SNAPLEN bytes,滿了覆蓋最舊的)
+ * pcap_capture_dump() 輸出為 pcapng (LINKTYPE_RAW),每筆資料加上合成的
+ * IPv4 + TCP 標頭,可直接用 Wireshark 開啟並依連線 Follow TCP Stream:
+ *   - TCP / IPv4 連線使用 getsockname / getpeername 取得的真實位址
+ *   - Unix socket 等其他連線以 127.0.0.1 (本端) / 127.0.0.2 (對端) 表示,
+ *     port 為 10000 + fd
+ *   - sequence / ack 依擷取到的位元組數在輸出時推算
+ *
+ * 擷取預設關閉,關閉時每個 I/O 只有一次載入與分支;開啟時位址依 fd 快取,
+ * 每個連線只在第一筆資料呼叫 getsockname / getpeername,
+ * socket_helper_close 與 socket_helper_connect_* 會以 pcap_capture_forget 清除該 fd
+ *
+ * 匯出 metrics: pcap.records (counter)
+ */
+
+#ifndef PCAP_CAPTURE_H
+#define PCAP_CAPTURE_H
+
+#include "gaming_common.h"
+#include <stddef.h>
+
+// ========================================
+// Capture 配置
+// ========================================
+
+// 環狀緩衝區筆數 (2 的次方),第一次開啟時才配置
+#define PCAP_CAPTURE_RING_SIZE     512
+
+// 每筆保留的資料長度 (超過的部分截斷, 原始長度仍會記錄)
+#define PCAP_CAPTURE_SNAPLEN       1500
+
+#define PCAP_CAPTURE_DEFAULT_DUMP_PATH PATH_RUN_DIR "/gaming_capture.pcapng"
+
+// ========================================
+// Capture 型別定義
+// ========================================
+
+typedef enum {
+    PCAP_DIR_OUT = 0,            ///< 本端送出
+    PCAP_DIR_IN = 1,             ///< 本端收到
+} pcap_dir_t;
+
+// 擷取開關 (請用 pcap_capture_set_enabled 修改)
+extern bool pcap_capture_enabled_flag;
+
+// ========================================
+// Capture 公開函數
+// ========================================
+
+/**
+ * @brief 執行期開啟或關閉擷取
+ *
+ * 第一次開啟時配置環狀緩衝區,之後不會釋放 (關閉後仍可 dump)
+ *
+ * @param enabled true 開啟
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR_NO_MEMORY 配置失敗
+ */
+int pcap_capture_set_enabled(bool enabled);
+
+/**
+ * @brief 檢查擷取是否開啟
+ */
+static inline bool pcap_capture_is_enabled(void) {
+    return __builtin_expect(__atomic_load_n(&pcap_capture_enabled_flag, __ATOMIC_RELAXED), 0);
+}
+
+/**
+ * @brief 記錄一筆資料 (內部使用,呼叫前先檢查 pcap_capture_is_enabled)
+ *
+ * 可由多個執行緒同時呼叫
+ *
+ * @param sockfd 資料所屬的 socket
+ * @param dir 方向
+ * @param data 資料
+ * @param len 長度
+ */
+void pcap_capture_record(int sockfd, pcap_dir_t dir, const void *data, size_t len);
+
+/**
+ * @brief 將環狀緩衝區內容輸出為 pcapng
+ *
+ * 可在擷取進行中呼叫;輸出期間被覆蓋的記錄會略過
+ *
+ * @param path 輸出路徑, NULL 使用 PCAP_CAPTURE_DEFAULT_DUMP_PATH
+ * @return >= 0 輸出的封包數
+ * @return GAMING_ERROR_IO 寫檔失敗
+ */
+int pcap_capture_dump(const char *path);
+
+/**
+ * @brief 清除 fd 的位址快取 (fd 關閉或重新使用時呼叫)
+ *
+ * 可由多個執行緒同時呼叫;從未開啟擷取時不做任何事
+ *
+ * @param sockfd socket
+ */
+void pcap_capture_forget(int sockfd);
+
+/**
+ * @brief 清除已擷取的資料
+ */
+void pcap_capture_clear(void);
+
+#endif // PCAP_CAPTURE_H
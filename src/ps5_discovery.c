@@ -0,0 +1,674 @@
+/**
+ * @file ps5_discovery.c
+ * @brief PS5 區網探索實作
+ * @version 1.0.0
+ */
+
+#define _GNU_SOURCE
+
+#include "ps5_discovery.h"
+#include "cache_file.h"
+#include "logger.h"
+#include "metrics.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include <ifaddrs.h>
+#include <net/if.h>
+#include <arpa/inet.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <linux/neighbour.h>
+
+// ========================================
+// 內部結構
+// ========================================
+
+#define PS5_DISCOVERY_RECV_SIZE  16384
+
+typedef struct {
+    uint8_t mac[PS5_MAC_LEN];
+    struct in_addr ip;
+    uint64_t expires_ms;
+} ps5_discovery_entry_t;
+
+struct ps5_discovery {
+    int nl_fd;
+    int probe_fd;
+    int timer_fd;                // 掃描分批計時器
+    int epfd;                    // nl_fd + timer_fd
+    uint32_t nl_seq;
+    uint32_t ttl_ms;
+    int ifindex;
+
+    cache_file_t *ip_cache;
+    cache_file_t *mac_cache;
+
+    bool has_target;
+    uint8_t target_mac[PS5_MAC_LEN];
+    struct in_addr target_ip;    // 最後寫入快取的 IP (s_addr 0 表示尚未寫入)
+
+    // 掃描游標 (host byte order), probe_next > probe_last 表示沒有進行中的掃描
+    uint32_t probe_next;
+    uint32_t probe_last;
+
+    ps5_discovery_callback_t callback;
+    void *user_data;
+
+    size_t entry_count;
+    ps5_discovery_entry_t entries[PS5_DISCOVERY_MAX_ENTRIES];
+
+    // netlink 接收緩衝區, 以 uint32_t 宣告讓 nlmsghdr 4 位元組對齊
+    uint32_t recv_buf[PS5_DISCOVERY_RECV_SIZE / sizeof(uint32_t)];
+};
+
+// ========================================
+// 統計
+// ========================================
+
+static pthread_once_t discovery_metrics_once = PTHREAD_ONCE_INIT;
+static metrics_counter_t *metric_neigh_updates;
+static metrics_counter_t *metric_probes;
+static metrics_counter_t *metric_cache_writes;
+static metrics_gauge_t *metric_entries;
+
+static void discovery_metrics_register(void) {
+    metric_neigh_updates = metrics_counter_register("discovery.neigh.updates");
+    metric_probes = metrics_counter_register("discovery.probes.sent");
+    metric_cache_writes = metrics_counter_register("discovery.cache.writes");
+    metric_entries = metrics_gauge_register("discovery.entries");
+}
+
+static inline void discovery_metrics_init(void) {
+    pthread_once(&discovery_metrics_once, discovery_metrics_register);
+}
+
+// ========================================
+// 內部函數
+// ========================================
+
+static uint64_t discovery_now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000ULL + (uint64_t)ts.tv_nsec / 1000000ULL;
+}
+
+static void format_mac(const uint8_t mac[PS5_MAC_LEN], char *buf, size_t size) {
+    snprintf(buf, size, "%02x:%02x:%02x:%02x:%02x:%02x",
+             mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+}
+
+/**
+ * @brief 寫入快取檔案 (內容未改變時略過)
+ *
+ * @return 1 已寫入, 0 未改變, < 0 失敗
+ */
+static int write_cache(cache_file_t *cache, const char *content) {
+    int ret = cache_file_write_line(cache, content);
+    if (ret > 0) {
+        metrics_counter_inc(metric_cache_writes);
+    }
+    return ret;
+}
+
+/**
+ * @brief 載入既有的 IP 快取,重新啟動後 IP 未改變時不重複通知
+ */
+static void load_existing_caches(ps5_discovery_t *discovery) {
+    char buf[64];
+    uint8_t mac[PS5_MAC_LEN];
+
+    if (cache_file_read_line(discovery->mac_cache, buf, sizeof(buf)) != GAMING_OK ||
+        ps5_discovery_parse_mac(buf, mac) != GAMING_OK) {
+        return;
+    }
+
+    if (cache_file_read_line(discovery->ip_cache, buf, sizeof(buf)) == GAMING_OK) {
+        inet_pton(AF_INET, buf, &discovery->target_ip);
+    }
+}
+
+static ps5_discovery_entry_t *find_entry(ps5_discovery_t *discovery,
+                                         const uint8_t mac[PS5_MAC_LEN]) {
+    for (size_t i = 0; i < discovery->entry_count; i++) {
+        if (memcmp(discovery->entries[i].mac, mac, PS5_MAC_LEN) == 0) {
+            return &discovery->entries[i];
+        }
+    }
+    return NULL;
+}
+
+static void remove_entry(ps5_discovery_t *discovery, ps5_discovery_entry_t *entry) {
+    // 以最後一個項目填補空位
+    *entry = discovery->entries[--discovery->entry_count];
+    metrics_gauge_set(metric_entries, (int64_t)discovery->entry_count);
+}
+
+/**
+ * @brief 目標 IP 改變時更新快取並通知
+ */
+static void update_target(ps5_discovery_t *discovery, struct in_addr ip) {
+    if (ip.s_addr == discovery->target_ip.s_addr) {
+        return;
+    }
+
+    char ip_str[INET_ADDRSTRLEN];
+    inet_ntop(AF_INET, &ip, ip_str, sizeof(ip_str));
+    if (write_cache(discovery->ip_cache, ip_str) < 0) {
+        return;
+    }
+
+    discovery->target_ip = ip;
+    if (discovery->callback != NULL) {
+        discovery->callback(discovery->target_mac, ip, discovery->user_data);
+    }
+}
+
+static void handle_neigh(ps5_discovery_t *discovery, const struct nlmsghdr *nlh) {
+    const struct ndmsg *ndm = NLMSG_DATA(nlh);
+    if (nlh->nlmsg_len < NLMSG_LENGTH(sizeof(*ndm)) || ndm->ndm_family != AF_INET) {
+        return;
+    }
+    if (discovery->ifindex != 0 && ndm->ndm_ifindex != discovery->ifindex) {
+        return;
+    }
+
+    const uint8_t *mac = NULL;
+    const struct in_addr *dst = NULL;
+
+    int len = (int)RTM_PAYLOAD(nlh);
+    for (const struct rtattr *rta = RTM_RTA(ndm); RTA_OK(rta, len); rta = RTA_NEXT(rta, len)) {
+        if (rta->rta_type == NDA_DST && RTA_PAYLOAD(rta) == sizeof(struct in_addr)) {
+            dst = RTA_DATA(rta);
+        } else if (rta->rta_type == NDA_LLADDR && RTA_PAYLOAD(rta) == PS5_MAC_LEN) {
+            mac = RTA_DATA(rta);
+        }
+    }
+
+    if (mac == NULL || dst == NULL) {
+        return;
+    }
+
+    metrics_counter_inc(metric_neigh_updates);
+    ps5_discovery_entry_t *entry = find_entry(discovery, mac);
+
+    bool valid = (ndm->ndm_state & (NUD_REACHABLE | NUD_STALE | NUD_DELAY | NUD_PROBE |
+                                    NUD_PERMANENT | NUD_NOARP)) != 0;
+    if (nlh->nlmsg_type == RTM_DELNEIGH || !valid) {
+        // 只有對應的 IP 被刪除才移除 (同一 MAC 可能換了 IP)
+        if (entry != NULL && entry->ip.s_addr == dst->s_addr) {
+            remove_entry(discovery, entry);
+        }
+        return;
+    }
+
+    if (entry == NULL) {
+        if (discovery->entry_count >= PS5_DISCOVERY_MAX_ENTRIES) {
+            return;
+        }
+        entry = &discovery->entries[discovery->entry_count++];
+        memcpy(entry->mac, mac, PS5_MAC_LEN);
+        metrics_gauge_set(metric_entries, (int64_t)discovery->entry_count);
+    }
+
+    entry->ip = *dst;
+    entry->expires_ms = discovery_now_ms() + discovery->ttl_ms;
+
+    if (discovery->has_target && memcmp(mac, discovery->target_mac, PS5_MAC_LEN) == 0) {
+        update_target(discovery, *dst);
+    }
+}
+
+/**
+ * @brief 設定掃描計時器 (interval_ms 為 0 時停止)
+ */
+static void probe_timer_set(ps5_discovery_t *discovery, uint32_t interval_ms) {
+    struct itimerspec its;
+    memset(&its, 0, sizeof(its));
+    its.it_value.tv_sec = interval_ms / 1000;
+    its.it_value.tv_nsec = (long)(interval_ms % 1000) * 1000000L;
+    its.it_interval = its.it_value;
+    if (timerfd_settime(discovery->timer_fd, 0, &its, NULL) < 0) {
+        LOGM_ERRNO(LOG_MODULE_PS5, "timerfd_settime");
+    }
+}
+
+static bool probe_active(const ps5_discovery_t *discovery) {
+    return discovery->probe_next <= discovery->probe_last && discovery->probe_next != 0;
+}
+
+/**
+ * @brief 從游標送出一批探測
+ *
+ * socket 緩衝區滿 (EAGAIN / ENOBUFS) 時游標停在第一個未送出的位址;
+ * 單一位址的其他錯誤 (例如 EACCES) 只略過該位址
+ */
+static void probe_send_batch(ps5_discovery_t *discovery) {
+    static const uint8_t payload[1] = { 0 };
+    struct sockaddr_in addrs[PS5_DISCOVERY_PROBE_BATCH];
+    struct iovec iov = { (void *)payload, sizeof(payload) };
+    struct mmsghdr msgs[PS5_DISCOVERY_PROBE_BATCH];
+
+    unsigned int batch = 0;
+    for (uint32_t host = discovery->probe_next;
+         batch < PS5_DISCOVERY_PROBE_BATCH && host <= discovery->probe_last; batch++, host++) {
+        memset(&addrs[batch], 0, sizeof(addrs[batch]));
+        addrs[batch].sin_family = AF_INET;
+        addrs[batch].sin_port = htons(PS5_DISCOVERY_PROBE_PORT);
+        addrs[batch].sin_addr.s_addr = htonl(host);
+
+        memset(&msgs[batch], 0, sizeof(msgs[batch]));
+        msgs[batch].msg_hdr.msg_name = &addrs[batch];
+        msgs[batch].msg_hdr.msg_namelen = sizeof(addrs[batch]);
+        msgs[batch].msg_hdr.msg_iov = &iov;
+        msgs[batch].msg_hdr.msg_iovlen = 1;
+    }
+
+    int n = sendmmsg(discovery->probe_fd, msgs, batch, 0);
+    if (n < 0) {
+        if (errno != EAGAIN && errno != ENOBUFS) {
+            LOGM_ERRNO(LOG_MODULE_PS5, "sendmmsg");
+            discovery->probe_next++;
+        }
+    } else {
+        metrics_counter_add(metric_probes, (uint64_t)n);
+        discovery->probe_next += (uint32_t)n;
+    }
+
+    if (!probe_active(discovery)) {
+        discovery->probe_next = 0;
+        discovery->probe_last = 0;
+        probe_timer_set(discovery, 0);
+    }
+}
+
+/**
+ * @brief 取得介面的 IPv4 位址與遮罩 (host byte order)
+ */
+static int interface_network(int ifindex, uint32_t *addr, int *prefix_len) {
+    char name[IF_NAMESIZE];
+    if (ifindex == 0 || if_indextoname((unsigned int)ifindex, name) == NULL) {
+        return GAMING_ERROR_NOT_FOUND;
+    }
+
+    struct ifaddrs *list;
+    if (getifaddrs(&list) < 0) {
+        LOGM_ERRNO(LOG_MODULE_PS5, "getifaddrs");
+        return GAMING_ERROR_IO;
+    }
+
+    int ret = GAMING_ERROR_NOT_FOUND;
+    for (struct ifaddrs *ifa = list; ifa != NULL; ifa = ifa->ifa_next) {
+        if (ifa->ifa_addr == NULL || ifa->ifa_netmask == NULL ||
+            ifa->ifa_addr->sa_family != AF_INET || strcmp(ifa->ifa_name, name) != 0) {
+            continue;
+        }
+        *addr = ntohl(((const struct sockaddr_in *)ifa->ifa_addr)->sin_addr.s_addr);
+        uint32_t mask = ntohl(((const struct sockaddr_in *)ifa->ifa_netmask)->sin_addr.s_addr);
+        *prefix_len = __builtin_popcount(mask);
+        ret = GAMING_OK;
+        break;
+    }
+
+    freeifaddrs(list);
+    return ret;
+}
+
+static void expire_entries(ps5_discovery_t *discovery) {
+    uint64_t now = discovery_now_ms();
+    size_t i = 0;
+    while (i < discovery->entry_count) {
+        if (discovery->entries[i].expires_ms <= now) {
+            remove_entry(discovery, &discovery->entries[i]);
+        } else {
+            i++;
+        }
+    }
+}
+
+// ========================================
+// 公開函數
+// ========================================
+
+ps5_discovery_t *ps5_discovery_create(const ps5_discovery_config_t *config) {
+    discovery_metrics_init();
+
+    ps5_discovery_t *discovery = calloc(1, sizeof(*discovery));
+    if (discovery == NULL) {
+        return NULL;
+    }
+
+    discovery->ttl_ms = PS5_DISCOVERY_DEFAULT_TTL_MS;
+    const char *ip_cache_path = PATH_PS5_IP_CACHE;
+    const char *mac_cache_path = PATH_PS5_MAC_CACHE;
+
+    if (config != NULL) {
+        if (config->ip_cache_path != NULL) {
+            ip_cache_path = config->ip_cache_path;
+        }
+        if (config->mac_cache_path != NULL) {
+            mac_cache_path = config->mac_cache_path;
+        }
+        if (config->ttl_ms > 0) {
+            discovery->ttl_ms = config->ttl_ms;
+        }
+        discovery->ifindex = config->ifindex;
+    }
+
+    discovery->probe_fd = -1;
+    discovery->nl_fd = -1;
+    discovery->timer_fd = -1;
+    discovery->epfd = -1;
+    discovery->ip_cache = cache_file_open(ip_cache_path);
+    discovery->mac_cache = cache_file_open(mac_cache_path);
+    if (discovery->ip_cache == NULL || discovery->mac_cache == NULL) {
+        ps5_discovery_destroy(discovery);
+        return NULL;
+    }
+
+    load_existing_caches(discovery);
+
+    discovery->nl_fd = socket(AF_NETLINK, SOCK_RAW | SOCK_NONBLOCK | SOCK_CLOEXEC,
+                              NETLINK_ROUTE);
+    if (discovery->nl_fd < 0) {
+        LOGM_ERRNO(LOG_MODULE_PS5, "socket(AF_NETLINK)");
+        ps5_discovery_destroy(discovery);
+        return NULL;
+    }
+
+    struct sockaddr_nl addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.nl_family = AF_NETLINK;
+    addr.nl_groups = RTMGRP_NEIGH;
+    if (bind(discovery->nl_fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        LOGM_ERRNO(LOG_MODULE_PS5, "bind(netlink)");
+        ps5_discovery_destroy(discovery);
+        return NULL;
+    }
+
+    discovery->probe_fd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (discovery->probe_fd < 0) {
+        LOGM_ERRNO(LOG_MODULE_PS5, "socket(probe)");
+        ps5_discovery_destroy(discovery);
+        return NULL;
+    }
+
+    discovery->timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    discovery->epfd = epoll_create1(EPOLL_CLOEXEC);
+    if (discovery->timer_fd < 0 || discovery->epfd < 0) {
+        LOGM_ERRNO(LOG_MODULE_PS5, "timerfd/epoll");
+        ps5_discovery_destroy(discovery);
+        return NULL;
+    }
+
+    struct epoll_event ev = { .events = EPOLLIN };
+    ev.data.fd = discovery->nl_fd;
+    if (epoll_ctl(discovery->epfd, EPOLL_CTL_ADD, discovery->nl_fd, &ev) < 0) {
+        LOGM_ERRNO(LOG_MODULE_PS5, "epoll_ctl");
+        ps5_discovery_destroy(discovery);
+        return NULL;
+    }
+    ev.data.fd = discovery->timer_fd;
+    if (epoll_ctl(discovery->epfd, EPOLL_CTL_ADD, discovery->timer_fd, &ev) < 0) {
+        LOGM_ERRNO(LOG_MODULE_PS5, "epoll_ctl");
+        ps5_discovery_destroy(discovery);
+        return NULL;
+    }
+
+    if (ps5_discovery_refresh(discovery) != GAMING_OK) {
+        ps5_discovery_destroy(discovery);
+        return NULL;
+    }
+
+    return discovery;
+}
+
+void ps5_discovery_destroy(ps5_discovery_t *discovery) {
+    if (discovery == NULL) {
+        return;
+    }
+
+    if (discovery->nl_fd >= 0) {
+        close(discovery->nl_fd);
+    }
+    if (discovery->probe_fd >= 0) {
+        close(discovery->probe_fd);
+    }
+    if (discovery->timer_fd >= 0) {
+        close(discovery->timer_fd);
+    }
+    if (discovery->epfd >= 0) {
+        close(discovery->epfd);
+    }
+    cache_file_close(discovery->ip_cache);
+    cache_file_close(discovery->mac_cache);
+    free(discovery);
+}
+
+int ps5_discovery_get_fd(const ps5_discovery_t *discovery) {
+    if (discovery == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+    return discovery->epfd;
+}
+
+int ps5_discovery_process(ps5_discovery_t *discovery) {
+    if (discovery == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    uint32_t *buf = discovery->recv_buf;
+
+    for (;;) {
+        ssize_t n = recv(discovery->nl_fd, buf, sizeof(discovery->recv_buf), 0);
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EINTR) {
+                break;
+            }
+            if (errno == ENOBUFS) {
+                // 通知佇列溢位,重新 dump 取得完整狀態
+                ps5_discovery_refresh(discovery);
+                continue;
+            }
+            LOGM_ERRNO(LOG_MODULE_PS5, "recv(netlink)");
+            return GAMING_ERROR_IO;
+        }
+
+        int len = (int)n;
+        for (struct nlmsghdr *nlh = (struct nlmsghdr *)buf; NLMSG_OK(nlh, len);
+             nlh = NLMSG_NEXT(nlh, len)) {
+            if (nlh->nlmsg_type == RTM_NEWNEIGH || nlh->nlmsg_type == RTM_DELNEIGH) {
+                handle_neigh(discovery, nlh);
+            }
+        }
+    }
+
+    uint64_t expirations;
+    if (read(discovery->timer_fd, &expirations, sizeof(expirations)) == sizeof(expirations) &&
+        probe_active(discovery)) {
+        probe_send_batch(discovery);
+    }
+
+    expire_entries(discovery);
+    return GAMING_OK;
+}
+
+int ps5_discovery_set_target(ps5_discovery_t *discovery, const char *mac) {
+    if (discovery == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    char buf[64];
+    if (mac == NULL) {
+        if (cache_file_read_line(discovery->mac_cache, buf, sizeof(buf)) != GAMING_OK) {
+            return GAMING_ERROR_NOT_FOUND;
+        }
+        mac = buf;
+    }
+
+    uint8_t target[PS5_MAC_LEN];
+    if (ps5_discovery_parse_mac(mac, target) != GAMING_OK) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    memcpy(discovery->target_mac, target, PS5_MAC_LEN);
+    discovery->has_target = true;
+
+    // 換了目標時 IP 快取必須重寫
+    char mac_str[PS5_MAC_STRING_SIZE];
+    format_mac(target, mac_str, sizeof(mac_str));
+    if (write_cache(discovery->mac_cache, mac_str) != 0) {
+        discovery->target_ip.s_addr = 0;
+    }
+
+    ps5_discovery_entry_t *entry = find_entry(discovery, target);
+    if (entry != NULL) {
+        update_target(discovery, entry->ip);
+    }
+
+    return GAMING_OK;
+}
+
+void ps5_discovery_set_callback(ps5_discovery_t *discovery, ps5_discovery_callback_t callback,
+                                void *user_data) {
+    if (discovery == NULL) {
+        return;
+    }
+
+    discovery->callback = callback;
+    discovery->user_data = user_data;
+}
+
+int ps5_discovery_refresh(ps5_discovery_t *discovery) {
+    if (discovery == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    struct {
+        struct nlmsghdr nlh;
+        struct ndmsg ndm;
+    } req;
+    memset(&req, 0, sizeof(req));
+    req.nlh.nlmsg_len = NLMSG_LENGTH(sizeof(struct ndmsg));
+    req.nlh.nlmsg_type = RTM_GETNEIGH;
+    req.nlh.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+    req.nlh.nlmsg_seq = ++discovery->nl_seq;
+    req.ndm.ndm_family = AF_INET;
+
+    struct sockaddr_nl kernel;
+    memset(&kernel, 0, sizeof(kernel));
+    kernel.nl_family = AF_NETLINK;
+
+    if (sendto(discovery->nl_fd, &req, req.nlh.nlmsg_len, 0,
+               (struct sockaddr *)&kernel, sizeof(kernel)) < 0) {
+        LOGM_ERRNO(LOG_MODULE_PS5, "sendto(RTM_GETNEIGH)");
+        return GAMING_ERROR_IO;
+    }
+    return GAMING_OK;
+}
+
+int ps5_discovery_probe(ps5_discovery_t *discovery, const char *network, int prefix_len) {
+    if (discovery == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    uint32_t base;
+    if (network == NULL) {
+        int ret = interface_network(discovery->ifindex, &base, &prefix_len);
+        if (ret != GAMING_OK) {
+            return ret;
+        }
+        // 介面子網路大於 /24 時只掃描本機所在的 /24
+        prefix_len = MAX(prefix_len, PS5_DISCOVERY_MIN_PREFIX);
+    } else {
+        struct in_addr addr;
+        if (inet_pton(AF_INET, network, &addr) != 1) {
+            return GAMING_ERROR_INVALID_PARAM;
+        }
+        base = ntohl(addr.s_addr);
+    }
+
+    if (prefix_len < PS5_DISCOVERY_MIN_PREFIX || prefix_len > 30) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    uint32_t mask = 0xFFFFFFFFU << (32 - prefix_len);
+    discovery->probe_next = (base & mask) + 1;
+    discovery->probe_last = (base | ~mask) - 1;
+    int count = (int)(discovery->probe_last - discovery->probe_next + 1);
+
+    probe_timer_set(discovery, PS5_DISCOVERY_PROBE_INTERVAL_MS);
+    probe_send_batch(discovery);
+    return count;
+}
+
+int ps5_discovery_probe_remaining(const ps5_discovery_t *discovery) {
+    if (discovery == NULL || !probe_active(discovery)) {
+        return 0;
+    }
+    return (int)(discovery->probe_last - discovery->probe_next + 1);
+}
+
+int ps5_discovery_lookup(const ps5_discovery_t *discovery, const uint8_t mac[PS5_MAC_LEN],
+                         struct in_addr *ip) {
+    if (discovery == NULL || mac == NULL || ip == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    uint64_t now = discovery_now_ms();
+    for (size_t i = 0; i < discovery->entry_count; i++) {
+        const ps5_discovery_entry_t *entry = &discovery->entries[i];
+        if (memcmp(entry->mac, mac, PS5_MAC_LEN) == 0 && entry->expires_ms > now) {
+            *ip = entry->ip;
+            return GAMING_OK;
+        }
+    }
+    return GAMING_ERROR_NOT_FOUND;
+}
+
+int ps5_discovery_get_target_ip(const ps5_discovery_t *discovery, char *buffer, size_t size) {
+    if (discovery == NULL || buffer == NULL || size < INET_ADDRSTRLEN) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    struct in_addr ip;
+    if (!discovery->has_target ||
+        ps5_discovery_lookup(discovery, discovery->target_mac, &ip) != GAMING_OK) {
+        return GAMING_ERROR_NOT_FOUND;
+    }
+
+    inet_ntop(AF_INET, &ip, buffer, (socklen_t)size);
+    return GAMING_OK;
+}
+
+int ps5_discovery_parse_mac(const char *str, uint8_t mac[PS5_MAC_LEN]) {
+    if (str == NULL || mac == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    unsigned int bytes[PS5_MAC_LEN];
+    char sep[PS5_MAC_LEN - 1];
+    if (sscanf(str, "%2x%c%2x%c%2x%c%2x%c%2x%c%2x",
+               &bytes[0], &sep[0], &bytes[1], &sep[1], &bytes[2], &sep[2],
+               &bytes[3], &sep[3], &bytes[4], &sep[4], &bytes[5]) != 11) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    for (int i = 0; i < PS5_MAC_LEN - 1; i++) {
+        if (sep[i] != ':' && sep[i] != '-') {
+            return GAMING_ERROR_INVALID_PARAM;
+        }
+    }
+
+    for (int i = 0; i < PS5_MAC_LEN; i++) {
+        mac[i] = (uint8_t)bytes[i];
+    }
+    return GAMING_OK;
+}
@@ -0,0 +1,199 @@
+/**
+ * @file ps5_discovery.h
+ * @brief PS5 區網探索 (neighbor table)
+ * @version 1.0.0
+ *
+ * 以 rtnetlink 讀取核心 neighbor table (RTM_GETNEIGH),並訂閱 RTMGRP_NEIGH
+ * 即時接收 ARP 變化,維護 MAC → IP 對照表 (有 TTL)
+ * 探測以單一非阻塞 UDP socket 批次送出 (sendmmsg),由核心自行發出 ARP 請求,
+ * 回應同樣經由 netlink 通知進入對照表,不需要 raw socket 權限
+ * 掃描由 timerfd 分批進行 (每 PS5_DISCOVERY_PROBE_INTERVAL_MS 送出
+ * PS5_DISCOVERY_PROBE_BATCH 個),不會塞滿 socket 緩衝區,也不會一次在
+ * 鄰居表中產生大量未解析的項目
+ *
+ * 目標 MAC 的 IP 改變時才以 cache_file 重寫 PATH_PS5_IP_CACHE / PATH_PS5_MAC_CACHE
+ */
+
+#ifndef PS5_DISCOVERY_H
+#define PS5_DISCOVERY_H
+
+#include "gaming_common.h"
+#include <stddef.h>
+#include <netinet/in.h>
+
+// ========================================
+// 探索配置
+// ========================================
+
+#define PS5_DISCOVERY_MAX_ENTRIES   256
+#define PS5_DISCOVERY_DEFAULT_TTL_MS (5 * 60 * 1000)
+#define PS5_DISCOVERY_PROBE_BATCH   32          // 每次送出的探測數
+#define PS5_DISCOVERY_PROBE_INTERVAL_MS 250
+#define PS5_DISCOVERY_PROBE_PORT    9           // discard
+// 最大探測範圍 /24: 每個未回應的位址會在鄰居表停留數秒 (INCOMPLETE),
+// 254 筆仍低於預設 gc_thresh2 (512),不會觸發強制回收其他主機的項目
+#define PS5_DISCOVERY_MIN_PREFIX    24
+
+#define PS5_MAC_LEN                 6
+#define PS5_MAC_STRING_SIZE         18          // "aa:bb:cc:dd:ee:ff"
+
+// ========================================
+// 探索型別定義
+// ========================================
+
+typedef struct ps5_discovery ps5_discovery_t;
+
+/**
+ * @brief 探索設定
+ */
+typedef struct {
+    const char *ip_cache_path;   ///< NULL 使用 PATH_PS5_IP_CACHE
+    const char *mac_cache_path;  ///< NULL 使用 PATH_PS5_MAC_CACHE
+    uint32_t ttl_ms;             ///< 對照表項目存活時間, 0 使用預設值
+    int ifindex;                 ///< 只接受此介面的項目, 0 為所有介面
+} ps5_discovery_config_t;
+
+/**
+ * @brief 目標 IP 變化回呼
+ *
+ * @param mac 目標 MAC
+ * @param ip 新的 IP
+ * @param user_data 使用者資料
+ */
+typedef void (*ps5_discovery_callback_t)(const uint8_t mac[PS5_MAC_LEN], struct in_addr ip,
+                                         void *user_data);
+
+// ========================================
+// 探索公開函數
+// ========================================
+
+/**
+ * @brief 建立探索引擎
+ *
+ * 建立 netlink 與探測 socket,並送出第一次 neighbor table dump
+ *
+ * @param config 設定, NULL 使用預設值
+ * @return 引擎指標, NULL 失敗
+ */
+ps5_discovery_t *ps5_discovery_create(const ps5_discovery_config_t *config);
+
+/**
+ * @brief 銷毀探索引擎
+ *
+ * @param discovery 引擎指標
+ */
+void ps5_discovery_destroy(ps5_discovery_t *discovery);
+
+/**
+ * @brief 取得事件 fd (內含 netlink 與探測計時器的 epoll fd)
+ *
+ * 加入呼叫端的事件迴圈 (EPOLLIN),可讀時呼叫 ps5_discovery_process()
+ *
+ * @param discovery 引擎指標
+ * @return >= 0 fd
+ * @return < 0 參數錯誤
+ */
+int ps5_discovery_get_fd(const ps5_discovery_t *discovery);
+
+/**
+ * @brief 處理 netlink 訊息、送出下一批探測並清除過期項目 (不阻塞)
+ *
+ * @param discovery 引擎指標
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR_IO 讀取失敗
+ */
+int ps5_discovery_process(ps5_discovery_t *discovery);
+
+/**
+ * @brief 設定要追蹤的 PS5 MAC
+ *
+ * MAC 會寫入 MAC 快取 (內容改變時);若對照表已有此 MAC 則立即更新 IP 快取
+ *
+ * @param discovery 引擎指標
+ * @param mac MAC 字串 ("aa:bb:cc:dd:ee:ff"), NULL 則讀取 MAC 快取檔案
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR_INVALID_PARAM MAC 格式錯誤
+ * @return GAMING_ERROR_NOT_FOUND 未指定且快取檔案不存在
+ */
+int ps5_discovery_set_target(ps5_discovery_t *discovery, const char *mac);
+
+/**
+ * @brief 設定目標 IP 變化回呼
+ *
+ * @param discovery 引擎指標
+ * @param callback 回呼函數 (NULL 取消)
+ * @param user_data 使用者資料
+ */
+void ps5_discovery_set_callback(ps5_discovery_t *discovery, ps5_discovery_callback_t callback,
+                                void *user_data);
+
+/**
+ * @brief 重新 dump 核心 neighbor table
+ *
+ * @param discovery 引擎指標
+ * @return GAMING_OK 已送出
+ * @return GAMING_ERROR_IO 傳送失敗
+ */
+int ps5_discovery_refresh(ps5_discovery_t *discovery);
+
+/**
+ * @brief 開始探測整個子網路
+ *
+ * 每個位址送出一個 UDP 封包,核心會為尚未解析的位址發出 ARP 請求;
+ * 有回應的主機會經由 netlink 通知加入對照表
+ * 此函數立即送出第一批,其餘由 ps5_discovery_process() 依計時器分批送出;
+ * socket 緩衝區滿時該批停在未送出的位址,下一次計時器觸發時繼續
+ * 掃描進行中再次呼叫會以新的範圍重新開始
+ *
+ * @param discovery 引擎指標
+ * @param network 網路位址 (例如 "192.168.1.0"), NULL 使用設定介面 (ifindex)
+ *                的 IPv4 位址所在的 /24 (或更小的實際子網路)
+ * @param prefix_len 前綴長度 (PS5_DISCOVERY_MIN_PREFIX - 30), network 為 NULL 時忽略
+ * @return >= 0 此次掃描的位址數
+ * @return GAMING_ERROR_INVALID_PARAM 參數錯誤
+ * @return GAMING_ERROR_NOT_FOUND network 為 NULL 且介面沒有 IPv4 位址
+ */
+int ps5_discovery_probe(ps5_discovery_t *discovery, const char *network, int prefix_len);
+
+/**
+ * @brief 取得進行中的掃描尚未送出的位址數
+ *
+ * @param discovery 引擎指標
+ * @return >= 0 剩餘位址數 (0 表示沒有進行中的掃描)
+ */
+int ps5_discovery_probe_remaining(const ps5_discovery_t *discovery);
+
+/**
+ * @brief 查詢 MAC 對應的 IP
+ *
+ * @param discovery 引擎指標
+ * @param mac MAC
+ * @param ip 輸出 IP
+ * @return GAMING_OK 找到
+ * @return GAMING_ERROR_NOT_FOUND 不在對照表中或已過期
+ */
+int ps5_discovery_lookup(const ps5_discovery_t *discovery, const uint8_t mac[PS5_MAC_LEN],
+                         struct in_addr *ip);
+
+/**
+ * @brief 取得目標 PS5 的 IP 字串
+ *
+ * @param discovery 引擎指標
+ * @param buffer 輸出緩衝區
+ * @param size 緩衝區大小 (至少 INET_ADDRSTRLEN)
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR_NOT_FOUND 尚未找到
+ */
+int ps5_discovery_get_target_ip(const ps5_discovery_t *discovery, char *buffer, size_t size);
+
+/**
+ * @brief 解析 MAC 字串
+ *
+ * @param str MAC 字串 (':' 或 '-' 分隔)
+ * @param mac 輸出 MAC
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR_INVALID_PARAM 格式錯誤
+ */
+int ps5_discovery_parse_mac(const char *str, uint8_t mac[PS5_MAC_LEN]);
+
+#endif // PS5_DISCOVERY_H
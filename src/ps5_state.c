@@ -0,0 +1,328 @@
+/**
+ * @file ps5_state.c
+ * @brief PS5 狀態追蹤引擎實作
+ * @version 1.0.0
+ */
+
+#include "ps5_state.h"
+#include "logger.h"
+#include "metrics.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/timerfd.h>
+
+#define PS5_STATE_NEVER  UINT64_MAX
+
+// ========================================
+// 內部結構
+// ========================================
+
+typedef struct {
+    ps5_state_t state;           // PS5_STATE_UNKNOWN 表示沒有證據
+    uint64_t reported_ms;
+} evidence_t;
+
+typedef struct {
+    ps5_state_callback_t callback;
+    void *user_data;
+} subscriber_t;
+
+struct ps5_state_engine {
+    ps5_state_config_t config;
+    int timer_fd;
+    uint64_t armed_ms;           // 目前 timerfd 的期限, PS5_STATE_NEVER 表示未啟動
+
+    evidence_t evidence[PS5_EVIDENCE_COUNT];
+
+    ps5_state_t state;
+    uint64_t state_since_ms;
+
+    ps5_state_t pending;         // 候選狀態, 等於 state 表示沒有候選
+    uint64_t pending_since_ms;
+
+    subscriber_t subscribers[PS5_STATE_MAX_SUBSCRIBERS];
+};
+
+static const uint32_t default_weight[PS5_EVIDENCE_COUNT] = { 3, 1, 2, 10 };
+static const uint32_t default_ttl_ms[PS5_EVIDENCE_COUNT] = {
+    UINT32_MAX, 60 * 1000, 30 * 1000, UINT32_MAX,
+};
+
+// ========================================
+// 統計
+// ========================================
+
+static pthread_once_t ps5_state_metrics_once = PTHREAD_ONCE_INIT;
+static metrics_counter_t *metric_reports;
+static metrics_counter_t *metric_transitions;
+static metrics_counter_t *metric_suppressed;
+
+static void ps5_state_metrics_register(void) {
+    metric_reports = metrics_counter_register("ps5_state.reports");
+    metric_transitions = metrics_counter_register("ps5_state.transitions");
+    metric_suppressed = metrics_counter_register("ps5_state.suppressed");
+}
+
+static inline void ps5_state_metrics_init(void) {
+    pthread_once(&ps5_state_metrics_once, ps5_state_metrics_register);
+}
+
+// ========================================
+// 內部輔助函數
+// ========================================
+
+static uint64_t monotonic_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + (uint64_t)ts.tv_nsec / 1000000;
+}
+
+static bool evidence_fresh(const ps5_state_engine_t *engine, int source, uint64_t now_ms) {
+    const evidence_t *ev = &engine->evidence[source];
+    if (ev->state == PS5_STATE_UNKNOWN) {
+        return false;
+    }
+    uint32_t ttl = engine->config.ttl_ms[source];
+    return ttl == UINT32_MAX || now_ms < ev->reported_ms + ttl;
+}
+
+/**
+ * @brief 以新鮮證據的權重加總計分, 回傳得分最高的狀態
+ *
+ * 同分時偏好目前狀態; 沒有任何證據時回傳 PS5_STATE_UNKNOWN
+ */
+static ps5_state_t fuse(const ps5_state_engine_t *engine, uint64_t now_ms,
+                        uint32_t score[PS5_STATE_OFF + 1]) {
+    memset(score, 0, sizeof(uint32_t) * (PS5_STATE_OFF + 1));
+    for (int i = 0; i < PS5_EVIDENCE_COUNT; i++) {
+        if (evidence_fresh(engine, i, now_ms)) {
+            score[engine->evidence[i].state] += engine->config.weight[i];
+        }
+    }
+
+    ps5_state_t best = PS5_STATE_UNKNOWN;
+    uint32_t best_score = 0;
+    for (int s = PS5_STATE_ON; s <= PS5_STATE_OFF; s++) {
+        if (score[s] > best_score ||
+            (score[s] == best_score && score[s] > 0 && (ps5_state_t)s == engine->state)) {
+            best = (ps5_state_t)s;
+            best_score = score[s];
+        }
+    }
+    return best;
+}
+
+static void arm_timer(ps5_state_engine_t *engine, uint64_t deadline_ms) {
+    if (deadline_ms == engine->armed_ms) {
+        return;
+    }
+
+    struct itimerspec its;
+    memset(&its, 0, sizeof(its));
+    if (deadline_ms != PS5_STATE_NEVER) {
+        // 0 會停用 timerfd, 已過期的期限至少設為 1 ns
+        its.it_value.tv_sec = (time_t)(deadline_ms / 1000);
+        its.it_value.tv_nsec = (long)(deadline_ms % 1000) * 1000000L;
+        if (its.it_value.tv_sec == 0 && its.it_value.tv_nsec == 0) {
+            its.it_value.tv_nsec = 1;
+        }
+    }
+
+    if (timerfd_settime(engine->timer_fd, TFD_TIMER_ABSTIME, &its, NULL) < 0) {
+        LOGM_ERRNO(LOG_MODULE_PS5, "timerfd_settime");
+        return;
+    }
+    engine->armed_ms = deadline_ms;
+}
+
+static void notify(ps5_state_engine_t *engine, ps5_state_t old_state, ps5_state_t new_state) {
+    for (int i = 0; i < PS5_STATE_MAX_SUBSCRIBERS; i++) {
+        subscriber_t *sub = &engine->subscribers[i];
+        if (sub->callback != NULL) {
+            sub->callback(old_state, new_state, sub->user_data);
+        }
+    }
+}
+
+/**
+ * @brief 重新評估狀態並設定下一個期限
+ *
+ * 候選狀態在 confirm_ms 內若改變或消失即重新計時 (抖動被合併或抑制);
+ * 從 PS5_STATE_UNKNOWN 出發的第一次切換不需等待
+ * 目前狀態的證據都已過期時不套用 hysteresis, 否則低權重來源永遠無法讓狀態離開
+ */
+static void evaluate(ps5_state_engine_t *engine, uint64_t now_ms) {
+    uint32_t score[PS5_STATE_OFF + 1];
+    ps5_state_t candidate = fuse(engine, now_ms, score);
+
+    if (candidate != engine->state && candidate != PS5_STATE_UNKNOWN &&
+        engine->state != PS5_STATE_UNKNOWN && score[engine->state] > 0 &&
+        score[candidate] < score[engine->state] + engine->config.hysteresis) {
+        candidate = engine->state;
+    }
+
+    if (candidate != engine->pending) {
+        if (engine->pending != engine->state) {
+            metrics_counter_inc(metric_suppressed);
+        }
+        engine->pending = candidate;
+        engine->pending_since_ms = now_ms;
+    }
+
+    uint64_t deadline = PS5_STATE_NEVER;
+
+    if (engine->pending != engine->state) {
+        bool initial = engine->state == PS5_STATE_UNKNOWN;
+        uint64_t confirm_at = initial ? now_ms
+                                      : engine->pending_since_ms + engine->config.confirm_ms;
+        uint64_t dwell_at = initial ? now_ms
+                                    : engine->state_since_ms + engine->config.min_dwell_ms;
+        uint64_t ready_at = MAX(confirm_at, dwell_at);
+
+        if (now_ms >= ready_at) {
+            ps5_state_t old_state = engine->state;
+            engine->state = engine->pending;
+            engine->state_since_ms = now_ms;
+            metrics_counter_inc(metric_transitions);
+            notify(engine, old_state, engine->state);
+        } else {
+            deadline = ready_at;
+        }
+    }
+
+    // 證據過期會改變計分, 在最早的過期時間重新評估
+    for (int i = 0; i < PS5_EVIDENCE_COUNT; i++) {
+        if (evidence_fresh(engine, i, now_ms) && engine->config.ttl_ms[i] != UINT32_MAX) {
+            deadline = MIN(deadline, engine->evidence[i].reported_ms + engine->config.ttl_ms[i]);
+        }
+    }
+
+    arm_timer(engine, deadline);
+}
+
+// ========================================
+// 公開函數實作
+// ========================================
+
+ps5_state_engine_t *ps5_state_create(const ps5_state_config_t *config) {
+    ps5_state_metrics_init();
+
+    ps5_state_engine_t *engine = calloc(1, sizeof(*engine));
+    if (engine == NULL) {
+        return NULL;
+    }
+
+    if (config != NULL) {
+        engine->config = *config;
+    }
+    if (engine->config.confirm_ms == 0) {
+        engine->config.confirm_ms = PS5_STATE_DEFAULT_CONFIRM_MS;
+    }
+    if (engine->config.min_dwell_ms == 0) {
+        engine->config.min_dwell_ms = PS5_STATE_DEFAULT_DWELL_MS;
+    }
+    if (engine->config.hysteresis == 0) {
+        engine->config.hysteresis = PS5_STATE_DEFAULT_HYSTERESIS;
+    }
+    for (int i = 0; i < PS5_EVIDENCE_COUNT; i++) {
+        if (engine->config.weight[i] == 0) {
+            engine->config.weight[i] = default_weight[i];
+        }
+        if (engine->config.ttl_ms[i] == 0) {
+            engine->config.ttl_ms[i] = default_ttl_ms[i];
+        }
+    }
+
+    engine->timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (engine->timer_fd < 0) {
+        LOGM_ERRNO(LOG_MODULE_PS5, "timerfd_create");
+        free(engine);
+        return NULL;
+    }
+
+    engine->armed_ms = PS5_STATE_NEVER;
+    engine->state = PS5_STATE_UNKNOWN;
+    engine->pending = PS5_STATE_UNKNOWN;
+    engine->state_since_ms = monotonic_ms();
+    return engine;
+}
+
+void ps5_state_destroy(ps5_state_engine_t *engine) {
+    if (engine == NULL) {
+        return;
+    }
+
+    close(engine->timer_fd);
+    free(engine);
+}
+
+int ps5_state_get_fd(const ps5_state_engine_t *engine) {
+    if (engine == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+    return engine->timer_fd;
+}
+
+int ps5_state_process(ps5_state_engine_t *engine) {
+    if (engine == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    uint64_t expirations;
+    if (read(engine->timer_fd, &expirations, sizeof(expirations)) < 0 && errno != EAGAIN) {
+        LOGM_ERRNO(LOG_MODULE_PS5, "read timerfd");
+    }
+
+    engine->armed_ms = PS5_STATE_NEVER;
+    evaluate(engine, monotonic_ms());
+    return GAMING_OK;
+}
+
+int ps5_state_report(ps5_state_engine_t *engine, ps5_evidence_source_t source,
+                     ps5_state_t state) {
+    if (engine == NULL || source < 0 || source >= PS5_EVIDENCE_COUNT ||
+        state < PS5_STATE_UNKNOWN || state > PS5_STATE_OFF) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    uint64_t now_ms = monotonic_ms();
+    engine->evidence[source].state = state;
+    engine->evidence[source].reported_ms = now_ms;
+    metrics_counter_inc(metric_reports);
+
+    evaluate(engine, now_ms);
+    return GAMING_OK;
+}
+
+ps5_state_t ps5_state_get(const ps5_state_engine_t *engine) {
+    return engine != NULL ? engine->state : PS5_STATE_UNKNOWN;
+}
+
+int ps5_state_subscribe(ps5_state_engine_t *engine, ps5_state_callback_t callback,
+                        void *user_data) {
+    if (engine == NULL || callback == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    for (int i = 0; i < PS5_STATE_MAX_SUBSCRIBERS; i++) {
+        if (engine->subscribers[i].callback == NULL) {
+            engine->subscribers[i].callback = callback;
+            engine->subscribers[i].user_data = user_data;
+            return i;
+        }
+    }
+    return GAMING_ERROR_NO_MEMORY;
+}
+
+void ps5_state_unsubscribe(ps5_state_engine_t *engine, int id) {
+    if (engine == NULL || id < 0 || id >= PS5_STATE_MAX_SUBSCRIBERS) {
+        return;
+    }
+    engine->subscribers[id].callback = NULL;
+    engine->subscribers[id].user_data = NULL;
+}
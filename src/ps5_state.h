@@ -0,0 +1,149 @@
+/**
+ * @file ps5_state.h
+ * @brief PS5 狀態追蹤引擎
+ * @version 1.0.0
+ *
+ * 融合多個證據來源 (CEC、neighbor table、主動探測、手動設定) 決定 ps5_state_t:
+ *   - 每個來源有權重與有效期限,過期的證據不再計分
+ *   - 候選狀態的分數必須超過目前狀態至少 hysteresis (目前狀態已無有效證據時不需要),
+ *     並持續 confirm_ms (期間的來回跳動會被合併) 才會切換
+ *   - 每次切換後至少維持 min_dwell_ms
+ *   - 只有真正的切換才通知訂閱者,降低 LED、日誌與廣播在抖動時的負擔
+ *
+ * 期限以 timerfd 驅動 (get_fd / process),所有函數須在同一個執行緒呼叫
+ *
+ * 匯出 metrics: ps5_state.reports / ps5_state.transitions /
+ * ps5_state.suppressed (被合併或抑制的候選狀態) (counter)
+ */
+
+#ifndef PS5_STATE_H
+#define PS5_STATE_H
+
+#include "gaming_common.h"
+
+// ========================================
+// 狀態引擎配置
+// ========================================
+
+#define PS5_STATE_MAX_SUBSCRIBERS     8
+
+#define PS5_STATE_DEFAULT_CONFIRM_MS  2000
+#define PS5_STATE_DEFAULT_DWELL_MS    5000
+#define PS5_STATE_DEFAULT_HYSTERESIS  2   // 同分已由目前狀態勝出, 1 等於沒有遲滯
+
+// ========================================
+// 狀態引擎型別定義
+// ========================================
+
+/**
+ * @brief 證據來源
+ */
+typedef enum {
+    PS5_EVIDENCE_CEC = 0,        ///< HDMI-CEC 電源狀態 (預設權重 3, 不過期)
+    PS5_EVIDENCE_NETWORK = 1,    ///< neighbor table 可達性 (預設權重 1, 60 秒)
+    PS5_EVIDENCE_PROBE = 2,      ///< 主動探測結果 (預設權重 2, 30 秒)
+    PS5_EVIDENCE_MANUAL = 3,     ///< 手動指定 (預設權重 10, 不過期)
+    PS5_EVIDENCE_COUNT,
+} ps5_evidence_source_t;
+
+typedef struct ps5_state_engine ps5_state_engine_t;
+
+/**
+ * @brief 引擎設定 (0 使用預設值)
+ */
+typedef struct {
+    uint32_t confirm_ms;                       ///< 候選狀態需持續的時間
+    uint32_t min_dwell_ms;                     ///< 切換後的最短維持時間
+    uint32_t hysteresis;                       ///< 候選分數需超過目前狀態的差距 (>= 2 才有作用)
+    uint32_t weight[PS5_EVIDENCE_COUNT];       ///< 各來源權重
+    uint32_t ttl_ms[PS5_EVIDENCE_COUNT];       ///< 各來源有效期限 (UINT32_MAX 不過期)
+} ps5_state_config_t;
+
+/**
+ * @brief 狀態切換回呼
+ *
+ * @param old_state 舊狀態
+ * @param new_state 新狀態
+ * @param user_data 使用者資料
+ */
+typedef void (*ps5_state_callback_t)(ps5_state_t old_state, ps5_state_t new_state,
+                                     void *user_data);
+
+// ========================================
+// 狀態引擎公開函數
+// ========================================
+
+/**
+ * @brief 建立狀態引擎 (初始為 PS5_STATE_UNKNOWN)
+ *
+ * @param config 設定, NULL 使用預設值
+ * @return 引擎指標, NULL 失敗
+ */
+ps5_state_engine_t *ps5_state_create(const ps5_state_config_t *config);
+
+/**
+ * @brief 銷毀狀態引擎
+ *
+ * @param engine 引擎指標
+ */
+void ps5_state_destroy(ps5_state_engine_t *engine);
+
+/**
+ * @brief 取得期限計時器 fd
+ *
+ * 加入呼叫端的事件迴圈 (EPOLLIN),可讀時呼叫 ps5_state_process()
+ *
+ * @param engine 引擎指標
+ * @return >= 0 timerfd
+ * @return < 0 參數錯誤
+ */
+int ps5_state_get_fd(const ps5_state_engine_t *engine);
+
+/**
+ * @brief 處理到期的期限 (不阻塞)
+ *
+ * @param engine 引擎指標
+ * @return GAMING_OK 成功
+ */
+int ps5_state_process(ps5_state_engine_t *engine);
+
+/**
+ * @brief 回報一個來源的觀察結果
+ *
+ * PS5_STATE_UNKNOWN 表示撤回該來源的證據
+ *
+ * @param engine 引擎指標
+ * @param source 證據來源
+ * @param state 觀察到的狀態
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR_INVALID_PARAM 參數錯誤
+ */
+int ps5_state_report(ps5_state_engine_t *engine, ps5_evidence_source_t source,
+                     ps5_state_t state);
+
+/**
+ * @brief 取得目前 (已確認) 的狀態
+ */
+ps5_state_t ps5_state_get(const ps5_state_engine_t *engine);
+
+/**
+ * @brief 訂閱狀態切換
+ *
+ * @param engine 引擎指標
+ * @param callback 回呼函數
+ * @param user_data 使用者資料
+ * @return >= 0 訂閱編號
+ * @return GAMING_ERROR_NO_MEMORY 已達 PS5_STATE_MAX_SUBSCRIBERS
+ */
+int ps5_state_subscribe(ps5_state_engine_t *engine, ps5_state_callback_t callback,
+                        void *user_data);
+
+/**
+ * @brief 取消訂閱
+ *
+ * @param engine 引擎指標
+ * @param id 訂閱編號
+ */
+void ps5_state_unsubscribe(ps5_state_engine_t *engine, int id);
+
+#endif // PS5_STATE_H
@@ -0,0 +1,481 @@
+/**
+ * @file relay.c
+ * @brief 雙向 Socket 轉發引擎實作
+ * @version 1.0.0
+ */
+
+#define _GNU_SOURCE  // 需要這個才能使用 splice / pipe2 / F_SETPIPE_SZ
+
+#include "relay.h"
+#include "logger.h"
+#include "socket_helper.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/epoll.h>
+
+// ========================================
+// 內部結構
+// ========================================
+
+/**
+ * @brief 單一方向的轉送狀態 (src → dst)
+ */
+typedef struct {
+    int src;
+    int dst;
+    int pipe_rd;             // splice 模式使用的 pipe
+    int pipe_wr;
+    char *buffer;            // 退回模式使用的緩衝區
+    size_t buffer_off;       // 緩衝區中尚未送出的資料起點
+    size_t pending;          // pipe / 緩衝區中尚未送出的位元組數
+    size_t capacity;
+    bool src_eof;
+    bool shut_done;          // 已對 dst 執行 shutdown(SHUT_WR)
+    uint64_t bytes;
+} relay_dir_t;
+
+struct relay {
+    int fd_a;
+    int fd_b;
+    int epfd;
+    uint32_t events_a;       // 目前在 epoll 中註冊的事件
+    uint32_t events_b;
+    bool failed;
+    relay_dir_t a_to_b;
+    relay_dir_t b_to_a;
+};
+
+// ========================================
+// 內部輔助函數
+// ========================================
+
+/**
+ * @brief 初始化單一方向,優先建立 splice pipe
+ */
+static int relay_dir_init(relay_dir_t *dir, int src, int dst, bool zero_copy) {
+    memset(dir, 0, sizeof(*dir));
+    dir->src = src;
+    dir->dst = dst;
+    dir->pipe_rd = -1;
+    dir->pipe_wr = -1;
+
+    if (zero_copy) {
+        int fds[2];
+        if (pipe2(fds, O_NONBLOCK | O_CLOEXEC) == 0) {
+            dir->pipe_rd = fds[0];
+            dir->pipe_wr = fds[1];
+
+            fcntl(dir->pipe_wr, F_SETPIPE_SZ, RELAY_DEFAULT_BUFFER_SIZE);
+            int size = fcntl(dir->pipe_wr, F_GETPIPE_SZ);
+            dir->capacity = (size > 0) ? (size_t)size : RELAY_DEFAULT_BUFFER_SIZE;
+            return GAMING_OK;
+        }
+    }
+
+    dir->buffer = malloc(RELAY_DEFAULT_BUFFER_SIZE);
+    if (dir->buffer == NULL) {
+        return GAMING_ERROR_NO_MEMORY;
+    }
+    dir->capacity = RELAY_DEFAULT_BUFFER_SIZE;
+    return GAMING_OK;
+}
+
+static void relay_dir_cleanup(relay_dir_t *dir) {
+    if (dir->pipe_rd >= 0) {
+        close(dir->pipe_rd);
+    }
+    if (dir->pipe_wr >= 0) {
+        close(dir->pipe_wr);
+    }
+    free(dir->buffer);
+    dir->pipe_rd = -1;
+    dir->pipe_wr = -1;
+    dir->buffer = NULL;
+}
+
+/**
+ * @brief 將單一方向從 splice 模式切換為緩衝區模式
+ */
+static int relay_dir_fallback(relay_dir_t *dir) {
+    char *buffer = malloc(RELAY_DEFAULT_BUFFER_SIZE);
+    if (buffer == NULL) {
+        return GAMING_ERROR_NO_MEMORY;
+    }
+
+    relay_dir_cleanup(dir);
+    dir->buffer = buffer;
+    dir->buffer_off = 0;
+    dir->capacity = RELAY_DEFAULT_BUFFER_SIZE;
+    return GAMING_OK;
+}
+
+/**
+ * @brief 從來源端讀入 pipe / 緩衝區
+ *
+ * @return > 0 讀入位元組數, 0 EOF, -1 暫時無資料, -2 錯誤
+ */
+static ssize_t relay_dir_fill(relay_dir_t *dir) {
+    size_t room = dir->capacity - dir->pending;
+    ssize_t n;
+
+    if (dir->pipe_wr >= 0) {
+        n = splice(dir->src, NULL, dir->pipe_wr, NULL, room,
+                   SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+    } else {
+        // 緩衝區已送空時從頭開始填,避免資料搬移
+        if (dir->pending == 0) {
+            dir->buffer_off = 0;
+        }
+        size_t tail = dir->buffer_off + dir->pending;
+        if (tail >= dir->capacity) {
+            return -1;
+        }
+        n = recv(dir->src, dir->buffer + tail, dir->capacity - tail, 0);
+    }
+
+    if (n > 0) {
+        dir->pending += (size_t)n;
+        return n;
+    }
+    if (n == 0) {
+        return 0;
+    }
+    if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+        return -1;
+    }
+    // 來源端不支援 splice 時,改用緩衝區模式重試
+    if (errno == EINVAL && dir->pipe_wr >= 0 && dir->pending == 0) {
+        if (relay_dir_fallback(dir) == GAMING_OK) {
+            return relay_dir_fill(dir);
+        }
+    }
+    return -2;
+}
+
+/**
+ * @brief 將 pipe / 緩衝區中的資料寫到目的端
+ *
+ * @return > 0 寫出位元組數, -1 目的端塞住, -2 錯誤
+ */
+static ssize_t relay_dir_drain(relay_dir_t *dir) {
+    ssize_t n;
+
+    if (dir->pipe_rd >= 0) {
+        n = splice(dir->pipe_rd, NULL, dir->dst, NULL, dir->pending,
+                   SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+    } else {
+        n = send(dir->dst, dir->buffer + dir->buffer_off, dir->pending,
+                 MSG_NOSIGNAL);
+    }
+
+    if (n > 0) {
+        dir->pending -= (size_t)n;
+        dir->bytes += (uint64_t)n;
+        if (dir->pipe_rd < 0) {
+            dir->buffer_off = (dir->pending == 0) ? 0 : dir->buffer_off + (size_t)n;
+        }
+        return n;
+    }
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+        return -1;
+    }
+    // EPIPE / ECONNRESET: 目的端已關閉,此方向無法再送出,整個轉送視為失敗
+    return -2;
+}
+
+/**
+ * @brief 在目前執行緒阻擋 SIGPIPE
+ *
+ * splice 沒有 MSG_NOSIGNAL,寫入已關閉的 socket 會產生 SIGPIPE (預設結束程式)
+ *
+ * @return true 原本未阻擋, 結束時需呼叫 relay_sigpipe_restore()
+ */
+static bool relay_sigpipe_block(sigset_t *old) {
+    sigset_t set;
+    sigemptyset(&set);
+    sigaddset(&set, SIGPIPE);
+    pthread_sigmask(SIG_BLOCK, &set, old);
+    return !sigismember(old, SIGPIPE);
+}
+
+/**
+ * @brief 丟棄轉送期間產生的 SIGPIPE 並恢復 signal mask
+ */
+static void relay_sigpipe_restore(const sigset_t *old) {
+    sigset_t pending;
+    sigemptyset(&pending);
+    if (sigpending(&pending) == 0 && sigismember(&pending, SIGPIPE)) {
+        sigset_t set;
+        sigemptyset(&set);
+        sigaddset(&set, SIGPIPE);
+        struct timespec zero = { 0, 0 };
+        while (sigtimedwait(&set, NULL, &zero) < 0 && errno == EINTR) {
+        }
+    }
+    pthread_sigmask(SIG_SETMASK, old, NULL);
+}
+
+/**
+ * @brief 在單一方向上盡可能轉送資料
+ *
+ * @return GAMING_OK 成功, GAMING_ERROR_IO 錯誤
+ */
+static int relay_dir_pump(relay_dir_t *dir) {
+    bool progress = true;
+
+    while (progress) {
+        progress = false;
+
+        if (!dir->src_eof && dir->pending < dir->capacity) {
+            ssize_t n = relay_dir_fill(dir);
+            if (n > 0) {
+                progress = true;
+            } else if (n == 0) {
+                dir->src_eof = true;
+            } else if (n == -2) {
+                return GAMING_ERROR_IO;
+            }
+        }
+
+        if (dir->pending > 0) {
+            ssize_t n = relay_dir_drain(dir);
+            if (n > 0) {
+                progress = true;
+            } else if (n == -2) {
+                return GAMING_ERROR_IO;
+            }
+        }
+    }
+
+    // 來源端 EOF 且資料已送完,將半關閉傳遞給目的端
+    if (dir->src_eof && dir->pending == 0 && !dir->shut_done) {
+        shutdown(dir->dst, SHUT_WR);
+        dir->shut_done = true;
+    }
+
+    return GAMING_OK;
+}
+
+/**
+ * @brief 依背壓狀態計算某個 fd 需要的 epoll 事件
+ *
+ * in_dir: 此 fd 為來源端的方向; out_dir: 此 fd 為目的端的方向
+ */
+static uint32_t relay_wanted_events(const relay_dir_t *in_dir, const relay_dir_t *out_dir) {
+    uint32_t events = 0;
+
+    if (!in_dir->src_eof && in_dir->pending < in_dir->capacity) {
+        events |= EPOLLIN;
+    }
+    if (out_dir->pending > 0) {
+        events |= EPOLLOUT;
+    }
+    return events;
+}
+
+/**
+ * @brief 更新 fd 在 epoll 中的事件
+ *
+ * 不需要任何事件時將 fd 移出 epoll: EPOLLERR / EPOLLHUP 無法遮罩,
+ * 留在 level-triggered 的 epfd 中會在對端重設後不斷喚醒,而此時沒有
+ * 可轉送的資料,relay_process 會形成忙碌迴圈;之後若需要寫入,
+ * 錯誤會由 write / splice 回報
+ */
+static int relay_update_interest(int epfd, int fd, uint32_t *current, uint32_t wanted) {
+    if (*current == wanted) {
+        return GAMING_OK;
+    }
+
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = wanted;
+    ev.data.fd = fd;
+
+    int op = (wanted == 0) ? EPOLL_CTL_DEL : (*current == 0) ? EPOLL_CTL_ADD : EPOLL_CTL_MOD;
+    if (epoll_ctl(epfd, op, fd, &ev) < 0) {
+        LOGM_ERRNO(LOG_MODULE_RELAY, "epoll_ctl");
+        return GAMING_ERROR;
+    }
+
+    *current = wanted;
+    return GAMING_OK;
+}
+
+static int relay_add_fd(int epfd, int fd, uint32_t events) {
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = events;
+    ev.data.fd = fd;
+
+    if (epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+        LOGM_ERRNO(LOG_MODULE_RELAY, "epoll_ctl(EPOLL_CTL_ADD)");
+        return GAMING_ERROR;
+    }
+    return GAMING_OK;
+}
+
+// ========================================
+// 公開函數實作
+// ========================================
+
+relay_t *relay_create(int fd_a, int fd_b) {
+    if (fd_a < 0 || fd_b < 0 || fd_a == fd_b) {
+        return NULL;
+    }
+
+    if (socket_helper_set_nonblocking(fd_a) != GAMING_OK ||
+        socket_helper_set_nonblocking(fd_b) != GAMING_OK) {
+        return NULL;
+    }
+
+    relay_t *relay = calloc(1, sizeof(*relay));
+    if (relay == NULL) {
+        return NULL;
+    }
+
+    relay->fd_a = fd_a;
+    relay->fd_b = fd_b;
+    relay->a_to_b.pipe_rd = relay->a_to_b.pipe_wr = -1;
+    relay->b_to_a.pipe_rd = relay->b_to_a.pipe_wr = -1;
+
+    // 無法建立 pipe 時該方向自動使用緩衝區模式
+    if (relay_dir_init(&relay->a_to_b, fd_a, fd_b, true) != GAMING_OK ||
+        relay_dir_init(&relay->b_to_a, fd_b, fd_a, true) != GAMING_OK) {
+        goto fail;
+    }
+
+    relay->epfd = epoll_create1(EPOLL_CLOEXEC);
+    if (relay->epfd < 0) {
+        LOGM_ERRNO(LOG_MODULE_RELAY, "epoll_create1");
+        goto fail;
+    }
+
+    relay->events_a = EPOLLIN;
+    relay->events_b = EPOLLIN;
+    if (relay_add_fd(relay->epfd, fd_a, relay->events_a) != GAMING_OK ||
+        relay_add_fd(relay->epfd, fd_b, relay->events_b) != GAMING_OK) {
+        close(relay->epfd);
+        goto fail;
+    }
+
+    return relay;
+
+fail:
+    relay_dir_cleanup(&relay->a_to_b);
+    relay_dir_cleanup(&relay->b_to_a);
+    free(relay);
+    return NULL;
+}
+
+void relay_destroy(relay_t *relay) {
+    if (relay == NULL) {
+        return;
+    }
+
+    relay_dir_cleanup(&relay->a_to_b);
+    relay_dir_cleanup(&relay->b_to_a);
+    close(relay->epfd);
+    socket_helper_close(relay->fd_a);
+    socket_helper_close(relay->fd_b);
+    free(relay);
+}
+
+int relay_get_fd(const relay_t *relay) {
+    if (relay == NULL) {
+        return -1;
+    }
+    return relay->epfd;
+}
+
+int relay_process(relay_t *relay) {
+    if (relay == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    if (relay->failed) {
+        return GAMING_ERROR_IO;
+    }
+
+    // 轉送不依賴個別事件 (level-triggered),兩個方向都嘗試一次
+    sigset_t old_mask;
+    bool restore = relay_sigpipe_block(&old_mask);
+    int ret = relay_dir_pump(&relay->a_to_b);
+    if (ret == GAMING_OK) {
+        ret = relay_dir_pump(&relay->b_to_a);
+    }
+    if (restore) {
+        relay_sigpipe_restore(&old_mask);
+    }
+
+    if (ret != GAMING_OK) {
+        relay->failed = true;
+        return GAMING_ERROR_IO;
+    }
+
+    if (relay_update_interest(relay->epfd, relay->fd_a, &relay->events_a,
+            relay_wanted_events(&relay->a_to_b, &relay->b_to_a)) != GAMING_OK ||
+        relay_update_interest(relay->epfd, relay->fd_b, &relay->events_b,
+            relay_wanted_events(&relay->b_to_a, &relay->a_to_b)) != GAMING_OK) {
+        relay->failed = true;
+        return GAMING_ERROR_IO;
+    }
+
+    return GAMING_OK;
+}
+
+int relay_run(relay_t *relay, int idle_timeout_ms) {
+    if (relay == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    int timeout = (idle_timeout_ms > 0) ? idle_timeout_ms : -1;
+
+    // 先處理一次,以便已在 socket 中的資料立即轉送
+    int ret = relay_process(relay);
+
+    while (ret == GAMING_OK && !relay_is_finished(relay)) {
+        struct epoll_event events[2];
+        int n = epoll_wait(relay->epfd, events, ARRAY_SIZE(events), timeout);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            LOGM_ERRNO(LOG_MODULE_RELAY, "epoll_wait");
+            return GAMING_ERROR_IO;
+        }
+        if (n == 0) {
+            return GAMING_ERROR_TIMEOUT;
+        }
+
+        ret = relay_process(relay);
+    }
+
+    return ret;
+}
+
+bool relay_is_finished(const relay_t *relay) {
+    if (relay == NULL) {
+        return true;
+    }
+    return relay->a_to_b.shut_done && relay->b_to_a.shut_done;
+}
+
+int relay_get_stats(const relay_t *relay, relay_stats_t *stats) {
+    if (relay == NULL || stats == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    stats->bytes_a_to_b = relay->a_to_b.bytes;
+    stats->bytes_b_to_a = relay->b_to_a.bytes;
+    stats->a_eof = relay->a_to_b.src_eof;
+    stats->b_eof = relay->b_to_a.src_eof;
+    stats->zero_copy = relay->a_to_b.pipe_rd >= 0 && relay->b_to_a.pipe_rd >= 0;
+    return GAMING_OK;
+}
@@ -0,0 +1,117 @@
+/**
+ * @file relay.h
+ * @brief 雙向 Socket 轉發引擎
+ * @version 1.0.0
+ *
+ * 將兩個已連線的 socket (由 socket_helper_connect_unix /
+ * socket_helper_connect_tcp 等建立) 配對,雙向轉送資料
+ * 優先使用 splice() 經由 pipe 零拷貝轉送,不支援時退回可重用緩衝區
+ * 支援背壓 (目的端塞住時停止讀取來源端) 與半關閉 (EOF 轉為 shutdown)
+ */
+
+#ifndef RELAY_H
+#define RELAY_H
+
+#include "gaming_common.h"
+#include <stddef.h>
+
+// ========================================
+// Relay 配置
+// ========================================
+
+// 每個方向的轉送緩衝容量 (pipe 大小或退回緩衝區大小)
+#define RELAY_DEFAULT_BUFFER_SIZE (64 * 1024)
+
+// ========================================
+// Relay 型別定義
+// ========================================
+
+typedef struct relay relay_t;
+
+/**
+ * @brief Relay 統計資訊
+ */
+typedef struct {
+    uint64_t bytes_a_to_b;   ///< A → B 已送出的位元組數
+    uint64_t bytes_b_to_a;   ///< B → A 已送出的位元組數
+    bool a_eof;              ///< A 端已讀到 EOF
+    bool b_eof;              ///< B 端已讀到 EOF
+    bool zero_copy;          ///< 是否使用 splice() 零拷貝
+} relay_stats_t;
+
+// ========================================
+// Relay 公開函數
+// ========================================
+
+/**
+ * @brief 建立 relay
+ *
+ * 兩個 fd 會被設為非阻塞模式,並由 relay 接管 (relay_destroy 時關閉)
+ *
+ * @param fd_a 第一個已連線的 socket
+ * @param fd_b 第二個已連線的 socket
+ * @return relay 指標, NULL 失敗
+ */
+relay_t *relay_create(int fd_a, int fd_b);
+
+/**
+ * @brief 銷毀 relay 並關閉兩端 socket
+ *
+ * @param relay Relay 指標
+ */
+void relay_destroy(relay_t *relay);
+
+/**
+ * @brief 取得 relay 的事件 fd
+ *
+ * 回傳的 fd 為 epoll fd,可加入呼叫端的事件迴圈 (EPOLLIN)
+ * 可讀時呼叫 relay_process()
+ *
+ * @param relay Relay 指標
+ * @return >= 0 事件 fd
+ * @return < 0 參數錯誤
+ */
+int relay_get_fd(const relay_t *relay);
+
+/**
+ * @brief 處理就緒事件並轉送資料 (不阻塞)
+ *
+ * @param relay Relay 指標
+ * @return GAMING_OK 成功 (可能已結束,請用 relay_is_finished 檢查)
+ * @return GAMING_ERROR_IO 任一端發生 I/O 錯誤
+ * @return GAMING_ERROR_INVALID_PARAM 參數錯誤
+ */
+int relay_process(relay_t *relay);
+
+/**
+ * @brief 執行 relay 直到兩個方向都結束
+ *
+ * 給沒有自己事件迴圈的呼叫端使用
+ *
+ * @param relay Relay 指標
+ * @param idle_timeout_ms 閒置超時(毫秒), <= 0 表示不限
+ * @return GAMING_OK 兩個方向都正常結束
+ * @return GAMING_ERROR_TIMEOUT 閒置超時
+ * @return GAMING_ERROR_IO I/O 錯誤
+ */
+int relay_run(relay_t *relay, int idle_timeout_ms);
+
+/**
+ * @brief 檢查 relay 是否已結束 (兩個方向都 EOF 並送完)
+ *
+ * @param relay Relay 指標
+ * @return true 已結束
+ */
+bool relay_is_finished(const relay_t *relay);
+
+/**
+ * @brief 取得 relay 統計資訊
+ *
+ * @param relay Relay 指標
+ * @param stats 輸出統計
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR_INVALID_PARAM 參數錯誤
+ */
+int relay_get_stats(const relay_t *relay, relay_stats_t *stats);
+
+#endif // RELAY_H
@@ -4,7 +4,13 @@
  * @version 1.0.0
  */
 
+#define _GNU_SOURCE  // struct ucred, MSG_CMSG_CLOEXEC
+
 #include "socket_helper.h"
+#include "logger.h"
+#include "metrics.h"
+#include "pcap_capture.h"
+#include "trace.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -13,6 +19,42 @@
 #include <errno.h>
 #include <sys/select.h>
 #include <arpa/inet.h>
+#include <pthread.h>
+
+// ========================================
+// 統計
+// ========================================
+
+static pthread_once_t socket_metrics_once = PTHREAD_ONCE_INIT;
+static metrics_counter_t *metric_connect_errors;
+static metrics_counter_t *metric_send_bytes;
+static metrics_counter_t *metric_send_errors;
+static metrics_counter_t *metric_recv_bytes;
+static metrics_counter_t *metric_recv_errors;
+
+static void socket_metrics_register(void) {
+    metric_connect_errors = metrics_counter_register("socket.connect.errors");
+    metric_send_bytes = metrics_counter_register("socket.send.bytes");
+    metric_send_errors = metrics_counter_register("socket.send.errors");
+    metric_recv_bytes = metrics_counter_register("socket.recv.bytes");
+    metric_recv_errors = metrics_counter_register("socket.recv.errors");
+}
+
+static inline void socket_metrics_init(void) {
+    pthread_once(&socket_metrics_once, socket_metrics_register);
+}
+
+/**
+ * @brief 記錄一次 I/O 結果 (EAGAIN 不算錯誤)
+ */
+static inline void socket_metrics_io(ssize_t result, metrics_counter_t *bytes,
+                                     metrics_counter_t *errors) {
+    if (result > 0) {
+        metrics_counter_add(bytes, (uint64_t)result);
+    } else if (result < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+        metrics_counter_inc(errors);
+    }
+}
 
 // ========================================
 // Unix Socket 函數
@@ -26,7 +68,7 @@ int socket_helper_create_unix(const char *path) {
     // 建立 socket
     int sockfd = socket(AF_UNIX, SOCK_STREAM, 0);
     if (sockfd < 0) {
-        perror("socket");
+        LOGM_ERRNO(LOG_MODULE_SOCKET, "socket");
         return -1;
     }
 
@@ -41,14 +83,14 @@ int socket_helper_create_unix(const char *path) {
 
     // 綁定
     if (bind(sockfd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
-        perror("bind");
+        LOGM_ERRNO(LOG_MODULE_SOCKET, "bind");
         close(sockfd);
         return -1;
     }
 
     // 監聽
     if (listen(sockfd, SOCKET_DEFAULT_BACKLOG) < 0) {
-        perror("listen");
+        LOGM_ERRNO(LOG_MODULE_SOCKET, "listen");
         close(sockfd);
         return -1;
     }
@@ -61,10 +103,12 @@ int socket_helper_connect_unix(const char *path) {
         return -1;
     }
 
+    TRACE_SCOPE("socket.connect_unix");
+
     // 建立 socket
     int sockfd = socket(AF_UNIX, SOCK_STREAM, 0);
     if (sockfd < 0) {
-        perror("socket");
+        LOGM_ERRNO(LOG_MODULE_SOCKET, "socket");
         return -1;
     }
 
@@ -76,11 +120,15 @@ int socket_helper_connect_unix(const char *path) {
 
     // 連接
     if (connect(sockfd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
-        perror("connect");
+        LOGM_WARN(LOG_MODULE_SOCKET, "connect %s: %s", path, strerror(errno));
+        socket_metrics_init();
+        metrics_counter_inc(metric_connect_errors);
         close(sockfd);
         return -1;
     }
 
+    // fd 可能是以 close() 關閉後重新配置的號碼
+    pcap_capture_forget(sockfd);
     return sockfd;
 }
 
@@ -96,7 +144,7 @@ int socket_helper_create_tcp_server(int port, int backlog) {
     // 建立 socket
     int sockfd = socket(AF_INET, SOCK_STREAM, 0);
     if (sockfd < 0) {
-        perror("socket");
+        LOGM_ERRNO(LOG_MODULE_SOCKET, "socket");
         return -1;
     }
 
@@ -112,7 +160,7 @@ int socket_helper_create_tcp_server(int port, int backlog) {
 
     // 綁定
     if (bind(sockfd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
-        perror("bind");
+        LOGM_ERRNO(LOG_MODULE_SOCKET, "bind");
         close(sockfd);
         return -1;
     }
@@ -120,7 +168,7 @@ int socket_helper_create_tcp_server(int port, int backlog) {
     // 監聽
     int listen_backlog = (backlog > 0) ? backlog : SOCKET_DEFAULT_BACKLOG;
     if (listen(sockfd, listen_backlog) < 0) {
-        perror("listen");
+        LOGM_ERRNO(LOG_MODULE_SOCKET, "listen");
         close(sockfd);
         return -1;
     }
@@ -133,10 +181,12 @@ int socket_helper_connect_tcp(const char *host, int port) {
         return -1;
     }
 
+    TRACE_SCOPE("socket.connect_tcp");
+
     // 建立 socket
     int sockfd = socket(AF_INET, SOCK_STREAM, 0);
     if (sockfd < 0) {
-        perror("socket");
+        LOGM_ERRNO(LOG_MODULE_SOCKET, "socket");
         return -1;
     }
 
@@ -147,18 +197,22 @@ int socket_helper_connect_tcp(const char *host, int port) {
     addr.sin_port = htons(port);
 
     if (inet_pton(AF_INET, host, &addr.sin_addr) <= 0) {
-        perror("inet_pton");
+        LOGM_ERRNO(LOG_MODULE_SOCKET, "inet_pton");
         close(sockfd);
         return -1;
     }
 
     // 連接
     if (connect(sockfd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
-        perror("connect");
+        LOGM_WARN(LOG_MODULE_SOCKET, "connect %s:%d: %s", host, port, strerror(errno));
+        socket_metrics_init();
+        metrics_counter_inc(metric_connect_errors);
         close(sockfd);
         return -1;
     }
 
+    // fd 可能是以 close() 關閉後重新配置的號碼
+    pcap_capture_forget(sockfd);
     return sockfd;
 }
 
@@ -176,12 +230,12 @@ int socket_helper_set_timeout(int sockfd, int timeout_sec) {
     timeout.tv_usec = 0;
 
     if (setsockopt(sockfd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)) < 0) {
-        perror("setsockopt(SO_RCVTIMEO)");
+        LOGM_ERRNO(LOG_MODULE_SOCKET, "setsockopt(SO_RCVTIMEO)");
         return GAMING_ERROR;
     }
 
     if (setsockopt(sockfd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout)) < 0) {
-        perror("setsockopt(SO_SNDTIMEO)");
+        LOGM_ERRNO(LOG_MODULE_SOCKET, "setsockopt(SO_SNDTIMEO)");
         return GAMING_ERROR;
     }
 
@@ -195,12 +249,12 @@ int socket_helper_set_nonblocking(int sockfd) {
 
     int flags = fcntl(sockfd, F_GETFL, 0);
     if (flags < 0) {
-        perror("fcntl(F_GETFL)");
+        LOGM_ERRNO(LOG_MODULE_SOCKET, "fcntl(F_GETFL)");
         return GAMING_ERROR;
     }
 
     if (fcntl(sockfd, F_SETFL, flags | O_NONBLOCK) < 0) {
-        perror("fcntl(F_SETFL)");
+        LOGM_ERRNO(LOG_MODULE_SOCKET, "fcntl(F_SETFL)");
         return GAMING_ERROR;
     }
 
@@ -214,7 +268,7 @@ int socket_helper_set_reuseaddr(int sockfd) {
 
     int optval = 1;
     if (setsockopt(sockfd, SOL_SOCKET, SO_REUSEADDR, &optval, sizeof(optval)) < 0) {
-        perror("setsockopt(SO_REUSEADDR)");
+        LOGM_ERRNO(LOG_MODULE_SOCKET, "setsockopt(SO_REUSEADDR)");
         return GAMING_ERROR;
     }
 
@@ -230,7 +284,16 @@ ssize_t socket_helper_send(int sockfd, const void *data, size_t len) {
         return -1;
     }
 
-    return send(sockfd, data, len, 0);
+    socket_metrics_init();
+
+    trace_begin("socket.send");
+    ssize_t ret = send(sockfd, data, len, 0);
+    trace_end("socket.send");
+    socket_metrics_io(ret, metric_send_bytes, metric_send_errors);
+    if (pcap_capture_is_enabled() && ret > 0) {
+        pcap_capture_record(sockfd, PCAP_DIR_OUT, data, (size_t)ret);
+    }
+    return ret;
 }
 
 ssize_t socket_helper_recv(int sockfd, void *buffer, size_t len) {
@@ -238,11 +301,158 @@ ssize_t socket_helper_recv(int sockfd, void *buffer, size_t len) {
         return -1;
     }
 
-    return recv(sockfd, buffer, len, 0);
+    socket_metrics_init();
+
+    trace_begin("socket.recv");
+    ssize_t ret = recv(sockfd, buffer, len, 0);
+    trace_end("socket.recv");
+    socket_metrics_io(ret, metric_recv_bytes, metric_recv_errors);
+    if (pcap_capture_is_enabled() && ret > 0) {
+        pcap_capture_record(sockfd, PCAP_DIR_IN, buffer, (size_t)ret);
+    }
+    return ret;
+}
+
+ssize_t socket_helper_send_fds(int sockfd, const void *data, size_t len,
+                               const int *fds, size_t nfds) {
+    if (sockfd < 0 || fds == NULL || nfds == 0 || nfds > SOCKET_MAX_FDS) {
+        return -1;
+    }
+
+    socket_metrics_init();
+
+    // stream socket 必須帶至少 1 byte 資料, control message 才會送出
+    char placeholder = 0;
+    struct iovec iov = {
+        .iov_base = (data != NULL && len > 0) ? (void *)data : &placeholder,
+        .iov_len = (data != NULL && len > 0) ? len : 1,
+    };
+
+    union {
+        char buf[CMSG_SPACE(sizeof(int) * SOCKET_MAX_FDS)];
+        struct cmsghdr align;
+    } control;
+    memset(&control, 0, sizeof(control));
+
+    struct msghdr msg = {
+        .msg_iov = &iov,
+        .msg_iovlen = 1,
+        .msg_control = control.buf,
+        .msg_controllen = CMSG_SPACE(sizeof(int) * nfds),
+    };
+
+    struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(int) * nfds);
+    memcpy(CMSG_DATA(cmsg), fds, sizeof(int) * nfds);
+
+    trace_begin("socket.send_fds");
+    ssize_t ret = sendmsg(sockfd, &msg, MSG_NOSIGNAL);
+    trace_end("socket.send_fds");
+    socket_metrics_io(ret, metric_send_bytes, metric_send_errors);
+    // 只帶 fd 時送出的 1 byte 填充不是資料, 不擷取
+    if (pcap_capture_is_enabled() && ret > 0 && iov.iov_base != &placeholder) {
+        pcap_capture_record(sockfd, PCAP_DIR_OUT, iov.iov_base, (size_t)ret);
+    }
+    return ret;
+}
+
+ssize_t socket_helper_recv_fds(int sockfd, void *buffer, size_t len, int *fds, size_t *nfds) {
+    if (sockfd < 0 || buffer == NULL || len == 0 || fds == NULL || nfds == NULL) {
+        return -1;
+    }
+
+    socket_metrics_init();
+
+    struct iovec iov = { .iov_base = buffer, .iov_len = len };
+    union {
+        char buf[CMSG_SPACE(sizeof(int) * SOCKET_MAX_FDS)];
+        struct cmsghdr align;
+    } control;
+
+    struct msghdr msg = {
+        .msg_iov = &iov,
+        .msg_iovlen = 1,
+        .msg_control = control.buf,
+        .msg_controllen = sizeof(control.buf),
+    };
+
+    size_t max_fds = *nfds;
+    *nfds = 0;
+
+    trace_begin("socket.recv_fds");
+    ssize_t ret = recvmsg(sockfd, &msg, MSG_CMSG_CLOEXEC);
+    trace_end("socket.recv_fds");
+    socket_metrics_io(ret, metric_recv_bytes, metric_recv_errors);
+    if (ret < 0) {
+        return ret;
+    }
+    if (pcap_capture_is_enabled() && ret > 0) {
+        pcap_capture_record(sockfd, PCAP_DIR_IN, buffer, (size_t)ret);
+    }
+
+    for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); cmsg != NULL;
+         cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+        if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS) {
+            continue;
+        }
+
+        size_t count = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+        const unsigned char *data = CMSG_DATA(cmsg);
+        for (size_t i = 0; i < count; i++) {
+            int fd;
+            memcpy(&fd, data + i * sizeof(int), sizeof(int));
+            if (*nfds < max_fds) {
+                fds[(*nfds)++] = fd;
+            } else {
+                close(fd);
+            }
+        }
+    }
+
+    if (msg.msg_flags & MSG_CTRUNC) {
+        LOGM_WARN(LOG_MODULE_SOCKET, "control message truncated, fds dropped");
+    }
+
+    return ret;
+}
+
+int socket_helper_handoff(int sockfd, int conn_fd, const void *data, size_t len) {
+    if (conn_fd < 0) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    if (socket_helper_send_fds(sockfd, data, len, &conn_fd, 1) < 0) {
+        LOGM_ERRNO(LOG_MODULE_SOCKET, "sendmsg");
+        return GAMING_ERROR;
+    }
+
+    close(conn_fd);
+    return GAMING_OK;
+}
+
+int socket_helper_get_peer_cred(int sockfd, socket_peer_cred_t *cred) {
+    if (sockfd < 0 || cred == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    struct ucred ucred;
+    socklen_t optlen = sizeof(ucred);
+    if (getsockopt(sockfd, SOL_SOCKET, SO_PEERCRED, &ucred, &optlen) < 0) {
+        LOGM_ERRNO(LOG_MODULE_SOCKET, "getsockopt(SO_PEERCRED)");
+        return GAMING_ERROR;
+    }
+
+    cred->pid = ucred.pid;
+    cred->uid = ucred.uid;
+    cred->gid = ucred.gid;
+    return GAMING_OK;
 }
 
 void socket_helper_close(int sockfd) {
     if (sockfd >= 0) {
+        pcap_capture_forget(sockfd);
         close(sockfd);
     }
 }
@@ -5,6 +5,7 @@
  * 
  * 提供 Socket 通訊的輔助函數
  * 包含 Unix domain socket 和 TCP socket 的基本操作
+ * send / recv / send_fds / recv_fds 的資料可由 pcap_capture 擷取 (預設關閉)
  */
 
 #ifndef SOCKET_HELPER_H
@@ -14,6 +15,7 @@
 #include <sys/socket.h>
 #include <sys/un.h>
 #include <netinet/in.h>
+#include <sys/types.h>
 
 // ========================================
 // Socket 類型定義
@@ -37,6 +39,18 @@ typedef enum {
 // 預設連接佇列長度
 #define SOCKET_DEFAULT_BACKLOG 5
 
+// 單一訊息最多傳遞的 fd 數
+#define SOCKET_MAX_FDS 16
+
+/**
+ * @brief Unix socket 對端身分 (SO_PEERCRED)
+ */
+typedef struct {
+    pid_t pid;
+    uid_t uid;
+    gid_t gid;
+} socket_peer_cred_t;
+
 // ========================================
 // Socket Helper 公開函數
 // ========================================
@@ -129,6 +143,65 @@ ssize_t socket_helper_send(int sockfd, const void *data, size_t len);
  */
 ssize_t socket_helper_recv(int sockfd, void *buffer, size_t len);
 
+/**
+ * @brief 經由 Unix socket 傳送資料與 fd (SCM_RIGHTS)
+ *
+ * 對方收到的是同一個開啟中的檔案 (例如已 accept 的 TCP 連線),
+ * 不需要代理複製資料;data 為 NULL 時送出 1 byte 佔位資料
+ *
+ * @param sockfd Unix socket
+ * @param data 資料指標 (可為 NULL)
+ * @param len 資料長度
+ * @param fds 要傳遞的 fd
+ * @param nfds fd 數量 (1 - SOCKET_MAX_FDS)
+ * @return >= 0 實際發送的位元組數
+ * @return < 0 發送失敗
+ */
+ssize_t socket_helper_send_fds(int sockfd, const void *data, size_t len,
+                               const int *fds, size_t nfds);
+
+/**
+ * @brief 經由 Unix socket 接收資料與 fd
+ *
+ * 收到的 fd 帶有 FD_CLOEXEC;超過 *nfds 的 fd 會被關閉
+ *
+ * @param sockfd Unix socket
+ * @param buffer 接收緩衝區
+ * @param len 緩衝區大小
+ * @param fds 輸出 fd 陣列
+ * @param nfds 輸入陣列大小, 輸出實際收到的 fd 數
+ * @return >= 0 實際接收的位元組數
+ * @return < 0 接收失敗
+ */
+ssize_t socket_helper_recv_fds(int sockfd, void *buffer, size_t len, int *fds, size_t *nfds);
+
+/**
+ * @brief 將已 accept 的連線交給另一個行程
+ *
+ * 傳送成功後關閉本地的 conn_fd
+ *
+ * @param sockfd 連到 worker 的 Unix socket
+ * @param conn_fd 要交出的連線
+ * @param data 附帶資料 (可為 NULL)
+ * @param len 附帶資料長度
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR 傳送失敗 (conn_fd 保持開啟)
+ * @return GAMING_ERROR_INVALID_PARAM 參數錯誤
+ */
+int socket_helper_handoff(int sockfd, int conn_fd, const void *data, size_t len);
+
+/**
+ * @brief 取得 Unix socket 對端的 pid / uid / gid
+ *
+ * 由核心在 connect 時記錄,不需要額外的握手
+ *
+ * @param sockfd 已連線的 Unix socket
+ * @param cred 輸出身分
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR 失敗
+ */
+int socket_helper_get_peer_cred(int sockfd, socket_peer_cred_t *cred);
+
 /**
  * @brief 關閉 socket
  * 
@@ -139,6 +212,8 @@ void socket_helper_close(int sockfd);
 /**
  * @brief 檢查 socket 是否可讀
  * 
+ * 會阻塞至多 timeout_ms;在 uloop 中執行的服務應改用 uloop_adapter 註冊回呼
+ *
  * @param sockfd Socket 檔案描述符
  * @param timeout_ms 超時時間(毫秒)
  * @return true 可讀
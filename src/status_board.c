@@ -0,0 +1,355 @@
+/**
+ * @file status_board.c
+ * @brief 共享記憶體狀態看板實作
+ * @version 1.0.0
+ */
+
+#define _GNU_SOURCE
+
+#include "status_board.h"
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <time.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/file.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+// ========================================
+// 共享區域佈局
+// ========================================
+
+#define STATUS_BOARD_MAGIC   0x47535442   // "GSTB"
+#define STATUS_BOARD_VERSION 1
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t seq;            // seqlock 序號,奇數表示寫入中
+    uint32_t change_count;   // futex 等待字,每次實際變更遞增
+    status_board_snapshot_t data;
+} status_board_region_t;
+
+// ========================================
+// 內部狀態
+// ========================================
+
+static int board_fd = -1;
+static status_board_region_t *board = NULL;
+static bool board_writable = false;
+
+// ========================================
+// 內部輔助函數
+// ========================================
+
+static long futex_call(uint32_t *addr, int op, uint32_t val, const struct timespec *timeout) {
+    return syscall(SYS_futex, addr, op, val, timeout, NULL, 0);
+}
+
+/**
+ * @brief 首次建立時初始化共享區域 (呼叫端需持有 flock)
+ */
+static int status_board_format(int fd) {
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+        perror("fstat");
+        return GAMING_ERROR_IO;
+    }
+
+    if ((size_t)st.st_size >= sizeof(status_board_region_t)) {
+        return GAMING_OK;
+    }
+
+    if (ftruncate(fd, sizeof(status_board_region_t)) < 0) {
+        perror("ftruncate");
+        return GAMING_ERROR_IO;
+    }
+
+    status_board_region_t *region = mmap(NULL, sizeof(*region), PROT_READ | PROT_WRITE,
+                                         MAP_SHARED, fd, 0);
+    if (region == MAP_FAILED) {
+        perror("mmap");
+        return GAMING_ERROR_IO;
+    }
+
+    memset(region, 0, sizeof(*region));
+    region->version = STATUS_BOARD_VERSION;
+    region->data.device_type = DEVICE_TYPE_UNKNOWN;
+    region->data.ps5_state = PS5_STATE_UNKNOWN;
+    region->data.vpn_state = VPN_STATE_UNKNOWN;
+    __atomic_store_n(&region->magic, STATUS_BOARD_MAGIC, __ATOMIC_RELEASE);
+
+    munmap(region, sizeof(*region));
+    return GAMING_OK;
+}
+
+/**
+ * @brief 開始寫入:取得跨行程寫入鎖並將 seqlock 設為奇數
+ */
+static int status_board_write_begin(void) {
+    if (board == NULL || !board_writable) {
+        return GAMING_ERROR_NOT_INITIALIZED;
+    }
+
+    // 寫入端以 flock 互斥,行程異常結束時鎖會自動釋放
+    while (flock(board_fd, LOCK_EX) < 0) {
+        if (errno != EINTR) {
+            perror("flock");
+            return GAMING_ERROR_IO;
+        }
+    }
+
+    // 持有鎖時序號仍為奇數,表示上一個寫入者在 write_end 前結束,先修復
+    uint32_t seq = __atomic_load_n(&board->seq, __ATOMIC_RELAXED);
+    if (seq & 1) {
+        fprintf(stderr, "status_board: repairing seqlock left odd by a dead writer\n");
+        seq++;
+    }
+    __atomic_store_n(&board->seq, seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    return GAMING_OK;
+}
+
+/**
+ * @brief 結束寫入:seqlock 回到偶數,有變更時喚醒等待者
+ */
+static void status_board_write_end(bool changed) {
+    if (changed) {
+        board->data.change_count++;
+    }
+
+    uint32_t seq = __atomic_load_n(&board->seq, __ATOMIC_RELAXED);
+    __atomic_store_n(&board->seq, seq + 1, __ATOMIC_RELEASE);
+
+    if (changed) {
+        __atomic_add_fetch(&board->change_count, 1, __ATOMIC_RELEASE);
+        futex_call(&board->change_count, FUTEX_WAKE, INT32_MAX, NULL);
+    }
+
+    flock(board_fd, LOCK_UN);
+}
+
+// ========================================
+// 公開函數實作
+// ========================================
+
+int status_board_init(void) {
+    if (board != NULL) {
+        return GAMING_OK;
+    }
+
+    bool writable = true;
+    int fd = shm_open(STATUS_BOARD_SHM_NAME, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0 && errno == EACCES) {
+        writable = false;
+        fd = shm_open(STATUS_BOARD_SHM_NAME, O_RDONLY | O_CLOEXEC, 0);
+    }
+    if (fd < 0) {
+        perror("shm_open");
+        return GAMING_ERROR_IO;
+    }
+
+    if (writable) {
+        flock(fd, LOCK_EX);
+        int ret = status_board_format(fd);
+        flock(fd, LOCK_UN);
+        if (ret != GAMING_OK) {
+            close(fd);
+            return ret;
+        }
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) < 0 || (size_t)st.st_size < sizeof(status_board_region_t)) {
+        close(fd);
+        return GAMING_ERROR_IO;
+    }
+
+    int prot = writable ? (PROT_READ | PROT_WRITE) : PROT_READ;
+    status_board_region_t *region = mmap(NULL, sizeof(*region), prot, MAP_SHARED, fd, 0);
+    if (region == MAP_FAILED) {
+        perror("mmap");
+        close(fd);
+        return GAMING_ERROR_IO;
+    }
+
+    if (__atomic_load_n(&region->magic, __ATOMIC_ACQUIRE) != STATUS_BOARD_MAGIC ||
+        region->version != STATUS_BOARD_VERSION) {
+        munmap(region, sizeof(*region));
+        close(fd);
+        return GAMING_ERROR_IO;
+    }
+
+    board_fd = fd;
+    board = region;
+    board_writable = writable;
+    return GAMING_OK;
+}
+
+void status_board_cleanup(void) {
+    if (board == NULL) {
+        return;
+    }
+
+    munmap(board, sizeof(*board));
+    close(board_fd);
+    board = NULL;
+    board_fd = -1;
+    board_writable = false;
+}
+
+int status_board_read(status_board_snapshot_t *snapshot) {
+    if (snapshot == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    if (board == NULL) {
+        return GAMING_ERROR_NOT_INITIALIZED;
+    }
+
+    uint32_t start;
+    uint32_t end;
+    int attempts = 0;
+
+    do {
+        // 寫入者在 write_end 前結束時序號會停在奇數,不可無限重試
+        if (attempts++ >= STATUS_BOARD_READ_RETRIES) {
+            return GAMING_ERROR_BUSY;
+        }
+        if (attempts > STATUS_BOARD_READ_SPINS) {
+            sched_yield();
+        }
+
+        start = __atomic_load_n(&board->seq, __ATOMIC_ACQUIRE);
+        if (start & 1) {
+            continue;   // 寫入中,重試
+        }
+
+        memcpy(snapshot, (const void *)&board->data, sizeof(*snapshot));
+
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        end = __atomic_load_n(&board->seq, __ATOMIC_RELAXED);
+    } while ((start & 1) || start != end);
+
+    snapshot->ps5_ip[STATUS_BOARD_IP_SIZE - 1] = '\0';
+    snapshot->ps5_mac[STATUS_BOARD_MAC_SIZE - 1] = '\0';
+    return GAMING_OK;
+}
+
+int status_board_wait(uint32_t last_change_count, int timeout_ms) {
+    if (board == NULL) {
+        return GAMING_ERROR_NOT_INITIALIZED;
+    }
+
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    if (timeout_ms > 0) {
+        deadline.tv_sec += timeout_ms / 1000;
+        deadline.tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+    }
+
+    while (__atomic_load_n(&board->change_count, __ATOMIC_ACQUIRE) == last_change_count) {
+        struct timespec remaining;
+        struct timespec *timeout = NULL;
+
+        if (timeout_ms >= 0) {
+            struct timespec now;
+            clock_gettime(CLOCK_MONOTONIC, &now);
+            remaining.tv_sec = deadline.tv_sec - now.tv_sec;
+            remaining.tv_nsec = deadline.tv_nsec - now.tv_nsec;
+            if (remaining.tv_nsec < 0) {
+                remaining.tv_sec--;
+                remaining.tv_nsec += 1000000000L;
+            }
+            if (remaining.tv_sec < 0) {
+                return GAMING_ERROR_TIMEOUT;
+            }
+            timeout = &remaining;
+        }
+
+        // 共享記憶體跨行程,不能使用 FUTEX_PRIVATE_FLAG
+        if (futex_call(&board->change_count, FUTEX_WAIT, last_change_count, timeout) < 0 &&
+            errno == ETIMEDOUT) {
+            return GAMING_ERROR_TIMEOUT;
+        }
+    }
+
+    return GAMING_OK;
+}
+
+int status_board_set_device_type(device_type_t type) {
+    int ret = status_board_write_begin();
+    if (ret != GAMING_OK) {
+        return ret;
+    }
+
+    bool changed = (board->data.device_type != type);
+    board->data.device_type = type;
+
+    status_board_write_end(changed);
+    return GAMING_OK;
+}
+
+int status_board_set_ps5_state(ps5_state_t state) {
+    int ret = status_board_write_begin();
+    if (ret != GAMING_OK) {
+        return ret;
+    }
+
+    bool changed = (board->data.ps5_state != state);
+    board->data.ps5_state = state;
+
+    status_board_write_end(changed);
+    return GAMING_OK;
+}
+
+int status_board_set_ps5_address(const char *ip, const char *mac) {
+    if ((ip != NULL && strlen(ip) >= STATUS_BOARD_IP_SIZE) ||
+        (mac != NULL && strlen(mac) >= STATUS_BOARD_MAC_SIZE)) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    int ret = status_board_write_begin();
+    if (ret != GAMING_OK) {
+        return ret;
+    }
+
+    bool changed = false;
+
+    if (ip != NULL && strcmp(board->data.ps5_ip, ip) != 0) {
+        memset(board->data.ps5_ip, 0, sizeof(board->data.ps5_ip));
+        strcpy(board->data.ps5_ip, ip);
+        changed = true;
+    }
+
+    if (mac != NULL && strcmp(board->data.ps5_mac, mac) != 0) {
+        memset(board->data.ps5_mac, 0, sizeof(board->data.ps5_mac));
+        strcpy(board->data.ps5_mac, mac);
+        changed = true;
+    }
+
+    status_board_write_end(changed);
+    return GAMING_OK;
+}
+
+int status_board_set_vpn_state(vpn_state_t state) {
+    int ret = status_board_write_begin();
+    if (ret != GAMING_OK) {
+        return ret;
+    }
+
+    bool changed = (board->data.vpn_state != state);
+    board->data.vpn_state = state;
+
+    status_board_write_end(changed);
+    return GAMING_OK;
+}
@@ -0,0 +1,130 @@
+/**
+ * @file status_board.h
+ * @brief 共享記憶體狀態看板
+ * @version 1.0.0
+ *
+ * 以 POSIX 共享記憶體存放裝置類型、PS5 狀態/IP/MAC 與 VPN 狀態
+ * 寫入端以 seqlock 更新,讀取端不需任何系統呼叫即可取得一致的快照
+ * 狀態變更時透過 futex 喚醒等待中的讀取端 (跨行程)
+ *
+ * 取代每次都要開檔解析的 /var/run 快取檔 (PATH_DEVICE_TYPE_CACHE 等)
+ */
+
+#ifndef STATUS_BOARD_H
+#define STATUS_BOARD_H
+
+#include "gaming_common.h"
+
+// ========================================
+// Status Board 配置
+// ========================================
+
+// 共享記憶體名稱 (位於 /dev/shm)
+#define STATUS_BOARD_SHM_NAME "/gaming_status"
+
+#define STATUS_BOARD_IP_SIZE  16   // "255.255.255.255" + '\0'
+#define STATUS_BOARD_MAC_SIZE 18   // "aa:bb:cc:dd:ee:ff" + '\0'
+
+// 讀取端重試: 先自旋 STATUS_BOARD_READ_SPINS 次,之後每次 sched_yield
+#define STATUS_BOARD_READ_SPINS    64
+#define STATUS_BOARD_READ_RETRIES  10000
+
+// ========================================
+// Status Board 型別定義
+// ========================================
+
+/**
+ * @brief 狀態快照
+ */
+typedef struct {
+    device_type_t device_type;
+    ps5_state_t ps5_state;
+    vpn_state_t vpn_state;
+    char ps5_ip[STATUS_BOARD_IP_SIZE];
+    char ps5_mac[STATUS_BOARD_MAC_SIZE];
+    uint32_t change_count;   ///< 每次更新遞增,可用於 status_board_wait
+} status_board_snapshot_t;
+
+// ========================================
+// Status Board 公開函數
+// ========================================
+
+/**
+ * @brief 開啟 (必要時建立) 共享狀態看板
+ *
+ * 沒有寫入權限時以唯讀方式開啟,此時 status_board_set_* 會失敗
+ *
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR_IO 開啟或映射失敗
+ */
+int status_board_init(void);
+
+/**
+ * @brief 解除映射並關閉狀態看板
+ *
+ * 共享記憶體本身保留,其他行程仍可使用
+ */
+void status_board_cleanup(void);
+
+/**
+ * @brief 讀取一致的狀態快照 (無系統呼叫)
+ *
+ * @param snapshot 輸出快照
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR_NOT_INITIALIZED 尚未初始化
+ * @return GAMING_ERROR_INVALID_PARAM 參數錯誤
+ * @return GAMING_ERROR_BUSY 重試 STATUS_BOARD_READ_RETRIES 次仍在寫入中
+ *         (寫入者異常結束,下一次寫入時會修復)
+ */
+int status_board_read(status_board_snapshot_t *snapshot);
+
+/**
+ * @brief 等待狀態變更
+ *
+ * @param last_change_count 呼叫端最後看到的 change_count
+ * @param timeout_ms 超時時間(毫秒), < 0 表示無限等待
+ * @return GAMING_OK 狀態已變更 (change_count 與 last_change_count 不同)
+ * @return GAMING_ERROR_TIMEOUT 超時
+ * @return GAMING_ERROR_NOT_INITIALIZED 尚未初始化
+ */
+int status_board_wait(uint32_t last_change_count, int timeout_ms);
+
+/**
+ * @brief 設定裝置類型
+ *
+ * @param type 裝置類型
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR_NOT_INITIALIZED 尚未初始化或唯讀
+ */
+int status_board_set_device_type(device_type_t type);
+
+/**
+ * @brief 設定 PS5 狀態
+ *
+ * @param state PS5 狀態
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR_NOT_INITIALIZED 尚未初始化或唯讀
+ */
+int status_board_set_ps5_state(ps5_state_t state);
+
+/**
+ * @brief 設定 PS5 位址
+ *
+ * @param ip IPv4 位址字串, NULL 表示不變
+ * @param mac MAC 位址字串, NULL 表示不變
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR_INVALID_PARAM 字串過長
+ * @return GAMING_ERROR_NOT_INITIALIZED 尚未初始化或唯讀
+ */
+int status_board_set_ps5_address(const char *ip, const char *mac);
+
+/**
+ * @brief 設定 VPN 狀態
+ *
+ * @param state VPN 狀態
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR_NOT_INITIALIZED 尚未初始化或唯讀
+ */
+int status_board_set_vpn_state(vpn_state_t state);
+
+#endif // STATUS_BOARD_H
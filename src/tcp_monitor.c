@@ -0,0 +1,337 @@
+/**
+ * @file tcp_monitor.c
+ * @brief TCP 連線健康度監控實作
+ * @version 1.0.0
+ */
+
+#define _GNU_SOURCE
+
+#include "tcp_monitor.h"
+#include "metrics.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <pthread.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+#include <linux/sockios.h>
+
+// ========================================
+// 內部結構
+// ========================================
+
+typedef struct {
+    int fd;                      // -1 表示空位
+    void *user_data;
+    tcp_conn_info_t info;
+    uint32_t over_count;         // 連續超過門檻的次數
+    uint32_t under_count;        // 慢速狀態下連續正常的次數
+    bool slow;
+} tcp_conn_t;
+
+struct tcp_monitor {
+    tcp_monitor_config_t config;
+    int timer_fd;
+    tcp_monitor_callback_t callback;
+
+    tcp_conn_t *conns;
+    size_t conn_count;           // 已登記數
+    size_t slow_count;
+};
+
+// ========================================
+// 統計
+// ========================================
+
+static pthread_once_t tcp_metrics_once = PTHREAD_ONCE_INIT;
+static metrics_gauge_t *metric_conns;
+static metrics_gauge_t *metric_slow_conns;
+static metrics_gauge_t *metric_send_queue_max;
+static metrics_histogram_t *metric_rtt;
+static metrics_counter_t *metric_slow_flagged;
+
+static void tcp_metrics_register(void) {
+    metric_conns = metrics_gauge_register("tcp.conns");
+    metric_slow_conns = metrics_gauge_register("tcp.slow_conns");
+    metric_send_queue_max = metrics_gauge_register("tcp.send_queue.max");
+    metric_rtt = metrics_histogram_register("tcp.rtt_us");
+    metric_slow_flagged = metrics_counter_register("tcp.slow.flagged");
+}
+
+static inline void tcp_metrics_init(void) {
+    pthread_once(&tcp_metrics_once, tcp_metrics_register);
+}
+
+// ========================================
+// 內部輔助函數
+// ========================================
+
+static tcp_conn_t *find_conn(const tcp_monitor_t *monitor, int fd) {
+    for (size_t i = 0; i < monitor->config.max_conns; i++) {
+        if (monitor->conns[i].fd == fd) {
+            return &monitor->conns[i];
+        }
+    }
+    return NULL;
+}
+
+static bool is_over_threshold(const tcp_monitor_t *monitor, const tcp_conn_info_t *info) {
+    return info->send_queue_bytes >= monitor->config.slow_queue_bytes ||
+           info->rtt_us >= monitor->config.slow_rtt_us;
+}
+
+/**
+ * @brief 取樣一條連線並更新慢速狀態 (連續 slow_samples 次才切換)
+ */
+static void sample_conn(tcp_monitor_t *monitor, tcp_conn_t *conn) {
+    if (tcp_monitor_sample_fd(conn->fd, &conn->info) != GAMING_OK) {
+        return;
+    }
+
+    metrics_histogram_observe(metric_rtt, conn->info.rtt_us);
+
+    bool over = is_over_threshold(monitor, &conn->info);
+    bool changed = false;
+
+    if (over) {
+        conn->under_count = 0;
+        if (!conn->slow && ++conn->over_count >= monitor->config.slow_samples) {
+            conn->slow = true;
+            monitor->slow_count++;
+            metrics_counter_inc(metric_slow_flagged);
+            changed = true;
+        }
+    } else {
+        conn->over_count = 0;
+        if (conn->slow && ++conn->under_count >= monitor->config.slow_samples) {
+            conn->slow = false;
+            monitor->slow_count--;
+            changed = true;
+        }
+    }
+
+    if (changed && monitor->callback != NULL) {
+        monitor->callback(conn->fd, conn->slow, &conn->info, conn->user_data);
+    }
+}
+
+// ========================================
+// 公開函數實作
+// ========================================
+
+int tcp_monitor_sample_fd(int fd, tcp_conn_info_t *info) {
+    if (fd < 0 || info == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    struct tcp_info ti;
+    socklen_t len = sizeof(ti);
+    memset(&ti, 0, sizeof(ti));
+    if (getsockopt(fd, IPPROTO_TCP, TCP_INFO, &ti, &len) < 0) {
+        return GAMING_ERROR_IO;
+    }
+
+    memset(info, 0, sizeof(*info));
+    info->state = ti.tcpi_state;
+    info->rtt_us = ti.tcpi_rtt;
+    info->rttvar_us = ti.tcpi_rttvar;
+    info->retransmits = ti.tcpi_retransmits;
+    info->total_retrans = ti.tcpi_total_retrans;
+    info->lost = ti.tcpi_lost;
+    info->snd_cwnd = ti.tcpi_snd_cwnd;
+    info->unacked = ti.tcpi_unacked;
+
+    int value = 0;
+    if (ioctl(fd, SIOCOUTQ, &value) == 0 && value > 0) {
+        info->send_queue_bytes = (uint32_t)value;
+    }
+    value = 0;
+    if (ioctl(fd, SIOCOUTQNSD, &value) == 0 && value > 0) {
+        info->unsent_bytes = (uint32_t)value;
+    }
+
+    return GAMING_OK;
+}
+
+tcp_monitor_t *tcp_monitor_create(const tcp_monitor_config_t *config) {
+    tcp_metrics_init();
+
+    tcp_monitor_t *monitor = calloc(1, sizeof(*monitor));
+    if (monitor == NULL) {
+        return NULL;
+    }
+
+    if (config != NULL) {
+        monitor->config = *config;
+    }
+    if (monitor->config.max_conns == 0) {
+        monitor->config.max_conns = TCP_MONITOR_DEFAULT_MAX_CONNS;
+    }
+    if (monitor->config.interval_ms == 0) {
+        monitor->config.interval_ms = TCP_MONITOR_DEFAULT_INTERVAL_MS;
+    }
+    if (monitor->config.slow_queue_bytes == 0) {
+        monitor->config.slow_queue_bytes = TCP_MONITOR_DEFAULT_QUEUE_BYTES;
+    }
+    if (monitor->config.slow_rtt_us == 0) {
+        monitor->config.slow_rtt_us = TCP_MONITOR_DEFAULT_RTT_US;
+    }
+    if (monitor->config.slow_samples == 0) {
+        monitor->config.slow_samples = TCP_MONITOR_DEFAULT_SAMPLES;
+    }
+
+    monitor->conns = calloc(monitor->config.max_conns, sizeof(tcp_conn_t));
+    if (monitor->conns == NULL) {
+        free(monitor);
+        return NULL;
+    }
+    for (size_t i = 0; i < monitor->config.max_conns; i++) {
+        monitor->conns[i].fd = -1;
+    }
+
+    monitor->timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (monitor->timer_fd < 0) {
+        perror("timerfd_create");
+        free(monitor->conns);
+        free(monitor);
+        return NULL;
+    }
+
+    uint32_t ms = monitor->config.interval_ms;
+    struct itimerspec its = {
+        .it_interval = { .tv_sec = ms / 1000, .tv_nsec = (long)(ms % 1000) * 1000000L },
+        .it_value = { .tv_sec = ms / 1000, .tv_nsec = (long)(ms % 1000) * 1000000L },
+    };
+    if (timerfd_settime(monitor->timer_fd, 0, &its, NULL) < 0) {
+        perror("timerfd_settime");
+        close(monitor->timer_fd);
+        free(monitor->conns);
+        free(monitor);
+        return NULL;
+    }
+
+    return monitor;
+}
+
+void tcp_monitor_destroy(tcp_monitor_t *monitor) {
+    if (monitor == NULL) {
+        return;
+    }
+
+    close(monitor->timer_fd);
+    free(monitor->conns);
+    free(monitor);
+}
+
+int tcp_monitor_get_fd(const tcp_monitor_t *monitor) {
+    if (monitor == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+    return monitor->timer_fd;
+}
+
+void tcp_monitor_set_callback(tcp_monitor_t *monitor, tcp_monitor_callback_t callback) {
+    if (monitor != NULL) {
+        monitor->callback = callback;
+    }
+}
+
+int tcp_monitor_add(tcp_monitor_t *monitor, int fd, void *user_data) {
+    if (monitor == NULL || fd < 0) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    if (find_conn(monitor, fd) != NULL) {
+        return GAMING_ERROR_ALREADY_EXISTS;
+    }
+
+    tcp_conn_t *conn = find_conn(monitor, -1);
+    if (conn == NULL) {
+        return GAMING_ERROR_NO_MEMORY;
+    }
+
+    memset(conn, 0, sizeof(*conn));
+    conn->fd = fd;
+    conn->user_data = user_data;
+    monitor->conn_count++;
+    metrics_gauge_set(metric_conns, (int64_t)monitor->conn_count);
+    return GAMING_OK;
+}
+
+int tcp_monitor_remove(tcp_monitor_t *monitor, int fd) {
+    if (monitor == NULL || fd < 0) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    tcp_conn_t *conn = find_conn(monitor, fd);
+    if (conn == NULL) {
+        return GAMING_ERROR_NOT_FOUND;
+    }
+
+    if (conn->slow) {
+        monitor->slow_count--;
+    }
+    conn->fd = -1;
+    monitor->conn_count--;
+    metrics_gauge_set(metric_conns, (int64_t)monitor->conn_count);
+    metrics_gauge_set(metric_slow_conns, (int64_t)monitor->slow_count);
+    return GAMING_OK;
+}
+
+int tcp_monitor_process(tcp_monitor_t *monitor) {
+    if (monitor == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    uint64_t expirations;
+    if (read(monitor->timer_fd, &expirations, sizeof(expirations)) < 0 && errno != EAGAIN) {
+        perror("read timerfd");
+    }
+
+    return tcp_monitor_sample_all(monitor);
+}
+
+int tcp_monitor_sample_all(tcp_monitor_t *monitor) {
+    if (monitor == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    uint32_t queue_max = 0;
+    for (size_t i = 0; i < monitor->config.max_conns; i++) {
+        tcp_conn_t *conn = &monitor->conns[i];
+        if (conn->fd < 0) {
+            continue;
+        }
+
+        sample_conn(monitor, conn);
+        queue_max = MAX(queue_max, conn->info.send_queue_bytes);
+    }
+
+    metrics_gauge_set(metric_slow_conns, (int64_t)monitor->slow_count);
+    metrics_gauge_set(metric_send_queue_max, (int64_t)queue_max);
+    return (int)monitor->slow_count;
+}
+
+int tcp_monitor_get(const tcp_monitor_t *monitor, int fd, tcp_conn_info_t *info, bool *slow) {
+    if (monitor == NULL || fd < 0) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    const tcp_conn_t *conn = find_conn(monitor, fd);
+    if (conn == NULL) {
+        return GAMING_ERROR_NOT_FOUND;
+    }
+
+    if (info != NULL) {
+        *info = conn->info;
+    }
+    if (slow != NULL) {
+        *slow = conn->slow;
+    }
+    return GAMING_OK;
+}
@@ -0,0 +1,180 @@
+/**
+ * @file tcp_monitor.h
+ * @brief TCP 連線健康度監控
+ * @version 1.0.0
+ *
+ * 以 TCP_INFO 取樣 RTT、RTT 變異、重傳、cwnd、未確認封包,
+ * 以 SIOCOUTQ / SIOCOUTQNSD 取得送出佇列中的位元組數
+ *
+ * 監控器以 timerfd 週期性取樣所有登記的連線,連續數次超過門檻
+ * (佇列積壓或 RTT 過高) 即標記為慢速連線,恢復同樣需要連續數次正常,
+ * 讓伺服器能在廣播被拖慢前降級或中斷落後的遠端遊玩用戶端
+ *
+ * 匯出 metrics: tcp.conns / tcp.slow_conns / tcp.send_queue.max (gauge),
+ * tcp.rtt_us (histogram)
+ */
+
+#ifndef TCP_MONITOR_H
+#define TCP_MONITOR_H
+
+#include "gaming_common.h"
+#include <stddef.h>
+
+// ========================================
+// TCP Monitor 配置
+// ========================================
+
+#define TCP_MONITOR_DEFAULT_MAX_CONNS     64
+#define TCP_MONITOR_DEFAULT_INTERVAL_MS   1000
+#define TCP_MONITOR_DEFAULT_QUEUE_BYTES   (256 * 1024)
+#define TCP_MONITOR_DEFAULT_RTT_US        (200 * 1000)
+#define TCP_MONITOR_DEFAULT_SAMPLES       3
+
+// ========================================
+// TCP Monitor 型別定義
+// ========================================
+
+typedef struct tcp_monitor tcp_monitor_t;
+
+/**
+ * @brief 單一連線的取樣結果
+ */
+typedef struct {
+    uint8_t state;               ///< TCP 狀態 (TCP_ESTABLISHED 等)
+    uint32_t rtt_us;             ///< 平滑 RTT
+    uint32_t rttvar_us;          ///< RTT 變異
+    uint32_t retransmits;        ///< 目前連續重傳次數
+    uint32_t total_retrans;      ///< 累計重傳封包數
+    uint32_t lost;               ///< 判定遺失的封包數
+    uint32_t snd_cwnd;           ///< 壅塞視窗 (封包)
+    uint32_t unacked;            ///< 已送出未確認的封包數
+    uint32_t send_queue_bytes;   ///< 送出佇列中的位元組 (含未確認)
+    uint32_t unsent_bytes;       ///< 尚未送出的位元組
+} tcp_conn_info_t;
+
+/**
+ * @brief 監控設定 (0 使用預設值)
+ */
+typedef struct {
+    size_t max_conns;            ///< 最多登記的連線數
+    uint32_t interval_ms;        ///< 取樣週期
+    uint32_t slow_queue_bytes;   ///< 送出佇列超過此值視為落後
+    uint32_t slow_rtt_us;        ///< RTT 超過此值視為落後
+    uint32_t slow_samples;       ///< 連續幾次異常才標記 (恢復同樣次數)
+} tcp_monitor_config_t;
+
+/**
+ * @brief 慢速狀態改變回呼
+ *
+ * @param fd 連線
+ * @param slow true 變為慢速, false 恢復
+ * @param info 最新取樣
+ * @param user_data 登記時的使用者資料
+ */
+typedef void (*tcp_monitor_callback_t)(int fd, bool slow, const tcp_conn_info_t *info,
+                                       void *user_data);
+
+// ========================================
+// TCP Monitor 公開函數
+// ========================================
+
+/**
+ * @brief 取樣任一 TCP socket 的狀態
+ *
+ * 可用於 socket_helper_connect_tcp() 或 accept 自
+ * socket_helper_create_tcp_server() 的連線
+ *
+ * @param fd TCP socket
+ * @param info 輸出取樣
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR_IO 不是 TCP socket 或查詢失敗
+ */
+int tcp_monitor_sample_fd(int fd, tcp_conn_info_t *info);
+
+/**
+ * @brief 建立監控器
+ *
+ * @param config 設定, NULL 使用預設值
+ * @return 監控器指標, NULL 失敗
+ */
+tcp_monitor_t *tcp_monitor_create(const tcp_monitor_config_t *config);
+
+/**
+ * @brief 銷毀監控器 (不關閉登記的連線)
+ *
+ * @param monitor 監控器指標
+ */
+void tcp_monitor_destroy(tcp_monitor_t *monitor);
+
+/**
+ * @brief 取得取樣計時器 fd
+ *
+ * 加入呼叫端的事件迴圈 (EPOLLIN),可讀時呼叫 tcp_monitor_process()
+ *
+ * @param monitor 監控器指標
+ * @return >= 0 timerfd
+ * @return < 0 參數錯誤
+ */
+int tcp_monitor_get_fd(const tcp_monitor_t *monitor);
+
+/**
+ * @brief 設定慢速狀態改變回呼
+ *
+ * @param monitor 監控器指標
+ * @param callback 回呼函數 (NULL 取消)
+ */
+void tcp_monitor_set_callback(tcp_monitor_t *monitor, tcp_monitor_callback_t callback);
+
+/**
+ * @brief 登記連線
+ *
+ * @param monitor 監控器指標
+ * @param fd TCP socket
+ * @param user_data 回呼時帶回的使用者資料
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR_ALREADY_EXISTS 已登記
+ * @return GAMING_ERROR_NO_MEMORY 已達 max_conns
+ */
+int tcp_monitor_add(tcp_monitor_t *monitor, int fd, void *user_data);
+
+/**
+ * @brief 取消登記 (連線關閉前呼叫)
+ *
+ * @param monitor 監控器指標
+ * @param fd TCP socket
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR_NOT_FOUND 未登記
+ */
+int tcp_monitor_remove(tcp_monitor_t *monitor, int fd);
+
+/**
+ * @brief 處理計時器並取樣所有連線 (不阻塞)
+ *
+ * @param monitor 監控器指標
+ * @return >= 0 目前的慢速連線數
+ * @return < 0 參數錯誤
+ */
+int tcp_monitor_process(tcp_monitor_t *monitor);
+
+/**
+ * @brief 立即取樣所有連線
+ *
+ * @param monitor 監控器指標
+ * @return >= 0 目前的慢速連線數
+ * @return < 0 參數錯誤
+ */
+int tcp_monitor_sample_all(tcp_monitor_t *monitor);
+
+/**
+ * @brief 取得連線最近一次的取樣
+ *
+ * @param monitor 監控器指標
+ * @param fd TCP socket
+ * @param info 輸出取樣 (可為 NULL)
+ * @param slow 輸出是否為慢速 (可為 NULL)
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR_NOT_FOUND 未登記
+ */
+int tcp_monitor_get(const tcp_monitor_t *monitor, int fd, tcp_conn_info_t *info, bool *slow);
+
+#endif // TCP_MONITOR_H
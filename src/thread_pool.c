@@ -0,0 +1,369 @@
+/**
+ * @file thread_pool.c
+ * @brief 工作執行緒池實作
+ * @version 1.0.0
+ */
+
+#define _GNU_SOURCE
+
+#include "thread_pool.h"
+#include "metrics.h"
+#include "trace.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sched.h>
+#include <pthread.h>
+#include <signal.h>
+#include <semaphore.h>
+#include <sys/eventfd.h>
+
+// ========================================
+// 內部結構
+// ========================================
+
+typedef struct {
+    thread_pool_task_t task;
+    thread_pool_done_t done;
+    void *arg;
+    int result;
+    uint64_t submit_us;
+} pool_task_t;
+
+typedef struct {
+    size_t sequence;
+    pool_task_t task;
+} queue_cell_t;
+
+/**
+ * @brief 有界 MPMC 佇列 (Vyukov)
+ *
+ * 每個 cell 的 sequence 表示該 cell 目前可以被哪個位置的寫入/讀取使用,
+ * 生產者與消費者各自以 CAS 搶位置,不需要鎖
+ */
+typedef struct {
+    queue_cell_t *cells;
+    size_t mask;
+    size_t enqueue_pos __attribute__((aligned(64)));
+    size_t dequeue_pos __attribute__((aligned(64)));
+} mpmc_queue_t;
+
+struct thread_pool {
+    mpmc_queue_t tasks;
+    mpmc_queue_t completions;
+    sem_t task_sem;
+    int event_fd;
+
+    pthread_t threads[THREAD_POOL_MAX_THREADS];
+    size_t thread_count;
+    size_t capacity;
+    bool stopping;
+
+    uint32_t in_flight;
+    uint64_t submitted;
+    uint64_t completed;
+    uint64_t rejected;
+};
+
+// ========================================
+// 統計
+// ========================================
+
+static pthread_once_t pool_metrics_once = PTHREAD_ONCE_INIT;
+static metrics_histogram_t *metric_queue_wait;
+static metrics_histogram_t *metric_run_time;
+static metrics_counter_t *metric_rejected;
+
+static void pool_metrics_register(void) {
+    metric_queue_wait = metrics_histogram_register("thread_pool.queue_wait_us");
+    metric_run_time = metrics_histogram_register("thread_pool.run_us");
+    metric_rejected = metrics_counter_register("thread_pool.rejected");
+}
+
+static inline void pool_metrics_init(void) {
+    pthread_once(&pool_metrics_once, pool_metrics_register);
+}
+
+// ========================================
+// MPMC 佇列
+// ========================================
+
+static int queue_init(mpmc_queue_t *queue, size_t capacity) {
+    queue->cells = calloc(capacity, sizeof(queue_cell_t));
+    if (queue->cells == NULL) {
+        return GAMING_ERROR_NO_MEMORY;
+    }
+
+    for (size_t i = 0; i < capacity; i++) {
+        queue->cells[i].sequence = i;
+    }
+    queue->mask = capacity - 1;
+    queue->enqueue_pos = 0;
+    queue->dequeue_pos = 0;
+    return GAMING_OK;
+}
+
+static bool queue_push(mpmc_queue_t *queue, const pool_task_t *task) {
+    queue_cell_t *cell;
+    size_t pos = __atomic_load_n(&queue->enqueue_pos, __ATOMIC_RELAXED);
+
+    for (;;) {
+        cell = &queue->cells[pos & queue->mask];
+        size_t seq = __atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE);
+        intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&queue->enqueue_pos, &pos, pos + 1, true,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return false;    // 已滿
+        } else {
+            pos = __atomic_load_n(&queue->enqueue_pos, __ATOMIC_RELAXED);
+        }
+    }
+
+    cell->task = *task;
+    __atomic_store_n(&cell->sequence, pos + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+static bool queue_pop(mpmc_queue_t *queue, pool_task_t *task) {
+    queue_cell_t *cell;
+    size_t pos = __atomic_load_n(&queue->dequeue_pos, __ATOMIC_RELAXED);
+
+    for (;;) {
+        cell = &queue->cells[pos & queue->mask];
+        size_t seq = __atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE);
+        intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&queue->dequeue_pos, &pos, pos + 1, true,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return false;    // 空的 (或生產者尚未寫完)
+        } else {
+            pos = __atomic_load_n(&queue->dequeue_pos, __ATOMIC_RELAXED);
+        }
+    }
+
+    *task = cell->task;
+    __atomic_store_n(&cell->sequence, pos + queue->mask + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+// ========================================
+// 工作執行緒
+// ========================================
+
+static void *worker_main(void *arg) {
+    thread_pool_t *pool = arg;
+    pool_task_t task;
+
+    for (;;) {
+        while (sem_wait(&pool->task_sem) < 0 && errno == EINTR) {
+        }
+
+        // 號誌保證佇列中有任務, 失敗只代表生產者還在寫入該 cell
+        while (!queue_pop(&pool->tasks, &task)) {
+            if (__atomic_load_n(&pool->stopping, __ATOMIC_ACQUIRE)) {
+                return NULL;
+            }
+            sched_yield();
+        }
+
+        uint64_t start = metrics_now_us();
+        metrics_histogram_observe(metric_queue_wait, start - task.submit_us);
+
+        trace_begin("thread_pool.task");
+        task.result = task.task(task.arg);
+        trace_end("thread_pool.task");
+
+        metrics_histogram_observe(metric_run_time, metrics_now_us() - start);
+        __atomic_add_fetch(&pool->completed, 1, __ATOMIC_RELAXED);
+
+        if (task.done == NULL) {
+            __atomic_sub_fetch(&pool->in_flight, 1, __ATOMIC_RELEASE);
+            continue;
+        }
+
+        // in_flight 上限等於容量, 完成佇列不會滿
+        queue_push(&pool->completions, &task);
+        uint64_t one = 1;
+        if (write(pool->event_fd, &one, sizeof(one)) < 0 && errno != EAGAIN) {
+            perror("write eventfd");
+        }
+    }
+}
+
+// ========================================
+// 公開函數實作
+// ========================================
+
+thread_pool_t *thread_pool_create(size_t threads, size_t queue_size) {
+    if (threads == 0 || threads > THREAD_POOL_MAX_THREADS) {
+        return NULL;
+    }
+
+    if (queue_size == 0) {
+        queue_size = THREAD_POOL_DEFAULT_QUEUE;
+    }
+    if ((queue_size & (queue_size - 1)) != 0) {
+        return NULL;
+    }
+
+    pool_metrics_init();
+
+    thread_pool_t *pool = calloc(1, sizeof(*pool));
+    if (pool == NULL) {
+        return NULL;
+    }
+
+    pool->capacity = queue_size;
+    pool->event_fd = -1;
+
+    if (queue_init(&pool->tasks, queue_size) != GAMING_OK ||
+        queue_init(&pool->completions, queue_size) != GAMING_OK) {
+        goto fail;
+    }
+
+    if (sem_init(&pool->task_sem, 0, 0) < 0) {
+        perror("sem_init");
+        goto fail;
+    }
+
+    pool->event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (pool->event_fd < 0) {
+        perror("eventfd");
+        sem_destroy(&pool->task_sem);
+        goto fail;
+    }
+
+    // 工作執行緒繼承全部阻擋的遮罩, 訊號只會遞送給事件迴圈 (signalfd) 所在的執行緒
+    sigset_t all, old;
+    sigfillset(&all);
+    pthread_sigmask(SIG_SETMASK, &all, &old);
+
+    for (size_t i = 0; i < threads; i++) {
+        if (pthread_create(&pool->threads[i], NULL, worker_main, pool) != 0) {
+            perror("pthread_create");
+            pthread_sigmask(SIG_SETMASK, &old, NULL);
+            thread_pool_destroy(pool);
+            return NULL;
+        }
+        pool->thread_count++;
+    }
+
+    pthread_sigmask(SIG_SETMASK, &old, NULL);
+    return pool;
+
+fail:
+    if (pool->event_fd >= 0) {
+        close(pool->event_fd);
+    }
+    free(pool->tasks.cells);
+    free(pool->completions.cells);
+    free(pool);
+    return NULL;
+}
+
+void thread_pool_destroy(thread_pool_t *pool) {
+    if (pool == NULL) {
+        return;
+    }
+
+    __atomic_store_n(&pool->stopping, true, __ATOMIC_RELEASE);
+    for (size_t i = 0; i < pool->thread_count; i++) {
+        sem_post(&pool->task_sem);
+    }
+    for (size_t i = 0; i < pool->thread_count; i++) {
+        pthread_join(pool->threads[i], NULL);
+    }
+
+    thread_pool_process(pool);
+
+    sem_destroy(&pool->task_sem);
+    close(pool->event_fd);
+    free(pool->tasks.cells);
+    free(pool->completions.cells);
+    free(pool);
+}
+
+int thread_pool_submit(thread_pool_t *pool, thread_pool_task_t task, thread_pool_done_t done,
+                       void *arg) {
+    if (pool == NULL || task == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    // 先佔用名額, 保證完成佇列永遠放得下
+    if (__atomic_add_fetch(&pool->in_flight, 1, __ATOMIC_ACQ_REL) > pool->capacity) {
+        __atomic_sub_fetch(&pool->in_flight, 1, __ATOMIC_RELEASE);
+        __atomic_add_fetch(&pool->rejected, 1, __ATOMIC_RELAXED);
+        metrics_counter_inc(metric_rejected);
+        return GAMING_ERROR;
+    }
+
+    pool_task_t entry = {
+        .task = task,
+        .done = done,
+        .arg = arg,
+        .submit_us = metrics_now_us(),
+    };
+
+    if (!queue_push(&pool->tasks, &entry)) {
+        __atomic_sub_fetch(&pool->in_flight, 1, __ATOMIC_RELEASE);
+        __atomic_add_fetch(&pool->rejected, 1, __ATOMIC_RELAXED);
+        metrics_counter_inc(metric_rejected);
+        return GAMING_ERROR;
+    }
+
+    __atomic_add_fetch(&pool->submitted, 1, __ATOMIC_RELAXED);
+    sem_post(&pool->task_sem);
+    return GAMING_OK;
+}
+
+int thread_pool_get_fd(const thread_pool_t *pool) {
+    if (pool == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+    return pool->event_fd;
+}
+
+int thread_pool_process(thread_pool_t *pool) {
+    if (pool == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    uint64_t count;
+    if (read(pool->event_fd, &count, sizeof(count)) < 0 && errno != EAGAIN) {
+        perror("read eventfd");
+    }
+
+    // 先清 eventfd 再取佇列: 之後才完成的任務會再次觸發 eventfd
+    int delivered = 0;
+    pool_task_t task;
+    while (queue_pop(&pool->completions, &task)) {
+        __atomic_sub_fetch(&pool->in_flight, 1, __ATOMIC_RELEASE);
+        task.done(task.result, task.arg);
+        delivered++;
+    }
+
+    return delivered;
+}
+
+void thread_pool_get_stats(const thread_pool_t *pool, thread_pool_stats_t *stats) {
+    if (pool == NULL || stats == NULL) {
+        return;
+    }
+
+    stats->submitted = __atomic_load_n(&pool->submitted, __ATOMIC_RELAXED);
+    stats->completed = __atomic_load_n(&pool->completed, __ATOMIC_RELAXED);
+    stats->rejected = __atomic_load_n(&pool->rejected, __ATOMIC_RELAXED);
+    stats->in_flight = __atomic_load_n(&pool->in_flight, __ATOMIC_RELAXED);
+}
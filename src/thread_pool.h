@@ -0,0 +1,127 @@
+/**
+ * @file thread_pool.h
+ * @brief 工作執行緒池
+ * @version 1.0.0
+ *
+ * 將會阻塞的呼叫 (config_parser_commit 的 system()、socket_helper_connect_tcp
+ * 的阻塞 connect、syslog 寫入等) 移出事件迴圈執行
+ *
+ * 任務佇列為固定大小的無鎖 MPMC 環形佇列 (Vyukov bounded queue),
+ * 任何執行緒都可以提交;完成的任務放入完成佇列並寫入 eventfd,
+ * 由事件迴圈在 thread_pool_process() 中呼叫完成回呼,回呼永遠在呼叫端執行緒執行
+ *
+ * 工作執行緒阻擋所有訊號,訊號只會遞送給其他執行緒 (例如 uloop_adapter 的 signalfd)
+ *
+ * 排隊等待時間與執行時間記錄於 metrics 直方圖
+ * thread_pool.queue_wait_us / thread_pool.run_us
+ */
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include "gaming_common.h"
+#include <stddef.h>
+
+// ========================================
+// Thread Pool 配置
+// ========================================
+
+#define THREAD_POOL_MAX_THREADS     16
+#define THREAD_POOL_DEFAULT_QUEUE   256    // 必須是 2 的次方
+
+// ========================================
+// Thread Pool 型別定義
+// ========================================
+
+typedef struct thread_pool thread_pool_t;
+
+/**
+ * @brief 任務函數 (在工作執行緒執行)
+ *
+ * @param arg 提交時的參數
+ * @return 結果, 傳給完成回呼
+ */
+typedef int (*thread_pool_task_t)(void *arg);
+
+/**
+ * @brief 完成回呼 (在呼叫 thread_pool_process() 的執行緒執行)
+ *
+ * @param result 任務函數的回傳值
+ * @param arg 提交時的參數
+ */
+typedef void (*thread_pool_done_t)(int result, void *arg);
+
+/**
+ * @brief 執行緒池統計
+ */
+typedef struct {
+    uint64_t submitted;          ///< 已提交任務數
+    uint64_t completed;          ///< 已執行完成的任務數
+    uint64_t rejected;           ///< 佇列已滿被拒絕的任務數
+    uint32_t in_flight;          ///< 尚未交付完成回呼的任務數
+} thread_pool_stats_t;
+
+// ========================================
+// Thread Pool 公開函數
+// ========================================
+
+/**
+ * @brief 建立執行緒池
+ *
+ * @param threads 工作執行緒數 (1 - THREAD_POOL_MAX_THREADS)
+ * @param queue_size 佇列容量 (2 的次方), 0 使用 THREAD_POOL_DEFAULT_QUEUE
+ * @return 執行緒池, NULL 失敗
+ */
+thread_pool_t *thread_pool_create(size_t threads, size_t queue_size);
+
+/**
+ * @brief 銷毀執行緒池
+ *
+ * 先執行完佇列中的任務再結束工作執行緒,剩餘的完成回呼在此函數中交付
+ *
+ * @param pool 執行緒池
+ */
+void thread_pool_destroy(thread_pool_t *pool);
+
+/**
+ * @brief 提交任務 (不阻塞, 任何執行緒皆可呼叫)
+ *
+ * @param pool 執行緒池
+ * @param task 任務函數
+ * @param done 完成回呼 (可為 NULL, 不需要結果時省去完成佇列與 eventfd)
+ * @param arg 參數
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR 佇列已滿
+ */
+int thread_pool_submit(thread_pool_t *pool, thread_pool_task_t task, thread_pool_done_t done,
+                       void *arg);
+
+/**
+ * @brief 取得完成通知 eventfd
+ *
+ * 加入呼叫端的事件迴圈 (EPOLLIN),可讀時呼叫 thread_pool_process()
+ *
+ * @param pool 執行緒池
+ * @return >= 0 fd
+ * @return < 0 參數錯誤
+ */
+int thread_pool_get_fd(const thread_pool_t *pool);
+
+/**
+ * @brief 交付已完成任務的回呼 (不阻塞)
+ *
+ * @param pool 執行緒池
+ * @return >= 0 交付的回呼數
+ * @return < 0 參數錯誤
+ */
+int thread_pool_process(thread_pool_t *pool);
+
+/**
+ * @brief 取得統計
+ *
+ * @param pool 執行緒池
+ * @param stats 輸出統計
+ */
+void thread_pool_get_stats(const thread_pool_t *pool, thread_pool_stats_t *stats);
+
+#endif // THREAD_POOL_H
@@ -0,0 +1,392 @@
+/**
+ * @file timer_wheel.c
+ * @brief 階層式計時輪實作
+ * @version 1.0.0
+ */
+
+#define _GNU_SOURCE
+
+#include "timer_wheel.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <sys/timerfd.h>
+
+// ========================================
+// 內部結構
+// ========================================
+
+#define TIMER_WHEEL_SLOT_MASK   (TIMER_WHEEL_SLOTS - 1)
+
+// 可排程的最大 tick 數
+#define TIMER_WHEEL_MAX_TICKS \
+    ((1ULL << (TIMER_WHEEL_SLOT_BITS * TIMER_WHEEL_LEVELS)) - 1)
+
+struct timer_wheel {
+    int timerfd;
+    int tick_ms;
+    bool armed;                  // timerfd 是否已設定
+    uint64_t wake;               // timerfd 設定的 tick (armed 時有效)
+    uint64_t current;            // 已處理到的 tick
+    uint64_t start_ms;           // 建立時的單調時鐘
+    size_t count;
+    timer_wheel_node_t slots[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];
+};
+
+// ========================================
+// 串列操作
+// ========================================
+
+static void list_init(timer_wheel_node_t *head) {
+    head->next = head;
+    head->prev = head;
+}
+
+static bool list_empty(const timer_wheel_node_t *head) {
+    return head->next == head;
+}
+
+static void list_add_tail(timer_wheel_node_t *head, timer_wheel_node_t *node) {
+    node->prev = head->prev;
+    node->next = head;
+    head->prev->next = node;
+    head->prev = node;
+}
+
+static void list_del(timer_wheel_node_t *node) {
+    node->prev->next = node->next;
+    node->next->prev = node->prev;
+    node->next = node;
+    node->prev = node;
+}
+
+/**
+ * @brief 將 src 整串移到 dst (dst 必須為空)
+ */
+static void list_splice_init(timer_wheel_node_t *src, timer_wheel_node_t *dst) {
+    if (list_empty(src)) {
+        list_init(dst);
+        return;
+    }
+    dst->next = src->next;
+    dst->prev = src->prev;
+    dst->next->prev = dst;
+    dst->prev->next = dst;
+    list_init(src);
+}
+
+// ========================================
+// 內部輔助函數
+// ========================================
+
+static uint64_t monotonic_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + (uint64_t)ts.tv_nsec / 1000000;
+}
+
+static uint64_t timer_wheel_now_ticks(const timer_wheel_t *wheel) {
+    return (monotonic_ms() - wheel->start_ms) / (uint64_t)wheel->tick_ms;
+}
+
+/**
+ * @brief 將 timerfd 設為在指定 tick 單次觸發 (UINT64_MAX 為停用)
+ *
+ * 只在下一個到期或 cascade 的 tick 喚醒,閒置或只有長計時器時不會每個 tick 喚醒
+ */
+static void timer_wheel_arm(timer_wheel_t *wheel, uint64_t tick) {
+    bool enable = (tick != UINT64_MAX);
+    if (wheel->armed == enable && (!enable || wheel->wake == tick)) {
+        return;
+    }
+
+    struct itimerspec its;
+    memset(&its, 0, sizeof(its));
+    if (enable) {
+        uint64_t ms = wheel->start_ms + tick * (uint64_t)wheel->tick_ms;
+        its.it_value.tv_sec = (time_t)(ms / 1000);
+        its.it_value.tv_nsec = (long)(ms % 1000) * 1000000L;
+    }
+
+    if (timerfd_settime(wheel->timerfd, TFD_TIMER_ABSTIME, &its, NULL) < 0) {
+        perror("timerfd_settime");
+        return;
+    }
+
+    wheel->armed = enable;
+    wheel->wake = tick;
+}
+
+/**
+ * @brief 計算下一個需要處理的 tick
+ *
+ * 第 0 層為最近的非空槽;上層為最近的非空槽開始 cascade 的 tick
+ *
+ * @return tick, 沒有計時器時為 UINT64_MAX
+ */
+static uint64_t timer_wheel_next_tick(const timer_wheel_t *wheel) {
+    uint64_t best = UINT64_MAX;
+
+    for (int level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+        unsigned int shift = TIMER_WHEEL_SLOT_BITS * (unsigned int)level;
+        uint64_t block = wheel->current >> shift;
+
+        for (uint64_t i = 1; i <= TIMER_WHEEL_SLOTS; i++) {
+            uint64_t tick = (block + i) << shift;
+            if (tick >= best) {
+                break;
+            }
+            if (!list_empty(&wheel->slots[level][(block + i) & TIMER_WHEEL_SLOT_MASK])) {
+                best = tick;
+                break;
+            }
+        }
+    }
+
+    return best;
+}
+
+/**
+ * @brief 依到期 tick 把計時器放進對應層的槽
+ *
+ * @return 此計時器需要處理的 tick (到期或所在槽開始 cascade)
+ */
+static uint64_t timer_wheel_place(timer_wheel_t *wheel, timer_wheel_timer_t *timer) {
+    uint64_t delta = timer->expires - wheel->current;
+    int level = 0;
+
+    while (level < TIMER_WHEEL_LEVELS - 1 &&
+           delta >= (1ULL << (TIMER_WHEEL_SLOT_BITS * (level + 1)))) {
+        level++;
+    }
+
+    unsigned int shift = TIMER_WHEEL_SLOT_BITS * (unsigned int)level;
+    size_t slot = (size_t)(timer->expires >> shift) & TIMER_WHEEL_SLOT_MASK;
+    list_add_tail(&wheel->slots[level][slot], &timer->node);
+    return (timer->expires >> shift) << shift;
+}
+
+/**
+ * @brief 將上層槽的計時器重新分配到下層
+ *
+ * @return true 需要繼續 cascade 更上一層
+ */
+static bool timer_wheel_cascade(timer_wheel_t *wheel, int level) {
+    size_t slot = (size_t)(wheel->current >> (TIMER_WHEEL_SLOT_BITS * level)) &
+                  TIMER_WHEEL_SLOT_MASK;
+
+    timer_wheel_node_t pending;
+    list_splice_init(&wheel->slots[level][slot], &pending);
+
+    while (!list_empty(&pending)) {
+        timer_wheel_timer_t *timer = (timer_wheel_timer_t *)pending.next;
+        list_del(&timer->node);
+        timer_wheel_place(wheel, timer);
+    }
+
+    return slot == 0;
+}
+
+/**
+ * @brief 推進一個 tick 並執行到期的計時器
+ */
+static int timer_wheel_tick(timer_wheel_t *wheel) {
+    wheel->current++;
+
+    if ((wheel->current & TIMER_WHEEL_SLOT_MASK) == 0) {
+        for (int level = 1; level < TIMER_WHEEL_LEVELS; level++) {
+            if (!timer_wheel_cascade(wheel, level)) {
+                break;
+            }
+        }
+    }
+
+    size_t slot = (size_t)(wheel->current & TIMER_WHEEL_SLOT_MASK);
+    timer_wheel_node_t expired;
+    list_splice_init(&wheel->slots[0][slot], &expired);
+
+    int fired = 0;
+    while (!list_empty(&expired)) {
+        timer_wheel_timer_t *timer = (timer_wheel_timer_t *)expired.next;
+        list_del(&timer->node);
+        timer->active = false;
+        wheel->count--;
+        fired++;
+
+        // 回呼可能重新排程此計時器或取消 expired 中的其他計時器
+        if (timer->callback != NULL) {
+            timer->callback(timer, timer->user_data);
+        }
+    }
+
+    return fired;
+}
+
+// ========================================
+// 公開函數實作
+// ========================================
+
+timer_wheel_t *timer_wheel_create(int tick_ms) {
+    timer_wheel_t *wheel = calloc(1, sizeof(*wheel));
+    if (wheel == NULL) {
+        return NULL;
+    }
+
+    wheel->timerfd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (wheel->timerfd < 0) {
+        perror("timerfd_create");
+        free(wheel);
+        return NULL;
+    }
+
+    wheel->tick_ms = (tick_ms > 0) ? tick_ms : TIMER_WHEEL_DEFAULT_TICK_MS;
+    wheel->start_ms = monotonic_ms();
+
+    for (int level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+        for (int slot = 0; slot < TIMER_WHEEL_SLOTS; slot++) {
+            list_init(&wheel->slots[level][slot]);
+        }
+    }
+
+    return wheel;
+}
+
+void timer_wheel_destroy(timer_wheel_t *wheel) {
+    if (wheel == NULL) {
+        return;
+    }
+
+    for (int level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+        for (int slot = 0; slot < TIMER_WHEEL_SLOTS; slot++) {
+            timer_wheel_node_t *head = &wheel->slots[level][slot];
+            while (!list_empty(head)) {
+                timer_wheel_timer_t *timer = (timer_wheel_timer_t *)head->next;
+                list_del(&timer->node);
+                timer->active = false;
+            }
+        }
+    }
+
+    close(wheel->timerfd);
+    free(wheel);
+}
+
+int timer_wheel_get_fd(const timer_wheel_t *wheel) {
+    if (wheel == NULL) {
+        return -1;
+    }
+    return wheel->timerfd;
+}
+
+void timer_wheel_timer_init(timer_wheel_timer_t *timer,
+                            timer_wheel_cb_t callback,
+                            void *user_data) {
+    if (timer == NULL) {
+        return;
+    }
+
+    memset(timer, 0, sizeof(*timer));
+    timer->node.next = &timer->node;
+    timer->node.prev = &timer->node;
+    timer->callback = callback;
+    timer->user_data = user_data;
+}
+
+int timer_wheel_add(timer_wheel_t *wheel, timer_wheel_timer_t *timer, int timeout_ms) {
+    if (wheel == NULL || timer == NULL || timeout_ms < 0) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    if (timer->active) {
+        list_del(&timer->node);
+        wheel->count--;
+    }
+
+    // current 只在喚醒時前進,到期 tick 以目前時間計算
+    uint64_t now = timer_wheel_now_ticks(wheel);
+    if (wheel->count == 0) {
+        wheel->current = now;
+    }
+
+    uint64_t ticks = ((uint64_t)timeout_ms + (uint64_t)wheel->tick_ms - 1) /
+                     (uint64_t)wheel->tick_ms;
+    if (ticks == 0) {
+        ticks = 1;
+    }
+    if (ticks > TIMER_WHEEL_MAX_TICKS) {
+        ticks = TIMER_WHEEL_MAX_TICKS;
+    }
+
+    timer->expires = now + ticks;
+    timer->active = true;
+    uint64_t wake = timer_wheel_place(wheel, timer);
+    wheel->count++;
+
+    if (!wheel->armed || wake < wheel->wake) {
+        timer_wheel_arm(wheel, wake);
+    }
+    return GAMING_OK;
+}
+
+void timer_wheel_cancel(timer_wheel_t *wheel, timer_wheel_timer_t *timer) {
+    if (wheel == NULL || timer == NULL || !timer->active) {
+        return;
+    }
+
+    list_del(&timer->node);
+    timer->active = false;
+    wheel->count--;
+
+    if (wheel->count == 0) {
+        timer_wheel_arm(wheel, UINT64_MAX);
+    }
+}
+
+int timer_wheel_process(timer_wheel_t *wheel) {
+    if (wheel == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    // 清除 timerfd 的可讀狀態;實際到期判斷以單調時鐘為準
+    uint64_t expirations;
+    while (read(wheel->timerfd, &expirations, sizeof(expirations)) < 0 && errno == EINTR) {
+    }
+
+    uint64_t now = timer_wheel_now_ticks(wheel);
+    int fired = 0;
+
+    while (wheel->current < now) {
+        if (wheel->count == 0) {
+            wheel->current = now;
+            break;
+        }
+        fired += timer_wheel_tick(wheel);
+    }
+
+    timer_wheel_arm(wheel, (wheel->count > 0) ? timer_wheel_next_tick(wheel) : UINT64_MAX);
+    return fired;
+}
+
+size_t timer_wheel_count(const timer_wheel_t *wheel) {
+    if (wheel == NULL) {
+        return 0;
+    }
+    return wheel->count;
+}
+
+int timer_wheel_backoff_ms(int base_ms, int max_ms, unsigned int attempt) {
+    if (base_ms <= 0) {
+        return 0;
+    }
+
+    int64_t delay = base_ms;
+    while (attempt > 0 && delay < max_ms) {
+        delay *= 2;
+        attempt--;
+    }
+
+    return (int)MIN(delay, (int64_t)max_ms);
+}
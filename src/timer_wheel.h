@@ -0,0 +1,161 @@
+/**
+ * @file timer_wheel.h
+ * @brief 階層式計時輪 (timerfd 驅動)
+ * @version 1.0.0
+ *
+ * 以單一 timerfd 驅動的階層式計時輪,提供 O(1) 新增與取消
+ * 用於連線閒置超時、心跳與重試退避,數千個計時器只需一個 fd 且不需額外執行緒
+ * 計時器結構由呼叫端持有 (可直接嵌入連線結構中),計時輪本身不配置記憶體
+ */
+
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include "gaming_common.h"
+#include <stddef.h>
+
+// ========================================
+// Timer Wheel 配置
+// ========================================
+
+// 預設 tick 間隔 (毫秒)
+#define TIMER_WHEEL_DEFAULT_TICK_MS 10
+
+// 每層槽數 (2 的次方) 與層數,可表示 64^4 個 tick
+#define TIMER_WHEEL_SLOT_BITS  6
+#define TIMER_WHEEL_SLOTS      (1 << TIMER_WHEEL_SLOT_BITS)
+#define TIMER_WHEEL_LEVELS     4
+
+// ========================================
+// Timer Wheel 型別定義
+// ========================================
+
+typedef struct timer_wheel timer_wheel_t;
+typedef struct timer_wheel_timer timer_wheel_timer_t;
+
+/**
+ * @brief 計時器到期回呼
+ *
+ * 回呼中可以重新加入 (timer_wheel_add) 或取消任何計時器
+ */
+typedef void (*timer_wheel_cb_t)(timer_wheel_timer_t *timer, void *user_data);
+
+/**
+ * @brief 雙向鏈結串列節點 (內部使用)
+ */
+typedef struct timer_wheel_node {
+    struct timer_wheel_node *next;
+    struct timer_wheel_node *prev;
+} timer_wheel_node_t;
+
+/**
+ * @brief 計時器 (由呼叫端配置,使用前以 timer_wheel_timer_init 初始化)
+ */
+struct timer_wheel_timer {
+    timer_wheel_node_t node;     ///< 內部使用,必須是第一個成員
+    uint64_t expires;            ///< 到期 tick (內部使用)
+    timer_wheel_cb_t callback;   ///< 到期回呼
+    void *user_data;             ///< 回呼使用者資料
+    bool active;                 ///< 是否已排程
+};
+
+// ========================================
+// Timer Wheel 公開函數
+// ========================================
+
+/**
+ * @brief 建立計時輪
+ *
+ * @param tick_ms tick 間隔(毫秒), <= 0 則使用 TIMER_WHEEL_DEFAULT_TICK_MS
+ * @return 計時輪指標, NULL 失敗
+ */
+timer_wheel_t *timer_wheel_create(int tick_ms);
+
+/**
+ * @brief 銷毀計時輪
+ *
+ * 尚未到期的計時器會被標記為未排程,但不會呼叫回呼
+ *
+ * @param wheel 計時輪指標
+ */
+void timer_wheel_destroy(timer_wheel_t *wheel);
+
+/**
+ * @brief 取得 timerfd
+ *
+ * 加入事件迴圈 (EPOLLIN),可讀時呼叫 timer_wheel_process()
+ * timerfd 為單次觸發,只在下一個到期 (或上層槽 cascade) 時喚醒;
+ * 沒有任何計時器時不會觸發
+ *
+ * @param wheel 計時輪指標
+ * @return >= 0 timerfd
+ * @return < 0 參數錯誤
+ */
+int timer_wheel_get_fd(const timer_wheel_t *wheel);
+
+/**
+ * @brief 初始化計時器
+ *
+ * @param timer 計時器
+ * @param callback 到期回呼
+ * @param user_data 回呼使用者資料
+ */
+void timer_wheel_timer_init(timer_wheel_timer_t *timer,
+                            timer_wheel_cb_t callback,
+                            void *user_data);
+
+/**
+ * @brief 排程計時器 (O(1))
+ *
+ * 若計時器已排程,則重新排程 (用於閒置超時的重設)
+ *
+ * @param wheel 計時輪指標
+ * @param timer 計時器
+ * @param timeout_ms 超時時間(毫秒),會向上取整到 tick
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR_INVALID_PARAM 參數錯誤
+ */
+int timer_wheel_add(timer_wheel_t *wheel, timer_wheel_timer_t *timer, int timeout_ms);
+
+/**
+ * @brief 取消計時器 (O(1))
+ *
+ * 對未排程的計時器呼叫不會有任何效果
+ *
+ * @param wheel 計時輪指標
+ * @param timer 計時器
+ */
+void timer_wheel_cancel(timer_wheel_t *wheel, timer_wheel_timer_t *timer);
+
+/**
+ * @brief 處理到期計時器
+ *
+ * 讀取 timerfd 並依目前時間推進計時輪,呼叫所有到期計時器的回呼
+ *
+ * @param wheel 計時輪指標
+ * @return >= 0 本次觸發的計時器數量
+ * @return < 0 參數錯誤
+ */
+int timer_wheel_process(timer_wheel_t *wheel);
+
+/**
+ * @brief 取得目前排程中的計時器數量
+ *
+ * @param wheel 計時輪指標
+ * @return 計時器數量
+ */
+size_t timer_wheel_count(const timer_wheel_t *wheel);
+
+/**
+ * @brief 計算指數退避延遲
+ *
+ * 延遲為 base_ms * 2^attempt,上限 max_ms
+ *
+ * @param base_ms 第一次重試延遲(毫秒)
+ * @param max_ms 延遲上限(毫秒)
+ * @param attempt 重試次數 (從 0 開始)
+ * @return 延遲(毫秒)
+ */
+int timer_wheel_backoff_ms(int base_ms, int max_ms, unsigned int attempt);
+
+#endif // TIMER_WHEEL_H
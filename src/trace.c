@@ -0,0 +1,224 @@
+/**
+ * @file trace.c
+ * @brief 熱路徑追蹤實作
+ * @version 1.0.0
+ */
+
+#include "trace.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/syscall.h>
+
+// ========================================
+// 內部結構
+// ========================================
+
+typedef struct {
+    uint64_t ts_ns;
+    const char *name;
+    uint8_t phase;              ///< trace_phase_t
+} trace_event_t;
+
+/**
+ * @brief 每個執行緒的事件環
+ *
+ * 只有擁有的執行緒會寫入 head;head 為累計事件數,以 release 發佈供 trace_dump 讀取
+ * trace_clear 不改 head,只記錄當時的 head 為 base,輸出時略過 base 之前的事件
+ * 執行緒結束時 (pthread key destructor) 環狀緩衝區放入 free list,
+ * 仍保留在全域串列中,事件可被輸出,直到新的執行緒取用為止
+ */
+typedef struct trace_ring {
+    struct trace_ring *next;
+    struct trace_ring *free_next;   ///< free list 鏈結 (持有 trace_rings_mutex)
+    pid_t tid;
+    uint64_t head;
+    uint64_t base;                  ///< trace_clear 時的 head
+    trace_event_t events[TRACE_RING_SIZE];
+} trace_ring_t;
+
+bool trace_enabled_flag = false;
+
+static __thread trace_ring_t *trace_thread_ring = NULL;
+static trace_ring_t *trace_rings = NULL;
+static trace_ring_t *trace_free_rings = NULL;
+static pthread_mutex_t trace_rings_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_key_t trace_ring_key;
+static pthread_once_t trace_ring_key_once = PTHREAD_ONCE_INIT;
+
+#define TRACE_RING_MASK (TRACE_RING_SIZE - 1)
+
+_Static_assert((TRACE_RING_SIZE & TRACE_RING_MASK) == 0,
+               "TRACE_RING_SIZE must be a power of two");
+
+// ========================================
+// 內部函數
+// ========================================
+
+static inline uint64_t trace_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief 執行緒結束時將環狀緩衝區放回 free list
+ */
+static void trace_ring_release(void *arg) {
+    trace_ring_t *ring = arg;
+
+    pthread_mutex_lock(&trace_rings_mutex);
+    ring->free_next = trace_free_rings;
+    trace_free_rings = ring;
+    pthread_mutex_unlock(&trace_rings_mutex);
+
+    trace_thread_ring = NULL;
+}
+
+static void trace_ring_key_create(void) {
+    pthread_key_create(&trace_ring_key, trace_ring_release);
+}
+
+/**
+ * @brief 取得目前執行緒的環狀緩衝區 (優先重用已結束執行緒留下的)
+ */
+static trace_ring_t *trace_ring_create(void) {
+    pthread_once(&trace_ring_key_once, trace_ring_key_create);
+    pid_t tid = (pid_t)syscall(SYS_gettid);
+
+    pthread_mutex_lock(&trace_rings_mutex);
+    trace_ring_t *ring = trace_free_rings;
+    if (ring != NULL) {
+        // 舊執行緒的事件不再輸出, 避免被算到新的 tid
+        trace_free_rings = ring->free_next;
+        ring->tid = tid;
+        __atomic_store_n(&ring->base, __atomic_load_n(&ring->head, __ATOMIC_RELAXED),
+                         __ATOMIC_RELEASE);
+    }
+    pthread_mutex_unlock(&trace_rings_mutex);
+
+    if (ring == NULL) {
+        ring = calloc(1, sizeof(trace_ring_t));
+        if (ring == NULL) {
+            return NULL;
+        }
+        ring->tid = tid;
+
+        pthread_mutex_lock(&trace_rings_mutex);
+        ring->next = trace_rings;
+        trace_rings = ring;
+        pthread_mutex_unlock(&trace_rings_mutex);
+    }
+
+    pthread_setspecific(trace_ring_key, ring);
+    trace_thread_ring = ring;
+    return ring;
+}
+
+static void trace_write_json_string(FILE *fp, const char *str) {
+    fputc('"', fp);
+    for (const char *p = str; *p != '\0'; p++) {
+        unsigned char c = (unsigned char)*p;
+        if (c == '"' || c == '\\') {
+            fputc('\\', fp);
+            fputc(c, fp);
+        } else if (c < 0x20) {
+            fprintf(fp, "\\u%04x", c);
+        } else {
+            fputc(c, fp);
+        }
+    }
+    fputc('"', fp);
+}
+
+// ========================================
+// 公開函數
+// ========================================
+
+void trace_set_enabled(bool enabled) {
+    __atomic_store_n(&trace_enabled_flag, enabled, __ATOMIC_RELAXED);
+}
+
+void trace_record(const char *name, trace_phase_t phase) {
+    trace_ring_t *ring = trace_thread_ring;
+    if (ring == NULL) {
+        ring = trace_ring_create();
+        if (ring == NULL) {
+            return;
+        }
+    }
+
+    uint64_t head = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+    trace_event_t *event = &ring->events[head & TRACE_RING_MASK];
+    event->ts_ns = trace_now_ns();
+    event->name = name;
+    event->phase = (uint8_t)phase;
+
+    __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+}
+
+int trace_dump(const char *path) {
+    if (path == NULL) {
+        path = TRACE_DEFAULT_DUMP_PATH;
+    }
+
+    FILE *fp = fopen(path, "w");
+    if (fp == NULL) {
+        perror("fopen");
+        return GAMING_ERROR_IO;
+    }
+
+    pid_t pid = getpid();
+    int count = 0;
+
+    fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", fp);
+
+    pthread_mutex_lock(&trace_rings_mutex);
+    for (trace_ring_t *ring = trace_rings; ring != NULL; ring = ring->next) {
+        uint64_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+        uint64_t base = __atomic_load_n(&ring->base, __ATOMIC_ACQUIRE);
+        uint64_t start = (head > TRACE_RING_SIZE) ? head - TRACE_RING_SIZE : 0;
+        start = MAX(start, base);
+
+        for (uint64_t i = start; i < head; i++) {
+            const trace_event_t *event = &ring->events[i & TRACE_RING_MASK];
+
+            fputs(count > 0 ? ",\n" : "\n", fp);
+            fputs("{\"name\":", fp);
+            trace_write_json_string(fp, event->name);
+            // Chrome trace 的 ts 單位為微秒,保留小數以維持 ns 精度
+            fprintf(fp, ",\"ph\":\"%c\",\"ts\":%llu.%03llu,\"pid\":%d,\"tid\":%d",
+                    event->phase,
+                    (unsigned long long)(event->ts_ns / 1000),
+                    (unsigned long long)(event->ts_ns % 1000),
+                    (int)pid, (int)ring->tid);
+            if (event->phase == TRACE_PHASE_INSTANT) {
+                fputs(",\"s\":\"t\"", fp);
+            }
+            fputc('}', fp);
+            count++;
+        }
+    }
+    pthread_mutex_unlock(&trace_rings_mutex);
+
+    fputs("\n]}\n", fp);
+
+    if (fclose(fp) != 0) {
+        perror("fclose");
+        return GAMING_ERROR_IO;
+    }
+
+    return count;
+}
+
+void trace_clear(void) {
+    pthread_mutex_lock(&trace_rings_mutex);
+    for (trace_ring_t *ring = trace_rings; ring != NULL; ring = ring->next) {
+        __atomic_store_n(&ring->base, __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE),
+                         __ATOMIC_RELEASE);
+    }
+    pthread_mutex_unlock(&trace_rings_mutex);
+}
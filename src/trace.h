@@ -0,0 +1,153 @@
+/**
+ * @file trace.h
+ * @brief 熱路徑追蹤 (begin/end span 與 instant event)
+ * @version 1.0.0
+ *
+ * 事件以 CLOCK_MONOTONIC 時間戳記錄到每個執行緒自己的環狀緩衝區,無鎖
+ * 追蹤預設關閉,關閉時每個追蹤點只有一次載入與分支
+ * trace_dump() 將所有執行緒的事件輸出為 Chrome trace-event JSON,
+ * 可直接用 chrome://tracing 或 Perfetto 開啟
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include "gaming_common.h"
+
+// ========================================
+// Trace 配置
+// ========================================
+
+// 每個執行緒保留的事件數 (2 的次方),滿了會覆蓋最舊的事件
+#define TRACE_RING_SIZE        4096
+
+#define TRACE_DEFAULT_DUMP_PATH PATH_RUN_DIR "/gaming_trace.json"
+
+// ========================================
+// Trace 型別定義
+// ========================================
+
+typedef enum {
+    TRACE_PHASE_BEGIN = 'B',
+    TRACE_PHASE_END = 'E',
+    TRACE_PHASE_INSTANT = 'i',
+} trace_phase_t;
+
+// 追蹤開關 (請用 trace_set_enabled 修改)
+extern bool trace_enabled_flag;
+
+// ========================================
+// Trace 公開函數
+// ========================================
+
+/**
+ * @brief 執行期開啟或關閉追蹤
+ *
+ * @param enabled true 開啟
+ */
+void trace_set_enabled(bool enabled);
+
+/**
+ * @brief 檢查追蹤是否開啟
+ */
+static inline bool trace_is_enabled(void) {
+    return __builtin_expect(__atomic_load_n(&trace_enabled_flag, __ATOMIC_RELAXED), 0);
+}
+
+/**
+ * @brief 記錄一個事件 (內部使用,請用下方 inline 函數)
+ *
+ * @param name 事件名稱,必須是靜態字串 (只保存指標)
+ * @param phase 事件類型
+ */
+void trace_record(const char *name, trace_phase_t phase);
+
+/**
+ * @brief 開始一個 span
+ *
+ * @param name 名稱 (靜態字串)
+ */
+static inline void trace_begin(const char *name) {
+    if (trace_is_enabled()) {
+        trace_record(name, TRACE_PHASE_BEGIN);
+    }
+}
+
+/**
+ * @brief 結束一個 span
+ *
+ * @param name 名稱,需與 trace_begin 相同
+ */
+static inline void trace_end(const char *name) {
+    if (trace_is_enabled()) {
+        trace_record(name, TRACE_PHASE_END);
+    }
+}
+
+/**
+ * @brief 記錄瞬間事件
+ *
+ * @param name 名稱 (靜態字串)
+ */
+static inline void trace_instant(const char *name) {
+    if (trace_is_enabled()) {
+        trace_record(name, TRACE_PHASE_INSTANT);
+    }
+}
+
+// ========================================
+// 作用域 span
+// ========================================
+
+typedef struct {
+    const char *name;
+    bool active;
+} trace_scope_t;
+
+static inline trace_scope_t trace_scope_begin(const char *name) {
+    trace_scope_t scope = { name, trace_is_enabled() };
+    if (scope.active) {
+        trace_record(name, TRACE_PHASE_BEGIN);
+    }
+    return scope;
+}
+
+static inline void trace_scope_end(trace_scope_t *scope) {
+    if (scope->active) {
+        trace_record(scope->name, TRACE_PHASE_END);
+    }
+}
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+
+/**
+ * @brief 從此處到目前作用域結束為一個 span (任何 return 路徑都會結束)
+ *
+ * 用法: TRACE_SCOPE("socket.send");
+ */
+#define TRACE_SCOPE(name) \
+    trace_scope_t TRACE_CONCAT(trace_scope_, __LINE__) \
+        __attribute__((cleanup(trace_scope_end), unused)) = trace_scope_begin(name)
+
+// ========================================
+// 輸出
+// ========================================
+
+/**
+ * @brief 將所有執行緒的事件輸出為 Chrome trace-event JSON
+ *
+ * 建議先以 trace_set_enabled(false) 停止追蹤再輸出,以免讀到正在覆寫的事件
+ *
+ * @param path 輸出路徑, NULL 則使用 TRACE_DEFAULT_DUMP_PATH
+ * @return >= 0 輸出的事件數
+ * @return GAMING_ERROR_IO 寫檔失敗
+ */
+int trace_dump(const char *path);
+
+/**
+ * @brief 清除所有執行緒已記錄的事件
+ */
+void trace_clear(void);
+
+#endif // TRACE_H
@@ -0,0 +1,480 @@
+/**
+ * @file ubus_service.c
+ * @brief ubus 狀態發佈與設定方法實作
+ * @version 1.0.0
+ */
+
+#define _GNU_SOURCE
+
+#include "ubus_service.h"
+#include "config_parser.h"
+#include "device_detect.h"
+#include "logger.h"
+#include "metrics.h"
+#include "trace.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <libubus.h>
+#include <libubox/blobmsg.h>
+
+// ========================================
+// 內部結構
+// ========================================
+
+typedef struct {
+    char config[32];
+    char section[64];
+    char option[64];
+    char value[UBUS_SERVICE_VALUE_SIZE];
+    bool valid;
+} ubus_cache_entry_t;
+
+struct ubus_service {
+    struct ubus_context *ctx;
+    struct ubus_object object;
+    struct blob_buf buf;
+
+    ps5_state_t ps5_state;
+    vpn_state_t vpn_state;
+    device_type_t device_type;
+
+    ubus_cache_entry_t cache[UBUS_SERVICE_CACHE_SIZE];
+    size_t cache_next;           // 下一個要覆寫的位置 (round-robin)
+};
+
+// ========================================
+// 統計
+// ========================================
+
+static pthread_once_t ubus_metrics_once = PTHREAD_ONCE_INIT;
+static metrics_counter_t *metric_notify;
+static metrics_counter_t *metric_cache_hits;
+static metrics_counter_t *metric_cache_misses;
+static metrics_counter_t *metric_errors;
+
+static void ubus_metrics_register(void) {
+    metric_notify = metrics_counter_register("ubus.notify");
+    metric_cache_hits = metrics_counter_register("ubus.cache.hits");
+    metric_cache_misses = metrics_counter_register("ubus.cache.misses");
+    metric_errors = metrics_counter_register("ubus.errors");
+}
+
+static inline void ubus_metrics_init(void) {
+    pthread_once(&ubus_metrics_once, ubus_metrics_register);
+}
+
+// ========================================
+// 設定快取
+// ========================================
+
+static ubus_cache_entry_t *cache_find(ubus_service_t *service, const char *config,
+                                      const char *section, const char *option) {
+    for (size_t i = 0; i < UBUS_SERVICE_CACHE_SIZE; i++) {
+        ubus_cache_entry_t *entry = &service->cache[i];
+        if (entry->valid && strcmp(entry->option, option) == 0 &&
+            strcmp(entry->section, section) == 0 && strcmp(entry->config, config) == 0) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+static void cache_store(ubus_service_t *service, const char *config, const char *section,
+                        const char *option, const char *value) {
+    ubus_cache_entry_t *entry = cache_find(service, config, section, option);
+    if (entry == NULL) {
+        entry = &service->cache[service->cache_next];
+        service->cache_next = (service->cache_next + 1) % UBUS_SERVICE_CACHE_SIZE;
+    }
+
+    // 名稱過長的項目不快取, 每次都直接讀取
+    if (strlen(config) >= sizeof(entry->config) || strlen(section) >= sizeof(entry->section) ||
+        strlen(option) >= sizeof(entry->option) || strlen(value) >= sizeof(entry->value)) {
+        entry->valid = false;
+        return;
+    }
+
+    strcpy(entry->config, config);
+    strcpy(entry->section, section);
+    strcpy(entry->option, option);
+    strcpy(entry->value, value);
+    entry->valid = true;
+}
+
+// ========================================
+// 參數檢查
+// ========================================
+
+/**
+ * @brief 檢查 uci 名稱 ([A-Za-z0-9_@[]-])
+ *
+ * config_parser 的 set / commit / CLI 後援路徑會組成 shell 命令,
+ * 來自 ubus 的名稱必須先限制字元,避免命令注入
+ */
+static bool valid_identifier(const char *name) {
+    if (name[0] == '\0') {
+        return false;
+    }
+    for (const char *p = name; *p != '\0'; p++) {
+        char c = *p;
+        if (!((c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') ||
+              c == '_' || c == '@' || c == '[' || c == ']' || c == '-')) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 檢查設定值 (會被單引號包住傳給 shell, 不可含單引號)
+ */
+static bool valid_value(const char *value) {
+    return strchr(value, '\'') == NULL;
+}
+
+// ========================================
+// 通知
+// ========================================
+
+static void notify_state(ubus_service_t *service, const char *name, const char *value) {
+    TRACE_SCOPE("ubus.notify");
+
+    blob_buf_init(&service->buf, 0);
+    blobmsg_add_string(&service->buf, name, value);
+
+    // 訂閱者 (ubus subscribe) 與廣播事件 (ubus listen) 都送
+    if (service->object.has_subscribers) {
+        ubus_notify(service->ctx, &service->object, name, service->buf.head, -1);
+    }
+
+    char event[64];
+    snprintf(event, sizeof(event), UBUS_SERVICE_EVENT_PREFIX "%s", name);
+    if (ubus_send_event(service->ctx, event, service->buf.head) != UBUS_STATUS_OK) {
+        metrics_counter_inc(metric_errors);
+    }
+    metrics_counter_inc(metric_notify);
+}
+
+// ========================================
+// ubus 方法
+// ========================================
+
+enum {
+    CONFIG_ATTR_CONFIG,
+    CONFIG_ATTR_SECTION,
+    CONFIG_ATTR_OPTION,
+    CONFIG_ATTR_VALUE,
+    CONFIG_ATTR_COMMIT,
+    __CONFIG_ATTR_MAX,
+};
+
+static const struct blobmsg_policy config_policy[__CONFIG_ATTR_MAX] = {
+    [CONFIG_ATTR_CONFIG] = { .name = "config", .type = BLOBMSG_TYPE_STRING },
+    [CONFIG_ATTR_SECTION] = { .name = "section", .type = BLOBMSG_TYPE_STRING },
+    [CONFIG_ATTR_OPTION] = { .name = "option", .type = BLOBMSG_TYPE_STRING },
+    [CONFIG_ATTR_VALUE] = { .name = "value", .type = BLOBMSG_TYPE_STRING },
+    [CONFIG_ATTR_COMMIT] = { .name = "commit", .type = BLOBMSG_TYPE_BOOL },
+};
+
+static int method_status(struct ubus_context *ctx, struct ubus_object *obj,
+                         struct ubus_request_data *req, const char *method,
+                         struct blob_attr *msg) {
+    (void)method;
+    (void)msg;
+    ubus_service_t *service = container_of(obj, ubus_service_t, object);
+
+    blob_buf_init(&service->buf, 0);
+    blobmsg_add_string(&service->buf, "ps5_state",
+                       ubus_service_ps5_state_string(service->ps5_state));
+    blobmsg_add_string(&service->buf, "vpn_state",
+                       ubus_service_vpn_state_string(service->vpn_state));
+    blobmsg_add_string(&service->buf, "device_type",
+                       device_detect_type_string(service->device_type));
+    ubus_send_reply(ctx, req, service->buf.head);
+    return UBUS_STATUS_OK;
+}
+
+static int method_get(struct ubus_context *ctx, struct ubus_object *obj,
+                      struct ubus_request_data *req, const char *method,
+                      struct blob_attr *msg) {
+    (void)method;
+    ubus_service_t *service = container_of(obj, ubus_service_t, object);
+    struct blob_attr *tb[__CONFIG_ATTR_MAX];
+
+    blobmsg_parse(config_policy, __CONFIG_ATTR_MAX, tb, blob_data(msg), blob_len(msg));
+    if (!tb[CONFIG_ATTR_CONFIG] || !tb[CONFIG_ATTR_SECTION] || !tb[CONFIG_ATTR_OPTION]) {
+        return UBUS_STATUS_INVALID_ARGUMENT;
+    }
+
+    const char *config = blobmsg_get_string(tb[CONFIG_ATTR_CONFIG]);
+    const char *section = blobmsg_get_string(tb[CONFIG_ATTR_SECTION]);
+    const char *option = blobmsg_get_string(tb[CONFIG_ATTR_OPTION]);
+    if (!valid_identifier(config) || !valid_identifier(section) || !valid_identifier(option)) {
+        return UBUS_STATUS_INVALID_ARGUMENT;
+    }
+
+    char value[UBUS_SERVICE_VALUE_SIZE];
+    ubus_cache_entry_t *entry = cache_find(service, config, section, option);
+    if (entry != NULL) {
+        metrics_counter_inc(metric_cache_hits);
+        strcpy(value, entry->value);
+    } else {
+        metrics_counter_inc(metric_cache_misses);
+        int ret = config_parser_get_string(config, section, option, value, sizeof(value));
+        if (ret == GAMING_ERROR_NOT_FOUND) {
+            return UBUS_STATUS_NOT_FOUND;
+        } else if (ret != GAMING_OK) {
+            metrics_counter_inc(metric_errors);
+            return UBUS_STATUS_UNKNOWN_ERROR;
+        }
+        cache_store(service, config, section, option, value);
+    }
+
+    blob_buf_init(&service->buf, 0);
+    blobmsg_add_string(&service->buf, "value", value);
+    ubus_send_reply(ctx, req, service->buf.head);
+    return UBUS_STATUS_OK;
+}
+
+static int method_set(struct ubus_context *ctx, struct ubus_object *obj,
+                      struct ubus_request_data *req, const char *method,
+                      struct blob_attr *msg) {
+    (void)ctx;
+    (void)req;
+    (void)method;
+    ubus_service_t *service = container_of(obj, ubus_service_t, object);
+    struct blob_attr *tb[__CONFIG_ATTR_MAX];
+
+    blobmsg_parse(config_policy, __CONFIG_ATTR_MAX, tb, blob_data(msg), blob_len(msg));
+    if (!tb[CONFIG_ATTR_CONFIG] || !tb[CONFIG_ATTR_SECTION] || !tb[CONFIG_ATTR_OPTION] ||
+        !tb[CONFIG_ATTR_VALUE]) {
+        return UBUS_STATUS_INVALID_ARGUMENT;
+    }
+
+    const char *config = blobmsg_get_string(tb[CONFIG_ATTR_CONFIG]);
+    const char *section = blobmsg_get_string(tb[CONFIG_ATTR_SECTION]);
+    const char *option = blobmsg_get_string(tb[CONFIG_ATTR_OPTION]);
+    const char *value = blobmsg_get_string(tb[CONFIG_ATTR_VALUE]);
+    if (!valid_identifier(config) || !valid_identifier(section) || !valid_identifier(option) ||
+        !valid_value(value)) {
+        return UBUS_STATUS_INVALID_ARGUMENT;
+    }
+
+    if (config_parser_set_string(config, section, option, value) != GAMING_OK) {
+        metrics_counter_inc(metric_errors);
+        return UBUS_STATUS_UNKNOWN_ERROR;
+    }
+    if (tb[CONFIG_ATTR_COMMIT] && blobmsg_get_bool(tb[CONFIG_ATTR_COMMIT]) &&
+        config_parser_commit(config) != GAMING_OK) {
+        metrics_counter_inc(metric_errors);
+        return UBUS_STATUS_UNKNOWN_ERROR;
+    }
+
+    cache_store(service, config, section, option, value);
+
+    blob_buf_init(&service->buf, 0);
+    blobmsg_add_string(&service->buf, "config", config);
+    blobmsg_add_string(&service->buf, "section", section);
+    blobmsg_add_string(&service->buf, "option", option);
+    blobmsg_add_string(&service->buf, "value", value);
+    if (service->object.has_subscribers) {
+        ubus_notify(service->ctx, &service->object, "config", service->buf.head, -1);
+    }
+    ubus_send_event(service->ctx, UBUS_SERVICE_EVENT_PREFIX "config", service->buf.head);
+    metrics_counter_inc(metric_notify);
+
+    return UBUS_STATUS_OK;
+}
+
+static int method_reload(struct ubus_context *ctx, struct ubus_object *obj,
+                         struct ubus_request_data *req, const char *method,
+                         struct blob_attr *msg) {
+    (void)ctx;
+    (void)req;
+    (void)method;
+    (void)msg;
+    ubus_service_invalidate(container_of(obj, ubus_service_t, object));
+    config_parser_load_log_levels(UCI_CONFIG_GAMING, UCI_SECTION_MAIN);
+    return UBUS_STATUS_OK;
+}
+
+enum {
+    LOG_ATTR_MODULES,
+    __LOG_ATTR_MAX,
+};
+
+static const struct blobmsg_policy log_policy[__LOG_ATTR_MAX] = {
+    [LOG_ATTR_MODULES] = { .name = "modules", .type = BLOBMSG_TYPE_STRING },
+};
+
+/**
+ * @brief 執行期調整日誌等級 ("modules" 為 logger_set_module_levels() 格式)
+ *
+ * 回覆各模組目前的等級 (不帶參數時只查詢)
+ */
+static int method_log_levels(struct ubus_context *ctx, struct ubus_object *obj,
+                             struct ubus_request_data *req, const char *method,
+                             struct blob_attr *msg) {
+    (void)method;
+    ubus_service_t *service = container_of(obj, ubus_service_t, object);
+    struct blob_attr *tb[__LOG_ATTR_MAX];
+
+    blobmsg_parse(log_policy, __LOG_ATTR_MAX, tb, blob_data(msg), blob_len(msg));
+    if (tb[LOG_ATTR_MODULES] &&
+        logger_set_module_levels(blobmsg_get_string(tb[LOG_ATTR_MODULES])) != GAMING_OK) {
+        return UBUS_STATUS_INVALID_ARGUMENT;
+    }
+
+    blob_buf_init(&service->buf, 0);
+    for (int module = 0; module < LOG_MODULE_COUNT; module++) {
+        int level = logger_get_module_level((log_module_t)module);
+        blobmsg_add_string(&service->buf, logger_module_name((log_module_t)module),
+                           (level > LOG_LEVEL_ERROR) ? "off"
+                                                     : logger_level_string((log_level_t)level));
+    }
+    ubus_send_reply(ctx, req, service->buf.head);
+    return UBUS_STATUS_OK;
+}
+
+static const struct ubus_method gaming_methods[] = {
+    UBUS_METHOD_NOARG("status", method_status),
+    UBUS_METHOD_MASK("get", method_get, config_policy,
+                     (1 << CONFIG_ATTR_CONFIG) | (1 << CONFIG_ATTR_SECTION) |
+                     (1 << CONFIG_ATTR_OPTION)),
+    UBUS_METHOD("set", method_set, config_policy),
+    UBUS_METHOD_NOARG("reload", method_reload),
+    UBUS_METHOD("log_levels", method_log_levels, log_policy),
+};
+
+static struct ubus_object_type gaming_object_type =
+    UBUS_OBJECT_TYPE(UBUS_SERVICE_OBJECT_NAME, gaming_methods);
+
+// ========================================
+// 公開函數
+// ========================================
+
+ubus_service_t *ubus_service_create(const char *socket_path) {
+    ubus_metrics_init();
+
+    ubus_service_t *service = calloc(1, sizeof(*service));
+    if (service == NULL) {
+        return NULL;
+    }
+
+    service->ctx = ubus_connect(socket_path);
+    if (service->ctx == NULL) {
+        LOGM_ERROR(LOG_MODULE_UBUS, "failed to connect to ubusd");
+        free(service);
+        return NULL;
+    }
+
+    service->object.name = UBUS_SERVICE_OBJECT_NAME;
+    service->object.type = &gaming_object_type;
+    service->object.methods = gaming_methods;
+    service->object.n_methods = ARRAY_SIZE(gaming_methods);
+
+    int ret = ubus_add_object(service->ctx, &service->object);
+    if (ret != UBUS_STATUS_OK) {
+        LOGM_ERROR(LOG_MODULE_UBUS, "add object: %s", ubus_strerror(ret));
+        ubus_free(service->ctx);
+        free(service);
+        return NULL;
+    }
+
+    // 啟動時套用 UCI 日誌等級, 之後由 reload 重新套用
+    config_parser_load_log_levels(UCI_CONFIG_GAMING, UCI_SECTION_MAIN);
+    return service;
+}
+
+void ubus_service_destroy(ubus_service_t *service) {
+    if (service == NULL) {
+        return;
+    }
+
+    ubus_remove_object(service->ctx, &service->object);
+    ubus_free(service->ctx);
+    blob_buf_free(&service->buf);
+    free(service);
+}
+
+int ubus_service_get_fd(const ubus_service_t *service) {
+    if (service == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+    return service->ctx->sock.fd;
+}
+
+int ubus_service_process(ubus_service_t *service) {
+    if (service == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    ubus_handle_event(service->ctx);
+    return service->ctx->sock.eof ? GAMING_ERROR_IO : GAMING_OK;
+}
+
+int ubus_service_set_ps5_state(ubus_service_t *service, ps5_state_t state) {
+    if (service == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    if (service->ps5_state != state) {
+        service->ps5_state = state;
+        notify_state(service, "ps5_state", ubus_service_ps5_state_string(state));
+    }
+    return GAMING_OK;
+}
+
+int ubus_service_set_vpn_state(ubus_service_t *service, vpn_state_t state) {
+    if (service == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    if (service->vpn_state != state) {
+        service->vpn_state = state;
+        notify_state(service, "vpn_state", ubus_service_vpn_state_string(state));
+    }
+    return GAMING_OK;
+}
+
+int ubus_service_set_device_type(ubus_service_t *service, device_type_t type) {
+    if (service == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    if (service->device_type != type) {
+        service->device_type = type;
+        notify_state(service, "device_type", device_detect_type_string(type));
+    }
+    return GAMING_OK;
+}
+
+void ubus_service_invalidate(ubus_service_t *service) {
+    if (service == NULL) {
+        return;
+    }
+
+    for (size_t i = 0; i < UBUS_SERVICE_CACHE_SIZE; i++) {
+        service->cache[i].valid = false;
+    }
+}
+
+const char *ubus_service_ps5_state_string(ps5_state_t state) {
+    switch (state) {
+        case PS5_STATE_ON:       return "on";
+        case PS5_STATE_STANDBY:  return "standby";
+        case PS5_STATE_OFF:      return "off";
+        default:                 return "unknown";
+    }
+}
+
+const char *ubus_service_vpn_state_string(vpn_state_t state) {
+    switch (state) {
+        case VPN_STATE_DISCONNECTED: return "disconnected";
+        case VPN_STATE_CONNECTING:   return "connecting";
+        case VPN_STATE_CONNECTED:    return "connected";
+        default:                     return "unknown";
+    }
+}
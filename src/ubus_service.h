@@ -0,0 +1,123 @@
+/**
+ * @file ubus_service.h
+ * @brief ubus 狀態發佈與設定方法
+ * @version 1.0.0
+ *
+ * 在 ubus 上註冊 "gaming" 物件:
+ *   - 狀態 (PS5 / VPN / 裝置類型) 改變時以 ubus_notify 通知訂閱者,
+ *     並送出 "gaming.<name>" 事件 (可用 "ubus listen" 觀察)
+ *   - 方法 status / get / set / reload,get 由記憶體快取回應,
+ *     未命中才經由 config_parser 讀取;reload 同時重新套用 UCI 日誌等級
+ *   - 方法 log_levels {"modules": "socket=debug,led=off"} 執行期調整日誌等級
+ *
+ * 取代輪詢 socket 與快取檔案;所有函數須在同一個執行緒 (事件迴圈) 呼叫
+ */
+
+#ifndef UBUS_SERVICE_H
+#define UBUS_SERVICE_H
+
+#include "gaming_common.h"
+
+// ========================================
+// ubus 配置
+// ========================================
+
+#define UBUS_SERVICE_OBJECT_NAME   "gaming"
+#define UBUS_SERVICE_EVENT_PREFIX  "gaming."
+#define UBUS_SERVICE_CACHE_SIZE    64
+#define UBUS_SERVICE_VALUE_SIZE    256
+
+// ========================================
+// ubus 型別定義
+// ========================================
+
+typedef struct ubus_service ubus_service_t;
+
+// ========================================
+// ubus 公開函數
+// ========================================
+
+/**
+ * @brief 連線到 ubusd 並註冊物件
+ *
+ * 需先呼叫 config_parser_init()
+ *
+ * @param socket_path ubusd socket 路徑, NULL 使用預設值
+ * @return 服務指標, NULL 失敗
+ */
+ubus_service_t *ubus_service_create(const char *socket_path);
+
+/**
+ * @brief 移除物件並中斷連線
+ *
+ * @param service 服務指標
+ */
+void ubus_service_destroy(ubus_service_t *service);
+
+/**
+ * @brief 取得 ubus 連線 fd
+ *
+ * 加入呼叫端的事件迴圈 (EPOLLIN),可讀時呼叫 ubus_service_process()
+ *
+ * @param service 服務指標
+ * @return >= 0 fd
+ * @return < 0 參數錯誤
+ */
+int ubus_service_get_fd(const ubus_service_t *service);
+
+/**
+ * @brief 處理 ubus 訊息 (不阻塞)
+ *
+ * @param service 服務指標
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR_IO 連線已中斷
+ */
+int ubus_service_process(ubus_service_t *service);
+
+/**
+ * @brief 更新 PS5 狀態 (改變時通知)
+ *
+ * @param service 服務指標
+ * @param state PS5 狀態
+ * @return GAMING_OK 成功
+ */
+int ubus_service_set_ps5_state(ubus_service_t *service, ps5_state_t state);
+
+/**
+ * @brief 更新 VPN 狀態 (改變時通知)
+ *
+ * @param service 服務指標
+ * @param state VPN 狀態
+ * @return GAMING_OK 成功
+ */
+int ubus_service_set_vpn_state(ubus_service_t *service, vpn_state_t state);
+
+/**
+ * @brief 更新裝置類型 (改變時通知)
+ *
+ * @param service 服務指標
+ * @param type 裝置類型
+ * @return GAMING_OK 成功
+ */
+int ubus_service_set_device_type(ubus_service_t *service, device_type_t type);
+
+/**
+ * @brief 清除設定快取
+ *
+ * 設定檔在服務之外被修改時呼叫 (等同 ubus 方法 reload)
+ *
+ * @param service 服務指標
+ */
+void ubus_service_invalidate(ubus_service_t *service);
+
+/**
+ * @brief 取得 PS5 狀態字串
+ */
+const char *ubus_service_ps5_state_string(ps5_state_t state);
+
+/**
+ * @brief 取得 VPN 狀態字串
+ */
+const char *ubus_service_vpn_state_string(vpn_state_t state);
+
+#endif // UBUS_SERVICE_H
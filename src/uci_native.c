@@ -0,0 +1,685 @@
+/**
+ * @file uci_native.c
+ * @brief 原生 UCI 設定檔解析器實作
+ * @version 1.0.0
+ */
+
+#define _GNU_SOURCE
+
+#include "uci_native.h"
+#include "logger.h"
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <limits.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// ========================================
+// 內部結構
+// ========================================
+
+// get_string 串接 list 時最多處理的元素數
+#define UCI_NATIVE_MAX_LIST  64
+
+typedef struct {
+    uci_view_t type;
+    uci_view_t name;             // 匿名 section 長度為 0
+    size_t first_option;         // 在 options 陣列中的起始位置
+    size_t option_count;
+} uci_native_section_t;
+
+typedef struct {
+    uci_view_t name;
+    uci_view_t value;
+    bool is_list;
+} uci_native_option_t;
+
+struct uci_native {
+    char *map;
+    size_t size;
+
+    uci_native_section_t *sections;
+    size_t section_count;
+    size_t section_capacity;
+
+    uci_native_option_t *options;
+    size_t option_count;
+    size_t option_capacity;
+};
+
+typedef enum {
+    TOKEN_ERROR = -1,
+    TOKEN_EOL = 0,
+    TOKEN_OK = 1,
+} token_result_t;
+
+// ========================================
+// Tokenizer
+// ========================================
+
+static inline bool is_blank(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+static inline bool is_token_end(char c) {
+    return is_blank(c) || c == '\n';
+}
+
+/**
+ * @brief 讀取一個 token
+ *
+ * 單一段落且沒有跳脫字元的 token (最常見的情況) 直接指向引號內的內容;
+ * 相鄰串接或含跳脫字元的 token 指向原始文字並標記 escaped
+ */
+static token_result_t next_token(const char **pos, const char *end, uci_view_t *out) {
+    const char *p = *pos;
+    while (p < end && is_blank(*p)) {
+        p++;
+    }
+    if (p >= end || *p == '\n' || *p == '#') {
+        *pos = p;
+        return TOKEN_EOL;
+    }
+
+    const char *start = p;
+    const char *part = p;
+    size_t part_len = 0;
+    int parts = 0;
+    bool escaped = false;
+
+    while (p < end && !is_token_end(*p)) {
+        if (*p == '\'') {
+            const char *close = memchr(p + 1, '\'', (size_t)(end - p - 1));
+            if (close == NULL || memchr(p + 1, '\n', (size_t)(close - p - 1)) != NULL) {
+                return TOKEN_ERROR;
+            }
+            part = p + 1;
+            part_len = (size_t)(close - part);
+            p = close + 1;
+        } else if (*p == '"') {
+            const char *q = p + 1;
+            while (q < end && *q != '"') {
+                if (*q == '\n') {
+                    return TOKEN_ERROR;
+                }
+                if (*q == '\\') {
+                    escaped = true;
+                    q++;
+                }
+                q++;
+            }
+            if (q >= end) {
+                return TOKEN_ERROR;
+            }
+            part = p + 1;
+            part_len = (size_t)(q - part);
+            p = q + 1;
+        } else {
+            part = p;
+            while (p < end && !is_token_end(*p) && *p != '\'' && *p != '"') {
+                if (*p == '\\') {
+                    escaped = true;
+                    p++;
+                }
+                p++;
+            }
+            if (p > end) {
+                return TOKEN_ERROR;
+            }
+            part_len = (size_t)(p - part);
+        }
+        parts++;
+    }
+
+    if (parts == 1 && !escaped) {
+        out->ptr = part;
+        out->len = part_len;
+        out->escaped = false;
+    } else {
+        out->ptr = start;
+        out->len = (size_t)(p - start);
+        out->escaped = true;
+    }
+
+    *pos = p;
+    return TOKEN_OK;
+}
+
+/**
+ * @brief 還原含引號與跳脫字元的原始 token
+ *
+ * @param out 輸出 (NULL 只計算長度)
+ * @return 還原後的長度
+ */
+static size_t token_decode(const char *p, size_t len, char *out) {
+    const char *end = p + len;
+    size_t n = 0;
+
+    while (p < end) {
+        if (*p == '\'') {
+            for (p++; p < end && *p != '\''; p++) {
+                if (out != NULL) {
+                    out[n] = *p;
+                }
+                n++;
+            }
+            p++;
+        } else if (*p == '"') {
+            for (p++; p < end && *p != '"'; p++) {
+                if (*p == '\\' && p + 1 < end) {
+                    p++;
+                }
+                if (out != NULL) {
+                    out[n] = *p;
+                }
+                n++;
+            }
+            p++;
+        } else {
+            if (*p == '\\' && p + 1 < end) {
+                p++;
+            }
+            if (out != NULL) {
+                out[n] = *p;
+            }
+            n++;
+            p++;
+        }
+    }
+    return n;
+}
+
+// ========================================
+// 解析
+// ========================================
+
+static bool keyword_is(const uci_view_t *view, const char *keyword) {
+    size_t len = strlen(keyword);
+    return !view->escaped && view->len == len && memcmp(view->ptr, keyword, len) == 0;
+}
+
+static int add_section(uci_native_t *uci, const uci_view_t *type, const uci_view_t *name) {
+    if (uci->section_count == uci->section_capacity) {
+        size_t capacity = (uci->section_capacity == 0) ? 16 : uci->section_capacity * 2;
+        uci_native_section_t *sections = realloc(uci->sections, capacity * sizeof(*sections));
+        if (sections == NULL) {
+            return GAMING_ERROR_NO_MEMORY;
+        }
+        uci->sections = sections;
+        uci->section_capacity = capacity;
+    }
+
+    uci_native_section_t *section = &uci->sections[uci->section_count++];
+    section->type = *type;
+    section->name = *name;
+    section->first_option = uci->option_count;
+    section->option_count = 0;
+    return GAMING_OK;
+}
+
+static int add_option(uci_native_t *uci, const uci_view_t *name, const uci_view_t *value,
+                      bool is_list) {
+    if (uci->option_count == uci->option_capacity) {
+        size_t capacity = (uci->option_capacity == 0) ? 64 : uci->option_capacity * 2;
+        uci_native_option_t *options = realloc(uci->options, capacity * sizeof(*options));
+        if (options == NULL) {
+            return GAMING_ERROR_NO_MEMORY;
+        }
+        uci->options = options;
+        uci->option_capacity = capacity;
+    }
+
+    uci_native_option_t *option = &uci->options[uci->option_count++];
+    option->name = *name;
+    option->value = *value;
+    option->is_list = is_list;
+    uci->sections[uci->section_count - 1].option_count++;
+    return GAMING_OK;
+}
+
+static int parse(uci_native_t *uci, const char *path) {
+    const char *p = uci->map;
+    const char *end = uci->map + uci->size;
+    int line = 0;
+
+    while (p < end) {
+        line++;
+
+        uci_view_t keyword, first, second;
+        token_result_t r = next_token(&p, end, &keyword);
+        if (r == TOKEN_OK) {
+            token_result_t r1 = next_token(&p, end, &first);
+            token_result_t r2 = (r1 == TOKEN_OK) ? next_token(&p, end, &second) : TOKEN_EOL;
+            if (r1 == TOKEN_ERROR || r2 == TOKEN_ERROR) {
+                r = TOKEN_ERROR;
+            } else if (keyword_is(&keyword, "package")) {
+                // 單一檔案只有一個 package, 忽略
+            } else if (keyword_is(&keyword, "config") && r1 == TOKEN_OK) {
+                uci_view_t anonymous = { NULL, 0, false };
+                if (add_section(uci, &first, (r2 == TOKEN_OK) ? &second : &anonymous) != GAMING_OK) {
+                    return GAMING_ERROR_NO_MEMORY;
+                }
+            } else if ((keyword_is(&keyword, "option") || keyword_is(&keyword, "list")) &&
+                       r2 == TOKEN_OK && uci->section_count > 0) {
+                if (add_option(uci, &first, &second, keyword_is(&keyword, "list")) != GAMING_OK) {
+                    return GAMING_ERROR_NO_MEMORY;
+                }
+            } else {
+                r = TOKEN_ERROR;
+            }
+        }
+
+        if (r == TOKEN_ERROR) {
+            LOGM_ERROR(LOG_MODULE_CONFIG, "%s:%d: parse error", path, line);
+            return GAMING_ERROR_INVALID_PARAM;
+        }
+
+        // 略過行尾 (註解或多餘的 token)
+        const char *eol = memchr(p, '\n', (size_t)(end - p));
+        p = (eol != NULL) ? eol + 1 : end;
+    }
+
+    return GAMING_OK;
+}
+
+// ========================================
+// 查詢
+// ========================================
+
+static bool view_is_type(const uci_view_t *view, const char *type, size_t type_len) {
+    return !view->escaped && view->len == type_len && memcmp(view->ptr, type, type_len) == 0;
+}
+
+/**
+ * @brief 將 "@type[index]" 解析為 section 索引
+ *
+ * @return 符合的 section 索引, -1 不存在或格式錯誤
+ */
+static long resolve_indexed_section(const uci_native_t *uci, const char *spec) {
+    const char *bracket = strchr(spec, '[');
+    if (bracket == NULL) {
+        return -1;
+    }
+
+    const char *type = spec + 1;
+    size_t type_len = (size_t)(bracket - type);
+    long wanted = strtol(bracket + 1, NULL, 10);
+
+    if (wanted < 0) {
+        for (size_t i = uci->section_count; i-- > 0;) {
+            if (view_is_type(&uci->sections[i].type, type, type_len) && ++wanted == 0) {
+                return (long)i;
+            }
+        }
+    } else {
+        for (size_t i = 0; i < uci->section_count; i++) {
+            if (view_is_type(&uci->sections[i].type, type, type_len) && wanted-- == 0) {
+                return (long)i;
+            }
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief 收集 option 的所有值
+ *
+ * 依 libuci 語意: option 覆蓋先前的值;list 累加,接在 option 之後時
+ * 該 option 轉為 list 的第一個元素
+ *
+ * @return 值的總數 (0 表示不存在)
+ */
+static size_t collect_values(const uci_native_t *uci, const char *section, const char *option,
+                             uci_view_t *values, size_t max_values) {
+    size_t count = 0;
+    size_t first = 0;
+    size_t last = uci->section_count;
+
+    // "@type[index]" 只對應單一 section; 具名 section 可能重複出現, 內容需合併
+    bool indexed = (section[0] == '@');
+    if (indexed) {
+        long index = resolve_indexed_section(uci, section);
+        if (index < 0) {
+            return 0;
+        }
+        first = (size_t)index;
+        last = first + 1;
+    }
+
+    for (size_t s = first; s < last; s++) {
+        const uci_view_t *name = &uci->sections[s].name;
+        if (!indexed && (name->len == 0 || !uci_native_view_equals(name, section))) {
+            continue;
+        }
+
+        const uci_native_section_t *sec = &uci->sections[s];
+        for (size_t i = 0; i < sec->option_count; i++) {
+            const uci_native_option_t *opt = &uci->options[sec->first_option + i];
+            if (!uci_native_view_equals(&opt->name, option)) {
+                continue;
+            }
+
+            if (!opt->is_list) {
+                count = 0;
+            }
+            if (count < max_values) {
+                values[count] = opt->value;
+            }
+            count++;
+        }
+    }
+
+    return count;
+}
+
+// ========================================
+// 公開函數
+// ========================================
+
+uci_native_t *uci_native_open(const char *path) {
+    if (path == NULL) {
+        return NULL;
+    }
+
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return NULL;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+        close(fd);
+        return NULL;
+    }
+
+    uci_native_t *uci = calloc(1, sizeof(*uci));
+    if (uci == NULL) {
+        close(fd);
+        return NULL;
+    }
+
+    uci->size = (size_t)st.st_size;
+    if (uci->size > 0) {
+        uci->map = mmap(NULL, uci->size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (uci->map == MAP_FAILED) {
+            LOGM_ERRNO(LOG_MODULE_CONFIG, "mmap");
+            close(fd);
+            free(uci);
+            return NULL;
+        }
+    }
+    close(fd);
+
+    if (parse(uci, path) != GAMING_OK) {
+        uci_native_close(uci);
+        return NULL;
+    }
+
+    return uci;
+}
+
+uci_native_t *uci_native_open_config(const char *config_name) {
+    if (config_name == NULL || strchr(config_name, '/') != NULL) {
+        return NULL;
+    }
+
+    char path[PATH_MAX];
+    snprintf(path, sizeof(path), UCI_NATIVE_CONFIG_DIR "/%s", config_name);
+    return uci_native_open(path);
+}
+
+void uci_native_close(uci_native_t *uci) {
+    if (uci == NULL) {
+        return;
+    }
+
+    if (uci->map != NULL) {
+        munmap(uci->map, uci->size);
+    }
+    free(uci->sections);
+    free(uci->options);
+    free(uci);
+}
+
+size_t uci_native_section_count(const uci_native_t *uci) {
+    return (uci != NULL) ? uci->section_count : 0;
+}
+
+int uci_native_section_at(const uci_native_t *uci, size_t index,
+                          uci_view_t *type, uci_view_t *name) {
+    if (uci == NULL || index >= uci->section_count) {
+        return GAMING_ERROR_NOT_FOUND;
+    }
+
+    if (type != NULL) {
+        *type = uci->sections[index].type;
+    }
+    if (name != NULL) {
+        *name = uci->sections[index].name;
+    }
+    return GAMING_OK;
+}
+
+int uci_native_get(const uci_native_t *uci, const char *section, const char *option,
+                   uci_view_t *value) {
+    if (uci == NULL || section == NULL || option == NULL || value == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    uci_view_t values[1];
+    if (collect_values(uci, section, option, values, 1) == 0) {
+        return GAMING_ERROR_NOT_FOUND;
+    }
+
+    *value = values[0];
+    return GAMING_OK;
+}
+
+int uci_native_get_string(const uci_native_t *uci, const char *section, const char *option,
+                          char *buffer, size_t size) {
+    if (uci == NULL || section == NULL || option == NULL || buffer == NULL || size == 0) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    uci_view_t values[UCI_NATIVE_MAX_LIST];
+    size_t count = collect_values(uci, section, option, values, UCI_NATIVE_MAX_LIST);
+    if (count == 0) {
+        return GAMING_ERROR_NOT_FOUND;
+    }
+    if (count > UCI_NATIVE_MAX_LIST) {
+        return GAMING_ERROR_NO_MEMORY;
+    }
+
+    size_t used = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (i > 0) {
+            if (used + 1 >= size) {
+                return GAMING_ERROR_NO_MEMORY;
+            }
+            buffer[used++] = ' ';
+        }
+
+        int len = uci_native_view_copy(&values[i], buffer + used, size - used);
+        if (len < 0) {
+            return len;
+        }
+        used += (size_t)len;
+    }
+
+    return GAMING_OK;
+}
+
+int uci_native_get_list(const uci_native_t *uci, const char *section, const char *option,
+                        uci_view_t *values, size_t max_values) {
+    if (uci == NULL || section == NULL || option == NULL || (values == NULL && max_values > 0)) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    size_t count = collect_values(uci, section, option, values, max_values);
+    if (count == 0) {
+        return GAMING_ERROR_NOT_FOUND;
+    }
+    return (int)count;
+}
+
+int uci_native_view_copy(const uci_view_t *view, char *buffer, size_t size) {
+    if (view == NULL || buffer == NULL || size == 0) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    size_t len = view->escaped ? token_decode(view->ptr, view->len, NULL) : view->len;
+    if (len + 1 > size) {
+        return GAMING_ERROR_NO_MEMORY;
+    }
+
+    if (view->escaped) {
+        token_decode(view->ptr, view->len, buffer);
+    } else if (len > 0) {
+        memcpy(buffer, view->ptr, len);
+    }
+    buffer[len] = '\0';
+    return (int)len;
+}
+
+bool uci_native_view_equals(const uci_view_t *view, const char *str) {
+    if (view == NULL || str == NULL) {
+        return false;
+    }
+
+    if (!view->escaped) {
+        return strlen(str) == view->len && memcmp(view->ptr, str, view->len) == 0;
+    }
+
+    char buf[256];
+    int len = uci_native_view_copy(view, buf, sizeof(buf));
+    return len >= 0 && strcmp(buf, str) == 0;
+}
+
+/**
+ * @brief 以單引號輸出視圖內容 (' 轉為 '\'')
+ */
+static void write_quoted(FILE *fp, const uci_view_t *view) {
+    char stack_buf[256];
+    char *text = stack_buf;
+    size_t len = view->len;
+
+    if (view->escaped) {
+        if (view->len >= sizeof(stack_buf)) {
+            text = malloc(view->len + 1);
+            if (text == NULL) {
+                return;
+            }
+        }
+        len = token_decode(view->ptr, view->len, text);
+    } else {
+        text = (char *)view->ptr;
+    }
+
+    fputc('\'', fp);
+    for (size_t i = 0; i < len; i++) {
+        if (text[i] == '\'') {
+            fputs("'\\''", fp);
+        } else {
+            fputc(text[i], fp);
+        }
+    }
+    fputc('\'', fp);
+
+    if (text != stack_buf && text != view->ptr) {
+        free(text);
+    }
+}
+
+/**
+ * @brief 判斷 option 是否會被同一 section 之後的 list 轉為 list
+ */
+static bool becomes_list(const uci_native_t *uci, const uci_native_section_t *section,
+                         size_t index) {
+    const uci_native_option_t *option = &uci->options[section->first_option + index];
+    for (size_t i = index + 1; i < section->option_count; i++) {
+        const uci_native_option_t *next = &uci->options[section->first_option + i];
+        if (next->name.len == option->name.len &&
+            memcmp(next->name.ptr, option->name.ptr, option->name.len) == 0) {
+            return next->is_list;
+        }
+    }
+    return false;
+}
+
+static void write_plain(FILE *fp, const uci_view_t *view) {
+    if (!view->escaped) {
+        fwrite(view->ptr, 1, view->len, fp);
+        return;
+    }
+
+    char buf[256];
+    if (uci_native_view_copy(view, buf, sizeof(buf)) >= 0) {
+        fputs(buf, fp);
+    }
+}
+
+int uci_native_export(const uci_native_t *uci, const char *package, FILE *fp) {
+    if (uci == NULL || fp == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    if (package != NULL) {
+        fprintf(fp, "package %s\n", package);
+    }
+
+    for (size_t s = 0; s < uci->section_count; s++) {
+        const uci_native_section_t *section = &uci->sections[s];
+
+        fputs("\nconfig ", fp);
+        write_plain(fp, &section->type);
+        if (section->name.len > 0) {
+            fputc(' ', fp);
+            write_quoted(fp, &section->name);
+        }
+        fputc('\n', fp);
+
+        for (size_t i = 0; i < section->option_count; i++) {
+            const uci_native_option_t *option = &uci->options[section->first_option + i];
+            bool is_list = option->is_list || becomes_list(uci, section, i);
+            fputs(is_list ? "\tlist " : "\toption ", fp);
+            write_plain(fp, &option->name);
+            fputc(' ', fp);
+            write_quoted(fp, &option->value);
+            fputc('\n', fp);
+        }
+    }
+    fputc('\n', fp);
+
+    return ferror(fp) ? GAMING_ERROR_IO : GAMING_OK;
+}
+
+int uci_native_write(const uci_native_t *uci, const char *path) {
+    if (uci == NULL || path == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    char tmp_path[PATH_MAX + 16];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.%d.tmp", path, (int)getpid());
+
+    FILE *fp = fopen(tmp_path, "w");
+    if (fp == NULL) {
+        LOGM_ERRNO(LOG_MODULE_CONFIG, "fopen");
+        return GAMING_ERROR_IO;
+    }
+
+    int ret = uci_native_export(uci, NULL, fp);
+    if (fclose(fp) != 0) {
+        ret = GAMING_ERROR_IO;
+    }
+
+    if (ret != GAMING_OK || rename(tmp_path, path) < 0) {
+        LOGM_ERRNO(LOG_MODULE_CONFIG, "write uci");
+        unlink(tmp_path);
+        return GAMING_ERROR_IO;
+    }
+
+    return GAMING_OK;
+}
@@ -0,0 +1,180 @@
+/**
+ * @file uci_native.h
+ * @brief 原生 UCI 設定檔解析器
+ * @version 1.0.0
+ *
+ * 直接 mmap /etc/config/<name>,一次掃描切出 config / option / list,
+ * 值以指向映射區的字串視圖 (uci_view_t) 表示,不複製也不逐值配置記憶體
+ * 比經由 popen("uci get ...") 快數個數量級,適合常駐服務頻繁讀取設定
+ *
+ * 限制: 只讀取已 commit 的檔案內容 (不含 /tmp/.uci 中尚未 commit 的變更);
+ * 匿名 section 只能以 "@type[index]" 存取
+ */
+
+#ifndef UCI_NATIVE_H
+#define UCI_NATIVE_H
+
+#include "gaming_common.h"
+#include <stddef.h>
+#include <stdio.h>
+
+// ========================================
+// UCI 配置
+// ========================================
+
+#define UCI_NATIVE_CONFIG_DIR  "/etc/config"
+#define UCI_NATIVE_DELTA_DIR   "/tmp/.uci"
+
+// ========================================
+// UCI 型別定義
+// ========================================
+
+/**
+ * @brief 字串視圖 (指向映射區,不以 '\0' 結尾)
+ *
+ * escaped 為 true 時 ptr 指向含引號/跳脫字元的原始 token,
+ * 需以 uci_native_view_copy() 取得實際內容
+ */
+typedef struct {
+    const char *ptr;
+    size_t len;
+    bool escaped;
+} uci_view_t;
+
+typedef struct uci_native uci_native_t;
+
+// ========================================
+// UCI 公開函數
+// ========================================
+
+/**
+ * @brief 開啟並解析 UCI 檔案
+ *
+ * @param path 檔案路徑
+ * @return 解析結果, NULL 開啟失敗或語法錯誤
+ */
+uci_native_t *uci_native_open(const char *path);
+
+/**
+ * @brief 依設定名稱開啟 UCI_NATIVE_CONFIG_DIR 下的檔案
+ *
+ * @param config_name 設定名稱 (例如 "gaming")
+ * @return 解析結果, NULL 失敗
+ */
+uci_native_t *uci_native_open_config(const char *config_name);
+
+/**
+ * @brief 釋放解析結果並解除映射
+ *
+ * @param uci 解析結果
+ */
+void uci_native_close(uci_native_t *uci);
+
+/**
+ * @brief 取得 section 數量
+ */
+size_t uci_native_section_count(const uci_native_t *uci);
+
+/**
+ * @brief 取得第 index 個 section 的類型與名稱
+ *
+ * @param uci 解析結果
+ * @param index section 索引
+ * @param type 輸出類型 (可為 NULL)
+ * @param name 輸出名稱 (匿名 section 長度為 0, 可為 NULL)
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR_NOT_FOUND 索引超出範圍
+ */
+int uci_native_section_at(const uci_native_t *uci, size_t index,
+                          uci_view_t *type, uci_view_t *name);
+
+/**
+ * @brief 查詢 option 值
+ *
+ * @param uci 解析結果
+ * @param section section 名稱或 "@type[index]" (index 可為負數)
+ * @param option option 名稱
+ * @param value 輸出值 (list 為第一個元素)
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR_NOT_FOUND 不存在
+ */
+int uci_native_get(const uci_native_t *uci, const char *section, const char *option,
+                   uci_view_t *value);
+
+/**
+ * @brief 查詢 option 值並複製為字串
+ *
+ * list 會以空白串接 (與 "uci get" 輸出相同)
+ *
+ * @param uci 解析結果
+ * @param section section 名稱或 "@type[index]"
+ * @param option option 名稱
+ * @param buffer 輸出緩衝區
+ * @param size 緩衝區大小
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR_NOT_FOUND 不存在
+ * @return GAMING_ERROR_NO_MEMORY 緩衝區不足
+ */
+int uci_native_get_string(const uci_native_t *uci, const char *section, const char *option,
+                          char *buffer, size_t size);
+
+/**
+ * @brief 取得 list 的所有元素
+ *
+ * 一般 option 視為只有一個元素的 list
+ *
+ * @param uci 解析結果
+ * @param section section 名稱或 "@type[index]"
+ * @param option option 名稱
+ * @param values 輸出陣列
+ * @param max_values 陣列大小
+ * @return >= 0 元素總數 (可能大於 max_values)
+ * @return GAMING_ERROR_NOT_FOUND 不存在
+ */
+int uci_native_get_list(const uci_native_t *uci, const char *section, const char *option,
+                        uci_view_t *values, size_t max_values);
+
+/**
+ * @brief 將視圖內容複製為字串 (處理引號與跳脫字元)
+ *
+ * @param view 視圖
+ * @param buffer 輸出緩衝區
+ * @param size 緩衝區大小
+ * @return >= 0 字串長度
+ * @return GAMING_ERROR_NO_MEMORY 緩衝區不足
+ */
+int uci_native_view_copy(const uci_view_t *view, char *buffer, size_t size);
+
+/**
+ * @brief 比較視圖內容與字串
+ *
+ * @return true 相等
+ */
+bool uci_native_view_equals(const uci_view_t *view, const char *str);
+
+/**
+ * @brief 以 UCI 檔案格式輸出
+ *
+ * 輸出格式與 "uci export" 相同 (package 為 NULL 時不輸出 package 行),
+ * 所有值統一以單引號包住;後面接 list 的 option 輸出為 list
+ * 與 uci 不同的是,同名 section 與重複的 option 依原檔逐筆輸出而不合併
+ *
+ * @param uci 解析結果
+ * @param package package 名稱 (可為 NULL)
+ * @param fp 輸出檔案
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR_IO 寫入失敗
+ */
+int uci_native_export(const uci_native_t *uci, const char *package, FILE *fp);
+
+/**
+ * @brief 原子寫回檔案 (temp + rename)
+ *
+ * @param uci 解析結果
+ * @param path 輸出路徑
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR_IO 寫入失敗
+ */
+int uci_native_write(const uci_native_t *uci, const char *path);
+
+#endif // UCI_NATIVE_H
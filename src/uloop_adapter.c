@@ -0,0 +1,393 @@
+/**
+ * @file uloop_adapter.c
+ * @brief libubox uloop 事件迴圈整合實作
+ * @version 1.0.0
+ */
+
+#define _GNU_SOURCE
+
+#include "uloop_adapter.h"
+#include "logger.h"
+#include "socket_helper.h"
+#include "metrics.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <signal.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/signalfd.h>
+#include <libubox/uloop.h>
+#include <libubox/utils.h>
+
+// ========================================
+// 內部結構
+// ========================================
+
+struct uloop_adapter_conn {
+    struct uloop_fd ufd;
+    uloop_adapter_conn_cb_t callback;
+    void *user_data;
+};
+
+struct uloop_adapter_listener {
+    struct uloop_fd ufd;
+    uloop_adapter_accept_cb_t callback;
+    void *user_data;
+};
+
+struct uloop_adapter_timer {
+    struct uloop_timeout timeout;
+    uint32_t interval_ms;
+    uloop_adapter_timer_cb_t callback;
+    void *user_data;
+};
+
+typedef struct {
+    uloop_adapter_signal_cb_t callback;
+    void *user_data;
+} signal_handler_t;
+
+// ========================================
+// 內部狀態
+// ========================================
+
+static bool uloop_adapter_initialized = false;
+static struct uloop_fd signal_ufd = { .fd = -1 };
+static sigset_t signal_mask;
+static signal_handler_t signal_handlers[_NSIG];
+
+// ========================================
+// 統計
+// ========================================
+
+static pthread_once_t uloop_metrics_once = PTHREAD_ONCE_INIT;
+static metrics_counter_t *metric_accepts;
+static metrics_counter_t *metric_accept_errors;
+static metrics_counter_t *metric_signals;
+
+static void uloop_metrics_register(void) {
+    metric_accepts = metrics_counter_register("uloop.accepts");
+    metric_accept_errors = metrics_counter_register("uloop.accept.errors");
+    metric_signals = metrics_counter_register("uloop.signals");
+}
+
+static inline void uloop_metrics_init(void) {
+    pthread_once(&uloop_metrics_once, uloop_metrics_register);
+}
+
+// ========================================
+// 內部輔助函數
+// ========================================
+
+static unsigned int to_uloop_flags(unsigned int events) {
+    unsigned int flags = 0;
+    if (events & ULOOP_ADAPTER_READ) {
+        flags |= ULOOP_READ;
+    }
+    if (events & ULOOP_ADAPTER_WRITE) {
+        flags |= ULOOP_WRITE;
+    }
+    return flags;
+}
+
+static void conn_handler(struct uloop_fd *ufd, unsigned int events) {
+    uloop_adapter_conn_t *conn = container_of(ufd, uloop_adapter_conn_t, ufd);
+
+    unsigned int ready = 0;
+    if (events & ULOOP_READ) {
+        ready |= ULOOP_ADAPTER_READ;
+    }
+    if (events & ULOOP_WRITE) {
+        ready |= ULOOP_ADAPTER_WRITE;
+    }
+    if (ufd->eof || ufd->error) {
+        ready |= ULOOP_ADAPTER_HUP;
+    }
+
+    conn->callback(conn, ufd->fd, ready, conn->user_data);
+}
+
+static void listener_handler(struct uloop_fd *ufd, unsigned int events) {
+    (void)events;
+    uloop_adapter_listener_t *listener = container_of(ufd, uloop_adapter_listener_t, ufd);
+
+    for (int i = 0; i < ULOOP_ADAPTER_ACCEPT_BATCH; i++) {
+        int client_fd = accept4(ufd->fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (client_fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                LOGM_ERRNO(LOG_MODULE_UBUS, "accept4");
+                metrics_counter_inc(metric_accept_errors);
+            }
+            return;
+        }
+
+        metrics_counter_inc(metric_accepts);
+        listener->callback(client_fd, listener->user_data);
+    }
+}
+
+static void timer_handler(struct uloop_timeout *timeout) {
+    uloop_adapter_timer_t *timer = container_of(timeout, uloop_adapter_timer_t, timeout);
+
+    // 先重新排程, 回呼中可以再停止或重設
+    if (timer->interval_ms > 0) {
+        uloop_timeout_set(&timer->timeout, (int)timer->interval_ms);
+    }
+    timer->callback(timer, timer->user_data);
+}
+
+static void signal_handler(struct uloop_fd *ufd, unsigned int events) {
+    (void)events;
+    struct signalfd_siginfo info[8];
+
+    for (;;) {
+        ssize_t n = read(ufd->fd, info, sizeof(info));
+        if (n < (ssize_t)sizeof(info[0])) {
+            return;
+        }
+
+        for (size_t i = 0; i < (size_t)n / sizeof(info[0]); i++) {
+            int signo = (int)info[i].ssi_signo;
+            metrics_counter_inc(metric_signals);
+            if (signo > 0 && signo < _NSIG && signal_handlers[signo].callback != NULL) {
+                signal_handlers[signo].callback(signo, signal_handlers[signo].user_data);
+            }
+        }
+    }
+}
+
+// ========================================
+// 公開函數實作
+// ========================================
+
+int uloop_adapter_init(void) {
+    if (uloop_adapter_initialized) {
+        return GAMING_OK;
+    }
+
+    uloop_metrics_init();
+    if (uloop_init() < 0) {
+        return GAMING_ERROR;
+    }
+
+    sigemptyset(&signal_mask);
+    memset(signal_handlers, 0, sizeof(signal_handlers));
+    uloop_adapter_initialized = true;
+    return GAMING_OK;
+}
+
+void uloop_adapter_run(void) {
+    if (uloop_adapter_initialized) {
+        uloop_run();
+    }
+}
+
+void uloop_adapter_stop(void) {
+    uloop_end();
+}
+
+void uloop_adapter_cleanup(void) {
+    if (!uloop_adapter_initialized) {
+        return;
+    }
+
+    if (signal_ufd.fd >= 0) {
+        uloop_fd_delete(&signal_ufd);
+        close(signal_ufd.fd);
+        signal_ufd.fd = -1;
+        pthread_sigmask(SIG_UNBLOCK, &signal_mask, NULL);
+    }
+
+    uloop_done();
+    uloop_adapter_initialized = false;
+}
+
+uloop_adapter_conn_t *uloop_adapter_conn_add(int fd, unsigned int events,
+                                             uloop_adapter_conn_cb_t callback, void *user_data) {
+    if (!uloop_adapter_initialized || fd < 0 || callback == NULL) {
+        return NULL;
+    }
+
+    if (socket_helper_set_nonblocking(fd) != GAMING_OK) {
+        return NULL;
+    }
+
+    uloop_adapter_conn_t *conn = calloc(1, sizeof(*conn));
+    if (conn == NULL) {
+        return NULL;
+    }
+
+    conn->ufd.fd = fd;
+    conn->ufd.cb = conn_handler;
+    conn->callback = callback;
+    conn->user_data = user_data;
+
+    if (uloop_fd_add(&conn->ufd, to_uloop_flags(events)) < 0) {
+        LOGM_ERRNO(LOG_MODULE_UBUS, "uloop_fd_add");
+        free(conn);
+        return NULL;
+    }
+
+    return conn;
+}
+
+int uloop_adapter_conn_set_events(uloop_adapter_conn_t *conn, unsigned int events) {
+    if (conn == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    // uloop_fd_add 對已註冊的 fd 會改為修改關注的事件
+    if (uloop_fd_add(&conn->ufd, to_uloop_flags(events)) < 0) {
+        return GAMING_ERROR_IO;
+    }
+    return GAMING_OK;
+}
+
+void uloop_adapter_conn_remove(uloop_adapter_conn_t *conn, bool close_fd) {
+    if (conn == NULL) {
+        return;
+    }
+
+    uloop_fd_delete(&conn->ufd);
+    if (close_fd) {
+        socket_helper_close(conn->ufd.fd);
+    }
+    free(conn);
+}
+
+uloop_adapter_listener_t *uloop_adapter_listener_add(int listen_fd,
+                                                     uloop_adapter_accept_cb_t callback,
+                                                     void *user_data) {
+    if (!uloop_adapter_initialized || listen_fd < 0 || callback == NULL) {
+        return NULL;
+    }
+
+    if (socket_helper_set_nonblocking(listen_fd) != GAMING_OK) {
+        return NULL;
+    }
+
+    uloop_adapter_listener_t *listener = calloc(1, sizeof(*listener));
+    if (listener == NULL) {
+        return NULL;
+    }
+
+    listener->ufd.fd = listen_fd;
+    listener->ufd.cb = listener_handler;
+    listener->callback = callback;
+    listener->user_data = user_data;
+
+    if (uloop_fd_add(&listener->ufd, ULOOP_READ) < 0) {
+        LOGM_ERRNO(LOG_MODULE_UBUS, "uloop_fd_add");
+        free(listener);
+        return NULL;
+    }
+
+    return listener;
+}
+
+void uloop_adapter_listener_remove(uloop_adapter_listener_t *listener, bool close_fd) {
+    if (listener == NULL) {
+        return;
+    }
+
+    uloop_fd_delete(&listener->ufd);
+    if (close_fd) {
+        socket_helper_close(listener->ufd.fd);
+    }
+    free(listener);
+}
+
+uloop_adapter_timer_t *uloop_adapter_timer_create(uloop_adapter_timer_cb_t callback,
+                                                  void *user_data) {
+    if (callback == NULL) {
+        return NULL;
+    }
+
+    uloop_adapter_timer_t *timer = calloc(1, sizeof(*timer));
+    if (timer == NULL) {
+        return NULL;
+    }
+
+    timer->timeout.cb = timer_handler;
+    timer->callback = callback;
+    timer->user_data = user_data;
+    return timer;
+}
+
+int uloop_adapter_timer_start(uloop_adapter_timer_t *timer, uint32_t timeout_ms,
+                              uint32_t interval_ms) {
+    if (timer == NULL) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    timer->interval_ms = interval_ms;
+    if (uloop_timeout_set(&timer->timeout, (int)timeout_ms) < 0) {
+        return GAMING_ERROR;
+    }
+    return GAMING_OK;
+}
+
+void uloop_adapter_timer_stop(uloop_adapter_timer_t *timer) {
+    if (timer == NULL) {
+        return;
+    }
+
+    timer->interval_ms = 0;
+    uloop_timeout_cancel(&timer->timeout);
+}
+
+void uloop_adapter_timer_destroy(uloop_adapter_timer_t *timer) {
+    if (timer == NULL) {
+        return;
+    }
+
+    uloop_timeout_cancel(&timer->timeout);
+    free(timer);
+}
+
+int uloop_adapter_signal_add(int signo, uloop_adapter_signal_cb_t callback, void *user_data) {
+    if (!uloop_adapter_initialized || signo <= 0 || signo >= _NSIG ||
+        signo == SIGKILL || signo == SIGSTOP) {
+        return GAMING_ERROR_INVALID_PARAM;
+    }
+
+    sigset_t one;
+    sigemptyset(&one);
+    sigaddset(&one, signo);
+
+    if (callback == NULL) {
+        sigdelset(&signal_mask, signo);
+        pthread_sigmask(SIG_UNBLOCK, &one, NULL);
+    } else {
+        sigaddset(&signal_mask, signo);
+        pthread_sigmask(SIG_BLOCK, &one, NULL);
+    }
+
+    // signalfd 傳入既有 fd 時只更新遮罩
+    int fd = signalfd(signal_ufd.fd, &signal_mask, SFD_NONBLOCK | SFD_CLOEXEC);
+    if (fd < 0) {
+        LOGM_ERRNO(LOG_MODULE_UBUS, "signalfd");
+        return GAMING_ERROR_IO;
+    }
+
+    if (signal_ufd.fd < 0) {
+        signal_ufd.fd = fd;
+        signal_ufd.cb = signal_handler;
+        if (uloop_fd_add(&signal_ufd, ULOOP_READ) < 0) {
+            LOGM_ERRNO(LOG_MODULE_UBUS, "uloop_fd_add");
+            close(fd);
+            signal_ufd.fd = -1;
+            return GAMING_ERROR_IO;
+        }
+    }
+
+    signal_handlers[signo].callback = callback;
+    signal_handlers[signo].user_data = user_data;
+    return GAMING_OK;
+}
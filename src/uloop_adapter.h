@@ -0,0 +1,202 @@
+/**
+ * @file uloop_adapter.h
+ * @brief libubox uloop 事件迴圈整合
+ * @version 1.0.0
+ *
+ * 將 socket_helper 建立的 listener / 連線、計時器與訊號註冊到 uloop,
+ * 讓 ubus、socket 與計時器共用同一個執行緒,不再以 socket_helper_is_readable()
+ * 之類的函數各自阻塞等待
+ *
+ *   - listener: 可讀時以 accept4() 批次接受連線 (非阻塞, CLOEXEC)
+ *   - 連線: 依需要開關寫入關注,只在真的有資料待送時才監聽 EPOLLOUT
+ *   - 訊號: 以單一 signalfd 接收,回呼在迴圈中執行 (不在 signal handler 中)
+ *
+ * uloop 本身是全域狀態,本模組所有函數須在迴圈執行緒中呼叫
+ */
+
+#ifndef ULOOP_ADAPTER_H
+#define ULOOP_ADAPTER_H
+
+#include "gaming_common.h"
+
+// ========================================
+// uloop 配置
+// ========================================
+
+#define ULOOP_ADAPTER_ACCEPT_BATCH  32   // 每次喚醒最多接受的連線數 (避免餓死其他 fd)
+
+// 連線事件 (可組合)
+#define ULOOP_ADAPTER_READ   (1U << 0)
+#define ULOOP_ADAPTER_WRITE  (1U << 1)
+#define ULOOP_ADAPTER_HUP    (1U << 2)   // 對端關閉或錯誤 (只出現在回呼)
+
+// ========================================
+// uloop 型別定義
+// ========================================
+
+typedef struct uloop_adapter_conn uloop_adapter_conn_t;
+typedef struct uloop_adapter_listener uloop_adapter_listener_t;
+typedef struct uloop_adapter_timer uloop_adapter_timer_t;
+
+/**
+ * @brief 連線就緒回呼
+ *
+ * 回呼中可以呼叫 uloop_adapter_conn_remove() 移除自己
+ *
+ * @param conn 連線
+ * @param fd 連線 fd
+ * @param events ULOOP_ADAPTER_READ / WRITE / HUP 組合
+ * @param user_data 使用者資料
+ */
+typedef void (*uloop_adapter_conn_cb_t)(uloop_adapter_conn_t *conn, int fd, unsigned int events,
+                                        void *user_data);
+
+/**
+ * @brief 新連線回呼
+ *
+ * @param client_fd 新連線 (已設為非阻塞),由回呼接手
+ * @param user_data 使用者資料
+ */
+typedef void (*uloop_adapter_accept_cb_t)(int client_fd, void *user_data);
+
+/**
+ * @brief 計時器回呼
+ */
+typedef void (*uloop_adapter_timer_cb_t)(uloop_adapter_timer_t *timer, void *user_data);
+
+/**
+ * @brief 訊號回呼
+ */
+typedef void (*uloop_adapter_signal_cb_t)(int signo, void *user_data);
+
+// ========================================
+// uloop 公開函數
+// ========================================
+
+/**
+ * @brief 初始化 uloop
+ *
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR 初始化失敗
+ */
+int uloop_adapter_init(void);
+
+/**
+ * @brief 執行事件迴圈直到 uloop_adapter_stop()
+ */
+void uloop_adapter_run(void);
+
+/**
+ * @brief 讓 uloop_adapter_run() 返回
+ */
+void uloop_adapter_stop(void);
+
+/**
+ * @brief 釋放 uloop 與 signalfd
+ */
+void uloop_adapter_cleanup(void);
+
+/**
+ * @brief 註冊連線
+ *
+ * fd 會被設為非阻塞
+ *
+ * @param fd 連線 fd
+ * @param events 關注的事件 (ULOOP_ADAPTER_READ / WRITE)
+ * @param callback 就緒回呼
+ * @param user_data 使用者資料
+ * @return 連線, NULL 失敗
+ */
+uloop_adapter_conn_t *uloop_adapter_conn_add(int fd, unsigned int events,
+                                             uloop_adapter_conn_cb_t callback, void *user_data);
+
+/**
+ * @brief 變更關注的事件 (例如有資料待送時加上 WRITE)
+ *
+ * @param conn 連線
+ * @param events 新的事件組合
+ * @return GAMING_OK 成功
+ */
+int uloop_adapter_conn_set_events(uloop_adapter_conn_t *conn, unsigned int events);
+
+/**
+ * @brief 移除連線
+ *
+ * @param conn 連線
+ * @param close_fd 是否一併關閉 fd
+ */
+void uloop_adapter_conn_remove(uloop_adapter_conn_t *conn, bool close_fd);
+
+/**
+ * @brief 註冊 listener
+ *
+ * 例如 socket_helper_create_unix() / socket_helper_create_tcp_server() 的回傳值
+ *
+ * @param listen_fd listener fd
+ * @param callback 新連線回呼
+ * @param user_data 使用者資料
+ * @return listener, NULL 失敗
+ */
+uloop_adapter_listener_t *uloop_adapter_listener_add(int listen_fd,
+                                                     uloop_adapter_accept_cb_t callback,
+                                                     void *user_data);
+
+/**
+ * @brief 移除 listener
+ *
+ * @param listener listener
+ * @param close_fd 是否一併關閉 fd
+ */
+void uloop_adapter_listener_remove(uloop_adapter_listener_t *listener, bool close_fd);
+
+/**
+ * @brief 建立計時器 (尚未啟動)
+ *
+ * @param callback 逾時回呼
+ * @param user_data 使用者資料
+ * @return 計時器, NULL 失敗
+ */
+uloop_adapter_timer_t *uloop_adapter_timer_create(uloop_adapter_timer_cb_t callback,
+                                                  void *user_data);
+
+/**
+ * @brief 啟動或重設計時器
+ *
+ * @param timer 計時器
+ * @param timeout_ms 首次逾時
+ * @param interval_ms 之後的週期, 0 為單次
+ * @return GAMING_OK 成功
+ */
+int uloop_adapter_timer_start(uloop_adapter_timer_t *timer, uint32_t timeout_ms,
+                              uint32_t interval_ms);
+
+/**
+ * @brief 停止計時器
+ */
+void uloop_adapter_timer_stop(uloop_adapter_timer_t *timer);
+
+/**
+ * @brief 停止並釋放計時器
+ */
+void uloop_adapter_timer_destroy(uloop_adapter_timer_t *timer);
+
+/**
+ * @brief 註冊訊號回呼
+ *
+ * 訊號會在呼叫端執行緒以 pthread_sigmask 阻擋,改由 signalfd 在迴圈中遞送;
+ * 同一訊號重複註冊會覆蓋前一個回呼,callback 為 NULL 取消註冊
+ *
+ * 行程導向的訊號會遞送給任一未阻擋該訊號的執行緒,因此必須在建立其他
+ * 執行緒之前註冊 (新執行緒繼承阻擋遮罩),否則訊號可能被其他執行緒以
+ * 預設動作處理而不會出現在 signalfd;thread_pool 的工作執行緒本身已阻擋所有訊號
+ *
+ * @param signo 訊號編號
+ * @param callback 回呼函數
+ * @param user_data 使用者資料
+ * @return GAMING_OK 成功
+ * @return GAMING_ERROR_INVALID_PARAM 訊號編號錯誤
+ * @return GAMING_ERROR_IO signalfd 失敗
+ */
+int uloop_adapter_signal_add(int signo, uloop_adapter_signal_cb_t callback, void *user_data);
+
+#endif // ULOOP_ADAPTER_H